@@ -0,0 +1,277 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the small timing and checking helpers shared by the benchmark programs.
+//
+//   Each benchmark repeats a measured block several times and reports the fastest run, which filters out scheduler
+//   noise without needing a full statistics framework.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: benchmark
+//
+// Description:
+//
+//   Timing utilities used by the benchmark programs under benchmarks/.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace benchmark
+{
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: doNotOptimize
+	//
+	// Description:
+	//
+	//   Force the compiler to materialize a value so that the work producing it cannot be optimized away.
+	//
+	// Arguments:
+	//
+	//   value (const T&):
+	//     The value to keep alive.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename T>
+	inline void doNotOptimize ( const T& value )
+	{
+		#if defined ( __GNUC__ ) || defined ( __clang__ )
+			asm volatile ( "" : : "r,m" ( value ) : "memory" );
+		#else
+			static volatile const T* sink;
+			sink = &value;
+		#endif
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: measure
+	//
+	// Description:
+	//
+	//   Run a block several times and return the best observed cost per operation.
+	//
+	//   The optional setup callable runs before every repetition and is excluded from the measurement.
+	//
+	// Arguments:
+	//
+	//   operations (std::size_t):
+	//     The number of operations performed by one call to body, used to normalize the result.
+	//
+	//   repetitions (int):
+	//     The number of times to run the block.
+	//
+	//   setup (Setup&&):
+	//     Callable invoked before each repetition to restore the starting state.
+	//
+	//   body (Body&&):
+	//     Callable performing the measured work.
+	//
+	// Returns:
+	//
+	//   The fastest observed time per operation in nanoseconds.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename Setup, typename Body>
+	double measure ( std::size_t operations, int repetitions, Setup&& setup, Body&& body )
+	{
+		double best = std::numeric_limits <double>::max ();
+
+		for ( int r = 0; r < repetitions; ++r )
+		{
+			setup ();
+
+			auto start = std::chrono::steady_clock::now ();
+			body ();
+			auto end   = std::chrono::steady_clock::now ();
+
+			double nanoseconds = std::chrono::duration <double, std::nano> ( end - start ).count ();
+			best               = std::min ( best, nanoseconds / static_cast <double> ( operations ) );
+		}
+
+		return best;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: printRow
+	//
+	// Description:
+	//
+	//   Print one result row as fixed-width columns: case name, problem size, then the baseline and candidate costs
+	//   with the resulting speed-up.
+	//
+	// Arguments:
+	//
+	//   name (const char*):
+	//     The name of the measured operation.
+	//
+	//   size (std::size_t):
+	//     The problem size, typically the entity count.
+	//
+	//   baselineNs (double):
+	//     Cost per operation of the reference implementation in nanoseconds.
+	//
+	//   candidateNs (double):
+	//     Cost per operation of the implementation under test in nanoseconds.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline void printRow ( const char* name, std::size_t size, double baselineNs, double candidateNs )
+	{
+		std::printf
+		(
+			"%-24s %10zu %14.2f %14.2f %9.2fx\n",
+			name,
+			size,
+			baselineNs,
+			candidateNs,
+			baselineNs / candidateNs
+		);
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: check
+	//
+	// Description:
+	//
+	//   Print a check's outcome and return it.
+	//
+	// Arguments:
+	//
+	//   description (const char*):
+	//     What the check verifies.
+	//
+	//   passed (bool):
+	//     Whether the check passed.
+	//
+	// Returns:
+	//
+	//   The value of passed, so results can be combined into an exit code.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline bool check ( const char* description, bool passed )
+	{
+		std::printf ( "%-72s %s\n", description, passed ? "yes" : "NO" );
+		return passed;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: percentile
+	//
+	// Description:
+	//
+	//   Return the value at the given percentile of a sample set using the nearest-rank method.
+	//
+	// Arguments:
+	//
+	//   samples (std::vector <double>):
+	//     The samples, taken by value because they are sorted in place.
+	//
+	//   p (double):
+	//     The percentile in the range 0 .. 100.
+	//
+	// Returns:
+	//
+	//   The sample at the requested percentile, or 0 if there are no samples.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline double percentile ( std::vector <double> samples, double p )
+	{
+		if ( samples.empty () ) return 0.0;
+
+		std::sort ( samples.begin (), samples.end () );
+
+		std::size_t rank = static_cast <std::size_t> ( p / 100.0 * static_cast <double> ( samples.size () - 1 ) + 0.5 );
+
+		return samples [ std::min ( rank, samples.size () - 1 ) ];
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Allocation Counting
+//
+// Description:
+//
+//   A benchmark that defines BENCHMARK_COUNT_ALLOCATIONS before including this header replaces the global operator
+//   new with one that counts its calls, so its checks can see whether an operation allocates. The replacement is
+//   opt-in because it would otherwise add an atomic increment to every allocation in every benchmark, and it may only
+//   be defined in one translation unit of a program.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#if defined ( BENCHMARK_COUNT_ALLOCATIONS )
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace benchmark
+{
+	//-----------------------------------------------------------------------------------------------------------------
+	// Variable: allocations
+	//
+	// Description:
+	//
+	//   Number of calls to the global operator new since the program started.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline std::atomic <std::size_t> allocations { 0 };
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: allocationCount
+	//
+	// Description:
+	//
+	//   Return the number of calls to the global operator new so far. Take the difference of two calls to count the
+	//   allocations made in between.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline std::size_t allocationCount ()
+	{
+		return allocations.load ( std::memory_order_relaxed );
+	}
+}
+
+void* operator new ( std::size_t size )
+{
+	benchmark::allocations.fetch_add ( 1, std::memory_order_relaxed );
+
+	if ( void* memory = std::malloc ( size ? size : 1 ) ) return memory;
+
+	throw std::bad_alloc ();
+}
+
+void operator delete ( void* memory ) noexcept
+{
+	std::free ( memory );
+}
+
+void operator delete ( void* memory, std::size_t ) noexcept
+{
+	std::free ( memory );
+}
+
+#endif
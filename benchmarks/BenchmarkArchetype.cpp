@@ -0,0 +1,218 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark comparing the sparse and archetype storage modes of ecs::World.
+//
+//   Measures a wall-collision style pass over three components, once through per-entity getComponent lookups in
+//   sparse mode and once through forEachChunk in archetype mode, and the cost of adding and removing a component,
+//   which moves the entity's row in archetype mode.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+//*********************************************************************************************************************
+// Structs: BenchTransform, BenchPhysics, BenchCircle, BenchTag
+//
+// Description:
+//
+//   Stand-ins for the particle demo's transform, physics, and circle components, plus an empty tag component used
+//   to measure structural changes.
+//
+//*********************************************************************************************************************
+
+struct BenchTransform
+{
+	double x = 0.0, y = 0.0, rotation = 0.0, scaleX = 1.0, scaleY = 1.0;
+};
+
+struct BenchPhysics
+{
+	double vx = 0.0, vy = 0.0, ax = 0.0, ay = 0.0, mass = 1.0, elasticity = 0.9;
+};
+
+struct BenchCircle
+{
+	double radius  = 0.01;
+	bool   visible = false;
+};
+
+struct BenchTag
+{
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: bounce
+//
+// Description:
+//
+//   Reflect one particle off the unit-height world walls, the same work SystemCollider does per particle.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+inline void bounce ( BenchTransform& transform, BenchPhysics& physics, const BenchCircle& circle )
+{
+	const double width = 16.0 / 9.0;
+	double       r     = circle.radius;
+
+	if ( transform.x - r < 0.0   ) { transform.x = r;         physics.vx =  std::abs ( physics.vx ) * physics.elasticity; }
+	if ( transform.x + r > width ) { transform.x = width - r; physics.vx = -std::abs ( physics.vx ) * physics.elasticity; }
+	if ( transform.y - r < 0.0   ) { transform.y = r;         physics.vy =  std::abs ( physics.vy ) * physics.elasticity; }
+	if ( transform.y + r > 1.0   ) { transform.y = 1.0 - r;   physics.vy = -std::abs ( physics.vy ) * physics.elasticity; }
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: populate
+//
+// Description:
+//
+//   Register the benchmark components and create entities carrying transform, physics, and circle components.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+std::vector <ecs::Entity> populate ( ecs::World& world, std::size_t count )
+{
+	world.registerComponent <BenchTransform> ();
+	world.registerComponent <BenchPhysics>   ();
+	world.registerComponent <BenchCircle>    ();
+	world.registerComponent <BenchTag>       ();
+
+	std::vector <ecs::Entity> entities ( count );
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		BenchTransform transform;
+		transform.x = static_cast <double> ( i % 1000 ) / 500.0 - 0.1;
+		transform.y = static_cast <double> ( i % 997 )  / 900.0;
+
+		entities [ i ] = world.createEntity ();
+		world.addComponent ( entities [ i ], transform );
+		world.addComponent ( entities [ i ], BenchPhysics {} );
+		world.addComponent ( entities [ i ], BenchCircle {} );
+	}
+
+	return entities;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run both storage modes at each entity count and print one row per operation.
+//
+// Returns:
+//
+//   Exit code 0.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t sizes []    = { 4096, 65536, 1048576 };
+	const int         repetitions = 5;
+
+	std::printf ( "%-24s %10s %14s %14s %10s\n", "operation", "entities", "sparse ns/op", "chunk ns/op", "speed-up" );
+
+	for ( std::size_t count : sizes )
+	{
+		ecs::World sparse    ( count, ecs::StorageMode::Sparse );
+		ecs::World archetype ( count, ecs::StorageMode::Archetype );
+
+		std::vector <ecs::Entity> sparseEntities    = populate ( sparse,    count );
+		std::vector <ecs::Entity> archetypeEntities = populate ( archetype, count );
+
+		// Iterate: the previous SystemCollider pattern of three lookups per entity, against one pass per chunk.
+
+		double lookup = benchmark::measure
+		(
+			count, repetitions,
+			[] () {},
+			[ & ] ()
+			{
+				for ( auto entity : sparseEntities )
+				{
+					bounce
+					(
+						sparse.getComponent <BenchTransform> ( entity ),
+						sparse.getComponent <BenchPhysics>   ( entity ),
+						sparse.getComponent <BenchCircle>    ( entity )
+					);
+				}
+			}
+		);
+
+		double chunked = benchmark::measure
+		(
+			count, repetitions,
+			[] () {},
+			[ & ] ()
+			{
+				archetype.forEachChunk <BenchTransform, BenchPhysics, BenchCircle>
+				(
+					[] ( std::size_t n, const ecs::Entity*, BenchTransform* transforms, BenchPhysics* physics, BenchCircle* circles )
+					{
+						for ( std::size_t i = 0; i < n; ++i ) bounce ( transforms [ i ], physics [ i ], circles [ i ] );
+					}
+				);
+			}
+		);
+
+		benchmark::printRow ( "iterate 3 components", count, lookup, chunked );
+
+		// Sparse-mode forEachChunk falls back to one entity per call; show what that costs relative to lookups.
+
+		double sparseChunked = benchmark::measure
+		(
+			count, repetitions,
+			[] () {},
+			[ & ] ()
+			{
+				sparse.forEachChunk <BenchTransform, BenchPhysics, BenchCircle>
+				(
+					[] ( std::size_t n, const ecs::Entity*, BenchTransform* transforms, BenchPhysics* physics, BenchCircle* circles )
+					{
+						for ( std::size_t i = 0; i < n; ++i ) bounce ( transforms [ i ], physics [ i ], circles [ i ] );
+					}
+				);
+			}
+		);
+
+		benchmark::printRow ( "iterate (sparse chunks)", count, lookup, sparseChunked );
+
+		// Structural change: add then remove a tag on every entity. Archetype mode moves each row twice.
+
+		auto addRemove = [ & ] ( ecs::World& world, const std::vector <ecs::Entity>& entities )
+		{
+			return benchmark::measure
+			(
+				count, repetitions,
+				[] () {},
+				[ & ] ()
+				{
+					for ( auto entity : entities ) world.addComponent ( entity, BenchTag {} );
+					for ( auto entity : entities ) world.removeComponent <BenchTag> ( entity );
+				}
+			);
+		};
+
+		benchmark::printRow ( "add+remove component", count, addRemove ( sparse, sparseEntities ), addRemove ( archetype, archetypeEntities ) );
+	}
+
+	return 0;
+}
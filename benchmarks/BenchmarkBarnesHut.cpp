@@ -0,0 +1,256 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Accuracy harness and benchmark for the SystemGravity Barnes-Hut solver against its exact pairwise solver.
+//
+//   The accuracy table runs both solvers over the same particles and reports the RMS force error relative to the
+//   RMS exact force, and the worst single-particle error relative to the same RMS force, for a range of opening
+//   angles. Individual exact forces can nearly cancel, so per-particle relative errors are not meaningful.
+//
+//   The speed table times one gravity frame per solver from 1K to 1M particles. The exact solver is O(N^2), so it
+//   is only timed up to 100K particles; the 1M row extrapolates the 100K time and is marked as an estimate.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+#include "../demo/particle_demo/systems/SystemGravity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+//*********************************************************************************************************************
+// Class: GravityScene
+//
+// Description:
+//
+//   A world holding randomly scattered particles and a gravity system configured from the demo's settings.
+//
+//*********************************************************************************************************************
+
+class GravityScene
+{
+public:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	ecs::World                      world;
+	std::shared_ptr <SystemGravity> gravity;
+	std::vector <ecs::Entity>       particles;
+	ecs::Entity                     worldEntity = ecs::NULL_ENTITY;
+
+	//=================================================================================================================
+	// Constructors
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Constructor: GravityScene
+	//
+	// Description:
+	//
+	//   Scatter particles over the demo's 16:9 world with the demo's four radii and masses, scaling the radii down
+	//   as the count grows so the covered area stays constant.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	explicit GravityScene ( std::size_t count )
+		: world ( count + 1 )
+	{
+		const double worldWidth = 1920.0 / 1080.0;
+		const double radii []   = { 0.032, 0.016, 0.008, 0.004 };
+		const double masses []  = { 8.0, 4.0, 2.0, 1.0 };
+		const double scale      = std::min ( std::sqrt ( 16.0 / static_cast <double> ( count ) ), 1.0 );
+
+		world.registerComponent <ComponentTransform> ();
+		world.registerComponent <ComponentPhysics>   ();
+		world.registerComponent <ComponentCircle>    ();
+		world.registerComponent <ComponentWorld>     ();
+
+		gravity = world.registerSystem <SystemGravity> ( "Gravity", world.makeSignature <ComponentTransform, ComponentPhysics, ComponentCircle> () );
+
+		ComponentWorld componentWorld;
+
+		componentWorld.gravitationalConstant = 0.0001;
+
+		worldEntity = world.createEntity ();
+		world.addComponent ( worldEntity, componentWorld );
+
+		gravity->worldEntity      = worldEntity;
+		gravity->softeningEpsilon = 0.009;
+
+		std::mt19937                            random ( 2011 );
+		std::uniform_real_distribution <double> unit   ( 0.0, 1.0 );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			ComponentTransform transform;
+			ComponentPhysics   physics;
+			ComponentCircle    circle;
+
+			transform.translation = { unit ( random ) * worldWidth, unit ( random ) };
+			physics.mass          = masses [ i % 4 ];
+			circle.radius         = radii [ i % 4 ] * scale;
+
+			ecs::Entity entity = world.createEntity ();
+			world.addComponent ( entity, transform );
+			world.addComponent ( entity, physics );
+			world.addComponent ( entity, circle );
+			particles.push_back ( entity );
+		}
+	}
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: step
+	//
+	// Description:
+	//
+	//   Clear the force accumulators and run one gravity frame with the chosen solver.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void step ( bool barnesHut, double theta )
+	{
+		auto& componentWorld = world.getComponent <ComponentWorld> ( worldEntity );
+
+		componentWorld.barnesHutEnabled = barnesHut;
+		componentWorld.barnesHutTheta   = theta;
+
+		for ( ecs::Entity entity : particles ) world.getComponent <ComponentPhysics> ( entity ).forceAccumulator = { 0.0, 0.0 };
+
+		gravity->update ( world, 1.0 / 60.0 );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: forces
+	//
+	// Description:
+	//
+	//   Return a copy of every particle's accumulated force.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::vector <engine::Vector2D> forces ()
+	{
+		std::vector <engine::Vector2D> result;
+
+		for ( ecs::Entity entity : particles ) result.push_back ( world.getComponent <ComponentPhysics> ( entity ).forceAccumulator );
+
+		return result;
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Print the accuracy table, then the speed table.
+//
+// Returns:
+//
+//   Exit code 0.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	// Accuracy against the exact solver.
+
+	{
+		const std::size_t count     = 10000;
+		const double      thetas [] = { 0.0, 0.3, 0.5, 0.7, 1.0 };
+
+		GravityScene scene ( count );
+
+		scene.step ( false, 0.0 );
+
+		std::vector <engine::Vector2D> exact = scene.forces ();
+
+		std::printf ( "%-24s %10s %10s %14s %14s\n", "accuracy", "particles", "theta", "rms error", "max error" );
+
+		for ( double theta : thetas )
+		{
+			scene.step ( true, theta );
+
+			std::vector <engine::Vector2D> approximate = scene.forces ();
+
+			double errorSquared = 0.0;
+			double exactSquared = 0.0;
+			double worst        = 0.0;
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				double deltaX    = approximate [ i ].x - exact [ i ].x;
+				double deltaY    = approximate [ i ].y - exact [ i ].y;
+				double error     = deltaX * deltaX + deltaY * deltaY;
+				double magnitude = exact [ i ].x * exact [ i ].x + exact [ i ].y * exact [ i ].y;
+
+				errorSquared += error;
+				exactSquared += magnitude;
+
+				worst = std::max ( worst, error );
+			}
+
+			std::printf ( "%-24s %10zu %10.2f %13.4f%% %13.4f%%\n", "barnes-hut force", count, theta, 100.0 * std::sqrt ( errorSquared / exactSquared ), 100.0 * std::sqrt ( worst * count / exactSquared ) );
+		}
+	}
+
+	// Speed at the default opening angle.
+
+	{
+		const std::size_t sizes []  = { 1000, 10000, 100000, 1000000 };
+		const std::size_t exactMax  = 100000;
+		const double      theta     = 0.5;
+		double            lastExact = 0.0;
+		std::size_t       lastCount = 0;
+
+		std::printf ( "\n%-24s %10s %14s %14s %10s\n", "operation", "particles", "exact ns", "barnes-hut ns", "speed-up" );
+
+		for ( std::size_t count : sizes )
+		{
+			GravityScene scene ( count );
+
+			int    repetitions = count >= exactMax ? 1 : 5;
+			double exact;
+
+			if ( count <= exactMax )
+			{
+				exact     = benchmark::measure ( count, repetitions, [] () {}, [ & ] () { scene.step ( false, 0.0 ); } );
+				lastExact = exact;
+				lastCount = count;
+			}
+			else
+			{
+				// Exact cost per particle grows linearly with the count.
+
+				exact = lastExact * static_cast <double> ( count ) / static_cast <double> ( lastCount );
+			}
+
+			double barnesHut = benchmark::measure ( count, repetitions, [] () {}, [ & ] () { scene.step ( true, theta ); } );
+
+			benchmark::printRow ( count <= exactMax ? "gravity frame" : "gravity frame (est)", count, exact, barnesHut );
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,271 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark and check for CommandManager posting from several threads.
+//
+//   The program checks that
+//
+//   - posting a small lambda does not allocate, and a large one still runs,
+//   - with four producer threads posting into a small ring while the main thread flushes, every command runs once
+//     and each thread's commands run in the order it posted them, including those that went through the overflow
+//     list,
+//   - a limited overflow list drops and counts the commands past its limit, and
+//   - a command posted by a running command runs in the same flush,
+//
+//   then times posting and flushing against the previous design, a std::queue of std::function guarded by a
+//   mutex, with one producer and with four.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#define BENCHMARK_COUNT_ALLOCATIONS
+
+#include "Benchmark.h"
+
+#include "../engine/CommandManager.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+//*********************************************************************************************************************
+// Class: LockedQueue
+//
+// Description:
+//
+//   The previous CommandManager design with a mutex added, the baseline for the timings.
+//
+//*********************************************************************************************************************
+
+class LockedQueue
+{
+private:
+
+	std::mutex                           mutex;
+	std::queue <std::function <void ()>> commandQueue;
+
+public:
+
+	void post ( std::function <void ()> command )
+	{
+		std::lock_guard <std::mutex> lock ( mutex );
+		commandQueue.push ( std::move ( command ) );
+	}
+
+	void flush ()
+	{
+		for ( ;; )
+		{
+			std::function <void ()> command;
+			{
+				std::lock_guard <std::mutex> lock ( mutex );
+				if ( commandQueue.empty () ) return;
+				command = std::move ( commandQueue.front () );
+				commandQueue.pop ();
+			}
+			command ();
+		}
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: runProducers
+//
+// Description:
+//
+//   Start a number of threads that each post a number of commands, flush on the calling thread until every command
+//   has run, and return the elapsed time per command in nanoseconds.
+//
+//   Each command adds its producer and sequence number to a log, which only the flushing thread writes.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename Queue>
+double runProducers ( Queue& queue, int producers, int perProducer, std::vector <std::vector <int>>* log )
+{
+	std::atomic <int> ran   { 0 };
+	std::atomic <int> ready { 0 };
+
+	if ( log ) log->assign ( producers, {} );
+
+	auto start = std::chrono::steady_clock::now ();
+
+	std::vector <std::thread> threads;
+
+	for ( int p = 0; p < producers; ++p )
+	{
+		threads.emplace_back
+		(
+			[ &, p ] ()
+			{
+				ready.fetch_add ( 1 );
+				while ( ready.load () < producers ) std::this_thread::yield ();
+
+				for ( int i = 0; i < perProducer; ++i )
+				{
+					queue.post ( [ &ran, log, p, i ] () { if ( log ) ( *log ) [ p ].push_back ( i ); ran.fetch_add ( 1, std::memory_order_relaxed ); } );
+				}
+			}
+		);
+	}
+
+	while ( ran.load ( std::memory_order_relaxed ) < producers * perProducer )
+	{
+		queue.flush ();
+		std::this_thread::yield ();
+	}
+
+	auto end = std::chrono::steady_clock::now ();
+
+	for ( auto& thread : threads ) thread.join ();
+
+	return std::chrono::duration <double, std::nano> ( end - start ).count () / ( producers * perProducer );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run the checks, then the timings.
+//
+// Returns:
+//
+//   Exit code 0 if every check passes, or 1 otherwise.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	bool allPassed = true;
+
+	// Small lambdas are stored in the ring slot.
+
+	{
+		engine::CommandManager commands;
+		int                    sum    = 0;
+		int*                   target = &sum;
+		double                 scale  = 2.0;
+
+		std::size_t before = benchmark::allocationCount ();
+
+		for ( int i = 0; i < 100; ++i ) commands.post ( [ target, scale, i ] () { *target += static_cast <int> ( scale * i ); } );
+
+		std::size_t allocations = benchmark::allocationCount () - before;
+
+		commands.flush ();
+
+		allPassed &= benchmark::check ( "posting a lambda capturing a pointer and two values does not allocate", allocations == 0 );
+		allPassed &= benchmark::check ( "the posted lambdas all ran", sum == 9900 );
+
+		struct Large { char bytes [ 200 ] = {}; };
+
+		Large large;
+		large.bytes [ 199 ] = 7;
+
+		commands.post ( [ large, target ] () { *target = large.bytes [ 199 ]; } );
+		commands.flush ();
+
+		allPassed &= benchmark::check ( "a lambda too large to store inline runs from the heap", sum == 7 );
+	}
+
+	// Four producers into a 64-slot ring, so most commands overflow while the main thread flushes.
+
+	{
+		const int producers   = 4;
+		const int perProducer = 20000;
+
+		engine::CommandManager          commands ( 64 );
+		std::vector <std::vector <int>> log;
+
+		runProducers ( commands, producers, perProducer, &log );
+
+		bool complete = true;
+		bool ordered  = true;
+
+		for ( const auto& sequence : log )
+		{
+			complete &= static_cast <int> ( sequence.size () ) == perProducer;
+
+			for ( std::size_t i = 0; i < sequence.size (); ++i ) ordered &= sequence [ i ] == static_cast <int> ( i );
+		}
+
+		std::printf ( "  ring capacity %zu, commands through the overflow list %zu\n", commands.getCapacity (), commands.getOverflowedCount () );
+
+		allPassed &= benchmark::check ( "four producers: every command ran exactly once",                 complete );
+		allPassed &= benchmark::check ( "four producers: each thread's commands ran in the order posted", ordered );
+		allPassed &= benchmark::check ( "four producers: the queue is empty afterwards",                  commands.empty () && commands.getDroppedCount () == 0 );
+	}
+
+	// A limited overflow list drops what does not fit.
+
+	{
+		engine::CommandManager commands ( 16 );
+		int                    ran    = 0;
+		int                    queued = 0;
+
+		commands.setOverflowLimit ( 8 );
+
+		for ( int i = 0; i < 40; ++i ) queued += commands.post ( [ &ran ] () { ++ran; } ) ? 1 : 0;
+
+		std::size_t depth = commands.getDepth ();
+
+		commands.flush ();
+
+		allPassed &= benchmark::check ( "overflow limit: 16 ring slots and 8 overflow commands queued, 16 dropped", queued == 24 && depth == 24 && ran == 24 && commands.getDroppedCount () == 16 );
+	}
+
+	// A command may post another command.
+
+	{
+		engine::CommandManager commands;
+		int                    order  = 0;
+		int                    first  = 0;
+		int                    second = 0;
+
+		commands.post ( [ & ] () { first = ++order; commands.post ( [ & ] () { second = ++order; } ); } );
+		commands.flush ();
+
+		allPassed &= benchmark::check ( "a command posted while flushing runs in the same flush", first == 1 && second == 2 );
+	}
+
+	// Timings.
+
+	std::printf ( "\n%-24s %10s %14s %14s %10s\n", "operation", "commands", "locked ns/op", "ring ns/op", "speed-up" );
+
+	for ( int producers : { 1, 4 } )
+	{
+		const int   perProducer = 200000 / producers;
+		const char* name        = producers == 1 ? "post + flush, 1 thread" : "post + flush, 4 threads";
+
+		double locked = std::numeric_limits <double>::max ();
+		double ring   = std::numeric_limits <double>::max ();
+
+		for ( int r = 0; r < 3; ++r )
+		{
+			LockedQueue            baseline;
+			engine::CommandManager commands;
+
+			locked = std::min ( locked, runProducers ( baseline, producers, perProducer, nullptr ) );
+			ring   = std::min ( ring,   runProducers ( commands, producers, perProducer, nullptr ) );
+		}
+
+		benchmark::printRow ( name, static_cast <std::size_t> ( producers * perProducer ), locked, ring );
+	}
+
+	return allPassed ? 0 : 1;
+}
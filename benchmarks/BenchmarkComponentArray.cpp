@@ -0,0 +1,247 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Micro-benchmark comparing ecs::ComponentArray, which indexes entities through a paged sparse array, against the
+//   previous std::unordered_map based entity index.
+//
+//   Measures get, has, insert, and remove throughput at 4K, 64K, and 1M entities.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/ComponentArray.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+//*********************************************************************************************************************
+// Struct: BenchmarkComponent
+//
+// Description:
+//
+//   Component payload roughly the size of the particle demo's transform and physics components.
+//
+//*********************************************************************************************************************
+
+struct BenchmarkComponent
+{
+	double values [ 8 ] = {};
+};
+
+//*********************************************************************************************************************
+// Class: MapComponentArray
+//
+// Description:
+//
+//   Reference copy of the previous ComponentArray implementation, which mapped entities to dense slots with a
+//   std::unordered_map. Kept here only as the benchmark baseline.
+//
+//*********************************************************************************************************************
+
+template <typename T>
+class MapComponentArray
+{
+private:
+
+	std::vector <T>                                    components;
+	std::unordered_map <ecs::Entity, std::size_t>      entityToIndex;
+	std::vector <ecs::Entity>                          indexToEntity;
+
+public:
+
+	T& get ( ecs::Entity entity )
+	{
+		return components [ entityToIndex [ entity ] ];
+	}
+
+	bool has ( ecs::Entity entity ) const
+	{
+		return entityToIndex.find ( entity ) != entityToIndex.end ();
+	}
+
+	void insert ( ecs::Entity entity, const T& component )
+	{
+		entityToIndex [ entity ] = components.size ();
+		indexToEntity.push_back ( entity );
+		components.push_back    ( component );
+	}
+
+	void remove ( ecs::Entity entity )
+	{
+		std::size_t removedIndex = entityToIndex [ entity ];
+		std::size_t lastIndex    = components.size () - 1;
+
+		if ( removedIndex != lastIndex )
+		{
+			components [ removedIndex ]    = std::move ( components [ lastIndex ] );
+			ecs::Entity lastEntity         = indexToEntity [ lastIndex ];
+			entityToIndex [ lastEntity ]   = removedIndex;
+			indexToEntity [ removedIndex ] = lastEntity;
+		}
+
+		components.pop_back    ();
+		indexToEntity.pop_back ();
+		entityToIndex.erase    ( entity );
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: runCase
+//
+// Description:
+//
+//   Measure get, has, insert, and remove for one array implementation at one entity count.
+//
+// Arguments:
+//
+//   entities (const std::vector <ecs::Entity>&):
+//     The entity IDs to insert, in insertion order.
+//
+//   shuffled (const std::vector <ecs::Entity>&):
+//     The same IDs in random order, used for random-access lookups and removals.
+//
+//   probes (const std::vector <ecs::Entity>&):
+//     IDs for the has benchmark, half present and half absent.
+//
+//   results (double*):
+//     Output array receiving the insert, get, has, and remove costs in nanoseconds per operation.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename Array>
+void runCase
+(
+	const std::vector <ecs::Entity>& entities,
+	const std::vector <ecs::Entity>& shuffled,
+	const std::vector <ecs::Entity>& probes,
+	double*                          results
+)
+{
+	const int repetitions = 5;
+
+	std::size_t count = entities.size ();
+	Array       array;
+
+	auto fill = [ & ] ()
+	{
+		array = Array {};
+		for ( auto entity : entities ) array.insert ( entity, BenchmarkComponent {} );
+	};
+
+	// Insert: start from an empty array each repetition.
+
+	results [ 0 ] = benchmark::measure
+	(
+		count, repetitions,
+		[ & ] () { array = Array {}; },
+		[ & ] () { for ( auto entity : entities ) array.insert ( entity, BenchmarkComponent {} ); }
+	);
+
+	// Get: random-order lookups over a full array.
+
+	fill ();
+
+	results [ 1 ] = benchmark::measure
+	(
+		count, repetitions,
+		[] () {},
+		[ & ] ()
+		{
+			double sum = 0.0;
+			for ( auto entity : shuffled ) sum += array.get ( entity ).values [ 0 ];
+			benchmark::doNotOptimize ( sum );
+		}
+	);
+
+	// Has: random-order membership tests, half of which miss.
+
+	results [ 2 ] = benchmark::measure
+	(
+		probes.size (), repetitions,
+		[] () {},
+		[ & ] ()
+		{
+			std::size_t hits = 0;
+			for ( auto entity : probes ) hits += array.has ( entity ) ? 1 : 0;
+			benchmark::doNotOptimize ( hits );
+		}
+	);
+
+	// Remove: random-order removals from a full array.
+
+	results [ 3 ] = benchmark::measure
+	(
+		count, repetitions,
+		fill,
+		[ & ] () { for ( auto entity : shuffled ) array.remove ( entity ); }
+	);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run the comparison at each entity count and print one row per operation.
+//
+// Returns:
+//
+//   Exit code 0.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t sizes [] = { 4096, 65536, 1048576 };
+	const char*       names [] = { "insert", "get (random)", "has (50% hit)", "remove (random)" };
+
+	std::mt19937 rng ( 12345 );
+
+	std::printf ( "%-24s %10s %14s %14s %10s\n", "operation", "entities", "map ns/op", "sparse ns/op", "speed-up" );
+
+	for ( std::size_t count : sizes )
+	{
+		// Entity IDs start at 1; ID 0 is NULL_ENTITY.
+
+		std::vector <ecs::Entity> entities ( count );
+		std::iota ( entities.begin (), entities.end (), ecs::Entity ( 1 ) );
+
+		std::vector <ecs::Entity> shuffled = entities;
+		std::shuffle ( shuffled.begin (), shuffled.end (), rng );
+
+		// Probe IDs alternate between present entities and IDs just past the populated range.
+
+		std::vector <ecs::Entity> probes ( count );
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			probes [ i ] = ( i % 2 == 0 ) ? shuffled [ i ] : static_cast <ecs::Entity> ( count + 1 + i );
+		}
+
+		double mapResults    [ 4 ];
+		double sparseResults [ 4 ];
+
+		runCase <MapComponentArray <BenchmarkComponent>>  ( entities, shuffled, probes, mapResults );
+		runCase <ecs::ComponentArray <BenchmarkComponent>> ( entities, shuffled, probes, sparseResults );
+
+		for ( int op = 0; op < 4; ++op )
+		{
+			benchmark::printRow ( names [ op ], count, mapResults [ op ], sparseResults [ op ] );
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,273 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Stress benchmark for entity creation and destruction at scale.
+//
+//   Creates and destroys one million entities in a World, churns a steady population through recycled indices,
+//   measures the cost of constructing short-lived worlds, and reports per-operation latency alongside the peak
+//   resident set size.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#if defined ( _WIN32 )
+	#define NOMINMAX
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: peakResidentBytes
+//
+// Description:
+//
+//   Return the peak resident set size of the current process.
+//
+// Returns:
+//
+//   The peak resident set size in bytes, or 0 if the platform does not report it.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+std::size_t peakResidentBytes ()
+{
+	#if defined ( _WIN32 )
+		PROCESS_MEMORY_COUNTERS counters {};
+		if ( GetProcessMemoryInfo ( GetCurrentProcess (), &counters, sizeof ( counters ) ) )
+		{
+			return static_cast <std::size_t> ( counters.PeakWorkingSetSize );
+		}
+		return 0;
+	#else
+		struct rusage usage {};
+		getrusage ( RUSAGE_SELF, &usage );
+
+		// Linux reports ru_maxrss in kilobytes; macOS reports bytes.
+
+		#if defined ( __APPLE__ )
+			return static_cast <std::size_t> ( usage.ru_maxrss );
+		#else
+			return static_cast <std::size_t> ( usage.ru_maxrss ) * 1024;
+		#endif
+	#endif
+}
+
+//*********************************************************************************************************************
+// Struct: StressComponent
+//
+// Description:
+//
+//   Small component attached to every stress entity so destruction also exercises component cleanup.
+//
+//*********************************************************************************************************************
+
+struct StressComponent
+{
+	double x = 0.0;
+	double y = 0.0;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: timeBatches
+//
+// Description:
+//
+//   Run an operation a number of times in fixed-size batches, timing each batch.
+//
+// Arguments:
+//
+//   operations (std::size_t):
+//     Total number of operations to run.
+//
+//   op (Op&&):
+//     Callable taking the operation number.
+//
+// Returns:
+//
+//   The per-operation cost of each batch in nanoseconds.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename Op>
+std::vector <double> timeBatches ( std::size_t operations, Op&& op )
+{
+	const std::size_t batchSize = 1024;
+
+	std::vector <double> samples;
+	samples.reserve ( operations / batchSize + 1 );
+
+	for ( std::size_t begin = 0; begin < operations; begin += batchSize )
+	{
+		std::size_t end = std::min ( begin + batchSize, operations );
+
+		auto start = std::chrono::steady_clock::now ();
+		for ( std::size_t i = begin; i < end; ++i ) op ( i );
+		auto stop  = std::chrono::steady_clock::now ();
+
+		double nanoseconds = std::chrono::duration <double, std::nano> ( stop - start ).count ();
+		samples.push_back ( nanoseconds / static_cast <double> ( end - begin ) );
+	}
+
+	return samples;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: report
+//
+// Description:
+//
+//   Print the mean, median, and 99th percentile batch latency for one phase, plus the peak resident set size so
+//   far.
+//
+// Arguments:
+//
+//   name (const char*):
+//     The phase name.
+//
+//   samples (const std::vector <double>&):
+//     Per-operation batch costs in nanoseconds.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void report ( const char* name, const std::vector <double>& samples )
+{
+	double mean = 0.0;
+	for ( double s : samples ) mean += s;
+	mean /= samples.empty () ? 1.0 : static_cast <double> ( samples.size () );
+
+	std::printf
+	(
+		"%-28s %10.2f %10.2f %10.2f %12.1f\n",
+		name,
+		mean,
+		benchmark::percentile ( samples, 50.0 ),
+		benchmark::percentile ( samples, 99.0 ),
+		static_cast <double> ( peakResidentBytes () ) / ( 1024.0 * 1024.0 )
+	);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run the stress phases in sequence and print one row per phase.
+//
+// Returns:
+//
+//   Exit code 0.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t entityCount     = 1000000;
+	const std::size_t churnPopulation = 65536;
+	const std::size_t worldCount      = 10000;
+
+	std::mt19937 rng ( 12345 );
+
+	std::printf ( "%-28s %10s %10s %10s %12s\n", "phase", "mean ns", "p50 ns", "p99 ns", "peak RSS MB" );
+	report ( "startup", { 0.0 } );
+
+	// Short-lived worlds: construct a world, spawn a handful of entities, and tear it down again.
+
+	{
+		auto samples = timeBatches
+		(
+			worldCount,
+			[] ( std::size_t )
+			{
+				ecs::World world;
+				world.registerComponent <StressComponent> ();
+
+				for ( int i = 0; i < 8; ++i )
+				{
+					world.addComponent ( world.createEntity (), StressComponent {} );
+				}
+			}
+		);
+
+		report ( "world construct+8 entities", samples );
+	}
+
+	// One million entities in a world that starts with the default capacity and grows on demand.
+
+	ecs::World world;
+	world.registerComponent <StressComponent> ();
+
+	std::vector <ecs::Entity> entities ( entityCount );
+
+	report
+	(
+		"create",
+		timeBatches ( entityCount, [ & ] ( std::size_t i ) { entities [ i ] = world.createEntity (); } )
+	);
+
+	report
+	(
+		"add component",
+		timeBatches ( entityCount, [ & ] ( std::size_t i ) { world.addComponent ( entities [ i ], StressComponent {} ); } )
+	);
+
+	std::shuffle ( entities.begin (), entities.end (), rng );
+
+	report
+	(
+		"destroy (random order)",
+		timeBatches ( entityCount, [ & ] ( std::size_t i ) { world.destroyEntity ( entities [ i ] ); } )
+	);
+
+	// Churn: keep a steady population alive and replace one random member per operation, recycling indices
+	// through the free list.
+
+	std::vector <ecs::Entity> population ( churnPopulation );
+	for ( auto& entity : population )
+	{
+		entity = world.createEntity ();
+		world.addComponent ( entity, StressComponent {} );
+	}
+
+	std::uniform_int_distribution <std::size_t> pick ( 0, churnPopulation - 1 );
+
+	report
+	(
+		"churn destroy+create",
+		timeBatches
+		(
+			entityCount,
+			[ & ] ( std::size_t )
+			{
+				auto& slot = population [ pick ( rng ) ];
+				world.destroyEntity ( slot );
+				slot = world.createEntity ();
+				world.addComponent ( slot, StressComponent {} );
+			}
+		)
+	);
+
+	std::printf ( "\nliving entities: %u, entity capacity: %zu\n", world.getEntityCount (), world.getEntityCapacity () );
+
+	return 0;
+}
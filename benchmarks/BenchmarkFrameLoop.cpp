@@ -0,0 +1,260 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark and check for the Engine main loop's fixed simulation step and frame pacing.
+//
+//   A minimal engine runs a simulation system that records every step it is given and a render system that
+//   records every frame and stops the loop after a set number of frames. The program checks that
+//
+//   - a fixed step hands every simulation update exactly the fixed step, and never more steps per frame than
+//     the limit,
+//   - a simulation step slower than real time is capped at the limit rather than falling further behind,
+//   - a time scale of four advances simulated time about four times faster than real time,
+//   - the render systems see an interpolation alpha in [ 0, 1 ), and
+//   - the variable step still hands the simulation the previous frame's duration,
+//
+//   then times frames at a 120 Hz target with millisecond sleeping and with precise pacing.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../engine/Engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//*********************************************************************************************************************
+// Class: StepRecorder
+//
+// Description:
+//
+//   Simulation system that records the step of every update, optionally taking a fixed time per update.
+//
+//*********************************************************************************************************************
+
+class StepRecorder : public ecs::System
+{
+public:
+
+	std::vector <double>      steps;
+	std::chrono::microseconds cost { 0 };
+
+	void update ( ecs::World&, double dt ) override
+	{
+		steps.push_back ( dt );
+
+		if ( cost.count () > 0 ) std::this_thread::sleep_for ( cost );
+	}
+};
+
+//*********************************************************************************************************************
+// Class: FrameRecorder
+//
+// Description:
+//
+//   Render system that records the steps taken and the interpolation alpha of every frame, and stops the engine
+//   after a set number of frames.
+//
+//*********************************************************************************************************************
+
+class FrameRecorder : public ecs::System
+{
+public:
+
+	engine::Engine*           engine    = nullptr;
+	const StepRecorder*       simulator = nullptr;
+	int                       frames    = 0;
+	std::vector <double>      alphas;
+	std::vector <std::size_t> stepsBefore;
+
+	void update ( ecs::World& world, double ) override
+	{
+		alphas.push_back      ( world.getInterpolationAlpha () );
+		stepsBefore.push_back ( simulator->steps.size () );
+
+		if ( static_cast <int> ( alphas.size () ) >= frames ) engine->stop ();
+	}
+};
+
+//*********************************************************************************************************************
+// Class: LoopEngine
+//
+// Description:
+//
+//   An engine holding one simulation system and one render system.
+//
+//*********************************************************************************************************************
+
+class LoopEngine : public engine::Engine
+{
+public:
+
+	std::shared_ptr <StepRecorder>  simulator;
+	std::shared_ptr <FrameRecorder> renderer;
+
+	explicit LoopEngine ( int frames )
+	{
+		simulator = world.registerSystem <StepRecorder>  ( "Simulation", ecs::Signature () );
+		renderer  = world.registerSystem <FrameRecorder> ( "Render",     ecs::Signature () );
+
+		renderer->render    = true;
+		renderer->engine    = this;
+		renderer->simulator = simulator.get ();
+		renderer->frames    = frames;
+	}
+
+	// Steps taken in each frame, from the second frame on.
+
+	std::vector <std::size_t> stepsPerFrame () const
+	{
+		std::vector <std::size_t> result;
+
+		for ( std::size_t i = 1; i < renderer->stepsBefore.size (); ++i ) result.push_back ( renderer->stepsBefore [ i ] - renderer->stepsBefore [ i - 1 ] );
+
+		return result;
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: runTimed
+//
+// Description:
+//
+//   Run an engine to completion and return the wall time in seconds.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+double runTimed ( LoopEngine& loop )
+{
+	auto start = std::chrono::steady_clock::now ();
+
+	loop.run ();
+
+	return std::chrono::duration <double> ( std::chrono::steady_clock::now () - start ).count ();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run the checks, then time the two pacing modes.
+//
+// Returns:
+//
+//   Exit code 0 if every check passed, 1 otherwise.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const double step     = 1.0 / 240.0;
+	const int    maxSteps = 4;
+	bool         allPass  = true;
+
+	// Fixed step at 240 Hz under a 120 Hz frame rate: two steps per frame, every one exactly the step.
+
+	{
+		LoopEngine loop ( 60 );
+
+		loop.setTargetFPS     ( 120.0 );
+		loop.setPrecisePacing ( true );
+		loop.setFixedStep     ( step, maxSteps );
+		loop.run ();
+
+		auto perFrame = loop.stepsPerFrame ();
+		bool exact    = std::all_of ( loop.simulator->steps.begin (), loop.simulator->steps.end (), [ & ] ( double dt ) { return dt == step; } );
+		bool bounded  = std::all_of ( perFrame.begin (), perFrame.end (), [ & ] ( std::size_t n ) { return n <= static_cast <std::size_t> ( maxSteps ); } );
+		bool alphas   = std::all_of ( loop.renderer->alphas.begin (), loop.renderer->alphas.end (), [] ( double a ) { return a >= 0.0 && a < 1.0; } );
+
+		allPass = benchmark::check ( "fixed step hands every update exactly the step", exact && !loop.simulator->steps.empty () ) && allPass;
+		allPass = benchmark::check ( "fixed step never exceeds the per-frame limit", bounded ) && allPass;
+		allPass = benchmark::check ( "interpolation alpha stays in [ 0, 1 )", alphas ) && allPass;
+	}
+
+	// A simulation step costing 10 ms against a 4 ms step cannot keep up; the loop must cap, not spiral.
+
+	{
+		LoopEngine loop ( 20 );
+
+		loop.simulator->cost = std::chrono::microseconds ( 10000 );
+		loop.setTargetFPS     ( 120.0 );
+		loop.setFixedStep     ( step, maxSteps );
+		loop.run ();
+
+		auto perFrame = loop.stepsPerFrame ();
+		bool capped   = std::all_of ( perFrame.begin (), perFrame.end (), [ & ] ( std::size_t n ) { return n <= static_cast <std::size_t> ( maxSteps ); } );
+
+		allPass = benchmark::check ( "slow steps are capped at the per-frame limit", capped ) && allPass;
+	}
+
+	// A time scale of four simulates four seconds per real second.
+
+	{
+		LoopEngine loop ( 120 );
+
+		loop.setTargetFPS     ( 120.0 );
+		loop.setPrecisePacing ( true );
+		loop.setFixedStep     ( step, 16 );
+		loop.setTimeScale     ( 4.0 );
+
+		double wall      = runTimed ( loop );
+		double simulated = static_cast <double> ( loop.simulator->steps.size () ) * step;
+		double ratio     = simulated / wall;
+
+		std::printf ( "time scale 4: %.3f s simulated in %.3f s, ratio %.2f\n", simulated, wall, ratio );
+
+		allPass = benchmark::check ( "time scale 4 runs about four times faster than real time", ratio > 3.5 && ratio < 4.5 ) && allPass;
+	}
+
+	// The variable step hands each update the previous frame's duration.
+
+	{
+		LoopEngine loop ( 30 );
+
+		loop.setTargetFPS ( 120.0 );
+		loop.run ();
+
+		const auto& steps    = loop.simulator->steps;
+		bool        variable = steps.size () == 30 && steps [ 0 ] == 0.0 && std::all_of ( steps.begin () + 1, steps.end (), [] ( double dt ) { return dt > 0.0; } );
+
+		allPass = benchmark::check ( "variable step passes the previous frame's duration", variable ) && allPass;
+	}
+
+	// Pacing: mean frame period and its error against the 120 Hz target.
+
+	std::printf ( "\n%-10s %8s %14s %14s %12s\n", "pacing", "frames", "target ms", "mean ms", "error %" );
+
+	for ( bool precise : { false, true } )
+	{
+		const int frames = 240;
+
+		LoopEngine loop ( frames );
+
+		loop.setTargetFPS     ( 120.0 );
+		loop.setPrecisePacing ( precise );
+
+		double wall   = runTimed ( loop );
+		double mean   = wall / frames;
+		double target = 1.0 / 120.0;
+
+		std::printf ( "%-10s %8d %14.3f %14.3f %11.2f%%\n", precise ? "precise" : "sleep", frames, target * 1e3, mean * 1e3, ( mean - target ) / target * 100.0 );
+	}
+
+	return allPass ? 0 : 1;
+}
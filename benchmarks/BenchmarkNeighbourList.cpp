@@ -0,0 +1,322 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark comparing SystemRepulsion on the shared neighbour list against the all-pairs loop it replaced.
+//
+//   The baseline is the previous all-pairs repulsion loop, kept here as a reference. The candidate runs
+//   SystemRepulsion over a sequence of frames in which every particle drifts, so the cost of rebuilding the list
+//   whenever a particle has moved half the skin is included. Per-particle time that stays flat as the count grows
+//   shows linear scaling.
+//
+//   The forces from the first frame of each path are compared bit for bit. Both sum their pairs through a
+//   PairAccumulator, whose all-pairs and listed walks add in the same order.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+#include "../demo/particle_demo/systems/SystemRepulsion.h"
+#include "../demo/particle_demo/components/ComponentNeighbourList.h"
+#include "../engine/PairAccumulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+//*********************************************************************************************************************
+// Class: RepulsionScene
+//
+// Description:
+//
+//   A world holding randomly scattered, drifting particles, a repulsion system, and the shared neighbour list.
+//
+//*********************************************************************************************************************
+
+class RepulsionScene
+{
+public:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	ecs::World                        world;
+	std::shared_ptr <SystemRepulsion> repulsion;
+	std::vector <ecs::Entity>         particles;
+	std::vector <engine::Vector2D>    drift;
+	engine::PairAccumulator           accumulator;
+	ecs::Entity                       worldEntity = ecs::NULL_ENTITY;
+
+	//=================================================================================================================
+	// Constructors
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Constructor: RepulsionScene
+	//
+	// Description:
+	//
+	//   Scatter particles over the demo's 16:9 world with the demo's four radii, scaling the radii and the skin
+	//   down as the count grows so the covered area stays constant.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	explicit RepulsionScene ( std::size_t count )
+		: world ( count + 1 )
+	{
+		const double worldWidth = 1920.0 / 1080.0;
+		const double radii []   = { 0.032, 0.016, 0.008, 0.004 };
+		const double scale      = std::min ( std::sqrt ( 16.0 / static_cast <double> ( count ) ), 1.0 );
+
+		world.registerComponent <ComponentTransform>     ();
+		world.registerComponent <ComponentPhysics>       ();
+		world.registerComponent <ComponentCircle>        ();
+		world.registerComponent <ComponentWorld>         ();
+		world.registerComponent <ComponentNeighbourList> ();
+
+		repulsion = world.registerSystem <SystemRepulsion> ( "Repulsion", world.makeSignature <ComponentTransform, ComponentPhysics, ComponentCircle> () );
+
+		ComponentWorld         componentWorld;
+		ComponentNeighbourList neighbourList;
+
+		componentWorld.repulsiveConstant = 4.0;
+		neighbourList.pairs.setSkin ( 0.01 * scale );
+
+		worldEntity = world.createEntity ();
+		world.addComponent ( worldEntity, componentWorld );
+		world.addComponent ( worldEntity, neighbourList );
+
+		repulsion->worldEntity = worldEntity;
+
+		std::mt19937                            random ( 2011 );
+		std::uniform_real_distribution <double> unit   ( 0.0, 1.0 );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			ComponentTransform transform;
+			ComponentPhysics   physics;
+			ComponentCircle    circle;
+
+			transform.translation = { unit ( random ) * worldWidth, unit ( random ) };
+			circle.radius         = radii [ i % 4 ] * scale;
+
+			ecs::Entity entity = world.createEntity ();
+			world.addComponent ( entity, transform );
+			world.addComponent ( entity, physics );
+			world.addComponent ( entity, circle );
+			particles.push_back ( entity );
+
+			// Drift about a tenth of the skin per frame, so the list is rebuilt every few frames.
+
+			drift.push_back ( { ( unit ( random ) - 0.5 ) * 0.002 * scale, ( unit ( random ) - 0.5 ) * 0.002 * scale } );
+		}
+	}
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: clearForces
+	//
+	// Description:
+	//
+	//   Zero every particle's force accumulator.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void clearForces ()
+	{
+		for ( ecs::Entity entity : particles ) world.getComponent <ComponentPhysics> ( entity ).forceAccumulator = { 0.0, 0.0 };
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: move
+	//
+	// Description:
+	//
+	//   Advance every particle by its drift.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void move ()
+	{
+		for ( std::size_t i = 0; i < particles.size (); ++i )
+		{
+			auto& transform = world.getComponent <ComponentTransform> ( particles [ i ] );
+
+			transform.translation.x += drift [ i ].x;
+			transform.translation.y += drift [ i ].y;
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: repelAllPairs
+	//
+	// Description:
+	//
+	//   The previous SystemRepulsion loop: test every pair and apply the quadratic falloff force, summed by the
+	//   accumulator's all-pairs walk on the calling thread.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void repelAllPairs ()
+	{
+		double      repulsiveConstant = world.getComponent <ComponentWorld> ( worldEntity ).repulsiveConstant;
+		std::size_t n                 = particles.size ();
+
+		std::vector <ComponentTransform*> transforms ( n );
+		std::vector <ComponentPhysics*>   physics    ( n );
+		std::vector <ComponentCircle*>    circles    ( n );
+
+		for ( std::size_t i = 0; i < n; ++i )
+		{
+			transforms [ i ] = &world.getComponent <ComponentTransform> ( particles [ i ] );
+			physics    [ i ] = &world.getComponent <ComponentPhysics>   ( particles [ i ] );
+			circles    [ i ] = &world.getComponent <ComponentCircle>    ( particles [ i ] );
+		}
+
+		accumulator.accumulateAllPairs ( nullptr, n, [ & ] ( std::size_t i, std::size_t j, engine::Vector2D& force )
+		{
+			double deltaX   = transforms [ i ]->translation.x - transforms [ j ]->translation.x;
+			double deltaY   = transforms [ i ]->translation.y - transforms [ j ]->translation.y;
+			double distance = std::sqrt ( deltaX * deltaX + deltaY * deltaY );
+
+			double minimumDistance = circles [ i ]->radius + circles [ j ]->radius;
+			double threshold       = minimumDistance * 2.0;
+
+			if ( distance <= minimumDistance || distance >= threshold ) return false;
+
+			double scaleFactor         = ( distance - minimumDistance ) / ( threshold - minimumDistance );
+			double oneMinusScaleFactor = 1.0 - scaleFactor;
+			double forceMagnitude      = repulsiveConstant * oneMinusScaleFactor * oneMinusScaleFactor;
+
+			double normalX = deltaX / distance;
+			double normalY = deltaY / distance;
+
+			force.x = forceMagnitude * normalX;
+			force.y = forceMagnitude * normalY;
+
+			return true;
+		} );
+
+		for ( std::size_t i = 0; i < n; ++i )
+		{
+			physics [ i ]->forceAccumulator.x += accumulator.getForce ( i ).x;
+			physics [ i ]->forceAccumulator.y += accumulator.getForce ( i ).y;
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: forces
+	//
+	// Description:
+	//
+	//   Return a copy of every particle's accumulated force.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::vector <engine::Vector2D> forces ()
+	{
+		std::vector <engine::Vector2D> result;
+
+		for ( ecs::Entity entity : particles ) result.push_back ( world.getComponent <ComponentPhysics> ( entity ).forceAccumulator );
+
+		return result;
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run the comparison at each particle count and print one row per count, in nanoseconds per particle per frame.
+//
+// Returns:
+//
+//   Exit code 0 if every neighbour list frame matched the all-pairs frame, 1 otherwise.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t sizes [] = { 1000, 5000, 10000, 50000 };
+	const int         frames   = 60;
+	bool              allMatch = true;
+
+	std::printf ( "%-24s %10s %14s %14s %10s %10s %10s\n", "operation", "particles", "all-pairs ns", "neighbour ns", "speed-up", "rebuilds", "identical" );
+
+	for ( std::size_t count : sizes )
+	{
+		RepulsionScene scene ( count );
+
+		// Check the first frame against the reference loop.
+
+		scene.clearForces   ();
+		scene.repelAllPairs ();
+
+		std::vector <engine::Vector2D> expected = scene.forces ();
+
+		scene.clearForces ();
+		scene.repulsion->update ( scene.world, 1.0 / 60.0 );
+
+		std::vector <engine::Vector2D> actual = scene.forces ();
+
+		bool match = std::memcmp ( expected.data (), actual.data (), count * sizeof ( engine::Vector2D ) ) == 0;
+		allMatch   = allMatch && match;
+
+		// The all-pairs frame costs the same wherever the particles are, so one frame is timed.
+
+		int repetitions = count >= 50000 ? 1 : 3;
+
+		double allPairs = benchmark::measure ( count, repetitions, [ & ] () { scene.clearForces (); }, [ & ] () { scene.repelAllPairs (); } );
+
+		// Time a run of drifting frames, including the rebuilds they trigger.
+
+		auto&       pairs        = scene.world.getComponent <ComponentNeighbourList> ( scene.worldEntity ).pairs;
+		std::size_t buildsBefore = pairs.getBuildCount ();
+
+		double listed = benchmark::measure
+		(
+			count * frames, 1,
+			[] () {},
+			[ & ] ()
+			{
+				for ( int frame = 0; frame < frames; ++frame )
+				{
+					scene.move ();
+					scene.repulsion->update ( scene.world, 1.0 / 60.0 );
+				}
+			}
+		);
+
+		std::printf
+		(
+			"%-24s %10zu %14.2f %14.2f %9.2fx %10zu %10s\n",
+			"repulsion frame",
+			count,
+			allPairs,
+			listed,
+			allPairs / listed,
+			pairs.getBuildCount () - buildsBefore,
+			match ? "yes" : "NO"
+		);
+	}
+
+	return allMatch ? 0 : 1;
+}
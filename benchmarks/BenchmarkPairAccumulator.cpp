@@ -0,0 +1,428 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark measuring how the pair force systems scale with the number of job system threads.
+//
+//   SystemGravity sums every pair exactly and SystemRepulsion sums the pairs of the shared neighbour list, both
+//   through a PairAccumulator. SystemPairForces runs its vector kernel on fixed blocks of rows for both laws
+//   together, and sums the listed pairs through a PairAccumulator for repulsion alone. For each particle count the
+//   systems first run without a job system; every thread count must then reproduce those forces bit for bit. The exact gravity forces are also compared with a plain
+//   nested i < j loop, which sums in a different order, relative to the largest force.
+//
+//   Thread counts run in powers of two up to the hardware thread count, and at least up to four. Rows beyond the
+//   hardware thread count are oversubscribed and cannot speed up.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+#include "../engine/JobSystem.h"
+#include "../demo/particle_demo/systems/SystemGravity.h"
+#include "../demo/particle_demo/systems/SystemRepulsion.h"
+#include "../demo/particle_demo/systems/SystemPairForces.h"
+#include "../demo/particle_demo/components/ComponentNeighbourList.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+//*********************************************************************************************************************
+// Class: ForceScene
+//
+// Description:
+//
+//   A world holding randomly scattered particles with the demo's masses and radii, the gravity, repulsion, and
+//   fused pair force systems, and the shared neighbour list.
+//
+//*********************************************************************************************************************
+
+class ForceScene
+{
+public:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	ecs::World                         world;
+	std::shared_ptr <SystemGravity>    gravity;
+	std::shared_ptr <SystemRepulsion>  repulsion;
+	std::shared_ptr <SystemPairForces> pairForces;
+	std::vector <ecs::Entity>          particles;
+	ecs::Entity                        worldEntity = ecs::NULL_ENTITY;
+
+	//=================================================================================================================
+	// Constructors
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Constructor: ForceScene
+	//
+	// Description:
+	//
+	//   Scatter particles over the demo's 16:9 world, scaling the radii down as the count grows so the covered area
+	//   and the number of neighbours per particle stay constant.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	explicit ForceScene ( std::size_t count )
+		: world ( count + 1 )
+	{
+		const double worldWidth = 1920.0 / 1080.0;
+		const double masses []  = { 8.0, 4.0, 2.0, 1.0 };
+		const double radii []   = { 0.032, 0.016, 0.008, 0.004 };
+		const double scale      = std::min ( std::sqrt ( 16.0 / static_cast <double> ( count ) ), 1.0 );
+
+		world.registerComponent <ComponentTransform>     ();
+		world.registerComponent <ComponentPhysics>       ();
+		world.registerComponent <ComponentCircle>        ();
+		world.registerComponent <ComponentWorld>         ();
+		world.registerComponent <ComponentNeighbourList> ();
+
+		auto signature = world.makeSignature <ComponentTransform, ComponentPhysics, ComponentCircle> ();
+
+		gravity    = world.registerSystem <SystemGravity>    ( "Gravity",    signature );
+		repulsion  = world.registerSystem <SystemRepulsion>  ( "Repulsion",  signature );
+		pairForces = world.registerSystem <SystemPairForces> ( "PairForces", signature );
+
+		ComponentWorld         componentWorld;
+		ComponentNeighbourList neighbourList;
+
+		componentWorld.gravitationalConstant = 0.0001;
+		componentWorld.repulsiveConstant     = 4.0;
+		neighbourList.pairs.setSkin ( 0.01 * scale );
+
+		worldEntity = world.createEntity ();
+		world.addComponent ( worldEntity, componentWorld );
+		world.addComponent ( worldEntity, neighbourList );
+
+		gravity->worldEntity    = worldEntity;
+		repulsion->worldEntity  = worldEntity;
+		pairForces->worldEntity = worldEntity;
+
+		std::mt19937                            random ( 2011 );
+		std::uniform_real_distribution <double> unit   ( 0.0, 1.0 );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			ComponentTransform transform;
+			ComponentPhysics   physics;
+			ComponentCircle    circle;
+
+			transform.translation = { unit ( random ) * worldWidth, unit ( random ) };
+			physics.mass          = masses [ i % 4 ];
+			circle.radius         = radii [ i % 4 ] * scale;
+
+			ecs::Entity entity = world.createEntity ();
+			world.addComponent ( entity, transform );
+			world.addComponent ( entity, physics );
+			world.addComponent ( entity, circle );
+			particles.push_back ( entity );
+		}
+	}
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: useJobs
+	//
+	// Description:
+	//
+	//   Run the systems on a job system, or on the calling thread if jobs is null.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void useJobs ( engine::JobSystem* jobs )
+	{
+		gravity->jobs    = jobs;
+		repulsion->jobs  = jobs;
+		pairForces->jobs = jobs;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: fuse
+	//
+	// Description:
+	//
+	//   Hand the forces to the fused system, with gravity and repulsion or with repulsion alone.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void fuse ( bool gravityEnabled )
+	{
+		auto& componentWorld = world.getComponent <ComponentWorld> ( worldEntity );
+
+		componentWorld.fusedForcesEnabled = true;
+		componentWorld.gravityEnabled     = gravityEnabled;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: clearForces
+	//
+	// Description:
+	//
+	//   Zero every particle's force accumulator.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void clearForces ()
+	{
+		for ( ecs::Entity entity : particles ) world.getComponent <ComponentPhysics> ( entity ).forceAccumulator = { 0.0, 0.0 };
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: attractAllPairs
+	//
+	// Description:
+	//
+	//   The previous exact SystemGravity loop, adding each pair's force to both particles as it goes.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void attractAllPairs ()
+	{
+		double      gravitationalConstant = world.getComponent <ComponentWorld> ( worldEntity ).gravitationalConstant;
+		double      softeningEpsilon      = gravity->softeningEpsilon;
+		std::size_t n                     = particles.size ();
+
+		for ( std::size_t i = 0; i < n; ++i )
+		{
+			auto& transformA = world.getComponent <ComponentTransform> ( particles [ i ] );
+			auto& physicsA   = world.getComponent <ComponentPhysics>   ( particles [ i ] );
+			auto& circleA    = world.getComponent <ComponentCircle>    ( particles [ i ] );
+
+			for ( std::size_t j = i + 1; j < n; ++j )
+			{
+				auto& transformB = world.getComponent <ComponentTransform> ( particles [ j ] );
+				auto& physicsB   = world.getComponent <ComponentPhysics>   ( particles [ j ] );
+				auto& circleB    = world.getComponent <ComponentCircle>    ( particles [ j ] );
+
+				double deltaX          = transformB.translation.x - transformA.translation.x;
+				double deltaY          = transformB.translation.y - transformA.translation.y;
+				double distanceSquared = deltaX * deltaX + deltaY * deltaY;
+				double distance        = std::sqrt ( distanceSquared );
+
+				if ( distance <= circleA.radius + circleB.radius ) continue;
+
+				double forceMagnitude = gravitationalConstant * physicsA.mass * physicsB.mass / ( distanceSquared + softeningEpsilon * softeningEpsilon );
+				double forceX         = forceMagnitude * deltaX / distance;
+				double forceY         = forceMagnitude * deltaY / distance;
+
+				physicsA.forceAccumulator.x += forceX;
+				physicsA.forceAccumulator.y += forceY;
+				physicsB.forceAccumulator.x -= forceX;
+				physicsB.forceAccumulator.y -= forceY;
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: forces
+	//
+	// Description:
+	//
+	//   Return a copy of every particle's accumulated force.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::vector <engine::Vector2D> forces ()
+	{
+		std::vector <engine::Vector2D> result;
+
+		for ( ecs::Entity entity : particles ) result.push_back ( world.getComponent <ComponentPhysics> ( entity ).forceAccumulator );
+
+		return result;
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: sameForces
+//
+// Description:
+//
+//   Return true if two sets of forces are identical bit for bit.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+bool sameForces ( const std::vector <engine::Vector2D>& expected, const std::vector <engine::Vector2D>& actual )
+{
+	if ( expected.size () != actual.size () ) return false;
+
+	for ( std::size_t i = 0; i < expected.size (); ++i )
+	{
+		if ( expected [ i ].x != actual [ i ].x || expected [ i ].y != actual [ i ].y ) return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: maximumRelativeError
+//
+// Description:
+//
+//   Return the largest force difference from the reference, relative to the largest reference force.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+double maximumRelativeError ( const std::vector <engine::Vector2D>& expected, const std::vector <engine::Vector2D>& actual )
+{
+	double largestForce = 0.0;
+	double largestError = 0.0;
+
+	for ( std::size_t i = 0; i < expected.size (); ++i )
+	{
+		largestForce = std::max ( largestForce, std::hypot ( expected [ i ].x, expected [ i ].y ) );
+		largestError = std::max ( largestError, std::hypot ( actual [ i ].x - expected [ i ].x, actual [ i ].y - expected [ i ].y ) );
+	}
+
+	return largestForce > 0.0 ? largestError / largestForce : largestError;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: run
+//
+// Description:
+//
+//   Run one system at one particle count on each thread count, check its forces against the run without a job
+//   system, and print one row per thread count. The optional configure callable prepares the scene first.
+//
+// Returns:
+//
+//   True if every thread count reproduced the forces.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+bool run ( const char* operation, std::size_t count, std::size_t maximum, int repetitions, ecs::System& ( *select ) ( ForceScene& ), void ( *configure ) ( ForceScene& ) = nullptr )
+{
+	ForceScene scene ( count );
+
+	if ( configure ) configure ( scene );
+
+	auto step = [ & ] ()
+	{
+		scene.clearForces ();
+		select ( scene ).update ( scene.world, 1.0 / 60.0 );
+	};
+
+	step ();
+
+	std::vector <engine::Vector2D> expected = scene.forces ();
+
+	double serialNs = benchmark::measure ( 1, repetitions, [] () {}, step );
+	bool   allMatch = true;
+
+	for ( std::size_t threads = 1; threads <= maximum; threads *= 2 )
+	{
+		engine::JobSystem jobs ( threads );
+
+		scene.useJobs ( &jobs );
+		step ();
+
+		bool   match   = sameForces ( expected, scene.forces () );
+		double frameNs = benchmark::measure ( 1, repetitions, [] () {}, step );
+
+		allMatch = match && allMatch;
+
+		std::printf
+		(
+			"%-10s %10zu %8zu %12.3f %14.3f %9.2fx %6s\n",
+			operation,
+			count,
+			threads,
+			frameNs / 1e6,
+			frameNs / static_cast <double> ( count ),
+			serialNs / frameNs,
+			match ? "yes" : "NO"
+		);
+	}
+
+	return allMatch;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Check exact gravity against the nested loop, then time each system at each particle count and thread count,
+//   in milliseconds per frame and nanoseconds per particle, with the speed-up over the run without a job system.
+//
+// Returns:
+//
+//   Exit code 0 if every thread count reproduced the forces and gravity matched the nested loop, 1 otherwise.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t gravitySizes []   = { 1000, 5000, 20000 };
+	const std::size_t repulsionSizes [] = { 10000, 100000, 1000000 };
+	const std::size_t hardware          = std::max ( 1u, std::thread::hardware_concurrency () );
+	const std::size_t maximum           = std::max ( hardware, std::size_t ( 4 ) );
+	const double      tolerance         = 1e-12;
+	bool              allMatch          = true;
+
+	// The accumulator sums in a different order from the nested loop, so the two agree to rounding only.
+
+	for ( std::size_t count : gravitySizes )
+	{
+		ForceScene scene ( count );
+
+		scene.clearForces     ();
+		scene.attractAllPairs ();
+
+		std::vector <engine::Vector2D> expected = scene.forces ();
+
+		scene.clearForces ();
+		scene.gravity->update ( scene.world, 1.0 / 60.0 );
+
+		double error = maximumRelativeError ( expected, scene.forces () );
+		bool   match = error <= tolerance;
+
+		allMatch = match && allMatch;
+
+		std::printf ( "gravity against nested loop, %6zu particles: max error %.2e %s\n", count, error, match ? "yes" : "NO" );
+	}
+
+	std::printf ( "\nhardware threads: %zu\n", hardware );
+	std::printf ( "%-10s %10s %8s %12s %14s %10s %6s\n", "system", "particles", "threads", "frame ms", "ns/particle", "speed-up", "match" );
+
+	for ( std::size_t count : gravitySizes )
+	{
+		allMatch = run ( "gravity", count, maximum, count >= 20000 ? 1 : 3, [] ( ForceScene& scene ) -> ecs::System& { return *scene.gravity; } ) && allMatch;
+	}
+
+	for ( std::size_t count : repulsionSizes )
+	{
+		allMatch = run ( "repulsion", count, maximum, count >= 1000000 ? 3 : 10, [] ( ForceScene& scene ) -> ecs::System& { return *scene.repulsion; } ) && allMatch;
+	}
+
+	for ( std::size_t count : gravitySizes )
+	{
+		allMatch = run ( "fused", count, maximum, count >= 20000 ? 1 : 3, [] ( ForceScene& scene ) -> ecs::System& { return *scene.pairForces; }, [] ( ForceScene& scene ) { scene.fuse ( true ); } ) && allMatch;
+	}
+
+	for ( std::size_t count : repulsionSizes )
+	{
+		allMatch = run ( "fused rep", count, maximum, count >= 1000000 ? 3 : 10, [] ( ForceScene& scene ) -> ecs::System& { return *scene.pairForces; }, [] ( ForceScene& scene ) { scene.fuse ( false ); } ) && allMatch;
+	}
+
+	return allMatch ? 0 : 1;
+}
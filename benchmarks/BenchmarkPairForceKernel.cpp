@@ -0,0 +1,263 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark comparing the vector all-pairs force kernels against the scalar kernel.
+//
+//   Randomly scattered particles with the demo's masses, radii, and force constants are packed once. The scalar
+//   double-precision kernel is the reference. Every instruction set the CPU supports is then run in double and in
+//   single precision, and its forces are compared with the reference relative to the largest reference force.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../engine/simd/PairForceKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+//*********************************************************************************************************************
+// Struct: Particles
+//
+// Description:
+//
+//   Packed particle arrays in one precision.
+//
+//*********************************************************************************************************************
+
+template <typename T>
+struct Particles
+{
+	std::vector <T> positionX;
+	std::vector <T> positionY;
+	std::vector <T> mass;
+	std::vector <T> radius;
+	std::vector <T> forceX;
+	std::vector <T> forceY;
+
+	engine::PairForceArrays <T> arrays ()
+	{
+		return { positionX.data (), positionY.data (), mass.data (), radius.data (), forceX.data (), forceY.data (), positionX.size () };
+	}
+
+	void clearForces ()
+	{
+		std::fill ( forceX.begin (), forceX.end (), T ( 0 ) );
+		std::fill ( forceY.begin (), forceY.end (), T ( 0 ) );
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: makeParticles
+//
+// Description:
+//
+//   Scatter particles over the demo's 16:9 world with the demo's four masses and radii, scaling the radii down as
+//   the count grows so the covered area stays constant. Odd counts leave a tail on every vector width.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+Particles <double> makeParticles ( std::size_t count )
+{
+	const double worldWidth = 1920.0 / 1080.0;
+	const double masses []  = { 8.0, 4.0, 2.0, 1.0 };
+	const double radii []   = { 0.032, 0.016, 0.008, 0.004 };
+	const double scale      = std::min ( std::sqrt ( 16.0 / static_cast <double> ( count ) ), 1.0 );
+
+	std::mt19937                            random ( 2011 );
+	std::uniform_real_distribution <double> unit   ( 0.0, 1.0 );
+
+	Particles <double> particles;
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		particles.positionX.push_back ( unit ( random ) * worldWidth );
+		particles.positionY.push_back ( unit ( random ) );
+		particles.mass.push_back      ( masses [ i % 4 ] );
+		particles.radius.push_back    ( radii  [ i % 4 ] * scale );
+	}
+
+	particles.forceX.assign ( count, 0.0 );
+	particles.forceY.assign ( count, 0.0 );
+
+	return particles;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: narrow
+//
+// Description:
+//
+//   Convert packed particles to single precision.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+Particles <float> narrow ( const Particles <double>& source )
+{
+	Particles <float> particles;
+
+	particles.positionX.assign ( source.positionX.begin (), source.positionX.end () );
+	particles.positionY.assign ( source.positionY.begin (), source.positionY.end () );
+	particles.mass.assign      ( source.mass.begin (),      source.mass.end ()      );
+	particles.radius.assign    ( source.radius.begin (),    source.radius.end ()    );
+	particles.forceX.assign    ( source.forceX.size (), 0.0f );
+	particles.forceY.assign    ( source.forceY.size (), 0.0f );
+
+	return particles;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: maximumRelativeError
+//
+// Description:
+//
+//   Return the largest force difference from the reference, relative to the largest reference force.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+double maximumRelativeError ( const Particles <double>& expected, const Particles <T>& actual )
+{
+	double largestForce = 0.0;
+	double largestError = 0.0;
+
+	for ( std::size_t i = 0; i < expected.forceX.size (); ++i )
+	{
+		double errorX = static_cast <double> ( actual.forceX [ i ] ) - expected.forceX [ i ];
+		double errorY = static_cast <double> ( actual.forceY [ i ] ) - expected.forceY [ i ];
+
+		largestForce = std::max ( largestForce, std::hypot ( expected.forceX [ i ], expected.forceY [ i ] ) );
+		largestError = std::max ( largestError, std::hypot ( errorX, errorY ) );
+	}
+
+	return largestForce > 0.0 ? largestError / largestForce : largestError;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: run
+//
+// Description:
+//
+//   Time one kernel over every pair, check its forces against the reference, and print its row.
+//
+// Returns:
+//
+//   True if the forces were within tolerance.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+bool run ( const char* precision, engine::InstructionSet instructionSet, Particles <T>& particles, const Particles <double>& reference, double scalarNs, double tolerance )
+{
+	engine::PairForceLaws <T> laws;
+
+	laws.gravitationalConstant = T ( 0.0001 );
+	laws.repulsiveConstant     = T ( 4.0 );
+	laws.softeningEpsilon      = T ( 0.009 );
+
+	std::size_t count = particles.positionX.size ();
+	std::size_t pairs = count * ( count - 1 ) / 2;
+	int         runs  = count >= 10000 ? 3 : 5;
+
+	double candidateNs = benchmark::measure
+	(
+		pairs, runs,
+		[ & ] () { particles.clearForces (); },
+		[ & ] () { engine::accumulatePairForces ( instructionSet, particles.arrays (), laws ); }
+	);
+
+	double error = maximumRelativeError ( reference, particles );
+	bool   match = error <= tolerance;
+
+	std::printf
+	(
+		"%-8s %-8s %10zu %14.3f %14.3f %9.2fx %12.2e %6s\n",
+		engine::instructionSetName ( instructionSet ),
+		precision,
+		count,
+		scalarNs,
+		candidateNs,
+		scalarNs / candidateNs,
+		error,
+		match ? "yes" : "NO"
+	);
+
+	return match;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run every supported kernel at each particle count and print one row per kernel, in nanoseconds per pair.
+//
+// Returns:
+//
+//   Exit code 0 if every kernel matched the scalar reference within tolerance, 1 otherwise.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t sizes []        = { 1001, 4999, 20001 };
+	const double      doubleTolerance = 1e-12;
+	const double      singleTolerance = 1e-4;
+	bool              allMatch        = true;
+
+	const engine::InstructionSet instructionSets [] =
+	{
+		engine::InstructionSet::Scalar,
+		engine::InstructionSet::SSE2,
+		engine::InstructionSet::AVX2,
+		engine::InstructionSet::AVX512
+	};
+
+	std::printf ( "detected instruction set: %s\n", engine::instructionSetName ( engine::detectInstructionSet () ) );
+	std::printf ( "%-8s %-8s %10s %14s %14s %10s %12s %6s\n", "kernel", "type", "particles", "scalar ns", "kernel ns", "speed-up", "max error", "match" );
+
+	for ( std::size_t count : sizes )
+	{
+		// The scalar double kernel is the reference for both forces and time.
+
+		Particles <double> reference = makeParticles ( count );
+
+		engine::PairForceLaws <double> laws;
+
+		laws.gravitationalConstant = 0.0001;
+		laws.repulsiveConstant     = 4.0;
+		laws.softeningEpsilon      = 0.009;
+
+		double scalarNs = benchmark::measure
+		(
+			count * ( count - 1 ) / 2, count >= 10000 ? 3 : 5,
+			[ & ] () { reference.clearForces (); },
+			[ & ] () { engine::accumulatePairForcesScalar ( reference.arrays (), laws ); }
+		);
+
+		for ( engine::InstructionSet instructionSet : instructionSets )
+		{
+			if ( engine::supportedInstructionSet ( instructionSet ) != instructionSet ) continue;
+
+			Particles <double> particlesDouble = reference;
+			Particles <float>  particlesSingle = narrow ( reference );
+
+			allMatch = run ( "double", instructionSet, particlesDouble, reference, scalarNs, doubleTolerance ) && allMatch;
+			allMatch = run ( "float",  instructionSet, particlesSingle, reference, scalarNs, singleTolerance ) && allMatch;
+		}
+	}
+
+	return allMatch ? 0 : 1;
+}
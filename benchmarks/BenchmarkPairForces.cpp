@@ -0,0 +1,266 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark comparing the fused SystemPairForces kernel against SystemGravity and SystemRepulsion run back to
+//   back.
+//
+//   One world holds all three systems. The baseline clears the force accumulators and runs the two separate
+//   systems; the candidate sets ComponentWorld::fusedForcesEnabled and runs the fused system. Both use the exact
+//   gravity solver. The fused kernel sums in a different order, so the forces are compared to within a relative
+//   error rather than bit for bit.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+#include "../demo/particle_demo/systems/SystemGravity.h"
+#include "../demo/particle_demo/systems/SystemRepulsion.h"
+#include "../demo/particle_demo/systems/SystemPairForces.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+//*********************************************************************************************************************
+// Class: ForceScene
+//
+// Description:
+//
+//   A world holding randomly scattered particles with the demo's force constants, the two separate force systems,
+//   the fused force system, and the shared neighbour list.
+//
+//*********************************************************************************************************************
+
+class ForceScene
+{
+public:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	ecs::World                         world;
+	std::shared_ptr <SystemGravity>    gravity;
+	std::shared_ptr <SystemRepulsion>  repulsion;
+	std::shared_ptr <SystemPairForces> pairForces;
+	std::vector <ecs::Entity>          particles;
+	ecs::Entity                        worldEntity = ecs::NULL_ENTITY;
+
+	//=================================================================================================================
+	// Constructors
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Constructor: ForceScene
+	//
+	// Description:
+	//
+	//   Scatter particles over the demo's 16:9 world with the demo's four masses and radii, scaling the radii and
+	//   the skin down as the count grows so the covered area stays constant.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	explicit ForceScene ( std::size_t count )
+		: world ( count + 1 )
+	{
+		const double worldWidth = 1920.0 / 1080.0;
+		const double masses []  = { 8.0, 4.0, 2.0, 1.0 };
+		const double radii []   = { 0.032, 0.016, 0.008, 0.004 };
+		const double scale      = std::min ( std::sqrt ( 16.0 / static_cast <double> ( count ) ), 1.0 );
+
+		world.registerComponent <ComponentTransform>     ();
+		world.registerComponent <ComponentPhysics>       ();
+		world.registerComponent <ComponentCircle>        ();
+		world.registerComponent <ComponentWorld>         ();
+		world.registerComponent <ComponentNeighbourList> ();
+
+		auto signature = world.makeSignature <ComponentTransform, ComponentPhysics, ComponentCircle> ();
+
+		gravity    = world.registerSystem <SystemGravity>    ( "Gravity",    signature );
+		repulsion  = world.registerSystem <SystemRepulsion>  ( "Repulsion",  signature );
+		pairForces = world.registerSystem <SystemPairForces> ( "PairForces", signature );
+
+		ComponentWorld         componentWorld;
+		ComponentNeighbourList neighbourList;
+
+		componentWorld.gravitationalConstant = 0.0001;
+		componentWorld.repulsiveConstant     = 4.0;
+		neighbourList.pairs.setSkin ( 0.01 * scale );
+
+		worldEntity = world.createEntity ();
+		world.addComponent ( worldEntity, componentWorld );
+		world.addComponent ( worldEntity, neighbourList );
+
+		gravity->worldEntity    = worldEntity;
+		repulsion->worldEntity  = worldEntity;
+		pairForces->worldEntity = worldEntity;
+
+		std::mt19937                            random ( 2011 );
+		std::uniform_real_distribution <double> unit   ( 0.0, 1.0 );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			ComponentTransform transform;
+			ComponentPhysics   physics;
+			ComponentCircle    circle;
+
+			transform.translation = { unit ( random ) * worldWidth, unit ( random ) };
+			physics.mass          = masses [ i % 4 ];
+			circle.radius         = radii  [ i % 4 ] * scale;
+
+			ecs::Entity entity = world.createEntity ();
+			world.addComponent ( entity, transform );
+			world.addComponent ( entity, physics );
+			world.addComponent ( entity, circle );
+			particles.push_back ( entity );
+		}
+	}
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: select
+	//
+	// Description:
+	//
+	//   Zero every particle's force accumulator and choose between the separate and fused force systems.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void select ( bool fused )
+	{
+		world.getComponent <ComponentWorld> ( worldEntity ).fusedForcesEnabled = fused;
+
+		for ( ecs::Entity entity : particles ) world.getComponent <ComponentPhysics> ( entity ).forceAccumulator = { 0.0, 0.0 };
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: step
+	//
+	// Description:
+	//
+	//   Run the force systems for one frame. The systems not selected return at once.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void step ()
+	{
+		gravity->update    ( world, 1.0 / 60.0 );
+		repulsion->update  ( world, 1.0 / 60.0 );
+		pairForces->update ( world, 1.0 / 60.0 );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: forces
+	//
+	// Description:
+	//
+	//   Return a copy of every particle's accumulated force.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::vector <engine::Vector2D> forces ()
+	{
+		std::vector <engine::Vector2D> result;
+
+		for ( ecs::Entity entity : particles ) result.push_back ( world.getComponent <ComponentPhysics> ( entity ).forceAccumulator );
+
+		return result;
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: maximumRelativeError
+//
+// Description:
+//
+//   Return the largest force difference between two runs, relative to the largest force in the reference run.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+double maximumRelativeError ( const std::vector <engine::Vector2D>& expected, const std::vector <engine::Vector2D>& actual )
+{
+	double largestForce = 0.0;
+	double largestError = 0.0;
+
+	for ( std::size_t i = 0; i < expected.size (); ++i )
+	{
+		largestForce = std::max ( largestForce, std::hypot ( expected [ i ].x, expected [ i ].y ) );
+		largestError = std::max ( largestError, std::hypot ( actual [ i ].x - expected [ i ].x, actual [ i ].y - expected [ i ].y ) );
+	}
+
+	return largestForce > 0.0 ? largestError / largestForce : largestError;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run the comparison at each particle count and print one row per count, in nanoseconds per particle per frame.
+//
+// Returns:
+//
+//   Exit code 0 if the fused forces matched the separate forces at every count, 1 otherwise.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t sizes []  = { 1000, 2000, 5000, 10000, 20000 };
+	const double      tolerance = 1e-9;
+	bool              allMatch  = true;
+
+	std::printf ( "%-24s %10s %14s %14s %10s %12s\n", "operation", "particles", "separate ns", "fused ns", "speed-up", "max error" );
+
+	for ( std::size_t count : sizes )
+	{
+		ForceScene scene ( count );
+
+		// Check one frame of each path against the other.
+
+		scene.select ( false );
+		scene.step   ();
+
+		std::vector <engine::Vector2D> expected = scene.forces ();
+
+		scene.select ( true );
+		scene.step   ();
+
+		double error = maximumRelativeError ( expected, scene.forces () );
+		allMatch     = allMatch && error <= tolerance;
+
+		int repetitions = count >= 10000 ? 3 : 5;
+
+		double separate = benchmark::measure ( count, repetitions, [ & ] () { scene.select ( false ); }, [ & ] () { scene.step (); } );
+		double fused    = benchmark::measure ( count, repetitions, [ & ] () { scene.select ( true );  }, [ & ] () { scene.step (); } );
+
+		std::printf
+		(
+			"%-24s %10zu %14.2f %14.2f %9.2fx %12.2e\n",
+			"force frame",
+			count,
+			separate,
+			fused,
+			separate / fused,
+			error
+		);
+	}
+
+	return allMatch ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark measuring how the per-particle systems scale with the number of job system threads.
+//
+//   One frame runs SystemForceAccumulator, SystemPhysics, and the wall phase of SystemCollider over randomly
+//   scattered particles. The collider runs with the brute-force path and no collision iterations, so it resolves
+//   walls only. Each thread count runs the same frames from the same starting state, and the final positions and
+//   velocities must match the single-threaded run bit for bit.
+//
+//   Thread counts run in powers of two up to the hardware thread count, and at least up to four so the table
+//   always shows the scheduler's overhead. Rows beyond the hardware thread count are oversubscribed and cannot
+//   speed up.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+#include "../engine/JobSystem.h"
+#include "../demo/particle_demo/systems/SystemForceAccumulator.h"
+#include "../demo/particle_demo/systems/SystemPhysics.h"
+#include "../demo/particle_demo/systems/SystemCollider.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+//*********************************************************************************************************************
+// Class: ParticleScene
+//
+// Description:
+//
+//   A world holding randomly moving particles with the demo's masses, radii, and friction, and the three
+//   per-particle systems.
+//
+//*********************************************************************************************************************
+
+class ParticleScene
+{
+public:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	ecs::World                               world;
+	std::shared_ptr <SystemForceAccumulator> forceAccumulator;
+	std::shared_ptr <SystemPhysics>          physics;
+	std::shared_ptr <SystemCollider>         collider;
+	std::vector <ecs::Entity>                particles;
+	ecs::Entity                              worldEntity = ecs::NULL_ENTITY;
+
+	//=================================================================================================================
+	// Constructors
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Constructor: ParticleScene
+	//
+	// Description:
+	//
+	//   Scatter particles over the demo's 16:9 world with random velocities and an initial force, so every frame
+	//   moves every particle and some of them hit the walls.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	explicit ParticleScene ( std::size_t count )
+		: world ( count + 1 )
+	{
+		const double worldWidth = 1920.0 / 1080.0;
+		const double masses []  = { 8.0, 4.0, 2.0, 1.0 };
+		const double radii []   = { 0.032, 0.016, 0.008, 0.004 };
+
+		world.registerComponent       <ComponentTransform>   ();
+		world.registerComponent       <ComponentPhysics>     ();
+		world.registerComponent       <ComponentCircle>      ();
+		world.registerComponent       <ComponentTrail>       ();
+		world.registerComponent       <ComponentUserControl> ();
+		world.registerComponent       <ComponentWorld>       ();
+		world.registerSharedComponent <ComponentTrailStyle>  ();
+
+		auto signature = world.makeSignature <ComponentTransform, ComponentPhysics, ComponentCircle, ComponentTrail, ecs::Shared <ComponentTrailStyle>> ();
+
+		forceAccumulator = world.registerSystem <SystemForceAccumulator> ( "ForceAccumulator", signature );
+		physics          = world.registerSystem <SystemPhysics>          ( "Physics",          signature );
+		collider         = world.registerSystem <SystemCollider>         ( "Collider",         signature );
+
+		worldEntity = world.createEntity ();
+		world.addComponent ( worldEntity, ComponentWorld {} );
+
+		forceAccumulator->worldEntity = worldEntity;
+		physics->worldEntity          = worldEntity;
+		collider->worldEntity         = worldEntity;
+		collider->bruteForce          = true;
+		collider->collisionIterations = 0;
+
+		ComponentTrailStyle trailStyle;
+
+		trailStyle.depth = 16;
+
+		auto sharedTrailStyle = world.createShared ( trailStyle );
+
+		std::mt19937                            random ( 2011 );
+		std::uniform_real_distribution <double> unit   ( 0.0, 1.0 );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			ComponentTransform transform;
+			ComponentPhysics   physicsComponent;
+			ComponentCircle    circle;
+
+			transform.translation             = { unit ( random ) * worldWidth, unit ( random ) };
+			physicsComponent.mass             = masses [ i % 4 ];
+			physicsComponent.velocity         = { unit ( random ) - 0.5, unit ( random ) - 0.5 };
+			physicsComponent.forceAccumulator = { 0.0, 0.1 };
+			circle.radius                     = radii [ i % 4 ];
+
+			ecs::Entity entity = world.createEntity ();
+			world.addComponent ( entity, transform );
+			world.addComponent ( entity, physicsComponent );
+			world.addComponent ( entity, circle );
+			world.addComponent ( entity, ComponentTrail {} );
+			world.addComponent ( entity, sharedTrailStyle );
+			particles.push_back ( entity );
+		}
+	}
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: useJobs
+	//
+	// Description:
+	//
+	//   Run the systems on a job system, or on the calling thread if jobs is null.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void useJobs ( engine::JobSystem* jobs )
+	{
+		forceAccumulator->jobs = jobs;
+		physics->jobs          = jobs;
+		collider->jobs         = jobs;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: step
+	//
+	// Description:
+	//
+	//   Run the three systems for one frame.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void step ()
+	{
+		forceAccumulator->update ( world, 1.0 / 60.0 );
+		physics->update          ( world, 1.0 / 60.0 );
+		collider->update         ( world, 1.0 / 60.0 );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: state
+	//
+	// Description:
+	//
+	//   Return every particle's position and velocity, two vectors per particle.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::vector <engine::Vector2D> state ()
+	{
+		std::vector <engine::Vector2D> result;
+
+		for ( ecs::Entity entity : particles )
+		{
+			result.push_back ( world.getComponent <ComponentTransform> ( entity ).translation );
+			result.push_back ( world.getComponent <ComponentPhysics>   ( entity ).velocity );
+		}
+
+		return result;
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: sameState
+//
+// Description:
+//
+//   Return true if two states are identical bit for bit.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+bool sameState ( const std::vector <engine::Vector2D>& expected, const std::vector <engine::Vector2D>& actual )
+{
+	if ( expected.size () != actual.size () ) return false;
+
+	for ( std::size_t i = 0; i < expected.size (); ++i )
+	{
+		if ( expected [ i ].x != actual [ i ].x || expected [ i ].y != actual [ i ].y ) return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Time a frame at each particle count and thread count and print one row per pair, in milliseconds per frame
+//   and nanoseconds per particle, with the speed-up over the single-threaded run.
+//
+// Returns:
+//
+//   Exit code 0 if every thread count reproduced the single-threaded state, 1 otherwise.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t sizes [] = { 10000, 100000, 1000000 };
+	const std::size_t hardware = std::max ( 1u, std::thread::hardware_concurrency () );
+	const std::size_t maximum  = std::max ( hardware, std::size_t ( 4 ) );
+	const int         frames   = 5;
+	bool              allMatch = true;
+
+	std::printf ( "hardware threads: %zu\n", hardware );
+	std::printf ( "%10s %8s %12s %14s %10s %6s\n", "particles", "threads", "frame ms", "ns/particle", "speed-up", "match" );
+
+	for ( std::size_t count : sizes )
+	{
+		// The serial run, without a job system, is the reference for both state and time.
+
+		ParticleScene reference ( count );
+
+		for ( int frame = 0; frame < frames; ++frame ) reference.step ();
+
+		std::vector <engine::Vector2D> expected = reference.state ();
+		double                         serialNs = 0.0;
+
+		for ( std::size_t threads = 1; threads <= maximum; threads *= 2 )
+		{
+			ParticleScene     scene ( count );
+			engine::JobSystem jobs  ( threads );
+
+			scene.useJobs ( &jobs );
+
+			// Run the reference's frames and compare, then time further frames and keep the best.
+
+			for ( int frame = 0; frame < frames; ++frame ) scene.step ();
+
+			bool match = sameState ( expected, scene.state () );
+
+			double frameNs = benchmark::measure ( 1, count >= 1000000 ? 5 : 20, [] () {}, [ & ] () { scene.step (); } );
+
+			if ( threads == 1 ) serialNs = frameNs;
+
+			allMatch = match && allMatch;
+
+			std::printf
+			(
+				"%10zu %8zu %12.3f %14.3f %9.2fx %6s\n",
+				count,
+				threads,
+				frameNs / 1e6,
+				frameNs / static_cast <double> ( count ),
+				serialNs / frameNs,
+				match ? "yes" : "NO"
+			);
+		}
+	}
+
+	return allMatch ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark comparing the SystemCollider neighbour list broad phase against its all-pairs reference path.
+//
+//   Particles are scattered at random and settled with a few collider frames. Two worlds are then filled with the
+//   same particles, one collider per world with bruteForce set on the baseline. Each measured run restores the
+//   initial state, invalidates the neighbour list so the frame includes a rebuild, and steps one collider frame.
+//   The final states of the two worlds are then compared bit for bit.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+#include "../demo/particle_demo/systems/SystemCollider.h"
+#include "../demo/particle_demo/components/ComponentNeighbourList.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+//*********************************************************************************************************************
+// Struct: Particle
+//
+// Description:
+//
+//   Initial state of one particle, shared by both worlds.
+//
+//*********************************************************************************************************************
+
+struct Particle
+{
+	ComponentTransform transform;
+	ComponentPhysics   physics;
+	ComponentCircle    circle;
+};
+
+//*********************************************************************************************************************
+// Struct: Scene
+//
+// Description:
+//
+//   One world holding the particles and a collider system.
+//
+//*********************************************************************************************************************
+
+struct Scene
+{
+	std::unique_ptr <ecs::World>     world;
+	std::shared_ptr <SystemCollider> collider;
+	std::vector <ecs::Entity>        particles;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: makeParticles
+//
+// Description:
+//
+//   Scatter particles over the demo's 16:9 world with the demo's four radii scaled so the covered area fraction stays
+//   constant as the count grows.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+std::vector <Particle> makeParticles ( std::size_t count )
+{
+	const double worldWidth = 1920.0 / 1080.0;
+	const double radii []   = { 0.032, 0.016, 0.008, 0.004 };
+	const double masses []  = { 8.0, 4.0, 2.0, 1.0 };
+	const double scale      = std::sqrt ( 16.0 / static_cast <double> ( count ) );
+
+	std::mt19937                            random    ( 2011 );
+	std::uniform_real_distribution <double> unit      ( 0.0, 1.0 );
+	std::vector <Particle>                  particles ( count );
+
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		Particle& particle = particles [ i ];
+
+		particle.transform.translation = { unit ( random ) * worldWidth, unit ( random ) };
+		particle.physics.velocity      = { unit ( random ) - 0.5, unit ( random ) - 0.5 };
+		particle.physics.mass          = masses [ i % 4 ];
+		particle.circle.radius         = radii [ i % 4 ] * std::min ( scale, 1.0 );
+	}
+
+	return particles;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: makeScene
+//
+// Description:
+//
+//   Build a world holding the particles and a collider, with a world entity to drive it.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+Scene makeScene ( const std::vector <Particle>& initial, bool bruteForce )
+{
+	Scene scene;
+
+	scene.world = std::make_unique <ecs::World> ( initial.size () + 1 );
+
+	ecs::World& world = *scene.world;
+
+	world.registerComponent <ComponentTransform>     ();
+	world.registerComponent <ComponentPhysics>       ();
+	world.registerComponent <ComponentCircle>        ();
+	world.registerComponent <ComponentWorld>         ();
+	world.registerComponent <ComponentNeighbourList> ();
+
+	scene.collider = world.registerSystem <SystemCollider> ( "Collider", world.makeSignature <ComponentTransform, ComponentPhysics, ComponentCircle> () );
+
+	// Scale the demo's skin with the radii.
+
+	ComponentNeighbourList neighbourList;
+
+	neighbourList.pairs.setSkin ( 0.01 * std::min ( std::sqrt ( 16.0 / static_cast <double> ( initial.size () ) ), 1.0 ) );
+
+	ecs::Entity worldEntity = world.createEntity ();
+	world.addComponent ( worldEntity, ComponentWorld {} );
+	world.addComponent ( worldEntity, neighbourList );
+
+	scene.collider->worldEntity = worldEntity;
+	scene.collider->bruteForce  = bruteForce;
+
+	for ( const Particle& particle : initial )
+	{
+		ecs::Entity entity = world.createEntity ();
+		world.addComponent ( entity, particle.transform );
+		world.addComponent ( entity, particle.physics );
+		world.addComponent ( entity, particle.circle );
+		scene.particles.push_back ( entity );
+	}
+
+	return scene;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: settle
+//
+// Description:
+//
+//   Run a few collider frames over freshly scattered particles and keep the result, so the measured frames start
+//   from the small overlaps of a running simulation rather than the deep overlaps of random placement.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void settle ( std::vector <Particle>& initial )
+{
+	Scene scene = makeScene ( initial, false );
+
+	for ( int frame = 0; frame < 10; ++frame ) scene.collider->update ( *scene.world, 1.0 / 60.0 );
+
+	for ( std::size_t i = 0; i < initial.size (); ++i )
+	{
+		initial [ i ].transform = scene.world->getComponent <ComponentTransform> ( scene.particles [ i ] );
+		initial [ i ].physics   = scene.world->getComponent <ComponentPhysics>   ( scene.particles [ i ] );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: reset
+//
+// Description:
+//
+//   Restore every particle's transform and physics to its initial state, and invalidate the neighbour list.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void reset ( Scene& scene, const std::vector <Particle>& initial )
+{
+	for ( std::size_t i = 0; i < initial.size (); ++i )
+	{
+		scene.world->getComponent <ComponentTransform> ( scene.particles [ i ] ) = initial [ i ].transform;
+		scene.world->getComponent <ComponentPhysics>   ( scene.particles [ i ] ) = initial [ i ].physics;
+	}
+
+	scene.world->getComponent <ComponentNeighbourList> ( scene.collider->worldEntity ).pairs.invalidate ();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: identical
+//
+// Description:
+//
+//   Check that two scenes hold bitwise identical positions and velocities.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+bool identical ( Scene& a, Scene& b )
+{
+	for ( std::size_t i = 0; i < a.particles.size (); ++i )
+	{
+		auto& transformA = a.world->getComponent <ComponentTransform> ( a.particles [ i ] );
+		auto& transformB = b.world->getComponent <ComponentTransform> ( b.particles [ i ] );
+		auto& physicsA   = a.world->getComponent <ComponentPhysics>   ( a.particles [ i ] );
+		auto& physicsB   = b.world->getComponent <ComponentPhysics>   ( b.particles [ i ] );
+
+		if ( std::memcmp ( &transformA.translation, &transformB.translation, sizeof ( transformA.translation ) ) != 0 ) return false;
+		if ( std::memcmp ( &physicsA.velocity,      &physicsB.velocity,      sizeof ( physicsA.velocity ) )      != 0 ) return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run the comparison at each particle count and print one row per count, in nanoseconds per particle per frame.
+//
+// Returns:
+//
+//   Exit code 0 if every neighbour list frame matched the all-pairs frame, 1 otherwise.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t sizes [] = { 100, 1000, 10000, 100000 };
+	bool              allMatch = true;
+
+	std::printf ( "%-24s %10s %14s %14s %10s %10s\n", "operation", "particles", "all-pairs ns", "neighbour ns", "speed-up", "identical" );
+
+	for ( std::size_t count : sizes )
+	{
+		// The all-pairs frame at the largest count takes seconds, so it is timed once.
+
+		int repetitions = count >= 100000 ? 1 : 5;
+
+		std::vector <Particle> initial = makeParticles ( count );
+
+		settle ( initial );
+
+		Scene bruteForce = makeScene ( initial, true );
+		Scene neighbours = makeScene ( initial, false );
+
+		double allPairs = benchmark::measure
+		(
+			count, repetitions,
+			[ & ] () { reset ( bruteForce, initial ); },
+			[ & ] () { bruteForce.collider->update ( *bruteForce.world, 1.0 / 60.0 ); }
+		);
+
+		double listed = benchmark::measure
+		(
+			count, repetitions,
+			[ & ] () { reset ( neighbours, initial ); },
+			[ & ] () { neighbours.collider->update ( *neighbours.world, 1.0 / 60.0 ); }
+		);
+
+		bool match = identical ( bruteForce, neighbours );
+		allMatch   = allMatch && match;
+
+		std::printf
+		(
+			"%-24s %10zu %14.2f %14.2f %9.2fx %10s\n",
+			"collider frame",
+			count,
+			allPairs,
+			listed,
+			allPairs / listed,
+			match ? "yes" : "NO"
+		);
+	}
+
+	return allMatch ? 0 : 1;
+}
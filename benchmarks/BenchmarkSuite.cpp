@@ -0,0 +1,377 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Regression benchmark suite for the ECS core and the particle simulation systems, built as ecs_benchmarks.
+//
+//   The ECS cases time entity creation and destruction, adding and removing a component, getComponent in creation
+//   order and in random order, and a system's iteration over its entity set, at 1,000 to 100,000 entities.
+//
+//   The particle cases build the particle simulation's world headlessly from resources/settings.properties next to
+//   the executable, with yellow particles only, a fixed seed, and the systems on the calling thread. Each times one
+//   system's update at 250 to 4,000 particles after a warm-up step, and Particle/Step times a whole step. Gravity and
+//   Repulsion are timed with the separate force kernel, PairForces and Step with the fused kernel.
+//
+//   Run with --benchmark_format=json or --benchmark_out=<path> for results in Google Benchmark's JSON schema, which
+//   its compare.py can diff between two builds.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+#include "BenchmarkSuite.h"
+
+#include "../ecs/World.h"
+#include "../engine/ApplicationSettings.h"
+#include "../demo/particle_demo/engines/ParticleSimulation.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Global: settingsPath
+//
+// Description:
+//
+//   The settings file the particle cases build their world from, set by main.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+std::string settingsPath;
+
+//*********************************************************************************************************************
+// Structs: SuitePosition, SuiteVelocity
+//
+// Description:
+//
+//   Small components for the ECS core cases.
+//
+//*********************************************************************************************************************
+
+struct SuitePosition
+{
+	double x = 0.0, y = 0.0;
+};
+
+struct SuiteVelocity
+{
+	double x = 0.001, y = 0.002;
+};
+
+//*********************************************************************************************************************
+// Class: SuiteMotion
+//
+// Description:
+//
+//   System that moves each of its entities by its velocity, reading both components through getComponent.
+//
+//*********************************************************************************************************************
+
+class SuiteMotion : public ecs::System
+{
+public:
+
+	void update ( ecs::World& world, double dt ) override
+	{
+		for ( ecs::Entity entity : entities.span () )
+		{
+			auto&       position = world.getComponent <SuitePosition> ( entity );
+			const auto& velocity = world.getComponent <SuiteVelocity> ( entity );
+
+			position.x += velocity.x * dt;
+			position.y += velocity.y * dt;
+		}
+	}
+};
+
+//*********************************************************************************************************************
+// Class: ParticleFixture
+//
+// Description:
+//
+//   A particle simulation world of yellow particles, built from the settings file with a fixed seed and advanced
+//   by one full step so the neighbour list and forces are in their steady state.
+//
+//*********************************************************************************************************************
+
+class ParticleFixture
+{
+public:
+
+	ecs::World                  world;
+	engine::ApplicationSettings settings;
+	ParticleSimulation          simulation;
+	double                      step;
+
+	ParticleFixture ( std::int64_t count, const char* kernel )
+		: settings   ( loadSettings ( kernel ) )
+		, simulation ( world, settings )
+	{
+		step = 1.0 / settings.getDouble ( "Engine.Step.Rate" );
+
+		simulation.registerSystems ();
+		simulation.createWorld ( { 0, 0, 0, static_cast <int> ( count ) } );
+		simulation.configureSystems ( nullptr );
+
+		world.updateSystems ( step );
+	}
+
+private:
+
+	static engine::ApplicationSettings loadSettings ( const char* kernel )
+	{
+		engine::ApplicationSettings settings ( settingsPath );
+
+		settings.set ( "Initial.Seed",            "1" );
+		settings.set ( "Physics.Gravity.Solver",  "Exact" );
+		settings.set ( "Physics.Forces.Kernel",   kernel );
+		settings.set ( "ECS.Profiler.Enabled",    "false" );
+		settings.set ( "ECS.Profiler.Trace.Path", "" );
+
+		return settings;
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: makeWorld
+//
+// Description:
+//
+//   Return a world with the core case components and SuiteMotion registered, and optionally the given number of
+//   entities holding both components.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+std::unique_ptr <ecs::World> makeWorld ( std::int64_t count, bool populate, std::vector <ecs::Entity>* entities = nullptr )
+{
+	auto world = std::make_unique <ecs::World> ( static_cast <std::size_t> ( count ) );
+
+	world->registerComponent <SuitePosition> ();
+	world->registerComponent <SuiteVelocity> ();
+	world->registerSystem    <SuiteMotion>   ( "Motion", world->makeSignature <SuitePosition, SuiteVelocity> () );
+
+	if ( populate )
+	{
+		std::vector <ecs::Entity> created = world->createEntities ( static_cast <std::size_t> ( count ), SuitePosition {}, SuiteVelocity {} );
+
+		if ( entities ) *entities = std::move ( created );
+	}
+
+	return world;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Functions: ECS core cases
+//
+// Description:
+//
+//   Each case works on State::getArgument entities and reports one item per entity touched.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void entityCreate ( benchmark::State& state )
+{
+	auto                      world = makeWorld ( state.getArgument (), false );
+	std::vector <ecs::Entity> entities ( static_cast <std::size_t> ( state.getArgument () ) );
+
+	for ( [[maybe_unused]] auto _ : state )
+	{
+		for ( auto& entity : entities ) entity = world->createEntity ();
+
+		state.pauseTiming ();
+		for ( auto entity : entities ) world->destroyEntity ( entity );
+		state.resumeTiming ();
+	}
+
+	state.setItemsProcessed ( state.getIterations () * entities.size () );
+}
+
+void entityDestroy ( benchmark::State& state )
+{
+	auto                      world = makeWorld ( state.getArgument (), false );
+	std::vector <ecs::Entity> entities ( static_cast <std::size_t> ( state.getArgument () ) );
+
+	for ( [[maybe_unused]] auto _ : state )
+	{
+		state.pauseTiming ();
+		for ( auto& entity : entities ) entity = world->createEntity ();
+		state.resumeTiming ();
+
+		for ( auto entity : entities ) world->destroyEntity ( entity );
+	}
+
+	state.setItemsProcessed ( state.getIterations () * entities.size () );
+}
+
+void componentAdd ( benchmark::State& state )
+{
+	auto                      world    = makeWorld ( state.getArgument (), false );
+	std::vector <ecs::Entity> entities = world->createEntities ( static_cast <std::size_t> ( state.getArgument () ), SuitePosition {} );
+
+	for ( [[maybe_unused]] auto _ : state )
+	{
+		for ( auto entity : entities ) world->addComponent ( entity, SuiteVelocity {} );
+
+		state.pauseTiming ();
+		for ( auto entity : entities ) world->removeComponent <SuiteVelocity> ( entity );
+		state.resumeTiming ();
+	}
+
+	state.setItemsProcessed ( state.getIterations () * entities.size () );
+}
+
+void componentRemove ( benchmark::State& state )
+{
+	std::vector <ecs::Entity> entities;
+	auto                      world = makeWorld ( state.getArgument (), true, &entities );
+
+	for ( [[maybe_unused]] auto _ : state )
+	{
+		for ( auto entity : entities ) world->removeComponent <SuiteVelocity> ( entity );
+
+		state.pauseTiming ();
+		for ( auto entity : entities ) world->addComponent ( entity, SuiteVelocity {} );
+		state.resumeTiming ();
+	}
+
+	state.setItemsProcessed ( state.getIterations () * entities.size () );
+}
+
+void componentGet ( benchmark::State& state, bool shuffle )
+{
+	std::vector <ecs::Entity> entities;
+	auto                      world = makeWorld ( state.getArgument (), true, &entities );
+
+	if ( shuffle ) std::shuffle ( entities.begin (), entities.end (), std::mt19937 ( 1 ) );
+
+	for ( [[maybe_unused]] auto _ : state )
+	{
+		double sum = 0.0;
+
+		for ( auto entity : entities ) sum += world->getComponent <SuitePosition> ( entity ).x;
+
+		benchmark::doNotOptimize ( sum );
+	}
+
+	state.setItemsProcessed ( state.getIterations () * entities.size () );
+}
+
+void systemIterate ( benchmark::State& state )
+{
+	auto world = makeWorld ( state.getArgument (), true );
+
+	for ( [[maybe_unused]] auto _ : state )
+	{
+		world->updateSystems ( 1.0 / 60.0 );
+	}
+
+	state.setItemsProcessed ( state.getIterations () * static_cast <std::size_t> ( state.getArgument () ) );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: particleSystem
+//
+// Description:
+//
+//   Time one particle system's update, or a whole step if system is null, reporting one item per particle.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void particleSystem ( benchmark::State& state, const char* kernel, ecs::System* ( *select ) ( ParticleSimulation& ) )
+{
+	ParticleFixture fixture ( state.getArgument (), kernel );
+
+	ecs::System* target = select ? select ( fixture.simulation ) : nullptr;
+
+	for ( [[maybe_unused]] auto _ : state )
+	{
+		if ( target ) target->update ( fixture.world, fixture.step );
+		else          fixture.world.updateSystems ( fixture.step );
+	}
+
+	state.setItemsProcessed ( state.getIterations () * fixture.simulation.particleEntities.size () );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Register the cases and run the ones the command line selects.
+//
+// Arguments:
+//
+//   argc (int):
+//     The number of command-line arguments.
+//
+//   argv[] (char*):
+//     Array of command-line argument strings.
+//
+// Returns:
+//
+//   Exit code 0, or 1 if the command line is invalid or a case fails.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ( int argc, char* argv [] )
+{
+	settingsPath = ( std::filesystem::weakly_canonical ( std::filesystem::path ( argv [ 0 ] ) ).parent_path () / "resources" / "settings.properties" ).string ();
+
+	const std::vector <std::int64_t> entityCounts   = { 1000, 10000, 100000 };
+	const std::vector <std::int64_t> particleCounts = { 250, 1000, 4000 };
+
+	benchmark::Suite suite;
+
+	suite.add ( "Entity/Create",           entityCreate,                                                       entityCounts );
+	suite.add ( "Entity/Destroy",          entityDestroy,                                                      entityCounts );
+	suite.add ( "Component/Add",           componentAdd,                                                       entityCounts );
+	suite.add ( "Component/Remove",        componentRemove,                                                    entityCounts );
+	suite.add ( "Component/GetSequential", [] ( benchmark::State& state ) { componentGet ( state, false ); }, entityCounts );
+	suite.add ( "Component/GetRandom",     [] ( benchmark::State& state ) { componentGet ( state, true ); },  entityCounts );
+	suite.add ( "System/Iterate",          systemIterate,                                                      entityCounts );
+
+	struct ParticleCase
+	{
+		const char*  name;
+		const char*  kernel;
+		ecs::System* ( *select ) ( ParticleSimulation& );
+	};
+
+	const ParticleCase particleCases [] =
+	{
+		{ "Particle/Gravity",    "Separate", [] ( ParticleSimulation& s ) -> ecs::System* { return s.systemGravity.get (); } },
+		{ "Particle/Repulsion",  "Separate", [] ( ParticleSimulation& s ) -> ecs::System* { return s.systemRepulsion.get (); } },
+		{ "Particle/PairForces", "Fused",    [] ( ParticleSimulation& s ) -> ecs::System* { return s.systemPairForces.get (); } },
+		{ "Particle/Physics",    "Fused",    [] ( ParticleSimulation& s ) -> ecs::System* { return s.systemPhysics.get (); } },
+		{ "Particle/Collider",   "Fused",    [] ( ParticleSimulation& s ) -> ecs::System* { return s.systemCollider.get (); } },
+		{ "Particle/Step",       "Fused",    nullptr }
+	};
+
+	for ( const ParticleCase& c : particleCases )
+	{
+		suite.add ( c.name, [ c ] ( benchmark::State& state ) { particleSystem ( state, c.kernel, c.select ); }, particleCounts );
+	}
+
+	try
+	{
+		return suite.run ( argc, argv );
+	}
+	catch ( const std::exception& e )
+	{
+		std::fprintf ( stderr, "Fatal error: %s\n", e.what () );
+		return 1;
+	}
+}
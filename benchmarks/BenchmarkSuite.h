@@ -0,0 +1,647 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines a small registered-case benchmark runner in the style of Google Benchmark, without the dependency.
+//
+//   A case is a function taking a State and looping "for ( [[maybe_unused]] auto _ : state )" over the measured
+//   work. The runner calibrates the iteration count until a run lasts the minimum time, repeats it, and reports the
+//   time per iteration on the console or as JSON in Google Benchmark's schema, so results from two builds can be
+//   diffed with the usual tools.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <ostream>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: benchmark
+//
+// Description:
+//
+//   Timing utilities used by the benchmark programs under benchmarks/.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace benchmark
+{
+	//*****************************************************************************************************************
+	// Class: State
+	//
+	// Description:
+	//
+	//   The measured loop of one run of a case.
+	//
+	//   Iterating the state runs the loop body a set number of times. The clock starts when the loop begins and stops
+	//   when it ends, and work between pauseTiming and resumeTiming is left out, so per-iteration setup can sit inside
+	//   the loop.
+	//
+	//*****************************************************************************************************************
+
+	class State
+	{
+	public:
+
+		using Clock = std::chrono::steady_clock;
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Struct: Iterator
+		//
+		// Description:
+		//
+		//   Counts the remaining iterations down to zero, and stops the state's clock when the count is reached.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		struct Iterator
+		{
+			State*      state;
+			std::size_t remaining;
+
+			bool operator != ( const Iterator& ) const
+			{
+				if ( remaining != 0 ) return true;
+
+				state->pauseTiming ();
+				return false;
+			}
+
+			void operator ++ ()       { --remaining; }
+			int  operator *  () const { return 0; }
+		};
+
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::size_t       iterations;
+		std::int64_t      argument;
+		std::size_t       itemsProcessed = 0;
+		double            realSeconds    = 0.0;
+		double            cpuSeconds     = 0.0;
+		bool              running        = false;
+		Clock::time_point realStart;
+		std::clock_t      cpuStart       = 0;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		std::size_t  getIterations     () const { return iterations; }
+		std::int64_t getArgument       () const { return argument; }
+		std::size_t  getItemsProcessed () const { return itemsProcessed; }
+		double       getRealSeconds    () const { return realSeconds; }
+		double       getCpuSeconds     () const { return cpuSeconds; }
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: setItemsProcessed
+		//
+		// Description:
+		//
+		//   Set the number of items the whole run processed, reported as a rate alongside the time.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void setItemsProcessed ( std::size_t items )
+		{
+			itemsProcessed = items;
+		}
+
+		//=============================================================================================================
+		// Constructors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 1/1: State
+		//
+		// Description:
+		//
+		//   Prepare a run of the given number of iterations.
+		//
+		// Arguments:
+		//
+		//   iterations (std::size_t):
+		//     The number of times the loop body runs.
+		//
+		//   argument (std::int64_t):
+		//     The case argument for this run, typically a problem size.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		State ( std::size_t iterations, std::int64_t argument )
+			: iterations ( iterations )
+			, argument   ( argument )
+		{
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: begin, end
+		//
+		// Description:
+		//
+		//   Start the clock and return the iterator range of the measured loop.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Iterator begin ()
+		{
+			resumeTiming ();
+			return { this, iterations };
+		}
+
+		Iterator end ()
+		{
+			return { this, 0 };
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: pauseTiming, resumeTiming
+		//
+		// Description:
+		//
+		//   Stop and restart the clock around work that should not be measured. Each pair costs a few clock reads, so
+		//   the paused work should be much larger than that.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void pauseTiming ()
+		{
+			if ( !running ) return;
+
+			realSeconds += std::chrono::duration <double> ( Clock::now () - realStart ).count ();
+			cpuSeconds  += static_cast <double> ( std::clock () - cpuStart ) / CLOCKS_PER_SEC;
+			running      = false;
+		}
+
+		void resumeTiming ()
+		{
+			if ( running ) return;
+
+			running   = true;
+			cpuStart  = std::clock ();
+			realStart = Clock::now ();
+		}
+	};
+
+	//*****************************************************************************************************************
+	// Class: Suite
+	//
+	// Description:
+	//
+	//   A list of benchmark cases and the command-line runner for them.
+	//
+	//   Each case runs once per argument and is named "<name>/<argument>". The runner accepts the Google Benchmark
+	//   flags used most often:
+	//
+	//   - --benchmark_filter=<regex>      Run only the cases whose name matches.
+	//   - --benchmark_min_time=<seconds>  The shortest run used for a measurement (default 0.5).
+	//   - --benchmark_repetitions=<n>     Measure each case n times and add mean, median, and stddev rows.
+	//   - --benchmark_format=console|json The format written to standard output.
+	//   - --benchmark_out=<path>          Also write the results to a file as JSON.
+	//   - --benchmark_list_tests          Print the case names without running them.
+	//
+	//*****************************************************************************************************************
+
+	class Suite
+	{
+	public:
+
+		using Function = std::function <void ( State& )>;
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Struct: Case, Result
+		//
+		// Description:
+		//
+		//   A registered case, and one measured row of output: a repetition, or an aggregate over repetitions.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		struct Case
+		{
+			std::string                name;
+			Function                   function;
+			std::vector <std::int64_t> arguments;
+		};
+
+		struct Result
+		{
+			std::string name;
+			std::string runName;
+			std::string aggregate;
+			int         repetitionIndex = 0;
+			std::size_t iterations      = 0;
+			double      realNs          = 0.0;
+			double      cpuNs           = 0.0;
+			double      itemsPerSecond  = 0.0;
+		};
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::vector <Case> cases;
+
+	public:
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: add
+		//
+		// Description:
+		//
+		//   Register a case, to run once per argument in the order given.
+		//
+		// Arguments:
+		//
+		//   name (const std::string&):
+		//     The case name, conventionally "<Group>/<Operation>".
+		//
+		//   function (Function):
+		//     The case body, which loops over the State it is given.
+		//
+		//   arguments (std::vector <std::int64_t>):
+		//     The arguments to run the case with, read back with State::getArgument.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void add ( const std::string& name, Function function, std::vector <std::int64_t> arguments )
+		{
+			cases.push_back ( { name, std::move ( function ), std::move ( arguments ) } );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: run
+		//
+		// Description:
+		//
+		//   Parse the command line, run the selected cases, and write the results.
+		//
+		// Arguments:
+		//
+		//   argc (int):
+		//     The number of command-line arguments.
+		//
+		//   argv[] (char*):
+		//     Array of command-line argument strings.
+		//
+		// Returns:
+		//
+		//   Exit code 0, or 1 if the command line is invalid or the output file cannot be written.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		int run ( int argc, char* argv [] )
+		{
+			std::string filter      = ".*";
+			std::string format      = "console";
+			std::string outPath;
+			double      minTime     = 0.5;
+			int         repetitions = 1;
+			bool        listOnly    = false;
+
+			for ( int i = 1; i < argc; ++i )
+			{
+				std::string argument = argv [ i ];
+				std::string value    = argument.substr ( argument.find ( '=' ) + 1 );
+
+				if      ( argument.rfind ( "--benchmark_filter=",      0 ) == 0 ) filter      = value;
+				else if ( argument.rfind ( "--benchmark_format=",      0 ) == 0 ) format      = value;
+				else if ( argument.rfind ( "--benchmark_out=",         0 ) == 0 ) outPath     = value;
+				else if ( argument.rfind ( "--benchmark_min_time=",    0 ) == 0 ) minTime     = std::stod ( value );
+				else if ( argument.rfind ( "--benchmark_repetitions=", 0 ) == 0 ) repetitions = std::max ( 1, std::stoi ( value ) );
+				else if ( argument == "--benchmark_list_tests" )                  listOnly    = true;
+				else
+				{
+					std::fprintf ( stderr, "Unknown argument: %s\n", argument.c_str () );
+					return 1;
+				}
+			}
+
+			if ( format != "console" && format != "json" )
+			{
+				std::fprintf ( stderr, "Unknown format: %s\n", format.c_str () );
+				return 1;
+			}
+
+			std::regex           pattern ( filter );
+			std::vector <Result> results;
+			bool                 console = format == "console";
+
+			if ( console && !listOnly )
+			{
+				std::printf ( "%-40s %15s %15s %12s %14s\n", "Benchmark", "Time", "CPU", "Iterations", "Items/s" );
+			}
+
+			for ( const Case& c : cases )
+			{
+				for ( std::int64_t argument : c.arguments )
+				{
+					std::string name = c.name + "/" + std::to_string ( argument );
+
+					if ( !std::regex_search ( name, pattern ) ) continue;
+
+					if ( listOnly )
+					{
+						std::printf ( "%s\n", name.c_str () );
+						continue;
+					}
+
+					std::size_t first      = results.size ();
+					std::size_t iterations = calibrate ( c.function, argument, minTime );
+
+					for ( int r = 0; r < repetitions; ++r )
+					{
+						State state ( iterations, argument );
+
+						c.function ( state );
+
+						Result result;
+
+						result.name            = name;
+						result.runName         = name;
+						result.repetitionIndex = r;
+						result.iterations      = iterations;
+						result.realNs          = state.getRealSeconds () * 1e9 / static_cast <double> ( iterations );
+						result.cpuNs           = state.getCpuSeconds ()  * 1e9 / static_cast <double> ( iterations );
+						result.itemsPerSecond  = state.getRealSeconds () > 0.0 ? static_cast <double> ( state.getItemsProcessed () ) / state.getRealSeconds () : 0.0;
+
+						results.push_back ( result );
+
+						if ( console ) printRow ( results.back () );
+					}
+
+					if ( repetitions > 1 )
+					{
+						addAggregates ( results, first, name );
+
+						if ( console ) for ( std::size_t i = results.size () - 3; i < results.size (); ++i ) printRow ( results [ i ] );
+					}
+				}
+			}
+
+			if ( listOnly ) return 0;
+
+			if ( !console ) writeJson ( std::cout, results, argv [ 0 ], repetitions );
+
+			if ( !outPath.empty () )
+			{
+				std::ofstream out ( outPath );
+
+				if ( !out.is_open () )
+				{
+					std::fprintf ( stderr, "Cannot write results file: %s\n", outPath.c_str () );
+					return 1;
+				}
+
+				writeJson ( out, results, argv [ 0 ], repetitions );
+			}
+
+			return 0;
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: calibrate
+		//
+		// Description:
+		//
+		//   Find an iteration count whose run lasts at least the minimum time, growing the count from one by the
+		//   ratio the last run fell short, capped at ten times per try.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static std::size_t calibrate ( const Function& function, std::int64_t argument, double minTime )
+		{
+			std::size_t iterations = 1;
+
+			for ( ;; )
+			{
+				State state ( iterations, argument );
+
+				function ( state );
+
+				double seconds = state.getRealSeconds ();
+
+				if ( seconds >= minTime || iterations >= 1000000000 ) return iterations;
+
+				double growth = seconds > 0.0 ? minTime * 1.4 / seconds : 10.0;
+
+				iterations = static_cast <std::size_t> ( std::ceil ( static_cast <double> ( iterations ) * std::clamp ( growth, 2.0, 10.0 ) ) );
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: addAggregates
+		//
+		// Description:
+		//
+		//   Append the mean, median, and standard deviation of the repetitions from index first on.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static void addAggregates ( std::vector <Result>& results, std::size_t first, const std::string& name )
+		{
+			std::size_t count = results.size () - first;
+
+			auto statistic = [ & ] ( const char* aggregate, auto reduce )
+			{
+				Result result         = results [ first ];
+				result.name           = name + "_" + aggregate;
+				result.aggregate      = aggregate;
+				result.realNs         = reduce ( &Result::realNs );
+				result.cpuNs          = reduce ( &Result::cpuNs );
+				result.itemsPerSecond = reduce ( &Result::itemsPerSecond );
+				return result;
+			};
+
+			auto values = [ & ] ( double Result::* field )
+			{
+				std::vector <double> v;
+				for ( std::size_t i = first; i < first + count; ++i ) v.push_back ( results [ i ].*field );
+				return v;
+			};
+
+			auto mean = [ & ] ( double Result::* field )
+			{
+				double sum = 0.0;
+				for ( double value : values ( field ) ) sum += value;
+				return sum / static_cast <double> ( count );
+			};
+
+			auto median = [ & ] ( double Result::* field )
+			{
+				std::vector <double> v = values ( field );
+				std::sort ( v.begin (), v.end () );
+				return count % 2 ? v [ count / 2 ] : 0.5 * ( v [ count / 2 - 1 ] + v [ count / 2 ] );
+			};
+
+			auto stddev = [ & ] ( double Result::* field )
+			{
+				double m   = mean ( field );
+				double sum = 0.0;
+				for ( double value : values ( field ) ) sum += ( value - m ) * ( value - m );
+				return std::sqrt ( sum / static_cast <double> ( count - 1 ) );
+			};
+
+			Result rows [] = { statistic ( "mean", mean ), statistic ( "median", median ), statistic ( "stddev", stddev ) };
+
+			results.insert ( results.end (), std::begin ( rows ), std::end ( rows ) );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: printRow
+		//
+		// Description:
+		//
+		//   Print one result as a console row.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static void printRow ( const Result& result )
+		{
+			char items [ 32 ] = "";
+
+			if ( result.itemsPerSecond > 0.0 )
+			{
+				double      rate   = result.itemsPerSecond;
+				const char* suffix = "";
+
+				if      ( rate >= 1e9 ) { rate /= 1e9; suffix = "G"; }
+				else if ( rate >= 1e6 ) { rate /= 1e6; suffix = "M"; }
+				else if ( rate >= 1e3 ) { rate /= 1e3; suffix = "k"; }
+
+				std::snprintf ( items, sizeof ( items ), "%.3f%s/s", rate, suffix );
+			}
+
+			std::printf ( "%-40s %12.0f ns %12.0f ns %12zu %14s\n", result.name.c_str (), result.realNs, result.cpuNs, result.iterations, items );
+			std::fflush ( stdout );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: writeJson
+		//
+		// Description:
+		//
+		//   Write the results in Google Benchmark's JSON schema: a context object describing the run, then one entry
+		//   per row with times in nanoseconds per iteration.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static void writeJson ( std::ostream& out, const std::vector <Result>& results, const char* executable, int repetitions )
+		{
+			char        date [ 64 ];
+			std::time_t now = std::time ( nullptr );
+
+			std::strftime ( date, sizeof ( date ), "%Y-%m-%dT%H:%M:%S", std::localtime ( &now ) );
+
+			auto precision = out.precision ( 17 );
+
+			out << "{\n  \"context\": {\n";
+			out << "    \"date\": \"" << date << "\",\n";
+			out << "    \"executable\": \"";
+			writeEscaped ( out, executable );
+			out << "\",\n";
+			out << "    \"num_cpus\": " << std::thread::hardware_concurrency () << ",\n";
+			#if defined ( NDEBUG )
+				out << "    \"library_build_type\": \"release\",\n";
+			#else
+				out << "    \"library_build_type\": \"debug\",\n";
+			#endif
+			out << "    \"json_schema_version\": 1\n  },\n  \"benchmarks\": [";
+
+			const char* separator = "\n";
+
+			for ( const Result& result : results )
+			{
+				out << separator << "    {\n";
+				out << "      \"name\": \"" << result.name << "\",\n";
+				out << "      \"run_name\": \"" << result.runName << "\",\n";
+
+				if ( result.aggregate.empty () )
+				{
+					out << "      \"run_type\": \"iteration\",\n";
+					out << "      \"repetitions\": " << repetitions << ",\n";
+					out << "      \"repetition_index\": " << result.repetitionIndex << ",\n";
+				}
+				else
+				{
+					out << "      \"run_type\": \"aggregate\",\n";
+					out << "      \"repetitions\": " << repetitions << ",\n";
+					out << "      \"aggregate_name\": \"" << result.aggregate << "\",\n";
+				}
+
+				out << "      \"threads\": 1,\n";
+				out << "      \"iterations\": " << result.iterations << ",\n";
+				out << "      \"real_time\": " << result.realNs << ",\n";
+				out << "      \"cpu_time\": " << result.cpuNs << ",\n";
+				out << "      \"time_unit\": \"ns\"";
+
+				if ( result.itemsPerSecond > 0.0 ) out << ",\n      \"items_per_second\": " << result.itemsPerSecond;
+
+				out << "\n    }";
+				separator = ",\n";
+			}
+
+			out << "\n  ]\n}\n";
+			out.precision ( precision );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: writeEscaped
+		//
+		// Description:
+		//
+		//   Write a string as the contents of a JSON string literal.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static void writeEscaped ( std::ostream& out, const char* text )
+		{
+			for ( ; *text; ++text )
+			{
+				char c = *text;
+
+				if      ( c == '"' || c == '\\' )                      out << '\\' << c;
+				else if ( static_cast <unsigned char> ( c ) < 0x20 ) out << ' ';
+				else                                                   out << c;
+			}
+		}
+	};
+}
@@ -0,0 +1,308 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark for system membership maintenance when many systems are registered.
+//
+//   Spawns entities with eight components each against 200 systems, then destroys them. The baseline pairs a World
+//   with no systems and a reference that re-tests every system on each change, as World did before systems were
+//   indexed by component bit. The candidate is a World with the same 200 systems registered.
+//
+//   A final row compares that per-component spawn with World::createEntities, which adds all eight components to
+//   the whole batch at once, and World::instantiate, which copies the same eight components from a prefab.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//*********************************************************************************************************************
+// Struct: Comp
+//
+// Description:
+//
+//   Family of distinct component types, one per index.
+//
+//*********************************************************************************************************************
+
+template <std::size_t N>
+struct Comp
+{
+	double value = 0.0;
+};
+
+//*********************************************************************************************************************
+// Class: MembershipSystem
+//
+// Description:
+//
+//   Empty system registered only for its entity set.
+//
+//*********************************************************************************************************************
+
+class MembershipSystem : public ecs::System
+{
+public:
+
+	void update ( ecs::World&, double ) override {}
+};
+
+//*********************************************************************************************************************
+// Class: ScanMembership
+//
+// Description:
+//
+//   Reference membership bookkeeping that tests every system on every signature change and erases from every system
+//   on destroy, using an ordered set per system.
+//
+//*********************************************************************************************************************
+
+class ScanMembership
+{
+private:
+
+	struct Entry
+	{
+		ecs::Signature         signature;
+		std::set <ecs::Entity> entities;
+	};
+
+	std::unordered_map <std::string, std::shared_ptr <Entry>> systems;
+
+public:
+
+	void add ( const std::string& name, ecs::Signature signature )
+	{
+		auto entry = std::make_shared <Entry> ();
+		entry->signature = signature;
+		systems [ name ] = entry;
+	}
+
+	void update ( ecs::Entity entity, ecs::Signature entitySignature )
+	{
+		for ( auto& [ name, entry ] : systems )
+		{
+			if ( ( entitySignature & entry->signature ) == entry->signature )
+			{
+				entry->entities.insert ( entity );
+			}
+			else
+			{
+				entry->entities.erase ( entity );
+			}
+		}
+	}
+
+	void destroy ( ecs::Entity entity )
+	{
+		for ( auto& [ name, entry ] : systems )
+		{
+			entry->entities.erase ( entity );
+		}
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Constants
+//---------------------------------------------------------------------------------------------------------------------
+
+constexpr std::size_t COMPONENT_TYPES       = 16;
+constexpr std::size_t COMPONENTS_PER_ENTITY = 8;
+constexpr std::size_t SYSTEM_COUNT          = 200;
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: registerComponents
+//
+// Description:
+//
+//   Register Comp <0> .. Comp <COMPONENT_TYPES - 1> with a world.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+template <std::size_t... I>
+void registerComponents ( ecs::World& world, std::index_sequence <I...> )
+{
+	( world.registerComponent <Comp <I>> (), ... );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: spawn
+//
+// Description:
+//
+//   Create count entities, each with Comp <0> .. Comp <COMPONENTS_PER_ENTITY - 1>, calling onAdd with the entity's
+//   signature after every component is added. Comp <I> is registered first-to-last, so its bit is I.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename OnAdd, std::size_t... I>
+void spawn ( ecs::World& world, std::size_t count, std::vector <ecs::Entity>& entities, OnAdd&& onAdd, std::index_sequence <I...> )
+{
+	for ( std::size_t i = 0; i < count; ++i )
+	{
+		ecs::Entity    entity = world.createEntity ();
+		ecs::Signature signature;
+
+		( ( world.addComponent ( entity, Comp <I> {} ), signature.set ( I ), onAdd ( entity, signature ) ), ... );
+
+		entities.push_back ( entity );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Measure spawning and destroying 100K entities against 200 systems and print one row per phase.
+//
+// Returns:
+//
+//   Exit code 0.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t count       = 100000;
+	const int         repetitions = 3;
+
+	// Random system signatures of one to three bits over all component types. Fixed seed for repeatable runs.
+
+	std::mt19937                                 random ( 12345 );
+	std::uniform_int_distribution <std::size_t> bitDistribution   ( 0, COMPONENT_TYPES - 1 );
+	std::uniform_int_distribution <int>         widthDistribution ( 1, 3 );
+	std::vector <ecs::Signature>                 signatures;
+
+	for ( std::size_t s = 0; s < SYSTEM_COUNT; ++s )
+	{
+		ecs::Signature signature;
+		int            width = widthDistribution ( random );
+
+		for ( int b = 0; b < width; ++b ) signature.set ( bitDistribution ( random ) );
+
+		signatures.push_back ( signature );
+	}
+
+	std::unique_ptr <ecs::World>     world;
+	std::unique_ptr <ScanMembership> scan;
+	std::vector <ecs::Entity>        entities;
+
+	auto makeWorld = [ & ] ( bool withSystems )
+	{
+		world = std::make_unique <ecs::World> ( count );
+		scan  = std::make_unique <ScanMembership> ();
+		entities.clear ();
+
+		registerComponents ( *world, std::make_index_sequence <COMPONENT_TYPES> {} );
+
+		for ( std::size_t s = 0; s < SYSTEM_COUNT; ++s )
+		{
+			std::string name = "System" + std::to_string ( s );
+
+			if ( withSystems ) world->registerSystem <MembershipSystem> ( name, signatures [ s ] );
+			else               scan->add ( name, signatures [ s ] );
+		}
+	};
+
+	auto spawnScan = [ & ] ()
+	{
+		spawn
+		(
+			*world, count, entities,
+			[ & ] ( ecs::Entity entity, const ecs::Signature& signature ) { scan->update ( entity, signature ); },
+			std::make_index_sequence <COMPONENTS_PER_ENTITY> {}
+		);
+	};
+
+	auto spawnIndexed = [ & ] ()
+	{
+		spawn ( *world, count, entities, [] ( ecs::Entity, const ecs::Signature& ) {}, std::make_index_sequence <COMPONENTS_PER_ENTITY> {} );
+	};
+
+	std::printf ( "%-24s %10s %14s %14s %10s\n", "operation", "entities", "scan ns/op", "indexed ns/op", "speed-up" );
+
+	double spawnBaseline = benchmark::measure ( count, repetitions, [ & ] () { makeWorld ( false ); }, spawnScan );
+	double spawnIndex    = benchmark::measure ( count, repetitions, [ & ] () { makeWorld ( true ); }, spawnIndexed );
+
+	double destroyBaseline = benchmark::measure
+	(
+		count, repetitions,
+		[ & ] () { makeWorld ( false ); spawnScan (); },
+		[ & ] ()
+		{
+			for ( ecs::Entity entity : entities )
+			{
+				scan->destroy ( entity );
+				world->destroyEntity ( entity );
+			}
+		}
+	);
+
+	double destroyIndex = benchmark::measure
+	(
+		count, repetitions,
+		[ & ] () { makeWorld ( true ); spawnIndexed (); },
+		[ & ] ()
+		{
+			for ( ecs::Entity entity : entities ) world->destroyEntity ( entity );
+		}
+	);
+
+	double spawnBatch = benchmark::measure
+	(
+		count, repetitions,
+		[ & ] () { makeWorld ( true ); },
+		[ & ] ()
+		{
+			entities = world->createEntities
+			(
+				count,
+				Comp <0> {}, Comp <1> {}, Comp <2> {}, Comp <3> {}, Comp <4> {}, Comp <5> {}, Comp <6> {}, Comp <7> {}
+			);
+		}
+	);
+
+	double spawnPrefab = benchmark::measure
+	(
+		count, repetitions,
+		[ & ] () { makeWorld ( true ); },
+		[ & ] ()
+		{
+			ecs::Prefab prefab = world->createPrefab
+			(
+				Comp <0> {}, Comp <1> {}, Comp <2> {}, Comp <3> {}, Comp <4> {}, Comp <5> {}, Comp <6> {}, Comp <7> {}
+			);
+
+			entities = world->instantiate ( prefab, count );
+		}
+	);
+
+	benchmark::printRow ( "spawn 8 components", count, spawnBaseline, spawnIndex );
+	benchmark::printRow ( "destroy", count, destroyBaseline, destroyIndex );
+
+	std::printf ( "\n%-24s %10s %14s %14s %10s\n", "operation", "entities", "single ns/op", "batch ns/op", "speed-up" );
+
+	benchmark::printRow ( "createEntities", count, spawnIndex, spawnBatch );
+	benchmark::printRow ( "instantiate", count, spawnIndex, spawnPrefab );
+
+	return 0;
+}
@@ -0,0 +1,267 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark and check for scheduling systems by their declared component access.
+//
+//   Six systems each read one component and write another for every entity. Motion, HUD, and audio touch disjoint
+//   components and share the first stage; drawing reads what motion writes and follows it; the fade reads what the
+//   HUD writes and follows it; the undeclared logger runs alone at the end. The program
+//
+//   - prints the schedule dump,
+//   - checks each system's stage and that the schedule has no write/write races,
+//   - checks that a hand-built stage with two writers of the same component is reported as a race,
+//   - checks that the scheduled update reproduces the sequential update exactly, and
+//   - times both updates.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+#include "../engine/JobSystem.h"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Components
+//---------------------------------------------------------------------------------------------------------------------
+
+struct Position { double value = 1.0; };
+struct Velocity { double value = 2.0; };
+struct Hud      { double value = 3.0; };
+struct DrawList { double value = 0.0; };
+struct HudText  { double value = 0.0; };
+struct Sound    { double value = 0.0; };
+
+//*********************************************************************************************************************
+// Class: TransferSystem
+//
+// Description:
+//
+//   Reads Input, does a fixed amount of arithmetic, and adds the result to Output for every entity. Adding makes
+//   the final state depend on the order systems run in, so a wrongly ordered schedule changes the result.
+//
+//*********************************************************************************************************************
+
+template <typename Input, typename Output>
+class TransferSystem : public ecs::System
+{
+public:
+
+	int rounds = 8;
+
+	void update ( ecs::World& world, double ) override
+	{
+		auto view = world.view <Input, Output> ();
+
+		for ( ecs::Entity entity : entities )
+		{
+			double value = view.template get <Input> ( entity ).value;
+
+			for ( int round = 0; round < rounds; ++round ) value = std::sqrt ( value * value + 1.0 ) * 0.5;
+
+			view.template get <Output> ( entity ).value += value;
+		}
+	}
+};
+
+//*********************************************************************************************************************
+// Class: Scene
+//
+// Description:
+//
+//   A world holding entities with all six components and the six systems, declared as described above.
+//
+//*********************************************************************************************************************
+
+class Scene
+{
+public:
+
+	ecs::World                                            world;
+	std::shared_ptr <TransferSystem <Velocity, Position>> motion;
+	std::shared_ptr <TransferSystem <Position, DrawList>> draw;
+	std::shared_ptr <TransferSystem <Hud, HudText>>       hud;
+	std::shared_ptr <TransferSystem <HudText, Hud>>       fade;
+	std::shared_ptr <TransferSystem <Velocity, Sound>>    audio;
+	std::shared_ptr <TransferSystem <DrawList, Sound>>    logger;
+	std::vector <ecs::Entity>                             entities;
+
+	explicit Scene ( std::size_t count )
+		: world ( count )
+	{
+		world.registerComponent <Position> ();
+		world.registerComponent <Velocity> ();
+		world.registerComponent <Hud>      ();
+		world.registerComponent <DrawList> ();
+		world.registerComponent <HudText>  ();
+		world.registerComponent <Sound>    ();
+
+		motion = world.registerSystem <TransferSystem <Velocity, Position>> ( "Motion", world.makeSignature <Velocity, Position> () );
+		draw   = world.registerSystem <TransferSystem <Position, DrawList>> ( "Draw",   world.makeSignature <Position, DrawList> () );
+		hud    = world.registerSystem <TransferSystem <Hud, HudText>>       ( "Hud",    world.makeSignature <Hud, HudText> ()       );
+		fade   = world.registerSystem <TransferSystem <HudText, Hud>>       ( "Fade",   world.makeSignature <HudText, Hud> ()       );
+		audio  = world.registerSystem <TransferSystem <Velocity, Sound>>    ( "Audio",  world.makeSignature <Velocity, Sound> ()    );
+		logger = world.registerSystem <TransferSystem <DrawList, Sound>>    ( "Logger", world.makeSignature <DrawList, Sound> ()    );
+
+		world.declareSystemAccess ( *motion, world.makeSignature <Velocity> (), world.makeSignature <Position> () );
+		world.declareSystemAccess ( *draw,   world.makeSignature <Position> (), world.makeSignature <DrawList> () );
+		world.declareSystemAccess ( *hud,    world.makeSignature <Hud> (),      world.makeSignature <HudText> ()  );
+		world.declareSystemAccess ( *fade,   world.makeSignature <HudText> (),  world.makeSignature <Hud> ()      );
+		world.declareSystemAccess ( *audio,  world.makeSignature <Velocity> (), world.makeSignature <Sound> ()    );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			ecs::Entity entity = world.createEntity ();
+			world.addComponents ( ecs::Span <const ecs::Entity> ( &entity, 1 ), Position {}, Velocity { 2.0 + static_cast <double> ( i % 7 ) }, Hud {}, DrawList {}, HudText {}, Sound {} );
+			entities.push_back ( entity );
+		}
+	}
+
+	// Every entity's output components, in entity order.
+
+	std::vector <double> state ()
+	{
+		std::vector <double> result;
+
+		for ( ecs::Entity entity : entities )
+		{
+			result.push_back ( world.getComponent <Position> ( entity ).value );
+			result.push_back ( world.getComponent <DrawList> ( entity ).value );
+			result.push_back ( world.getComponent <Hud>      ( entity ).value );
+			result.push_back ( world.getComponent <HudText>  ( entity ).value );
+			result.push_back ( world.getComponent <Sound>    ( entity ).value );
+		}
+
+		return result;
+	}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: stageOf
+//
+// Description:
+//
+//   Return the stage a system was placed in, or -1 if it is not in the schedule.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int stageOf ( const std::vector <std::vector <ecs::System*>>& schedule, const ecs::System* system )
+{
+	for ( std::size_t stage = 0; stage < schedule.size (); ++stage )
+	{
+		for ( const ecs::System* member : schedule [ stage ] )
+		{
+			if ( member == system ) return static_cast <int> ( stage );
+		}
+	}
+
+	return -1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run the checks, then time the sequential and scheduled updates.
+//
+// Returns:
+//
+//   Exit code 0 if every check passed, 1 otherwise.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t count   = 100000;
+	const int         frames  = 3;
+	bool              allPass = true;
+
+	Scene scene ( count );
+
+	// Schedule.
+
+	scene.world.dumpSchedule ( std::cout );
+	std::cout << "\n";
+
+	const auto& schedule = scene.world.buildSchedule ();
+
+	bool expectedStages =
+		stageOf ( schedule, scene.motion.get () ) == 0 &&
+		stageOf ( schedule, scene.hud.get ()    ) == 0 &&
+		stageOf ( schedule, scene.audio.get ()  ) == 0 &&
+		stageOf ( schedule, scene.draw.get ()   ) == 1 &&
+		stageOf ( schedule, scene.fade.get ()   ) == 1 &&
+		stageOf ( schedule, scene.logger.get () ) == 2 &&
+		schedule [ 2 ].size () == 1;
+
+	allPass = benchmark::check ( "independent systems share a stage, dependent ones follow", expectedStages ) && allPass;
+	allPass = benchmark::check ( "built schedule has no write/write races", ecs::World::findScheduleRaces ( schedule ).empty () ) && allPass;
+
+	// A stage holding a second writer of Position must be reported.
+
+	TransferSystem <Velocity, Position> teleport;
+
+	teleport.name = "Teleport";
+	scene.world.declareSystemAccess ( teleport, scene.world.makeSignature <Velocity> (), scene.world.makeSignature <Position> () );
+
+	std::vector <std::vector <ecs::System*>> racy = { { scene.motion.get (), scene.hud.get (), &teleport } };
+	auto                                     races = ecs::World::findScheduleRaces ( racy );
+
+	allPass = benchmark::check ( "two writers of one component in a stage are reported", races.size () == 1 && races [ 0 ].first == scene.motion.get () && races [ 0 ].second == &teleport ) && allPass;
+
+	// Disabling a system removes it from the schedule and lets its dependants move up.
+
+	scene.motion->enabled = false;
+
+	const auto& reduced = scene.world.buildSchedule ();
+
+	allPass = benchmark::check ( "disabled systems leave the schedule", stageOf ( reduced, scene.motion.get () ) == -1 && stageOf ( reduced, scene.draw.get () ) == 0 ) && allPass;
+
+	scene.motion->enabled = true;
+
+	// Scheduled updates must match sequential updates exactly.
+
+	std::size_t       threads = std::max ( 1u, std::thread::hardware_concurrency () );
+	engine::JobSystem jobs    ( std::max ( threads, std::size_t ( 2 ) ) );
+
+	auto parallelFor = [ &jobs ] ( std::size_t n, auto&& body ) { jobs.parallelFor ( n, 1, body ); };
+
+	Scene sequential ( count );
+	Scene scheduled  ( count );
+
+	for ( int frame = 0; frame < frames; ++frame )
+	{
+		sequential.world.updateSystems ( 1.0 / 60.0 );
+		scheduled.world.updateSystems  ( 1.0 / 60.0, parallelFor );
+	}
+
+	allPass = benchmark::check ( "scheduled update matches sequential update", sequential.state () == scheduled.state () ) && allPass;
+
+	// Timing.
+
+	double sequentialNs = benchmark::measure ( 1, 10, [] () {}, [ & ] () { sequential.world.updateSystems ( 1.0 / 60.0 ); } );
+	double scheduledNs  = benchmark::measure ( 1, 10, [] () {}, [ & ] () { scheduled.world.updateSystems ( 1.0 / 60.0, parallelFor ); } );
+
+	std::printf ( "\nhardware threads: %zu, job system threads: %zu\n", threads, jobs.getThreadCount () );
+	std::printf ( "%-12s %10s %14s %14s %10s\n", "update", "entities", "sequential ms", "scheduled ms", "speed-up" );
+	std::printf ( "%-12s %10zu %14.3f %14.3f %9.2fx\n", "6 systems", count, sequentialNs / 1e6, scheduledNs / 1e6, sequentialNs / scheduledNs );
+
+	return allPass ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark and check for the RingBuffer trail history against the std::deque it replaced.
+//
+//   Each frame records one position into every particle's trail and then walks every trail from oldest to newest,
+//   as SystemPhysics and SystemRenderer do. The baseline pushes onto a std::deque and pops its front past the depth;
+//   the ring buffer is sized to the depth and overwrites its oldest position. The program checks that
+//
+//   - after many frames, both hold the same positions in the same order,
+//   - once the trails are full, ring buffer frames perform no heap allocation, and
+//   - changing the capacity keeps the newest positions,
+//
+//   then prints the time per particle of each path.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#define BENCHMARK_COUNT_ALLOCATIONS
+
+#include "Benchmark.h"
+
+#include "../engine/RingBuffer.h"
+#include "../engine/math/Vector2D.h"
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: positionAt
+//
+// Description:
+//
+//   Return the position a particle records on a frame, distinct for every particle and frame.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+engine::Vector2D positionAt ( std::size_t particle, int frame )
+{
+	return { static_cast <double> ( particle ), static_cast <double> ( frame ) };
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: timeFrames
+//
+// Description:
+//
+//   Run enough frames to fill every trail, then time a further number of frames, and return the time per particle
+//   per frame in nanoseconds, along with the allocations made by the timed frames.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename Frame>
+double timeFrames ( int fillFrames, int timedFrames, std::size_t particles, std::size_t& allocations, Frame&& frame )
+{
+	for ( int f = 0; f < fillFrames; ++f ) frame ( f );
+
+	std::size_t before = benchmark::allocationCount ();
+	auto        start  = std::chrono::steady_clock::now ();
+
+	for ( int f = fillFrames; f < fillFrames + timedFrames; ++f ) frame ( f );
+
+	auto end = std::chrono::steady_clock::now ();
+
+	allocations = benchmark::allocationCount () - before;
+
+	return std::chrono::duration <double, std::nano> ( end - start ).count () / static_cast <double> ( particles * timedFrames );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run the checks and timings.
+//
+// Returns:
+//
+//   Exit code 0 if every check passes, or 1 otherwise.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t particles = 2000;
+	const int         depth     = 500;
+	const int         timed     = 200;
+
+	bool allPassed = true;
+
+	// Baseline: a deque per particle, trimmed to the depth.
+
+	std::vector <std::deque <engine::Vector2D>> deques ( particles );
+	double                                      dequeSum         = 0.0;
+	std::size_t                                 dequeAllocations = 0;
+
+	double dequeNs = timeFrames
+	(
+		depth, timed, particles, dequeAllocations,
+		[ & ] ( int frame )
+		{
+			dequeSum = 0.0;
+
+			for ( std::size_t p = 0; p < particles; ++p )
+			{
+				auto& history = deques [ p ];
+
+				history.push_back ( positionAt ( p, frame ) );
+
+				while ( static_cast <int> ( history.size () ) > depth ) history.pop_front ();
+
+				for ( std::size_t i = 0; i < history.size (); ++i ) dequeSum += history [ i ].y;
+			}
+		}
+	);
+
+	// Ring buffer per particle, sized to the depth.
+
+	std::vector <engine::RingBuffer <engine::Vector2D>> rings ( particles );
+	double                                              ringSum         = 0.0;
+	std::size_t                                         ringAllocations = 0;
+
+	double ringNs = timeFrames
+	(
+		depth, timed, particles, ringAllocations,
+		[ & ] ( int frame )
+		{
+			ringSum = 0.0;
+
+			for ( std::size_t p = 0; p < particles; ++p )
+			{
+				auto& history = rings [ p ];
+
+				history.setCapacity ( depth );
+				history.push ( positionAt ( p, frame ) );
+
+				for ( ecs::Span <const engine::Vector2D> run : history.spans () )
+				{
+					for ( const engine::Vector2D& position : run ) ringSum += position.y;
+				}
+			}
+		}
+	);
+
+	bool same = true;
+
+	for ( std::size_t p = 0; p < particles && same; ++p )
+	{
+		same = deques [ p ].size () == rings [ p ].size ();
+
+		for ( std::size_t i = 0; i < rings [ p ].size () && same; ++i )
+		{
+			same = deques [ p ][ i ].x == rings [ p ][ i ].x && deques [ p ][ i ].y == rings [ p ][ i ].y;
+		}
+	}
+
+	allPassed &= benchmark::check ( "ring buffers hold the same positions in the same order as the deques",   same && ringSum == dequeSum );
+	allPassed &= benchmark::check ( "once the trails are full, ring buffer frames perform no heap allocation", ringAllocations == 0 );
+
+	std::printf ( "  allocations in the timed baseline frames: %zu\n", dequeAllocations );
+
+	// Resizing keeps the newest positions.
+
+	{
+		engine::RingBuffer <int> ring;
+
+		ring.setCapacity ( 4 );
+		for ( int i = 1; i <= 6; ++i ) ring.push ( i );
+
+		bool wrapped = ring.size () == 4 && ring [ 0 ] == 3 && ring [ 3 ] == 6 && ring.spans () [ 1 ].size () == 2;
+
+		ring.setCapacity ( 2 );
+
+		bool shrunk = ring.size () == 2 && ring [ 0 ] == 5 && ring [ 1 ] == 6;
+
+		ring.setCapacity ( 0 );
+		ring.push ( 7 );
+
+		allPassed &= benchmark::check ( "a full ring wraps, and shrinking it keeps the newest positions",          wrapped && shrunk && ring.empty () );
+	}
+
+	// Timings.
+
+	std::printf ( "\n%-24s %10s %14s %14s %10s\n", "operation", "particles", "deque ns/op", "ring ns/op", "speed-up" );
+
+	benchmark::printRow ( "push + walk, depth 500", particles, dequeNs, ringNs );
+
+	return allPassed ? 0 : 1;
+}
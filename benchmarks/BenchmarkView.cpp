@@ -0,0 +1,179 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Benchmark comparing World::view against the per-entity getComponent pattern used by the particle systems.
+//
+//   The baseline walks a system's entity set and calls getComponent for each of three components, resolving the
+//   component array by type on every call. The candidates iterate a view with each () and with a range-based for
+//   loop.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "../ecs/World.h"
+
+#include <cstdio>
+#include <vector>
+
+//*********************************************************************************************************************
+// Structs: ViewTransform, ViewPhysics, ViewTrail
+//
+// Description:
+//
+//   Stand-ins for the components SystemPhysics touches.
+//
+//*********************************************************************************************************************
+
+struct ViewTransform
+{
+	double x = 0.0, y = 0.0, rotation = 0.0, scaleX = 1.0, scaleY = 1.0;
+};
+
+struct ViewPhysics
+{
+	double vx = 0.001, vy = 0.002, ax = 0.0, ay = 0.0, mass = 1.0, friction = 0.99;
+};
+
+struct ViewTrail
+{
+	double lastX = 0.0, lastY = 0.0;
+};
+
+//*********************************************************************************************************************
+// Class: ViewSystem
+//
+// Description:
+//
+//   Empty system registered only so the World maintains an entity set for the baseline loop.
+//
+//*********************************************************************************************************************
+
+class ViewSystem : public ecs::System
+{
+public:
+
+	void update ( ecs::World&, double ) override {}
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: step
+//
+// Description:
+//
+//   Integrate, damp, and record one particle, the per-entity work of SystemPhysics.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+inline void step ( ViewTransform& transform, ViewPhysics& physics, ViewTrail& trail )
+{
+	const double dt = 1.0 / 60.0;
+
+	transform.x += physics.vx * dt;
+	transform.y += physics.vy * dt;
+	physics.vx  *= physics.friction;
+	physics.vy  *= physics.friction;
+	trail.lastX  = transform.x;
+	trail.lastY  = transform.y;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: main
+//
+// Description:
+//
+//   Run the comparison at each entity count and print one row per iteration style.
+//
+// Returns:
+//
+//   Exit code 0.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	const std::size_t sizes []    = { 4096, 65536, 1048576 };
+	const int         repetitions = 5;
+
+	std::printf ( "%-24s %10s %14s %14s %10s\n", "operation", "entities", "lookup ns/op", "view ns/op", "speed-up" );
+
+	for ( std::size_t count : sizes )
+	{
+		ecs::World world ( count );
+
+		world.registerComponent <ViewTransform> ();
+		world.registerComponent <ViewPhysics>   ();
+		world.registerComponent <ViewTrail>     ();
+
+		auto system = world.registerSystem <ViewSystem> ( "View", world.makeSignature <ViewTransform, ViewPhysics, ViewTrail> () );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			ecs::Entity entity = world.createEntity ();
+			world.addComponent ( entity, ViewTransform {} );
+			world.addComponent ( entity, ViewPhysics {} );
+			world.addComponent ( entity, ViewTrail {} );
+		}
+
+		double lookup = benchmark::measure
+		(
+			count, repetitions,
+			[] () {},
+			[ & ] ()
+			{
+				for ( auto entity : system->entities )
+				{
+					step
+					(
+						world.getComponent <ViewTransform> ( entity ),
+						world.getComponent <ViewPhysics>   ( entity ),
+						world.getComponent <ViewTrail>     ( entity )
+					);
+				}
+			}
+		);
+
+		double each = benchmark::measure
+		(
+			count, repetitions,
+			[] () {},
+			[ & ] ()
+			{
+				world.view <ViewTransform, ViewPhysics, ViewTrail> ().each
+				(
+					[] ( ecs::Entity, ViewTransform& transform, ViewPhysics& physics, ViewTrail& trail )
+					{
+						step ( transform, physics, trail );
+					}
+				);
+			}
+		);
+
+		double rangeFor = benchmark::measure
+		(
+			count, repetitions,
+			[] () {},
+			[ & ] ()
+			{
+				for ( auto [ entity, transform, physics, trail ] : world.view <ViewTransform, ViewPhysics, ViewTrail> () )
+				{
+					step ( transform, physics, trail );
+				}
+			}
+		);
+
+		benchmark::printRow ( "view each", count, lookup, each );
+		benchmark::printRow ( "view range-for", count, lookup, rangeFor );
+	}
+
+	return 0;
+}
@@ -69,7 +69,8 @@ int main ()
 	world.addComponent ( message, TextComponent { "Hello World!" } );
 	world.addComponent ( message, MessageStatusComponent {} );
 
-	// Background thread waits for any key press, then posts an exit command.
+	// Background thread waits for any key press, then posts an exit command. The command manager accepts posts from
+	// any thread, and the command itself runs on the main thread at the next flush.
 
 	std::thread inputThread
 	(
@@ -0,0 +1,212 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS Game Engine - Particle Batch
+// Version: 1.0
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Entry point for the headless particle batch runner.
+//
+//   Builds the particle simulator's world from settings.properties, runs the simulation systems for Batch.Steps
+//   fixed steps as fast as they go, writes the final particle state to Batch.State.Path as CSV, and prints timing
+//   statistics to standard output in the settings file's "key = value" form. Nothing is drawn and SDL is not
+//   linked, so it runs on machines without a display.
+//
+//   Usage:
+//
+//     particle_batch [ settings-file ] [ Key=Value ... ]
+//
+//   The settings file defaults to resources/settings.properties next to the executable. Each Key=Value argument
+//   overrides one setting, for example Particle.Count.Red.Default=500 or Initial.Seed=7, so a parameter sweep
+//   needs no edited copies of the settings file. An empty Batch.State.Path skips writing the state.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "../particle_demo/engines/EngineParticleBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Method: loadSettings
+//
+// Description:
+//
+//   Load the settings file named on the command line, or the default one, then apply the Key=Value overrides.
+//
+// Arguments:
+//
+//   argc (int):
+//     The number of command-line arguments.
+//
+//   argv[] (char*):
+//     Array of command-line argument strings.
+//
+// Returns:
+//
+//   The loaded and overridden settings.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+engine::ApplicationSettings loadSettings ( int argc, char* argv [] )
+{
+	std::filesystem::path exeDir       = std::filesystem::weakly_canonical ( std::filesystem::path ( argv [ 0 ] ) ).parent_path ();
+	std::string           settingsPath = ( exeDir / "resources" / "settings.properties" ).string ();
+	int                   first        = 1;
+
+	if ( argc > 1 && std::string ( argv [ 1 ] ).find ( '=' ) == std::string::npos )
+	{
+		settingsPath = argv [ 1 ];
+		first        = 2;
+	}
+
+	engine::ApplicationSettings settings ( settingsPath );
+
+	for ( int i = first; i < argc; ++i )
+	{
+		std::string argument  = argv [ i ];
+		auto        delimiter = argument.find ( '=' );
+
+		if ( delimiter == std::string::npos || delimiter == 0 )
+		{
+			throw std::runtime_error ( "Expected Key=Value, got: " + argument );
+		}
+
+		settings.set ( argument.substr ( 0, delimiter ), argument.substr ( delimiter + 1 ) );
+	}
+
+	return settings;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Method: main
+//
+// Description:
+//
+//   Application entry point.
+//
+//   Builds the batch engine, times each fixed step, then writes the final state and prints the statistics.
+//
+// Arguments:
+//
+//   argc (int):
+//     The number of command-line arguments.
+//
+//   argv[] (char*):
+//     Array of command-line argument strings.
+//
+// Returns:
+//
+//   Exit code 0 on successful termination, or 1 if a fatal exception occurs.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+int main ( int argc, char* argv [] )
+{
+	using Clock = std::chrono::steady_clock;
+
+	try
+	{
+		engine::ApplicationSettings settings = loadSettings ( argc, argv );
+
+		// Build the world.
+
+		auto setupStart = Clock::now ();
+
+		EngineParticleBatch batch ( settings );
+
+		double setupSeconds = std::chrono::duration <double> ( Clock::now () - setupStart ).count ();
+
+		// Run the steps one at a time so each can be timed. The clock reads cost far less than a step.
+
+		std::size_t          steps = static_cast <std::size_t> ( std::max ( 0, settings.getInt ( "Batch.Steps" ) ) );
+		std::vector <double> stepSeconds;
+
+		stepSeconds.reserve ( steps );
+
+		auto runStart = Clock::now ();
+
+		for ( std::size_t step = 0; step < steps; ++step )
+		{
+			auto stepStart = Clock::now ();
+
+			batch.runSteps ( 1 );
+
+			stepSeconds.push_back ( std::chrono::duration <double> ( Clock::now () - stepStart ).count () );
+		}
+
+		double runSeconds = std::chrono::duration <double> ( Clock::now () - runStart ).count ();
+
+		// Write the final state.
+
+		std::string statePath = settings.getString ( "Batch.State.Path" );
+
+		if ( !statePath.empty () )
+		{
+			std::ofstream state ( statePath );
+
+			if ( !state.is_open () )
+			{
+				throw std::runtime_error ( "Cannot write state file: " + statePath );
+			}
+
+			batch.writeState ( state );
+		}
+
+		// Print the statistics.
+
+		std::vector <double> sorted = stepSeconds;
+
+		std::sort ( sorted.begin (), sorted.end () );
+
+		auto percentile = [ &sorted ] ( double p ) { return sorted.empty () ? 0.0 : sorted [ static_cast <std::size_t> ( p * static_cast <double> ( sorted.size () - 1 ) ) ]; };
+
+		double particleSteps = static_cast <double> ( batch.getParticleCount () ) * static_cast <double> ( steps );
+
+		std::printf ( "Batch.Particles          = %zu\n",   batch.getParticleCount () );
+		std::printf ( "Batch.Threads            = %zu\n",   batch.getThreadCount () );
+		std::printf ( "Batch.Steps              = %zu\n",   steps );
+		std::printf ( "Batch.Step.Seconds       = %.9g\n",  batch.getFixedStep () );
+		std::printf ( "Batch.Simulated.Seconds  = %.6f\n",  batch.getFixedStep () * static_cast <double> ( steps ) );
+		std::printf ( "Batch.Setup.Ms           = %.3f\n",  setupSeconds * 1e3 );
+		std::printf ( "Batch.Run.Ms             = %.3f\n",  runSeconds * 1e3 );
+		std::printf ( "Batch.Steps.PerSecond    = %.1f\n",  runSeconds > 0.0 ? static_cast <double> ( steps ) / runSeconds : 0.0 );
+		std::printf ( "Batch.Step.Ms.Min        = %.4f\n",  percentile ( 0.0 ) * 1e3 );
+		std::printf ( "Batch.Step.Ms.Median     = %.4f\n",  percentile ( 0.5 ) * 1e3 );
+		std::printf ( "Batch.Step.Ms.P99        = %.4f\n",  percentile ( 0.99 ) * 1e3 );
+		std::printf ( "Batch.Step.Ms.Max        = %.4f\n",  percentile ( 1.0 ) * 1e3 );
+		std::printf ( "Batch.Ns.PerParticleStep = %.3f\n",  particleSteps > 0.0 ? runSeconds * 1e9 / particleSteps : 0.0 );
+		std::printf ( "Batch.State.Path         = %s\n",    statePath.c_str () );
+		std::fflush ( stdout );
+
+		// Add the per-system timings if the profiler ran, and write its trace if one was recorded.
+
+		batch.writeProfile ( std::cout );
+
+		std::string tracePath = settings.getString ( "ECS.Profiler.Trace.Path" );
+
+		if ( !tracePath.empty () && !batch.writeTrace () )
+		{
+			throw std::runtime_error ( "Cannot write trace file: " + tracePath );
+		}
+	}
+	catch ( const std::exception& e )
+	{
+		std::cerr << "Fatal error: " << e.what () << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
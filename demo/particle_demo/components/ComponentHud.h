@@ -29,7 +29,8 @@
 //   An ECS component that stores the visibility flag, text content, font properties, foreground and background
 //   colors, and screen position for a heads-up display overlay.
 //
-//   The SystemRenderer uses these properties to draw diagnostic text for the selected particle.
+//   The SystemRenderer uses these properties to draw diagnostic text for the selected particle, and the per-system
+//   timings while profilerVisible is set.
 //
 //*********************************************************************************************************************
 
@@ -40,15 +41,16 @@ struct ComponentHud
 	//=================================================================================================================
 
 	std::string  text;
-	std::string  font        = "Courier New";
-	engine::Vector2D position    = { 10.0, 10.0 };
-	bool         visible     = false;
-	int          fontSize    = 14;
-	int          colorR      = 0;
-	int          colorG      = 255;
-	int          colorB      = 0;
-	int          backgroundR = 0;
-	int          backgroundG = 0;
-	int          backgroundB = 0;
+	std::string  font            = "Courier New";
+	engine::Vector2D position        = { 10.0, 10.0 };
+	bool         visible         = false;
+	bool         profilerVisible = false;
+	int          fontSize        = 14;
+	int          colorR          = 0;
+	int          colorG          = 255;
+	int          colorB          = 0;
+	int          backgroundR     = 0;
+	int          backgroundG     = 0;
+	int          backgroundB     = 0;
 
 };
@@ -0,0 +1,101 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS Game Engine - Particle Simulator
+// Version: 1.0
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the ComponentNeighbourList struct, an ECS component on the world entity that holds the particle
+//   neighbour list shared by SystemRepulsion and SystemCollider.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "../../../ecs/Entity.h"
+#include "../../../ecs/Span.h"
+#include "../../../engine/spatial/NeighbourList.h"
+
+#include <algorithm>
+#include <vector>
+
+//*********************************************************************************************************************
+// Struct: ComponentNeighbourList
+//
+// Description:
+//
+//   An ECS component that stores the Verlet neighbour list of all particle pairs within repulsion range plus a
+//   skin, and the particle entities it was built for, in system iteration order.
+//
+//   Each particle reaches twice its radius, so a pair is listed while closer than twice their combined radii, the
+//   repulsion cutoff. Contact range is half that, so the collider uses the same list.
+//
+//*********************************************************************************************************************
+
+struct ComponentNeighbourList
+{
+	//=================================================================================================================
+	// Constants
+	//=================================================================================================================
+
+	static constexpr double REACH_PER_RADIUS = 2.0;
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	engine::NeighbourList     pairs;
+	std::vector <ecs::Entity> members;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+// Function: updateNeighbourList
+//
+// Description:
+//
+//   Bring a neighbour list up to date for a system's particles, rebuilding it if the particles differ from the ones
+//   it was built for or any has moved more than half the skin.
+//
+// Arguments:
+//
+//   neighbourList (ComponentNeighbourList&):
+//     The shared neighbour list.
+//
+//   particles (ecs::Span <const ecs::Entity>):
+//     The system's particles. Point i of the list is particles [ i ].
+//
+//   position (Position&&):
+//     Callable taking a particle index and returning its position as an engine::Vector2D.
+//
+//   radius (Radius&&):
+//     Callable taking a particle index and returning its radius.
+//
+// Returns:
+//
+//   True if the list was rebuilt.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+template <typename Position, typename Radius>
+bool updateNeighbourList ( ComponentNeighbourList& neighbourList, ecs::Span <const ecs::Entity> particles, Position&& position, Radius&& radius )
+{
+	auto& members = neighbourList.members;
+
+	if ( !std::equal ( particles.begin (), particles.end (), members.begin (), members.end () ) )
+	{
+		members.assign ( particles.begin (), particles.end () );
+		neighbourList.pairs.invalidate ();
+	}
+
+	return neighbourList.pairs.update
+	(
+		particles.size (),
+		position,
+		[ & ] ( std::size_t i ) { return ComponentNeighbourList::REACH_PER_RADIUS * radius ( i ); }
+	);
+}
@@ -6,8 +6,8 @@
 //
 // Description:
 //
-//   Defines the ComponentParticleGroup struct, an ECS component that links an individual particle entity to its
-//   group template entity.
+//   Defines the ComponentParticleGroup struct, an ECS component that records which particle group a particle was
+//   created from.
 //
 // TODO:
 //
@@ -17,17 +17,15 @@
 
 #pragma once
 
-#include "../../../ecs/Entity.h"
-
 //*********************************************************************************************************************
 // Struct: ComponentParticleGroup
 //
 // Description:
 //
-//   An ECS component that associates an individual particle entity with its group template entity.
+//   An ECS component that associates an individual particle entity with its particle group.
 //
-//   The SystemParticleGroupPropagator uses this reference to copy shared configuration from the group down to each
-//   member particle.
+//   The group index selects the prefab the particle was instantiated from, which holds the group's original sprite
+//   and trail values.
 //
 //*********************************************************************************************************************
 
@@ -37,5 +35,5 @@ struct ComponentParticleGroup
 	// Data Members
 	//=================================================================================================================
 
-	ecs::Entity groupEntity = ecs::NULL_ENTITY;
+	int groupIndex = 0;
 };
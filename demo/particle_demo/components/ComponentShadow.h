@@ -30,6 +30,8 @@
 //
 //   The SystemRenderer draws the shadow beneath each particle sprite using these properties.
 //
+//   Registered as a shared component; particles hold an ecs::Shared <ComponentShadow> handle.
+//
 //*********************************************************************************************************************
 
 struct ComponentShadow
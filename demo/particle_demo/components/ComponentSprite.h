@@ -30,6 +30,9 @@
 //
 //   The SystemRenderer uses these properties to draw particle sprites at the correct size and transparency.
 //
+//   Registered as a shared component; particles hold an ecs::Shared <ComponentSprite> handle, and the renderer
+//   draws all particles that reference the same sprite together.
+//
 //*********************************************************************************************************************
 
 struct ComponentSprite
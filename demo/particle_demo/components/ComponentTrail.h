@@ -6,8 +6,7 @@
 //
 // Description:
 //
-//   Defines the ComponentTrail struct, an ECS component that stores motion trail rendering history and visual
-//   properties for a particle entity.
+//   Defines the ComponentTrail struct, an ECS component that stores the motion trail history of a particle entity.
 //
 // TODO:
 //
@@ -18,18 +17,18 @@
 #pragma once
 
 #include "../../../engine/math/Vector2D.h"
-
-#include <deque>
+#include "../../../engine/RingBuffer.h"
 
 //*********************************************************************************************************************
 // Struct: ComponentTrail
 //
 // Description:
 //
-//   An ECS component that maintains a bounded deque of historical positions and stores trail rendering properties
-//   including color, opacity gradient, depth limit, and line thickness.
+//   An ECS component that maintains a bounded ring buffer of historical positions.
 //
-//   The SystemPhysics records positions and the SystemRenderer draws the trail.
+//   The SystemPhysics records positions and the SystemRenderer draws the trail. The depth limit and drawing style
+//   come from the particle's shared ComponentTrailStyle. The ring holds exactly depth positions, allocated once when
+//   the depth is first applied, so a full trail records each new position by overwriting its oldest.
 //
 //*********************************************************************************************************************
 
@@ -39,13 +38,5 @@ struct ComponentTrail
 	// Data Members
 	//=================================================================================================================
 
-	std::deque <engine::Vector2D> history;
-
-	int    depth       = 500;
-	int    colorR      = 64;
-	int    colorG      = 64;
-	int    colorB      = 64;
-	double opacityTail = 0.0;
-	double opacityHead = 0.5;
-	int    thickness   = 4;
+	engine::RingBuffer <engine::Vector2D> history;
 };
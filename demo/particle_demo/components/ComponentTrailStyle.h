@@ -0,0 +1,47 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS Game Engine - Particle Simulator
+// Version: 1.0
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the ComponentTrailStyle struct, a shared ECS component that stores the motion trail properties common to
+//   every particle in a group.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+//*********************************************************************************************************************
+// Struct: ComponentTrailStyle
+//
+// Description:
+//
+//   An ECS component that stores trail rendering properties including color, opacity gradient, depth limit, and line
+//   thickness.
+//
+//   Registered as a shared component; particles hold an ecs::Shared <ComponentTrailStyle> handle. The SystemPhysics
+//   uses the depth to bound each ComponentTrail history and the SystemRenderer draws each group's trails with the
+//   style's color and thickness.
+//
+//*********************************************************************************************************************
+
+struct ComponentTrailStyle
+{
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	int    depth       = 500;
+	int    colorR      = 64;
+	int    colorG      = 64;
+	int    colorB      = 64;
+	double opacityTail = 0.0;
+	double opacityHead = 0.5;
+	int    thickness   = 4;
+};
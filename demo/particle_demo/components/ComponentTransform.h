@@ -7,7 +7,7 @@
 // Description:
 //
 //   Defines the ComponentTransform struct, an ECS component that stores spatial transform properties including
-//   origin, scale, rotation, and translation.
+//   origin, scale, rotation, and translation, and the translation before the latest simulation step.
 //
 // TODO:
 //
@@ -28,6 +28,9 @@
 //   An ECS component that stores the spatial transform of an entity in simulation space, including origin offset,
 //   scale factors, Euler rotation angles, and translation position.
 //
+//   previousTranslation holds the translation at the start of the latest simulation step, so the renderer can draw
+//   the particle between its last two positions.
+//
 //*********************************************************************************************************************
 
 struct ComponentTransform
@@ -40,4 +43,6 @@ struct ComponentTransform
 	engine::Vector2D scale       = { 1.0, 1.0 };
 	engine::Vector3D rotation    = { 0.0, 0.0, 0.0 };
 	engine::Vector2D translation = { 0.0, 0.0 };
+
+	engine::Vector2D previousTranslation = { 0.0, 0.0 };
 };
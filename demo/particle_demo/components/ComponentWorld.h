@@ -23,8 +23,9 @@
 // Description:
 //
 //   An ECS component that stores global simulation configuration on a singleton world entity, including per-group
-//   particle counts, gravitational and repulsive force constants, pause state, and boolean toggles for trails,
-//   gravity, repulsion, friction, and elasticity.
+//   particle counts, gravitational and repulsive force constants, pause state, boolean toggles for trails,
+//   gravity, repulsion, friction, and elasticity, the gravity solver with its Barnes-Hut opening angle, and whether
+//   gravity and repulsion are evaluated separately or by the fused SystemPairForces kernel.
 //
 //*********************************************************************************************************************
 
@@ -46,4 +47,7 @@ struct ComponentWorld
 	bool   repulsionEnabled      = true;
 	bool   frictionEnabled       = true;
 	bool   elasticityEnabled     = true;
+	bool   barnesHutEnabled      = false;
+	double barnesHutTheta        = 0.5;
+	bool   fusedForcesEnabled    = false;
 };
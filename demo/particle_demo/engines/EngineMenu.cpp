@@ -453,6 +453,7 @@ void EngineMenu::initialize ()
 	// Wire up the menu renderer with the SDL renderer, entity lists, font paths, and visual settings so it can draw
 	// buttons, text boxes, and backgrounds each frame.
 
+	systemMenuRenderer->render           = true;
 	systemMenuRenderer->renderer         = &sdlRenderer;
 	systemMenuRenderer->settings         = &settings;
 	systemMenuRenderer->screenWidth      = screenWidth;
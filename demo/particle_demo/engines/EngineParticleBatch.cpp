@@ -0,0 +1,181 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS Game Engine - Particle Simulator
+// Version: 1.0
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Compilation unit for the EngineParticleBatch class.
+//
+//   Implements construction, world initialization, and writing the final particle state and system timings.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "EngineParticleBatch.h"
+
+#include "../components/ComponentParticleGroup.h"
+#include "../components/ComponentPhysics.h"
+#include "../components/ComponentTransform.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+
+//=====================================================================================================================
+// Constructors
+//=====================================================================================================================
+
+//---------------------------------------------------------------------------------------------------------------------
+// Constructor 1/1: EngineParticleBatch
+//
+// Description:
+//
+//   Construct the batch engine and build the simulation's world from application settings.
+//
+// Arguments:
+//
+//   settings (engine::ApplicationSettings&):
+//     Reference to the application settings for reading simulation configuration.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+EngineParticleBatch::EngineParticleBatch ( engine::ApplicationSettings& settings )
+	: settings   ( settings )
+	, simulation ( world, settings )
+{
+	initialize ();
+}
+
+//=====================================================================================================================
+// Methods
+//=====================================================================================================================
+
+//---------------------------------------------------------------------------------------------------------------------
+// Method: writeState
+//
+// Description:
+//
+//   Write every particle's group, position, and velocity as CSV, one row per particle in creation order, with
+//   values printed to full double precision.
+//
+// Arguments:
+//
+//   out (std::ostream&):
+//     The stream to write to.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void EngineParticleBatch::writeState ( std::ostream& out )
+{
+	auto precision = out.precision ( std::numeric_limits <double>::max_digits10 );
+
+	out << "entity,group,x,y,vx,vy\n";
+
+	for ( ecs::Entity particle : simulation.particleEntities )
+	{
+		const auto& translation = world.getComponent <ComponentTransform> ( particle ).translation;
+		const auto& velocity    = world.getComponent <ComponentPhysics>   ( particle ).velocity;
+
+		out << particle                                                          << ','
+		    << world.getComponent <ComponentParticleGroup> ( particle ).groupIndex << ','
+		    << translation.x                                                     << ','
+		    << translation.y                                                     << ','
+		    << velocity.x                                                        << ','
+		    << velocity.y                                                        << '\n';
+	}
+
+	out.precision ( precision );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Method: writeProfile
+//
+// Description:
+//
+//   Write each simulation system's timings in the settings file's "key = value" form. Systems that have not been
+//   timed are left out.
+//
+// Arguments:
+//
+//   out (std::ostream&):
+//     The stream to write to.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void EngineParticleBatch::writeProfile ( std::ostream& out ) const
+{
+	const ecs::System* systems [] =
+	{
+		simulation.systemGravity.get (),
+		simulation.systemRepulsion.get (),
+		simulation.systemPairForces.get (),
+		simulation.systemForceAccumulator.get (),
+		simulation.systemPhysics.get (),
+		simulation.systemCollider.get ()
+	};
+
+	auto flags     = out.flags ();
+	auto precision = out.precision ( 4 );
+
+	out.setf ( std::ios::fixed, std::ios::floatfield );
+
+	for ( const ecs::System* system : systems )
+	{
+		const ecs::SystemProfile& profile = system->profile;
+
+		if ( profile.getSampleCount () == 0 ) continue;
+
+		std::string key = "Batch.System." + system->name;
+
+		out << key << ".Entities = " << profile.getEntityCount ()              << "\n";
+		out << key << ".Ms.Min   = " << profile.getMinimum () * 1e3            << "\n";
+		out << key << ".Ms.Avg   = " << profile.getAverage () * 1e3            << "\n";
+		out << key << ".Ms.P99   = " << profile.getPercentile ( 0.99 ) * 1e3   << "\n";
+	}
+
+	out.flags ( flags );
+	out.precision ( precision );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Method: initialize
+//
+// Description:
+//
+//   Start the job system, select the fixed step, and build and configure the simulation.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void EngineParticleBatch::initialize ()
+{
+	// Start the worker threads the per-particle systems split their work across.
+
+	jobSystem = std::make_unique <engine::JobSystem> ( static_cast <std::size_t> ( std::max ( 0, settings.getInt ( "ECS.Worker.Threads" ) ) ) );
+
+	// A batch always steps by the fixed step, whatever Engine.Step.Mode says, so its result does not depend on how
+	// fast the machine runs it.
+
+	setFixedStep ( 1.0 / settings.getDouble ( "Engine.Step.Rate" ), settings.getInt ( "Engine.Step.MaxPerFrame" ) );
+
+	// Build the world with the default particle counts.
+
+	simulation.registerSystems ();
+
+	simulation.createWorld
+	(
+		{
+			settings.getInt ( "Particle.Count.Red.Default" ),
+			settings.getInt ( "Particle.Count.Green.Default" ),
+			settings.getInt ( "Particle.Count.Blue.Default" ),
+			settings.getInt ( "Particle.Count.Yellow.Default" )
+		}
+	);
+
+	simulation.configureSystems ( jobSystem.get () );
+}
@@ -0,0 +1,174 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS Game Engine - Particle Simulator
+// Version: 1.0
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the EngineParticleBatch class, a headless Engine subclass that runs the particle simulation without a
+//   window, renderer, or keyboard, for batch runs and parameter sweeps.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "../../../engine/Engine.h"
+#include "../../../engine/ApplicationSettings.h"
+#include "ParticleSimulation.h"
+
+#include <cstddef>
+#include <ostream>
+
+//*********************************************************************************************************************
+// Class: EngineParticleBatch
+//
+// Description:
+//
+//   A headless Engine subclass that builds the particle simulation's world from application settings, exactly as
+//   EngineParticleSimulator does but without a renderer or HUD, and steps it with the fixed step at Engine.Step.Rate.
+//
+//   The particle counts are the Particle.Count.*.Default settings. Steps run back to back through Engine::runSteps,
+//   with no frame pacing, and nothing in this class depends on SDL.
+//
+//*********************************************************************************************************************
+
+class EngineParticleBatch : public engine::Engine
+{
+private:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	engine::ApplicationSettings& settings;
+	ParticleSimulation           simulation;
+
+public:
+
+	//=================================================================================================================
+	// Accessors
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Accessor: getParticleCount
+	//
+	// Description:
+	//
+	//   Return the number of particles in the simulation.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::size_t getParticleCount () const
+	{
+		return simulation.particleEntities.size ();
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Accessor: getThreadCount
+	//
+	// Description:
+	//
+	//   Return the number of threads the simulation systems run on, counting the calling thread.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::size_t getThreadCount () const
+	{
+		return jobSystem->getThreadCount ();
+	}
+
+	//=================================================================================================================
+	// Constructors
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Constructor 1/1: EngineParticleBatch
+	//
+	// Description:
+	//
+	//   Construct the batch engine and build the simulation's world from application settings.
+	//
+	// Arguments:
+	//
+	//   settings (engine::ApplicationSettings&):
+	//     Reference to the application settings for reading simulation configuration.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	explicit EngineParticleBatch ( engine::ApplicationSettings& settings );
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: writeState
+	//
+	// Description:
+	//
+	//   Write every particle's group, position, and velocity as CSV, one row per particle in creation order, with
+	//   values printed to full double precision.
+	//
+	// Arguments:
+	//
+	//   out (std::ostream&):
+	//     The stream to write to.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void writeState ( std::ostream& out );
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: writeProfile
+	//
+	// Description:
+	//
+	//   Write each simulation system's timings in the settings file's "key = value" form: the entity count of its
+	//   latest update, then its minimum, average, and 99th percentile update times in milliseconds over the
+	//   profiler's window of the latest steps. Systems that have not been timed are left out.
+	//
+	// Arguments:
+	//
+	//   out (std::ostream&):
+	//     The stream to write to.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void writeProfile ( std::ostream& out ) const;
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: writeTrace
+	//
+	// Description:
+	//
+	//   Write the profiler's trace to ECS.Profiler.Trace.Path, if a path is set.
+	//
+	// Returns:
+	//
+	//   True if the trace was written.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	bool writeTrace ()
+	{
+		return simulation.writeTrace ();
+	}
+
+private:
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: initialize
+	//
+	// Description:
+	//
+	//   Start the job system, select the fixed step, and build and configure the simulation.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void initialize ();
+};
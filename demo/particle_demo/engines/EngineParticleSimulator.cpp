@@ -19,28 +19,20 @@
 
 #include "EngineParticleSimulator.h"
 
-#include "../../../engine/math/GMath.h"
 #include "../components/ComponentWorld.h"
-#include "../components/ComponentBackgroundImage.h"
 #include "../components/ComponentParticleGroup.h"
 #include "../components/ComponentSprite.h"
-#include "../components/ComponentShadow.h"
 #include "../components/ComponentCircle.h"
-#include "../components/ComponentPhysics.h"
-#include "../components/ComponentTransform.h"
-#include "../components/ComponentTrail.h"
-#include "../components/ComponentProjection2D.h"
+#include "../components/ComponentTrailStyle.h"
 #include "../components/ComponentUserControl.h"
 #include "../components/ComponentHud.h"
 
-#include "../systems/SystemParticleGroupPropagator.h"
-#include "../systems/SystemGravity.h"
-#include "../systems/SystemRepulsion.h"
-#include "../systems/SystemForceAccumulator.h"
-#include "../systems/SystemPhysics.h"
-#include "../systems/SystemCollider.h"
 #include "../systems/SystemRenderer.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <memory>
 #include <string>
 
 //=====================================================================================================================
@@ -88,11 +80,33 @@ EngineParticleSimulator::EngineParticleSimulator
 	, window      ( window )
 	, sdlRenderer ( sdlRenderer )
 	, keyboard    ( keyboard )
+	, simulation  ( world, settings )
 {
 	resourcePath = settings.getString ( "Application.Resource.Path" );
 	initialize ();
 }
 
+//=====================================================================================================================
+// Destructor
+//=====================================================================================================================
+
+//---------------------------------------------------------------------------------------------------------------------
+// Destructor: ~EngineParticleSimulator
+//
+// Description:
+//
+//   Write the profiler's trace, if one was recorded, when the simulation ends.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+EngineParticleSimulator::~EngineParticleSimulator ()
+{
+	if ( world.getProfiler ().isTracing () && !simulation.writeTrace () )
+	{
+		std::cerr << "Cannot write trace file: " << settings.getString ( "ECS.Profiler.Trace.Path" ) << std::endl;
+	}
+}
+
 //=====================================================================================================================
 // Methods
 //=====================================================================================================================
@@ -148,7 +162,7 @@ void EngineParticleSimulator::processInput ()
 //
 //   Process keyboard input for simulation controls including Escape (deselect or exit),
 //   Tab (cycle particle selection), arrow keys (accelerate selected particle), P (toggle pause), T (toggle trails),
-//   and W (toggle wireframe).
+//   F (toggle the system timings), and W (toggle wireframe).
 //
 //---------------------------------------------------------------------------------------------------------------------
 
@@ -166,11 +180,7 @@ void EngineParticleSimulator::handleKeyboardCommands ()
 			{
 				// Remove the user control component from the selected particle and clear the selection.
 
-				if ( selectedParticle != ecs::NULL_ENTITY && world.hasComponent <ComponentUserControl> ( selectedParticle ) )
-				{
-					world.removeComponent <ComponentUserControl> ( selectedParticle );
-				}
-				selectedParticle = ecs::NULL_ENTITY;
+				deselectParticle ();
 
 				// Hide the HUD overlay since no particle is selected.
 
@@ -200,40 +210,39 @@ void EngineParticleSimulator::handleKeyboardCommands ()
 
 		commandManager.post ( [ this, shiftDown ] ()
 		{
-			if ( particleEntities.empty () ) return;
+			if ( simulation.particleEntities.empty () ) return;
 
 			// Remove ComponentUserControl from current selection.
 
-			if ( selectedParticle != ecs::NULL_ENTITY && world.hasComponent <ComponentUserControl> ( selectedParticle ) )
-			{
-				world.removeComponent <ComponentUserControl> ( selectedParticle );
-			}
+			ecs::Entity previousParticle = selectedParticle;
+
+			deselectParticle ();
 
 			// Find next/previous.
 
-			if ( selectedParticle == ecs::NULL_ENTITY )
+			if ( previousParticle == ecs::NULL_ENTITY )
 			{
-				selectedParticle = particleEntities [ 0 ];
+				selectedParticle = simulation.particleEntities [ 0 ];
 			}
 			else
 			{
 				// Locate the currently selected particle in the entity list and cycle to the next or previous.
 
-				for ( std::size_t i = 0; i < particleEntities.size (); ++i )
+				for ( std::size_t i = 0; i < simulation.particleEntities.size (); ++i )
 				{
 					// Check if this entity matches the current selection.
 
-					if ( particleEntities [ i ] == selectedParticle )
+					if ( simulation.particleEntities [ i ] == previousParticle )
 					{
 						// Shift+Tab selects the previous particle, Tab selects the next, wrapping around at boundaries.
 
 						if ( shiftDown )
 						{
-							selectedParticle = ( i > 0 ) ? particleEntities [ i - 1 ] : particleEntities.back ();
+							selectedParticle = ( i > 0 ) ? simulation.particleEntities [ i - 1 ] : simulation.particleEntities.back ();
 						}
 						else
 						{
-							selectedParticle = ( i < particleEntities.size () - 1 ) ? particleEntities [ i + 1 ] : particleEntities [ 0 ];
+							selectedParticle = ( i < simulation.particleEntities.size () - 1 ) ? simulation.particleEntities [ i + 1 ] : simulation.particleEntities [ 0 ];
 						}
 						break;
 					}
@@ -247,25 +256,10 @@ void EngineParticleSimulator::handleKeyboardCommands ()
 			uc.accelerationMagnitude = acceleration;
 			world.addComponent ( selectedParticle, uc );
 
-			// Update sprite to selected sprite.
-
-			auto& sprite = world.getComponent <ComponentSprite> ( selectedParticle );
-			sprite.imagePath = resourcePath + settings.getString ( "Sprite.Selected" );
-
-			// Update trail color to selected trail color.
-
-			auto& trail = world.getComponent <ComponentTrail> ( selectedParticle );
-			std::string selTrailColorStr = settings.getString ( "Trail.Color.Selected" );
+			// Point the particle at the shared selected sprite and selected trail style.
 
-			// Parse "r,g,b".
-
-			int r = 128, g = 128, b = 128;
-			if ( sscanf ( selTrailColorStr.c_str (), "%d,%d,%d", &r, &g, &b ) == 3 )
-			{
-				trail.colorR = r;
-				trail.colorG = g;
-				trail.colorB = b;
-			}
+			world.getComponent <ecs::Shared <ComponentSprite>>     ( selectedParticle ) = simulation.selectedSprite;
+			world.getComponent <ecs::Shared <ComponentTrailStyle>> ( selectedParticle ) = simulation.selectedTrailStyle;
 
 			// Show HUD.
 
@@ -295,7 +289,7 @@ void EngineParticleSimulator::handleKeyboardCommands ()
 	{
 		commandManager.post ( [ this ] ()
 		{
-			auto& componentWorld     = world.getComponent <ComponentWorld> ( worldEntity );
+			auto& componentWorld     = world.getComponent <ComponentWorld> ( simulation.worldEntity );
 			componentWorld.paused    = !componentWorld.paused;
 		} );
 	}
@@ -306,11 +300,30 @@ void EngineParticleSimulator::handleKeyboardCommands ()
 	{
 		commandManager.post ( [ this ] ()
 		{
-			auto& componentWorld           = world.getComponent <ComponentWorld> ( worldEntity );
+			auto& componentWorld           = world.getComponent <ComponentWorld> ( simulation.worldEntity );
 			componentWorld.trailsVisible   = !componentWorld.trailsVisible;
 		} );
 	}
 
+	// F: Show or hide the per-system timings on the HUD. Timing runs only while they are shown, unless a trace is
+	// being recorded.
+
+	if ( keyboard.isKeyPressed ( SDL_SCANCODE_F ) )
+	{
+		commandManager.post
+		(
+			[ this ] ()
+			{
+				auto& hud      = world.getComponent <ComponentHud> ( hudEntity );
+				auto& profiler = world.getProfiler ();
+
+				hud.profilerVisible = !hud.profilerVisible;
+
+				if ( !profiler.isTracing () ) profiler.setEnabled ( hud.profilerVisible );
+			}
+		);
+	}
+
 	// W: Toggle wireframe.
 
 	if ( keyboard.isKeyPressed ( SDL_SCANCODE_W ) )
@@ -321,7 +334,7 @@ void EngineParticleSimulator::handleKeyboardCommands ()
 			{
 				// Toggle wireframe visibility on all particles.
 
-				for ( auto entity : particleEntities )
+				for ( auto entity : simulation.particleEntities )
 				{
 					auto& circle    = world.getComponent <ComponentCircle> ( entity );
 					circle.visible  = !circle.visible;
@@ -332,257 +345,105 @@ void EngineParticleSimulator::handleKeyboardCommands ()
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-// Method: initialize
+// Method: deselectParticle
 //
 // Description:
 //
-//   Register all ECS component types and systems, create particle group entities, individual particle entities, and
-//   the HUD entity, then configure system references from application settings.
+//   Remove user control from the selected particle, restore its group's sprite and trail style handles from the
+//   group prefab, and clear the selection.
 //
 //---------------------------------------------------------------------------------------------------------------------
 
-void EngineParticleSimulator::initialize ()
+void EngineParticleSimulator::deselectParticle ()
 {
-	// Read screen dimensions from application settings for coordinate conversions and renderer configuration.
+	if ( selectedParticle == ecs::NULL_ENTITY || !world.isAlive ( selectedParticle ) )
+	{
+		selectedParticle = ecs::NULL_ENTITY;
+		return;
+	}
 
-	int screenWidth  = settings.getInt ( "Application.Screen.Width" );
-	int screenHeight = settings.getInt ( "Application.Screen.Height" );
+	if ( world.hasComponent <ComponentUserControl> ( selectedParticle ) )
+	{
+		world.removeComponent <ComponentUserControl> ( selectedParticle );
+	}
 
-	// Register all ECS component types used by the particle simulation with the world.
+	// Restore the values that selection overrides from the particle's group prefab.
 
-	world.registerComponent <ComponentWorld>           ();
-	world.registerComponent <ComponentBackgroundImage> ();
-	world.registerComponent <ComponentParticleGroup>   ();
-	world.registerComponent <ComponentSprite>          ();
-	world.registerComponent <ComponentShadow>          ();
-	world.registerComponent <ComponentCircle>          ();
-	world.registerComponent <ComponentPhysics>         ();
-	world.registerComponent <ComponentTransform>       ();
-	world.registerComponent <ComponentTrail>           ();
-	world.registerComponent <ComponentProjection2D>    ();
-	world.registerComponent <ComponentUserControl>     ();
-	world.registerComponent <ComponentHud>             ();
+	int groupIndex = world.getComponent <ComponentParticleGroup> ( selectedParticle ).groupIndex;
 
-	// Build the particle component signature and register all simulation systems in execution order. Each system
-	// receives the same signature so it operates on entities that have the full set of particle components.
+	if ( groupIndex >= 0 && groupIndex < static_cast <int> ( simulation.particlePrefabs.size () ) )
+	{
+		using SharedSprite     = ecs::Shared <ComponentSprite>;
+		using SharedTrailStyle = ecs::Shared <ComponentTrailStyle>;
 
-	auto particleSignature             = world.makeSignature <ComponentParticleGroup, ComponentSprite, ComponentShadow, ComponentCircle, ComponentPhysics, ComponentTransform, ComponentTrail, ComponentProjection2D> ();
-	auto systemParticleGroupPropagator = world.registerSystem <SystemParticleGroupPropagator> ( "ParticleGroupPropagator", particleSignature );
-	auto systemGravity                 = world.registerSystem <SystemGravity>                 ( "Gravity",                 particleSignature );
-	auto systemRepulsion               = world.registerSystem <SystemRepulsion>               ( "Repulsion",               particleSignature );
-	auto systemForceAccumulator        = world.registerSystem <SystemForceAccumulator>        ( "ForceAccumulator",        particleSignature );
-	auto systemPhysics                 = world.registerSystem <SystemPhysics>                 ( "Physics",                 particleSignature );
-	auto systemCollider                = world.registerSystem <SystemCollider>                ( "Collider",                particleSignature );
-	auto systemRenderer                = world.registerSystem <SystemRenderer>                ( "Renderer",                particleSignature );
+		ecs::Prefab& prefab = simulation.particlePrefabs [ groupIndex ];
 
-	// Create the world entity.
+		world.getComponent <SharedSprite>     ( selectedParticle ) = world.getPrefabComponent <SharedSprite>     ( prefab );
+		world.getComponent <SharedTrailStyle> ( selectedParticle ) = world.getPrefabComponent <SharedTrailStyle> ( prefab );
+	}
 
-	worldEntity = world.createEntity ();
+	selectedParticle = ecs::NULL_ENTITY;
+}
 
-	ComponentWorld componentWorld;
+//---------------------------------------------------------------------------------------------------------------------
+// Method: initialize
+//
+// Description:
+//
+//   Register all ECS component types and systems, create a prefab per particle group, instantiate the particles and
+//   the HUD entity, then configure system references from application settings.
+//
+//---------------------------------------------------------------------------------------------------------------------
 
-	componentWorld.particleCountRed      = globalCache.get <int> ( "particleCountRed" );
-	componentWorld.particleCountGreen    = globalCache.get <int> ( "particleCountGreen" );
-	componentWorld.particleCountBlue     = globalCache.get <int> ( "particleCountBlue" );
-	componentWorld.particleCountYellow   = globalCache.get <int> ( "particleCountYellow" );
-	componentWorld.gravitationalConstant = settings.getDouble    ( "Physics.Gravity.Constant" );
-	componentWorld.repulsiveConstant     = settings.getDouble    ( "Physics.Repulsion.Constant" );
-	componentWorld.gravityEnabled        = settings.getBool      ( "Physics.Gravity.Enabled" );
-	componentWorld.repulsionEnabled      = settings.getBool      ( "Physics.Repulsion.Enabled" );
-	componentWorld.frictionEnabled       = settings.getBool      ( "Physics.Friction.Enabled" );
-	componentWorld.elasticityEnabled     = settings.getBool      ( "Physics.Elasticity.Enabled" );
-	componentWorld.trailsVisible         = settings.getBool      ( "Trail.Visible" );
+void EngineParticleSimulator::initialize ()
+{
+	// Read screen dimensions from application settings for coordinate conversions and renderer configuration.
 
-	world.addComponent ( worldEntity, componentWorld );
+	int screenWidth  = settings.getInt ( "Application.Screen.Width" );
+	int screenHeight = settings.getInt ( "Application.Screen.Height" );
 
-	// Create background image entity.
+	// Start the worker threads the per-particle systems split their work across.
 
-	ComponentBackgroundImage componentBackgroundImage;
+	jobSystem = std::make_unique <engine::JobSystem> ( static_cast <std::size_t> ( std::max ( 0, settings.getInt ( "ECS.Worker.Threads" ) ) ) );
 
-	componentBackgroundImage.imagePath = resourcePath + settings.getString ( "Simulation.Background" );
+	// Select the simulation step and frame pacing. A fixed step keeps the physics independent of the frame rate.
 
-	world.addComponent ( worldEntity, componentBackgroundImage );
+	if ( settings.getString ( "Engine.Step.Mode" ) == "Fixed" )
+	{
+		setFixedStep ( 1.0 / settings.getDouble ( "Engine.Step.Rate" ), settings.getInt ( "Engine.Step.MaxPerFrame" ) );
+		setTimeScale ( settings.getDouble ( "Engine.Time.Scale" ) );
+	}
+	else
+	{
+		setVariableStep ();
+	}
 
-	// Load sprite/shadow paths.
+	setPrecisePacing ( settings.getString ( "Engine.Frame.Pacing" ) == "Precise" );
 
-	std::string spriteRed    = resourcePath + settings.getString ( "Sprite.Red" );
-	std::string spriteGreen  = resourcePath + settings.getString ( "Sprite.Green" );
-	std::string spriteBlue   = resourcePath + settings.getString ( "Sprite.Blue" );
-	std::string spriteYellow = resourcePath + settings.getString ( "Sprite.Yellow" );
-	std::string spriteShadow = resourcePath + settings.getString ( "Sprite.Shadow" );
+	// Register the components and simulation systems, then the renderer after them, before any entity exists.
 
-	// Define a local configuration struct and color-parsing helper for setting up the four particle groups.
+	simulation.registerSystems ();
 
-	struct GroupConfig
-	{
-		std::string sprite;
-		int         count;
-		double      mass;
-		double      radius;
-		int         trailR, trailG, trailB;
-	};
+	auto systemRenderer = world.registerSystem <SystemRenderer> ( "Renderer", simulation.particleSignature );
 
-	auto parseColor = [] ( const std::string& s, int& r, int& g, int& b )
-	{
-		sscanf ( s.c_str (), "%d,%d,%d", &r, &g, &b );
-	};
+	// Create the world entity and the particles, with the particle counts chosen in the menu.
 
-	// Load physics, trail, projection, wireframe, and shadow parameters from application settings.
-
-	double frictionCoefficient    = settings.getDouble ( "Physics.Friction.Coefficient" );
-	double elasticityCoefficient  = settings.getDouble ( "Physics.Elasticity.Coefficient" );
-	double projectionZoom         = settings.getDouble ( "Projection.Zoom" );
-	int    trailDepth             = settings.getInt    ( "Trail.Depth" );
-	double trailOpacityHead       = settings.getDouble ( "Trail.Opacity.Head" );
-	double trailOpacityTail       = settings.getDouble ( "Trail.Opacity.Tail" );
-	int    trailThickness         = settings.getInt    ( "Trail.Thickness" );
-	bool   wireframeVisible       = settings.getBool   ( "Wireframe.Visible" );
-	double shadowOffsetX          = settings.getDouble ( "Shadow.Offset.X" );
-	double shadowOffsetY          = settings.getDouble ( "Shadow.Offset.Y" );
-	double shadowOpacity          = settings.getDouble ( "Shadow.Opacity" );
-	double shadowScale            = settings.getDouble ( "Shadow.Scale" );
-	double velocityMin            = settings.getDouble ( "Initial.Velocity.Min" );
-	double velocityMax            = settings.getDouble ( "Initial.Velocity.Max" );
-
-	// Configure the four particle groups (red, green, blue, yellow) with their sprite, count, mass, radius, and
-	// trail color loaded from application settings and the global cache.
-
-	GroupConfig groups [ 4 ];
-
-	groups [ 0 ].sprite = spriteRed;
-	groups [ 0 ].count  = componentWorld.particleCountRed;
-	groups [ 0 ].mass   = settings.getDouble ( "Particle.Mass.Red" );
-	groups [ 0 ].radius = settings.getDouble ( "Particle.Radius.Red" );
-	parseColor ( settings.getString ( "Trail.Color.Red" ), groups [ 0 ].trailR, groups [ 0 ].trailG, groups [ 0 ].trailB );
-
-	groups [ 1 ].sprite = spriteGreen;
-	groups [ 1 ].count  = componentWorld.particleCountGreen;
-	groups [ 1 ].mass   = settings.getDouble ( "Particle.Mass.Green" );
-	groups [ 1 ].radius = settings.getDouble ( "Particle.Radius.Green" );
-	parseColor ( settings.getString ( "Trail.Color.Green" ), groups [ 1 ].trailR, groups [ 1 ].trailG, groups [ 1 ].trailB );
-
-	groups [ 2 ].sprite  = spriteBlue;
-	groups [ 2 ].count   = componentWorld.particleCountBlue;
-	groups [ 2 ].mass    = settings.getDouble ( "Particle.Mass.Blue" );
-	groups [ 2 ].radius  = settings.getDouble ( "Particle.Radius.Blue" );
-	parseColor ( settings.getString ( "Trail.Color.Blue" ), groups [ 2 ].trailR, groups [ 2 ].trailG, groups [ 2 ].trailB );
-
-	groups [ 3 ].sprite = spriteYellow;
-	groups [ 3 ].count  = componentWorld.particleCountYellow;
-	groups [ 3 ].mass   = settings.getDouble ( "Particle.Mass.Yellow" );
-	groups [ 3 ].radius = settings.getDouble ( "Particle.Radius.Yellow" );
-	parseColor ( settings.getString ( "Trail.Color.Yellow" ), groups [ 3 ].trailR, groups [ 3 ].trailG, groups [ 3 ].trailB );
-
-	// World bounds for random particle placement.
-
-	double worldWidth  = static_cast < double > ( screenWidth ) / static_cast< double >( screenHeight );
-	double worldHeight = 1.0;
-	double margin      = 0.05;
-
-	// Create particle group entities and individual particles.
-
-	for ( int g = 0; g < 4; ++g )
-	{
-		auto& groupConfiguration = groups [ g ];
-
-		// Create group entity (template for propagator).
-
-		ecs::Entity groupEntity = world.createEntity ();
-
-		ComponentSprite groupSprite;
-		groupSprite.imagePath = groupConfiguration.sprite;
-		world.addComponent ( groupEntity, groupSprite );
-
-		ComponentShadow groupShadow;
-		groupShadow.imagePath = spriteShadow;
-		groupShadow.offset    = { shadowOffsetX, shadowOffsetY };
-		groupShadow.opacity   = shadowOpacity;
-		groupShadow.scale     = shadowScale;
-		world.addComponent ( groupEntity, groupShadow );
-
-		ComponentCircle groupCircle;
-		groupCircle.radius  = groupConfiguration.radius;
-		groupCircle.visible = wireframeVisible;
-		world.addComponent ( groupEntity, groupCircle );
-
-		ComponentPhysics groupPhysics;
-		groupPhysics.mass                   = groupConfiguration.mass;
-		groupPhysics.frictionCoefficient    = frictionCoefficient;
-		groupPhysics.elasticityCoefficient  = elasticityCoefficient;
-		world.addComponent ( groupEntity, groupPhysics );
-
-		ComponentTrail groupTrail;
-		groupTrail.colorR      = groupConfiguration.trailR;
-		groupTrail.colorG      = groupConfiguration.trailG;
-		groupTrail.colorB      = groupConfiguration.trailB;
-		groupTrail.depth       = trailDepth;
-		groupTrail.opacityHead = trailOpacityHead;
-		groupTrail.opacityTail = trailOpacityTail;
-		groupTrail.thickness   = trailThickness;
-		world.addComponent ( groupEntity, groupTrail );
-
-		ComponentProjection2D groupProjection;
-		groupProjection.scale = { projectionZoom, projectionZoom };
-		world.addComponent ( groupEntity, groupProjection );
-
-		// Create individual particles.
-
-		for ( int p = 0; p < groupConfiguration.count; ++p )
+	simulation.createWorld
+	(
 		{
-			ecs::Entity particle = world.createEntity ();
-
-			ComponentParticleGroup pgc;
-			pgc.groupEntity = groupEntity;
-			world.addComponent ( particle, pgc );
-
-			ComponentSprite sprite;
-			sprite.imagePath = groupConfiguration.sprite;
-			world.addComponent ( particle, sprite );
-
-			ComponentShadow shadow;
-			shadow.imagePath = spriteShadow;
-			shadow.offset    = { shadowOffsetX, shadowOffsetY };
-			shadow.opacity   = shadowOpacity;
-			shadow.scale     = shadowScale;
-			world.addComponent ( particle, shadow );
-
-			ComponentCircle circle;
-			circle.radius  = groupConfiguration.radius;
-			circle.visible = wireframeVisible;
-			world.addComponent ( particle, circle );
-
-			ComponentPhysics physics;
-			physics.mass                   = groupConfiguration.mass;
-			physics.frictionCoefficient    = frictionCoefficient;
-			physics.elasticityCoefficient  = elasticityCoefficient;
-			physics.velocity.x             = engine::randomInRange ( -velocityMax, velocityMax );
-			physics.velocity.y             = engine::randomInRange ( -velocityMax, velocityMax );
-			world.addComponent ( particle, physics );
-
-			ComponentTransform transform;
-			transform.translation.x = engine::randomInRange ( margin, worldWidth - margin );
-			transform.translation.y = engine::randomInRange ( margin, worldHeight - margin );
-			world.addComponent ( particle, transform );
-
-			ComponentTrail trail;
-			trail.colorR      = groupConfiguration.trailR;
-			trail.colorG      = groupConfiguration.trailG;
-			trail.colorB      = groupConfiguration.trailB;
-			trail.depth       = trailDepth;
-			trail.opacityHead = trailOpacityHead;
-			trail.opacityTail = trailOpacityTail;
-			trail.thickness   = trailThickness;
-			world.addComponent ( particle, trail );
-
-			ComponentProjection2D projection;
-			projection.scale = { projectionZoom, projectionZoom };
-			world.addComponent ( particle, projection );
-
-			particleEntities.push_back ( particle );
+			globalCache.get <int> ( "particleCountRed" ),
+			globalCache.get <int> ( "particleCountGreen" ),
+			globalCache.get <int> ( "particleCountBlue" ),
+			globalCache.get <int> ( "particleCountYellow" )
 		}
-	}
+	);
 
-	// Create HUD entity.
+	// Create HUD entity, with its font color parsed from an "r,g,b" setting.
+
+	auto parseColor = [] ( const std::string& s, int& r, int& g, int& b )
+	{
+		sscanf ( s.c_str (), "%d,%d,%d", &r, &g, &b );
+	};
 
 	hudEntity = world.createEntity ();
 
@@ -597,42 +458,22 @@ void EngineParticleSimulator::initialize ()
 	hud.colorG = hudG;
 	hud.colorB = hudB;
 
-	hud.position.x = settings.getDouble ( "Hud.Position.X" );
-	hud.position.y = settings.getDouble ( "Hud.Position.Y" );
+	hud.position.x      = settings.getDouble ( "Hud.Position.X" );
+	hud.position.y      = settings.getDouble ( "Hud.Position.Y" );
+	hud.profilerVisible = settings.getBool   ( "ECS.Profiler.Enabled" );
 	world.addComponent ( hudEntity, hud );
 
-	// Configure the gravity system with the world entity and a softening epsilon to prevent numerical instability
-	// at very short inter-particle distances.
-
-	systemGravity->worldEntity      = worldEntity;
-	systemGravity->softeningEpsilon = settings.getDouble ( "Physics.Softening.Epsilon" );
-
-	// Configure the repulsion system with the world entity for reading the repulsive force constant.
-
-	systemRepulsion->worldEntity = worldEntity;
-
-	// Configure the force accumulator system with the world entity for reading the pause state.
-
-	systemForceAccumulator->worldEntity = worldEntity;
-
-	// Configure the physics system with the world entity and the anisotropic friction coefficient for
-	// directional drag.
-
-	systemPhysics->worldEntity         = worldEntity;
-	systemPhysics->anisotropicFriction = settings.getDouble ( "Physics.Friction.Anisotropic" );
-
-	// Configure the collider system with the world entity, iteration count for iterative collision resolution, and
-	// screen dimensions for boundary clamping.
+	// Configure the simulation systems to split their work across the job system.
 
-	systemCollider->worldEntity         = worldEntity;
-	systemCollider->collisionIterations = settings.getInt ( "Physics.Collision.Iterations" );
-	systemCollider->screenWidth         = screenWidth;
-	systemCollider->screenHeight        = screenHeight;
+	simulation.configureSystems ( jobSystem.get () );
 
 	// Configure the renderer system with the SDL renderer, world and HUD entities, screen dimensions, and font paths.
+	// As a render system it runs once per frame, after the simulation steps, and always on the main thread, which
+	// SDL requires.
 
+	systemRenderer->render        = true;
 	systemRenderer->renderer      = &sdlRenderer;
-	systemRenderer->worldEntity   = worldEntity;
+	systemRenderer->worldEntity   = simulation.worldEntity;
 	systemRenderer->hudEntity     = hudEntity;
 	systemRenderer->screenWidth   = screenWidth;
 	systemRenderer->screenHeight  = screenHeight;
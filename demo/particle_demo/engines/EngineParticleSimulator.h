@@ -23,6 +23,7 @@
 #include "../../../engine/platform/SDLWindow.h"
 #include "../../../engine/platform/SDLRenderer.h"
 #include "../../../engine/platform/SDLKeyboard.h"
+#include "ParticleSimulation.h"
 
 //*********************************************************************************************************************
 // Class: EngineParticleSimulator
@@ -31,9 +32,8 @@
 //
 //   A specialized Engine subclass that sets up and runs the particle simulation.
 //
-//   Registers all component types and physics systems, creates particle group and individual particle entities from
-//   application settings, processes keyboard input for particle selection and simulation controls, and presents
-//   frames via SDL.
+//   Builds the simulation's world from application settings through ParticleSimulation, adds the renderer and the
+//   HUD, processes keyboard input for particle selection and simulation controls, and presents frames via SDL.
 //
 //*********************************************************************************************************************
 
@@ -50,12 +50,11 @@ private:
 	engine::SDLWindow&           window;
 	engine::SDLRenderer&         sdlRenderer;
 	engine::SDLKeyboard&         keyboard;
-	ecs::Entity worldEntity      = ecs::NULL_ENTITY;
+	ParticleSimulation           simulation;
 	ecs::Entity hudEntity        = ecs::NULL_ENTITY;
 	ecs::Entity selectedParticle = ecs::NULL_ENTITY;
 
-	std::vector <ecs::Entity> particleEntities;
-	std::string               resourcePath;
+	std::string resourcePath;
 
 	//=================================================================================================================
 	// Accessors
@@ -112,6 +111,21 @@ public:
 		engine::SDLKeyboard&         keyboard
 	);
 
+	//=================================================================================================================
+	// Destructor
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Destructor: ~EngineParticleSimulator
+	//
+	// Description:
+	//
+	//   Write the profiler's trace, if one was recorded, when the simulation ends.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	~EngineParticleSimulator () override;
+
 	//=================================================================================================================
 	// Methods
 	//=================================================================================================================
@@ -134,7 +148,7 @@ private:
 	//
 	// Description:
 	//
-	//   Register all ECS component types and systems, create particle group entities, individual particle entities,
+	//   Register all ECS component types and systems, create a prefab per particle group, instantiate the particles
 	//   and the HUD entity, then configure system references from application settings.
 	//
 	//-----------------------------------------------------------------------------------------------------------------
@@ -165,9 +179,22 @@ private:
 	//   - Arrow keys (accelerate selected particle)
 	//   - P (toggle pause)
 	//   - T (toggle trails)
+	//   - F (toggle the system timings)
 	//   - W (toggle wireframe).
 	//
 	//-----------------------------------------------------------------------------------------------------------------
 
 	void handleKeyboardCommands ();
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: deselectParticle
+	//
+	// Description:
+	//
+	//   Remove user control from the selected particle, restore its group's sprite and trail style handles from the
+	//   group prefab, and clear the selection.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void deselectParticle ();
 };
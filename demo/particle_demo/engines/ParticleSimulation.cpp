@@ -0,0 +1,490 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS Game Engine - Particle Simulator
+// Version: 1.0
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Compilation unit for the ParticleSimulation class.
+//
+//   Implements component and system registration, world entity and particle creation, and system configuration
+//   from application settings.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "ParticleSimulation.h"
+
+#include "../components/ComponentWorld.h"
+#include "../components/ComponentNeighbourList.h"
+#include "../components/ComponentBackgroundImage.h"
+#include "../components/ComponentParticleGroup.h"
+#include "../components/ComponentShadow.h"
+#include "../components/ComponentCircle.h"
+#include "../components/ComponentPhysics.h"
+#include "../components/ComponentTransform.h"
+#include "../components/ComponentTrail.h"
+#include "../components/ComponentProjection2D.h"
+#include "../components/ComponentUserControl.h"
+#include "../components/ComponentHud.h"
+
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+//=====================================================================================================================
+// Constructors
+//=====================================================================================================================
+
+//---------------------------------------------------------------------------------------------------------------------
+// Constructor 1/1: ParticleSimulation
+//
+// Description:
+//
+//   Bind the simulation to a world and the settings it is built from, and seed the placement generator.
+//
+// Arguments:
+//
+//   world (ecs::World&):
+//     The world to build the simulation in.
+//
+//   settings (const engine::ApplicationSettings&):
+//     The application settings to read the simulation configuration from.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+ParticleSimulation::ParticleSimulation ( ecs::World& world, const engine::ApplicationSettings& settings )
+	: world    ( world )
+	, settings ( settings )
+{
+	resourcePath = settings.getString ( "Application.Resource.Path" );
+
+	unsigned int seed = static_cast <unsigned int> ( settings.getInt ( "Initial.Seed" ) );
+
+	random.seed ( seed != 0 ? seed : std::random_device {} () );
+}
+
+//=====================================================================================================================
+// Methods
+//=====================================================================================================================
+
+//---------------------------------------------------------------------------------------------------------------------
+// Method: registerSystems
+//
+// Description:
+//
+//   Select the component storage backend, register the particle component types, and register the simulation
+//   systems in execution order with the particle signature.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void ParticleSimulation::registerSystems ()
+{
+	// Select the component storage backend before any entity exists.
+
+	if ( settings.getString ( "ECS.Storage.Mode" ) == "Archetype" )
+	{
+		world.setStorageMode ( ecs::StorageMode::Archetype );
+	}
+
+	// Register all ECS component types used by the particle simulation with the world.
+
+	world.registerComponent <ComponentWorld>           ();
+	world.registerComponent <ComponentBackgroundImage> ();
+	world.registerComponent <ComponentParticleGroup>   ();
+	world.registerComponent <ComponentCircle>          ();
+	world.registerComponent <ComponentPhysics>         ();
+	world.registerComponent <ComponentTransform>       ();
+	world.registerComponent <ComponentTrail>           ();
+	world.registerComponent <ComponentProjection2D>    ();
+	world.registerComponent <ComponentUserControl>     ();
+	world.registerComponent <ComponentHud>             ();
+	world.registerComponent <ComponentNeighbourList>   ();
+
+	// Register the shared components. Particles hold a handle to one value per group instead of their own copy.
+
+	world.registerSharedComponent <ComponentSprite>     ();
+	world.registerSharedComponent <ComponentShadow>     ();
+	world.registerSharedComponent <ComponentTrailStyle> ();
+
+	// Build the particle component signature and register all simulation systems in execution order. Each system
+	// receives the same signature so it operates on entities that have the full set of particle components.
+
+	particleSignature      = world.makeSignature <ComponentParticleGroup, ecs::Shared <ComponentSprite>, ecs::Shared <ComponentShadow>, ComponentCircle, ComponentPhysics, ComponentTransform, ComponentTrail, ecs::Shared <ComponentTrailStyle>, ComponentProjection2D> ();
+	systemGravity          = world.registerSystem <SystemGravity>          ( "Gravity",          particleSignature );
+	systemRepulsion        = world.registerSystem <SystemRepulsion>        ( "Repulsion",        particleSignature );
+	systemPairForces       = world.registerSystem <SystemPairForces>       ( "PairForces",       particleSignature );
+	systemForceAccumulator = world.registerSystem <SystemForceAccumulator> ( "ForceAccumulator", particleSignature );
+	systemPhysics          = world.registerSystem <SystemPhysics>          ( "Physics",          particleSignature );
+	systemCollider         = world.registerSystem <SystemCollider>         ( "Collider",         particleSignature );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Method: createWorld
+//
+// Description:
+//
+//   Create the world entity, then a prefab per particle group, and instantiate each group's particles at random
+//   positions with random velocities.
+//
+// Arguments:
+//
+//   counts (const std::array <int, 4>&):
+//     The number of red, green, blue, and yellow particles.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void ParticleSimulation::createWorld ( const std::array <int, 4>& counts )
+{
+	// Read screen dimensions from application settings for the world's aspect ratio.
+
+	int screenWidth  = settings.getInt ( "Application.Screen.Width" );
+	int screenHeight = settings.getInt ( "Application.Screen.Height" );
+
+	// Create the world entity.
+
+	worldEntity = world.createEntity ();
+
+	ComponentWorld componentWorld;
+
+	componentWorld.particleCountRed      = counts [ 0 ];
+	componentWorld.particleCountGreen    = counts [ 1 ];
+	componentWorld.particleCountBlue     = counts [ 2 ];
+	componentWorld.particleCountYellow   = counts [ 3 ];
+	componentWorld.gravitationalConstant = settings.getDouble ( "Physics.Gravity.Constant" );
+	componentWorld.repulsiveConstant     = settings.getDouble ( "Physics.Repulsion.Constant" );
+	componentWorld.gravityEnabled        = settings.getBool   ( "Physics.Gravity.Enabled" );
+	componentWorld.repulsionEnabled      = settings.getBool   ( "Physics.Repulsion.Enabled" );
+	componentWorld.frictionEnabled       = settings.getBool   ( "Physics.Friction.Enabled" );
+	componentWorld.elasticityEnabled     = settings.getBool   ( "Physics.Elasticity.Enabled" );
+	componentWorld.trailsVisible         = settings.getBool   ( "Trail.Visible" );
+	componentWorld.barnesHutEnabled      = settings.getString ( "Physics.Gravity.Solver" ) == "BarnesHut";
+	componentWorld.barnesHutTheta        = settings.getDouble ( "Physics.Gravity.Theta" );
+	componentWorld.fusedForcesEnabled    = settings.getString ( "Physics.Forces.Kernel" ) == "Fused" && !componentWorld.barnesHutEnabled;
+
+	world.addComponent ( worldEntity, componentWorld );
+
+	// Attach the particle neighbour list shared by the repulsion and collider systems.
+
+	ComponentNeighbourList componentNeighbourList;
+
+	componentNeighbourList.pairs.setSkin ( settings.getDouble ( "Physics.Neighbour.Skin" ) );
+
+	world.addComponent ( worldEntity, componentNeighbourList );
+
+	// Create background image entity.
+
+	ComponentBackgroundImage componentBackgroundImage;
+
+	componentBackgroundImage.imagePath = resourcePath + settings.getString ( "Simulation.Background" );
+
+	world.addComponent ( worldEntity, componentBackgroundImage );
+
+	// Load sprite/shadow paths.
+
+	std::string spriteRed    = resourcePath + settings.getString ( "Sprite.Red" );
+	std::string spriteGreen  = resourcePath + settings.getString ( "Sprite.Green" );
+	std::string spriteBlue   = resourcePath + settings.getString ( "Sprite.Blue" );
+	std::string spriteYellow = resourcePath + settings.getString ( "Sprite.Yellow" );
+	std::string spriteShadow = resourcePath + settings.getString ( "Sprite.Shadow" );
+
+	// Define a local configuration struct and color-parsing helper for setting up the four particle groups.
+
+	struct GroupConfig
+	{
+		std::string sprite;
+		int         count;
+		double      mass;
+		double      radius;
+		int         trailR, trailG, trailB;
+	};
+
+	auto parseColor = [] ( const std::string& s, int& r, int& g, int& b )
+	{
+		sscanf ( s.c_str (), "%d,%d,%d", &r, &g, &b );
+	};
+
+	// Load physics, trail, projection, wireframe, and shadow parameters from application settings.
+
+	double frictionCoefficient    = settings.getDouble ( "Physics.Friction.Coefficient" );
+	double elasticityCoefficient  = settings.getDouble ( "Physics.Elasticity.Coefficient" );
+	double projectionZoom         = settings.getDouble ( "Projection.Zoom" );
+	int    trailDepth             = settings.getInt    ( "Trail.Depth" );
+	double trailOpacityHead       = settings.getDouble ( "Trail.Opacity.Head" );
+	double trailOpacityTail       = settings.getDouble ( "Trail.Opacity.Tail" );
+	int    trailThickness         = settings.getInt    ( "Trail.Thickness" );
+	bool   wireframeVisible       = settings.getBool   ( "Wireframe.Visible" );
+	double shadowOffsetX          = settings.getDouble ( "Shadow.Offset.X" );
+	double shadowOffsetY          = settings.getDouble ( "Shadow.Offset.Y" );
+	double shadowOpacity          = settings.getDouble ( "Shadow.Opacity" );
+	double shadowScale            = settings.getDouble ( "Shadow.Scale" );
+	double velocityMax            = settings.getDouble ( "Initial.Velocity.Max" );
+
+	// Configure the four particle groups (red, green, blue, yellow) with their sprite, count, mass, radius, and
+	// trail color loaded from application settings.
+
+	GroupConfig groups [ 4 ];
+
+	groups [ 0 ].sprite = spriteRed;
+	groups [ 0 ].count  = componentWorld.particleCountRed;
+	groups [ 0 ].mass   = settings.getDouble ( "Particle.Mass.Red" );
+	groups [ 0 ].radius = settings.getDouble ( "Particle.Radius.Red" );
+	parseColor ( settings.getString ( "Trail.Color.Red" ), groups [ 0 ].trailR, groups [ 0 ].trailG, groups [ 0 ].trailB );
+
+	groups [ 1 ].sprite = spriteGreen;
+	groups [ 1 ].count  = componentWorld.particleCountGreen;
+	groups [ 1 ].mass   = settings.getDouble ( "Particle.Mass.Green" );
+	groups [ 1 ].radius = settings.getDouble ( "Particle.Radius.Green" );
+	parseColor ( settings.getString ( "Trail.Color.Green" ), groups [ 1 ].trailR, groups [ 1 ].trailG, groups [ 1 ].trailB );
+
+	groups [ 2 ].sprite  = spriteBlue;
+	groups [ 2 ].count   = componentWorld.particleCountBlue;
+	groups [ 2 ].mass    = settings.getDouble ( "Particle.Mass.Blue" );
+	groups [ 2 ].radius  = settings.getDouble ( "Particle.Radius.Blue" );
+	parseColor ( settings.getString ( "Trail.Color.Blue" ), groups [ 2 ].trailR, groups [ 2 ].trailG, groups [ 2 ].trailB );
+
+	groups [ 3 ].sprite = spriteYellow;
+	groups [ 3 ].count  = componentWorld.particleCountYellow;
+	groups [ 3 ].mass   = settings.getDouble ( "Particle.Mass.Yellow" );
+	groups [ 3 ].radius = settings.getDouble ( "Particle.Radius.Yellow" );
+	parseColor ( settings.getString ( "Trail.Color.Yellow" ), groups [ 3 ].trailR, groups [ 3 ].trailG, groups [ 3 ].trailB );
+
+	// World bounds for random particle placement.
+
+	double worldWidth  = static_cast < double > ( screenWidth ) / static_cast< double >( screenHeight );
+	double worldHeight = 1.0;
+	double margin      = 0.05;
+
+	// The shadow is the same for every group, so all particles share one value.
+
+	ComponentShadow shadow;
+	shadow.imagePath = spriteShadow;
+	shadow.offset    = { shadowOffsetX, shadowOffsetY };
+	shadow.opacity   = shadowOpacity;
+	shadow.scale     = shadowScale;
+
+	auto sharedShadow = world.createShared ( shadow );
+
+	// Create the shared sprite and trail style that a particle switches to while it is selected.
+
+	ComponentSprite spriteSelected;
+	spriteSelected.imagePath = resourcePath + settings.getString ( "Sprite.Selected" );
+
+	ComponentTrailStyle trailStyleSelected;
+	trailStyleSelected.depth       = trailDepth;
+	trailStyleSelected.opacityHead = trailOpacityHead;
+	trailStyleSelected.opacityTail = trailOpacityTail;
+	trailStyleSelected.thickness   = trailThickness;
+	trailStyleSelected.colorR      = 128;
+	trailStyleSelected.colorG      = 128;
+	trailStyleSelected.colorB      = 128;
+	parseColor ( settings.getString ( "Trail.Color.Selected" ), trailStyleSelected.colorR, trailStyleSelected.colorG, trailStyleSelected.colorB );
+
+	selectedSprite     = world.createShared ( spriteSelected );
+	selectedTrailStyle = world.createShared ( trailStyleSelected );
+
+	// Build one prefab per particle group and instantiate the group's particles from it, then randomize each
+	// particle's position and velocity. The group's sprite and trail style are created once as shared values and
+	// the prefab holds their handles. The prefabs are kept so a particle's original handles can be restored when it
+	// is deselected.
+
+	particleEntities.clear ();
+	particlePrefabs.clear ();
+
+	for ( int g = 0; g < 4; ++g )
+	{
+		auto& groupConfiguration = groups [ g ];
+
+		ComponentParticleGroup pgc;
+		pgc.groupIndex = g;
+
+		ComponentSprite sprite;
+		sprite.imagePath = groupConfiguration.sprite;
+
+		ComponentCircle circle;
+		circle.radius  = groupConfiguration.radius;
+		circle.visible = wireframeVisible;
+
+		ComponentPhysics physics;
+		physics.mass                   = groupConfiguration.mass;
+		physics.frictionCoefficient    = frictionCoefficient;
+		physics.elasticityCoefficient  = elasticityCoefficient;
+
+		ComponentTransform transform;
+
+		ComponentTrail trail;
+
+		ComponentTrailStyle trailStyle;
+		trailStyle.colorR      = groupConfiguration.trailR;
+		trailStyle.colorG      = groupConfiguration.trailG;
+		trailStyle.colorB      = groupConfiguration.trailB;
+		trailStyle.depth       = trailDepth;
+		trailStyle.opacityHead = trailOpacityHead;
+		trailStyle.opacityTail = trailOpacityTail;
+		trailStyle.thickness   = trailThickness;
+
+		ComponentProjection2D projection;
+		projection.scale = { projectionZoom, projectionZoom };
+
+		ecs::Prefab prefab = world.createPrefab
+		(
+			pgc,
+			world.createShared ( sprite ),
+			sharedShadow,
+			circle,
+			physics,
+			transform,
+			trail,
+			world.createShared ( trailStyle ),
+			projection
+		);
+
+		auto particles = world.instantiate ( prefab, static_cast <std::size_t> ( groupConfiguration.count ) );
+
+		for ( ecs::Entity particle : particles )
+		{
+			auto& particlePhysics = world.getComponent <ComponentPhysics>   ( particle );
+			auto& translation     = world.getComponent <ComponentTransform> ( particle ).translation;
+
+			particlePhysics.velocity.x = randomInRange ( -velocityMax, velocityMax );
+			particlePhysics.velocity.y = randomInRange ( -velocityMax, velocityMax );
+			translation.x              = randomInRange ( margin, worldWidth - margin );
+			translation.y              = randomInRange ( margin, worldHeight - margin );
+
+			world.getComponent <ComponentTransform> ( particle ).previousTranslation = translation;
+		}
+
+		particleEntities.insert ( particleEntities.end (), particles.begin (), particles.end () );
+		particlePrefabs.push_back ( std::move ( prefab ) );
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Method: configureSystems
+//
+// Description:
+//
+//   Configure the simulation systems from application settings, declare their component access for the
+//   scheduler, and set up the world's profiler.
+//
+// Arguments:
+//
+//   jobs (engine::JobSystem*):
+//     The job system the systems split their work across, or null to run them on the calling thread.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+void ParticleSimulation::configureSystems ( engine::JobSystem* jobs )
+{
+	// Configure the gravity system with the world entity, the job system, and a softening epsilon to prevent
+	// numerical instability at very short inter-particle distances.
+
+	systemGravity->worldEntity      = worldEntity;
+	systemGravity->jobs             = jobs;
+	systemGravity->softeningEpsilon = settings.getDouble ( "Physics.Softening.Epsilon" );
+
+	// Configure the repulsion system with the world entity for reading the repulsive force constant, and the job
+	// system.
+
+	systemRepulsion->worldEntity = worldEntity;
+	systemRepulsion->jobs        = jobs;
+
+	// Configure the fused force system, which stands in for the gravity and repulsion systems when selected, with
+	// the job system and the vector instruction set and precision of its all-pairs kernel.
+
+	systemPairForces->worldEntity      = worldEntity;
+	systemPairForces->jobs             = jobs;
+	systemPairForces->softeningEpsilon = settings.getDouble ( "Physics.Softening.Epsilon" );
+	systemPairForces->instructionSet   = engine::parseInstructionSet ( settings.getString ( "Physics.Forces.InstructionSet" ) );
+	systemPairForces->singlePrecision  = settings.getString ( "Physics.Forces.Precision" ) == "Single";
+
+	// Configure the force accumulator system with the world entity for reading the pause state, and the job system.
+
+	systemForceAccumulator->worldEntity = worldEntity;
+	systemForceAccumulator->jobs        = jobs;
+
+	// Configure the physics system with the world entity, the job system, and the anisotropic friction coefficient
+	// for directional drag.
+
+	systemPhysics->worldEntity         = worldEntity;
+	systemPhysics->jobs                = jobs;
+	systemPhysics->anisotropicFriction = settings.getDouble ( "Physics.Friction.Anisotropic" );
+
+	// Configure the collider system with the world entity, iteration count for iterative collision resolution,
+	// screen dimensions for boundary clamping, the broad phase used to find colliding pairs, and the job system
+	// for the wall phase.
+
+	systemCollider->worldEntity         = worldEntity;
+	systemCollider->jobs                = jobs;
+	systemCollider->collisionIterations = settings.getInt ( "Physics.Collision.Iterations" );
+	systemCollider->screenWidth         = settings.getInt ( "Application.Screen.Width" );
+	systemCollider->screenHeight        = settings.getInt ( "Application.Screen.Height" );
+	systemCollider->bruteForce          = settings.getString ( "Physics.Collision.BroadPhase" ) == "BruteForce";
+
+	// Declare each simulation system's component access, so the scheduler can run non-conflicting systems side by
+	// side. Every one of them writes ComponentPhysics, so they still run in registration order.
+
+	auto readsForces  = world.makeSignature <ComponentWorld, ComponentTransform, ComponentCircle> ();
+	auto writesForces = world.makeSignature <ComponentPhysics, ComponentNeighbourList> ();
+
+	world.declareSystemAccess ( *systemGravity,          readsForces, world.makeSignature <ComponentPhysics> () );
+	world.declareSystemAccess ( *systemRepulsion,        readsForces, writesForces );
+	world.declareSystemAccess ( *systemPairForces,       readsForces, writesForces );
+	world.declareSystemAccess ( *systemForceAccumulator, world.makeSignature <ComponentWorld, ComponentUserControl> (), world.makeSignature <ComponentPhysics> () );
+	world.declareSystemAccess ( *systemPhysics,          world.makeSignature <ComponentWorld, ComponentUserControl, ecs::Shared <ComponentTrailStyle>> (), world.makeSignature <ComponentTransform, ComponentPhysics, ComponentTrail> () );
+	world.declareSystemAccess ( *systemCollider,         world.makeSignature <ComponentWorld, ComponentCircle> (), world.makeSignature <ComponentTransform, ComponentPhysics, ComponentNeighbourList> () );
+
+	// Switch on per-system timing, and tracing if a trace file is named, before the first update.
+
+	world.getProfiler ().setEnabled ( settings.getBool ( "ECS.Profiler.Enabled" ) );
+
+	if ( !settings.getString ( "ECS.Profiler.Trace.Path" ).empty () ) world.getProfiler ().setTracing ( true );
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Method: writeTrace
+//
+// Description:
+//
+//   Write the profiler's trace to ECS.Profiler.Trace.Path as Chrome trace JSON, if a path is set.
+//
+// Returns:
+//
+//   True if the trace was written, false if no path is set or the file could not be opened.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+bool ParticleSimulation::writeTrace ()
+{
+	std::string tracePath = settings.getString ( "ECS.Profiler.Trace.Path" );
+
+	if ( tracePath.empty () ) return false;
+
+	std::ofstream trace ( tracePath );
+
+	if ( !trace.is_open () ) return false;
+
+	world.getProfiler ().writeChromeTrace ( trace );
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Method: randomInRange
+//
+// Description:
+//
+//   Draw a uniformly distributed number in [ minimum, maximum ] from the placement generator.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+double ParticleSimulation::randomInRange ( double minimum, double maximum )
+{
+	std::uniform_real_distribution <double> distribution ( minimum, maximum );
+
+	return distribution ( random );
+}
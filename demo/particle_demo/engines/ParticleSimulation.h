@@ -0,0 +1,191 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS Game Engine - Particle Simulator
+// Version: 1.0
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the ParticleSimulation class, which builds the particle simulation's world from application settings
+//   without touching SDL, so the interactive and headless engines share one world.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "../../../ecs/World.h"
+#include "../../../engine/ApplicationSettings.h"
+#include "../../../engine/JobSystem.h"
+#include "../components/ComponentSprite.h"
+#include "../components/ComponentTrailStyle.h"
+
+#include "../systems/SystemGravity.h"
+#include "../systems/SystemRepulsion.h"
+#include "../systems/SystemPairForces.h"
+#include "../systems/SystemForceAccumulator.h"
+#include "../systems/SystemPhysics.h"
+#include "../systems/SystemCollider.h"
+
+#include <array>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+//*********************************************************************************************************************
+// Class: ParticleSimulation
+//
+// Description:
+//
+//   Registers the particle components and simulation systems, creates the world entity and the four particle
+//   groups, and configures the systems, all from application settings.
+//
+//   The world must not hold entities yet. Building happens in three calls so an engine can register its own
+//   systems, such as a renderer, between them: systems must be registered before the entities they act on exist.
+//
+//   - registerSystems registers the components and the simulation systems, in execution order.
+//   - createWorld creates the world entity and the particles.
+//   - configureSystems configures the simulation systems and declares their component access.
+//
+//   Particle positions and velocities are drawn from a generator seeded by Initial.Seed, or from the system's
+//   random device if the seed is 0, so a run can be repeated exactly.
+//
+//*********************************************************************************************************************
+
+class ParticleSimulation
+{
+private:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	ecs::World&                        world;
+	const engine::ApplicationSettings& settings;
+	std::string                        resourcePath;
+	std::mt19937                       random;
+
+public:
+
+	ecs::Signature particleSignature;
+	ecs::Entity    worldEntity = ecs::NULL_ENTITY;
+
+	std::vector <ecs::Entity> particleEntities;
+	std::vector <ecs::Prefab> particlePrefabs;
+
+	ecs::Shared <ComponentSprite>     selectedSprite;
+	ecs::Shared <ComponentTrailStyle> selectedTrailStyle;
+
+	std::shared_ptr <SystemGravity>          systemGravity;
+	std::shared_ptr <SystemRepulsion>        systemRepulsion;
+	std::shared_ptr <SystemPairForces>       systemPairForces;
+	std::shared_ptr <SystemForceAccumulator> systemForceAccumulator;
+	std::shared_ptr <SystemPhysics>          systemPhysics;
+	std::shared_ptr <SystemCollider>         systemCollider;
+
+	//=================================================================================================================
+	// Constructors
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Constructor 1/1: ParticleSimulation
+	//
+	// Description:
+	//
+	//   Bind the simulation to a world and the settings it is built from, and seed the placement generator.
+	//
+	// Arguments:
+	//
+	//   world (ecs::World&):
+	//     The world to build the simulation in.
+	//
+	//   settings (const engine::ApplicationSettings&):
+	//     The application settings to read the simulation configuration from.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	ParticleSimulation ( ecs::World& world, const engine::ApplicationSettings& settings );
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: registerSystems
+	//
+	// Description:
+	//
+	//   Select the component storage backend, register the particle component types, and register the simulation
+	//   systems in execution order with the particle signature.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void registerSystems ();
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: createWorld
+	//
+	// Description:
+	//
+	//   Create the world entity, then a prefab per particle group, and instantiate each group's particles at random
+	//   positions with random velocities.
+	//
+	// Arguments:
+	//
+	//   counts (const std::array <int, 4>&):
+	//     The number of red, green, blue, and yellow particles.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void createWorld ( const std::array <int, 4>& counts );
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: configureSystems
+	//
+	// Description:
+	//
+	//   Configure the simulation systems from application settings, declare their component access for the
+	//   scheduler, and set up the world's profiler: per-system timing if ECS.Profiler.Enabled is set, and tracing
+	//   too if ECS.Profiler.Trace.Path names a file.
+	//
+	// Arguments:
+	//
+	//   jobs (engine::JobSystem*):
+	//     The job system the systems split their work across, or null to run them on the calling thread.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void configureSystems ( engine::JobSystem* jobs );
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: writeTrace
+	//
+	// Description:
+	//
+	//   Write the profiler's trace to ECS.Profiler.Trace.Path as Chrome trace JSON, if a path is set.
+	//
+	// Returns:
+	//
+	//   True if the trace was written, false if no path is set or the file could not be opened.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	bool writeTrace ();
+
+private:
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: randomInRange
+	//
+	// Description:
+	//
+	//   Draw a uniformly distributed number in [ minimum, maximum ] from the placement generator.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	double randomInRange ( double minimum, double maximum );
+};
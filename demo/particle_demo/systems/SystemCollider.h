@@ -19,13 +19,17 @@
 
 #include "../../../ecs/System.h"
 #include "../../../ecs/World.h"
+#include "../../../engine/JobSystem.h"
 #include "../components/ComponentParticleGroup.h"
 #include "../components/ComponentTransform.h"
 #include "../components/ComponentPhysics.h"
 #include "../components/ComponentCircle.h"
+#include "../components/ComponentNeighbourList.h"
 #include "../components/ComponentWorld.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 //*********************************************************************************************************************
@@ -38,6 +42,13 @@
 //   Resolves wall boundary reflections with configurable elasticity and performs iterative pairwise overlap 
 //   separation with impulse-based velocity exchange for particle-particle collisions.
 //
+//   Particle pairs are taken from the neighbour list on the world entity, shared with SystemRepulsion, so each
+//   particle is tested only against nearby particles. Setting bruteForce tests all pairs instead; both paths
+//   produce identical results.
+//
+//   Each particle's wall collision is independent, so when jobs is set the wall phase is split across its threads.
+//   Pair resolution depends on the order pairs are visited and stays on the calling thread.
+//
 //*********************************************************************************************************************
 
 class SystemCollider : public ecs::System
@@ -48,10 +59,16 @@ public:
 	// Data Members
 	//=================================================================================================================
 
-	ecs::Entity worldEntity         = ecs::NULL_ENTITY;
-	int         collisionIterations = 4;
-	int         screenWidth         = 1920;
-	int         screenHeight        = 1080;
+	ecs::Entity        worldEntity         = ecs::NULL_ENTITY;
+	engine::JobSystem* jobs                = nullptr;
+	int                collisionIterations = 4;
+	int                screenWidth         = 1920;
+	int                screenHeight        = 1080;
+	bool               bruteForce          = false;
+
+	// The smallest number of particles worth handing to another thread.
+
+	static constexpr std::size_t PARALLEL_GRAIN = 2048;
 
 	//=================================================================================================================
 	// Methods
@@ -92,133 +109,290 @@ public:
 		double worldWidth  = static_cast< double > ( screenWidth ) / static_cast< double > ( screenHeight );
 		double worldHeight = 1.0;
 
-		std::vector <ecs::Entity> particles ( entities.begin (), entities.end () );
-		std::size_t n = particles.size ();
-
-		// Wall collisions.
-
-		for ( std::size_t i = 0; i < n; ++i )
-		{
-			auto& transform = world.getComponent <ComponentTransform> ( particles [ i ] );
-			auto& physics   = world.getComponent <ComponentPhysics> ( particles [ i ] );
-			auto& circle    = world.getComponent <ComponentCircle> ( particles [ i ] );
+		// Resolve each member's components once. Nothing below adds or removes components, so the pointers stay
+		// valid for the rest of the update.
 
-			double& positionX  = transform.translation.x;
-			double& positionY  = transform.translation.y;
-			double& velocityX  = physics.velocity.x;
-			double& velocityY  = physics.velocity.y;
-			double  radius     = circle.radius;
-			double  elasticity = worldComponent.elasticityEnabled ? physics.elasticityCoefficient : 1.0;
+		auto        particles = entities.span ();
+		std::size_t n         = particles.size ();
+		auto        view      = world.view <ComponentTransform, ComponentPhysics, ComponentCircle> ();
 
-			// Left wall.
+		transforms.resize ( n );
+		physics.resize    ( n );
+		circles.resize    ( n );
 
-			if ( positionX - radius < 0.0 )
+		engine::parallelFor
+		(
+			jobs, n, PARALLEL_GRAIN,
+			[ & ] ( std::size_t begin, std::size_t end )
 			{
-				positionX = radius;
-				velocityX = std::abs ( velocityX ) * elasticity;
+				for ( std::size_t i = begin; i < end; ++i )
+				{
+					transforms [ i ] = &view.get <ComponentTransform> ( particles [ i ] );
+					physics    [ i ] = &view.get <ComponentPhysics>   ( particles [ i ] );
+					circles    [ i ] = &view.get <ComponentCircle>    ( particles [ i ] );
+				}
 			}
+		);
 
-			// Right wall.
+		// Wall collisions, split across the job system's threads. Each particle is clamped and reflected on its own.
 
-			if ( positionX + radius > worldWidth )
+		bool elasticityEnabled = worldComponent.elasticityEnabled;
+
+		engine::parallelFor
+		(
+			jobs, n, PARALLEL_GRAIN,
+			[ & ] ( std::size_t begin, std::size_t end )
 			{
-				positionX = worldWidth - radius;
-				velocityX = -std::abs ( velocityX ) * elasticity;
-			}
+				for ( std::size_t i = begin; i < end; ++i )
+				{
+					double& positionX  = transforms [ i ]->translation.x;
+					double& positionY  = transforms [ i ]->translation.y;
+					double& velocityX  = physics    [ i ]->velocity.x;
+					double& velocityY  = physics    [ i ]->velocity.y;
+					double  radius     = circles    [ i ]->radius;
+					double  elasticity = elasticityEnabled ? physics    [ i ]->elasticityCoefficient : 1.0;
 
-			// Top wall.
+					// Left wall.
 
-			if ( positionY - radius < 0.0 )
-			{
-				positionY = radius;
-				velocityY = std::abs ( velocityY ) * elasticity;
+					if ( positionX - radius < 0.0 )
+					{
+						positionX = radius;
+						velocityX = std::abs ( velocityX ) * elasticity;
+					}
+
+					// Right wall.
+
+					if ( positionX + radius > worldWidth )
+					{
+						positionX = worldWidth - radius;
+						velocityX = -std::abs ( velocityX ) * elasticity;
+					}
+
+					// Top wall.
+
+					if ( positionY - radius < 0.0 )
+					{
+						positionY = radius;
+						velocityY = std::abs ( velocityY ) * elasticity;
+					}
+
+					// Bottom wall.
+
+					if ( positionY + radius > worldHeight )
+					{
+						positionY = worldHeight - radius;
+						velocityY = -std::abs ( velocityY ) * elasticity;
+					}
+				}
 			}
+		);
 
-			// Bottom wall.
+		// Iterative pairwise particle-particle collision detection and response, as its own zone in a profiler trace.
 
-			if ( positionY + radius > worldHeight )
+		ecs::Profiler::Zone zone ( world.getProfiler (), "Collider.Pairs" );
+
+		if ( bruteForce ) resolveAllPairs       ( elasticityEnabled );
+		else              resolveNeighbourPairs ( world.getComponent <ComponentNeighbourList> ( worldEntity ), particles, elasticityEnabled );
+	}
+
+private:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	std::vector <ComponentTransform*> transforms;
+	std::vector <ComponentPhysics*>   physics;
+	std::vector <ComponentCircle*>    circles;
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: resolveAllPairs
+	//
+	// Description:
+	//
+	//   Test every particle against every subsequent particle, collisionIterations times.
+	//
+	//   This is the reference path enabled by bruteForce. resolveNeighbourPairs resolves the same pairs in the same
+	//   order.
+	//
+	// Arguments:
+	//
+	//   elasticityEnabled (bool):
+	//     Whether to apply the impulse response on the first iteration.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void resolveAllPairs ( bool elasticityEnabled )
+	{
+		std::size_t n = transforms.size ();
+
+		for ( int iter = 0; iter < collisionIterations; ++iter )
+		{
+			for ( std::size_t i = 0; i < n; ++i )
 			{
-				positionY = worldHeight - radius;
-				velocityY = -std::abs ( velocityY ) * elasticity;
+				for ( std::size_t j = i + 1; j < n; ++j ) resolvePair ( i, j, iter == 0 && elasticityEnabled );
 			}
 		}
+	}
 
-		// Iterative pairwise particle-particle collision detection and response.
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: resolveNeighbourPairs
+	//
+	// Description:
+	//
+	//   Test each particle only against its subsequent neighbours in the shared neighbour list, collisionIterations
+	//   times.
+	//
+	//   The list holds every pair within twice their combined radii plus the skin, so it still holds every
+	//   overlapping pair while no particle has moved more than half the skin since it was built. It is brought up to
+	//   date once per frame and reused across the iterations; if a push moves a particle past that limit the list
+	//   is rebuilt and the current particle's remaining neighbours are taken from the new list.
+	//
+	//   Neighbours are visited in ascending index order, so overlapping pairs are resolved in exactly the order
+	//   resolveAllPairs resolves them and the results are identical.
+	//
+	// Arguments:
+	//
+	//   neighbourList (ComponentNeighbourList&):
+	//     The neighbour list shared with SystemRepulsion.
+	//
+	//   particles (ecs::Span <const ecs::Entity>):
+	//     The system's particles, parallel to the resolved component pointers.
+	//
+	//   elasticityEnabled (bool):
+	//     Whether to apply the impulse response on the first iteration.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
 
-		for ( int iter = 0; iter < collisionIterations; ++iter )
+	void resolveNeighbourPairs ( ComponentNeighbourList& neighbourList, ecs::Span <const ecs::Entity> particles, bool elasticityEnabled )
+	{
+		auto&       pairs = neighbourList.pairs;
+		std::size_t n     = transforms.size ();
+
+		auto refresh = [ & ] ()
 		{
-			// Iterate over all particles as the primary collision candidate.
+			updateNeighbourList
+			(
+				neighbourList,
+				particles,
+				[ this ] ( std::size_t i ) -> const engine::Vector2D& { return transforms [ i ]->translation; },
+				[ this ] ( std::size_t i ) { return circles [ i ]->radius; }
+			);
+		};
+
+		refresh ();
 
+		for ( int iter = 0; iter < collisionIterations; ++iter )
+		{
 			for ( std::size_t i = 0; i < n; ++i )
 			{
-				// Fetch transform, physics, and circle components for particle A.
+				const uint32_t* neighbour = pairs.begin ( i );
+				const uint32_t* end       = pairs.end   ( i );
 
-				auto& transformA = world.getComponent <ComponentTransform> ( particles [ i ] );
-				auto& physicsA   = world.getComponent <ComponentPhysics>   ( particles [ i ] );
-				auto& circleA    = world.getComponent <ComponentCircle>    ( particles [ i ] );
+				while ( neighbour != end )
+				{
+					uint32_t j = *neighbour++;
 
-				// Test particle A against every subsequent particle to avoid redundant pair checks.
+					if ( !resolvePair ( i, j, iter == 0 && elasticityEnabled ) ) continue;
 
-				for ( std::size_t j = i + 1; j < n; ++j )
-				{
-					// Fetch transform, physics, and circle components for particle B.
+					if ( pairs.displaced ( i, transforms [ i ]->translation ) || pairs.displaced ( j, transforms [ j ]->translation ) )
+					{
+						refresh ();
+
+						neighbour = std::upper_bound ( pairs.begin ( i ), pairs.end ( i ), j );
+						end       = pairs.end ( i );
+					}
+				}
+			}
+		}
+	}
 
-					auto& transformB = world.getComponent <ComponentTransform> ( particles [ j ] );
-					auto& physicsB   = world.getComponent <ComponentPhysics>   ( particles [ j ] );
-					auto& circleB    = world.getComponent <ComponentCircle>    ( particles [ j ] );
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: resolvePair
+	//
+	// Description:
+	//
+	//   Separate two overlapping particles along their normal, weighted by mass, and optionally exchange an
+	//   elastic impulse if they are approaching.
+	//
+	// Arguments:
+	//
+	//   i, j (std::size_t):
+	//     The particles, with i before j.
+	//
+	//   applyImpulse (bool):
+	//     Whether to apply the impulse-based velocity response.
+	//
+	// Returns:
+	//
+	//   True if the particles overlapped and were separated, false otherwise.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
 
-					// Compute the displacement vector and Euclidean distance between particle centers.
+	bool resolvePair ( std::size_t i, std::size_t j, bool applyImpulse )
+	{
+		auto& transformA = *transforms [ i ];
+		auto& physicsA   = *physics    [ i ];
+		auto& circleA    = *circles    [ i ];
+		auto& transformB = *transforms [ j ];
+		auto& physicsB   = *physics    [ j ];
+		auto& circleB    = *circles    [ j ];
 
-					double deltaX   = transformB.translation.x - transformA.translation.x;
-					double deltaY   = transformB.translation.y - transformA.translation.y;
-					double distance = std::sqrt ( deltaX * deltaX + deltaY * deltaY );
+		// Compute the displacement vector and Euclidean distance between particle centers.
 
-					double minimumDistance = circleA.radius + circleB.radius;
+		double deltaX   = transformB.translation.x - transformA.translation.x;
+		double deltaY   = transformB.translation.y - transformA.translation.y;
+		double distance = std::sqrt ( deltaX * deltaX + deltaY * deltaY );
 
-					// Skip this pair if the particles are not overlapping or are coincident (zero distance).
+		double minimumDistance = circleA.radius + circleB.radius;
 
-					if ( distance >= minimumDistance || distance <= 0.0 ) continue;
+		// Skip this pair if the particles are not overlapping or are coincident (zero distance).
 
-					// Normal from A to B.
+		if ( distance >= minimumDistance || distance <= 0.0 ) return false;
 
-					double normalX = deltaX / distance;
-					double normalY = deltaY / distance;
+		// Normal from A to B.
 
-					// Positional separation (mass-weighted).
+		double normalX = deltaX / distance;
+		double normalY = deltaY / distance;
 
-					double overlap     = minimumDistance - distance;
-					double totalMass   = physicsA.mass + physicsB.mass;
-					double separationA = overlap * ( physicsB.mass / totalMass );
-					double separationB = overlap * ( physicsA.mass / totalMass );
+		// Positional separation (mass-weighted).
 
-					transformA.translation.x -= normalX * separationA;
-					transformA.translation.y -= normalY * separationA;
-					transformB.translation.x += normalX * separationB;
-					transformB.translation.y += normalY * separationB;
+		double overlap     = minimumDistance - distance;
+		double totalMass   = physicsA.mass + physicsB.mass;
+		double separationA = overlap * ( physicsB.mass / totalMass );
+		double separationB = overlap * ( physicsA.mass / totalMass );
 
-					// Impulse-based velocity response (only on first iteration).
+		transformA.translation.x -= normalX * separationA;
+		transformA.translation.y -= normalY * separationA;
+		transformB.translation.x += normalX * separationB;
+		transformB.translation.y += normalY * separationB;
 
-					if ( iter == 0 && worldComponent.elasticityEnabled )
-					{
-						double relativeVelocityX = physicsB.velocity.x - physicsA.velocity.x;
-						double relativeVelocityY = physicsB.velocity.y - physicsA.velocity.y;
-						double relativeVelocityNormal = relativeVelocityX * normalX + relativeVelocityY * normalY;
-
-						// Only apply if particles are approaching.
-
-						if ( relativeVelocityNormal < 0.0 )
-						{
-							double restitution = ( physicsA.elasticityCoefficient + physicsB.elasticityCoefficient ) / 2.0;
-							double impulse = -( 1.0 + restitution ) * relativeVelocityNormal / ( 1.0 / physicsA.mass + 1.0 / physicsB.mass );
-
-							physicsA.velocity.x -= ( impulse / physicsA.mass ) * normalX;
-							physicsA.velocity.y -= ( impulse / physicsA.mass ) * normalY;
-							physicsB.velocity.x += ( impulse / physicsB.mass ) * normalX;
-							physicsB.velocity.y += ( impulse / physicsB.mass ) * normalY;
-						}
-					}
-				}
+		// Impulse-based velocity response (only on first iteration).
+
+		if ( applyImpulse )
+		{
+			double relativeVelocityX = physicsB.velocity.x - physicsA.velocity.x;
+			double relativeVelocityY = physicsB.velocity.y - physicsA.velocity.y;
+			double relativeVelocityNormal = relativeVelocityX * normalX + relativeVelocityY * normalY;
+
+			// Only apply if particles are approaching.
+
+			if ( relativeVelocityNormal < 0.0 )
+			{
+				double restitution = ( physicsA.elasticityCoefficient + physicsB.elasticityCoefficient ) / 2.0;
+				double impulse = -( 1.0 + restitution ) * relativeVelocityNormal / ( 1.0 / physicsA.mass + 1.0 / physicsB.mass );
+
+				physicsA.velocity.x -= ( impulse / physicsA.mass ) * normalX;
+				physicsA.velocity.y -= ( impulse / physicsA.mass ) * normalY;
+				physicsB.velocity.x += ( impulse / physicsB.mass ) * normalX;
+				physicsB.velocity.y += ( impulse / physicsB.mass ) * normalY;
 			}
 		}
+
+		return true;
 	}
 };
@@ -19,7 +19,7 @@
 
 #include "../../../ecs/System.h"
 #include "../../../ecs/World.h"
-#include "../components/ComponentParticleGroup.h"
+#include "../../../engine/JobSystem.h"
 #include "../components/ComponentPhysics.h"
 #include "../components/ComponentUserControl.h"
 #include "../components/ComponentWorld.h"
@@ -34,6 +34,8 @@
 //
 //   Also injects directional forces from user keyboard input for the selected particle.
 //
+//   Each particle is updated independently, so when jobs is set the particles are split across its threads.
+//
 //*********************************************************************************************************************
 
 class SystemForceAccumulator : public ecs::System
@@ -44,7 +46,12 @@ public:
 	// Data Members
 	//=================================================================================================================
 
-	ecs::Entity worldEntity = ecs::NULL_ENTITY;
+	ecs::Entity        worldEntity = ecs::NULL_ENTITY;
+	engine::JobSystem* jobs        = nullptr;
+
+	// The smallest number of particles worth handing to another thread.
+
+	static constexpr std::size_t PARALLEL_GRAIN = 2048;
 
 	//=================================================================================================================
 	// Methods
@@ -80,47 +87,63 @@ public:
 
 		if ( worldComponent.paused ) return;
 
-		// 
+		// Resolve the optional user control storage once; at most a few particles carry it.
+
+		auto userControls = world.view <ComponentUserControl> ();
 
-		for ( auto entity : entities )
-		{
-			auto& physics = world.getComponent <ComponentPhysics> ( entity );
+		// Integrate forces for every particle, split across the job system's threads. The system's members are the
+		// particles, and each range touches only its own particles' components.
 
-			// Apply user input forces if this particle has a ComponentUserControl.
+		auto particles   = entities.span ();
+		auto physicsView = world.view <ComponentPhysics> ();
 
-			if ( world.hasComponent <ComponentUserControl> ( entity ) )
+		engine::parallelFor
+		(
+			jobs, particles.size (), PARALLEL_GRAIN,
+			[ & ] ( std::size_t begin, std::size_t end )
 			{
-				// Retrieve the user control component for this entity.
+				for ( std::size_t i = begin; i < end; ++i )
+				{
+					ecs::Entity       entity  = particles [ i ];
+					ComponentPhysics& physics = physicsView.get <ComponentPhysics> ( entity );
 
-				auto& userControl = world.getComponent <ComponentUserControl> ( entity );
+					// Apply user input forces if this particle has a ComponentUserControl.
 
-				// Compute the net force from user input.
+					if ( userControls.contains ( entity ) )
+					{
+						// Retrieve the user control component for this entity.
 
-				double forceX = 0.0;
-				double forceY = 0.0;
+						auto& userControl = userControls.get <ComponentUserControl> ( entity );
 
-				if ( userControl.accelerateUp )    forceY -= userControl.accelerationMagnitude;
-				if ( userControl.accelerateDown )  forceY += userControl.accelerationMagnitude;
-				if ( userControl.accelerateLeft )  forceX -= userControl.accelerationMagnitude;
-				if ( userControl.accelerateRight ) forceX += userControl.accelerationMagnitude;
+						// Compute the net force from user input.
 
-				physics.forceAccumulator.x += forceX;
-				physics.forceAccumulator.y += forceY;
-			}
+						double forceX = 0.0;
+						double forceY = 0.0;
+
+						if ( userControl.accelerateUp )    forceY -= userControl.accelerationMagnitude;
+						if ( userControl.accelerateDown )  forceY += userControl.accelerationMagnitude;
+						if ( userControl.accelerateLeft )  forceX -= userControl.accelerationMagnitude;
+						if ( userControl.accelerateRight ) forceX += userControl.accelerationMagnitude;
 
-			// F = ma -> a = F/m.
+						physics.forceAccumulator.x += forceX;
+						physics.forceAccumulator.y += forceY;
+					}
 
-			double ax = physics.forceAccumulator.x / physics.mass;
-			double ay = physics.forceAccumulator.y / physics.mass;
+					// F = ma -> a = F/m.
 
-			// Update velocity.
+					double ax = physics.forceAccumulator.x / physics.mass;
+					double ay = physics.forceAccumulator.y / physics.mass;
 
-			physics.velocity.x += ax * dt;
-			physics.velocity.y += ay * dt;
+					// Update velocity.
 
-			// Clear force accumulator for next frame.
+					physics.velocity.x += ax * dt;
+					physics.velocity.y += ay * dt;
 
-			physics.forceAccumulator = { 0.0, 0.0 };
-		}
+					// Clear force accumulator for next frame.
+
+					physics.forceAccumulator = { 0.0, 0.0 };
+				}
+			}
+		);
 	}
 };
@@ -24,6 +24,9 @@
 #include "../components/ComponentPhysics.h"
 #include "../components/ComponentCircle.h"
 #include "../components/ComponentWorld.h"
+#include "../../../engine/JobSystem.h"
+#include "../../../engine/PairAccumulator.h"
+#include "../../../engine/spatial/BarnesHutTree.h"
 
 #include <cmath>
 #include <vector>
@@ -40,6 +43,12 @@
 //
 //   - Overlapping particles are skipped to avoid double-counting with the collision system.
 //
+//   - Forces are summed exactly over all pairs in O(N^2), or approximated with a Barnes-Hut quadtree in
+//     O(N log N) when ComponentWorld::barnesHutEnabled is set.
+//
+//   - Both paths run on the job system when one is set. The exact sum goes through a PairAccumulator, so the
+//     forces are the same for any thread count.
+//
 //*********************************************************************************************************************
 
 class SystemGravity : public ecs::System
@@ -50,8 +59,13 @@ public:
 	// Data Members
 	//=================================================================================================================
 
-	ecs::Entity worldEntity      = ecs::NULL_ENTITY;
-	double      softeningEpsilon = 0.009;
+	ecs::Entity        worldEntity      = ecs::NULL_ENTITY;
+	double             softeningEpsilon = 0.009;
+	engine::JobSystem* jobs             = nullptr;
+
+	// Particles per job for the Barnes-Hut force loop.
+
+	static constexpr std::size_t PARALLEL_GRAIN = 256;
 
 	//=================================================================================================================
 	// Methods
@@ -65,7 +79,8 @@ public:
 	//   Compute pairwise gravitational forces between all particle entities and accumulate them into each
 	//   particle's force accumulator.
 	//
-	//   Skips pairs that are overlapping or closer than their combined radii.
+	//   Skips pairs that are overlapping or closer than their combined radii. Uses the Barnes-Hut solver when the
+	//   world component selects it.
 	//
 	// Arguments:
 	//
@@ -85,59 +100,155 @@ public:
 
 		auto& worldComponent = world.getComponent <ComponentWorld> ( worldEntity );
 
-		// Skip gravity computation if the simulation is paused or gravity is disabled.
+		// Skip gravity computation if the simulation is paused, gravity is disabled, or SystemPairForces evaluates it.
 
-		if ( worldComponent.paused || !worldComponent.gravityEnabled ) return;
+		if ( worldComponent.paused || !worldComponent.gravityEnabled || worldComponent.fusedForcesEnabled ) return;
 
 		double gravitationalConstant = worldComponent.gravitationalConstant;
 
-		// Collect all particle entities into a vector for double-loop access.
+		// Resolve each member's components once. Gravity only writes force accumulators, so the pointers stay valid
+		// for the rest of the update.
 
-		std::vector <ecs::Entity> particles ( entities.begin (), entities.end () );
-		std::size_t n = particles.size ();
+		auto        particles = entities.span ();
+		std::size_t n         = particles.size ();
+
+		transforms.resize ( n );
+		physics.resize    ( n );
+		circles.resize    ( n );
 
 		for ( std::size_t i = 0; i < n; ++i )
 		{
-			// Fetch transform, physics, and circle components for particle A.
+			transforms [ i ] = &world.getComponent <ComponentTransform> ( particles [ i ] );
+			physics    [ i ] = &world.getComponent <ComponentPhysics>   ( particles [ i ] );
+			circles    [ i ] = &world.getComponent <ComponentCircle>    ( particles [ i ] );
+		}
 
-			auto& transformEntityA = world.getComponent <ComponentTransform> ( particles [ i ] );
-			auto& physicsEntityA   = world.getComponent <ComponentPhysics>   ( particles [ i ] );
-			auto& circleEntityA    = world.getComponent <ComponentCircle>    ( particles [ i ] );
+		if ( worldComponent.barnesHutEnabled ) applyBarnesHut ( gravitationalConstant, worldComponent.barnesHutTheta );
+		else                                   applyExact     ( gravitationalConstant );
+	}
 
-			for ( std::size_t j = i + 1; j < n; ++j )
-			{
-				// Fetch transform, physics, and circle components for particle B.
+private:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	std::vector <ComponentTransform*>         transforms;
+	std::vector <ComponentPhysics*>           physics;
+	std::vector <ComponentCircle*>            circles;
+	std::vector <engine::BarnesHutTree::Body> bodies;
+	engine::BarnesHutTree                     tree;
+	engine::PairAccumulator                   accumulator;
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: applyExact
+	//
+	// Description:
+	//
+	//   Accumulate the exact pairwise force between every pair of particles, applying each pair's force to both
+	//   particles. The pairs are summed by the PairAccumulator, on the job system if one is set.
+	//
+	// Arguments:
+	//
+	//   gravitationalConstant (double):
+	//     The gravitational constant G.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void applyExact ( double gravitationalConstant )
+	{
+		std::size_t n = transforms.size ();
+
+		accumulator.accumulateAllPairs ( jobs, n, [ this, gravitationalConstant ] ( std::size_t i, std::size_t j, engine::Vector2D& force )
+		{
+			// Compute the displacement vector, squared distance, and Euclidean distance between particle centers.
+
+			double deltaX          = transforms [ j ]->translation.x - transforms [ i ]->translation.x;
+			double deltaY          = transforms [ j ]->translation.y - transforms [ i ]->translation.y;
+			double distanceSquared = deltaX * deltaX + deltaY * deltaY;
+			double distance        = std::sqrt ( distanceSquared );
 
-				auto& transformEntityB = world.getComponent <ComponentTransform> ( particles [ j ] );
-				auto& physicsEntityB   = world.getComponent <ComponentPhysics>   ( particles [ j ] );
-				auto& circleEntityB    = world.getComponent <ComponentCircle>    ( particles [ j ] );
+			// Skip gravity if particles are overlapping (collider handles contact).
 
-				// Compute the displacement vector, squared distance, and Euclidean distance between particle centers.
+			if ( distance <= circles [ i ]->radius + circles [ j ]->radius ) return false;
 
-				double deltaX          = transformEntityB.translation.x - transformEntityA.translation.x;
-				double deltaY          = transformEntityB.translation.y - transformEntityA.translation.y;
-				double distanceSquared = deltaX * deltaX + deltaY * deltaY;
-				double distance        = std::sqrt ( distanceSquared );
+			double distanceSquaredSoftened = distanceSquared + softeningEpsilon * softeningEpsilon;
+			double forceMagnitude          = gravitationalConstant * physics [ i ]->mass * physics [ j ]->mass / distanceSquaredSoftened;
 
-				// Skip gravity if particles are overlapping (collider handles contact).
+			// Compute the unit normal direction and project the gravitational force onto each axis.
 
-				if ( distance <= circleEntityA.radius + circleEntityB.radius ) continue;
+			double normalX = deltaX / distance;
+			double normalY = deltaY / distance;
 
-				double distanceSquaredSoftened = distanceSquared + softeningEpsilon * softeningEpsilon;
-				double forceMagnitude          = gravitationalConstant * physicsEntityA.mass * physicsEntityB.mass / distanceSquaredSoftened;
+			force.x = forceMagnitude * normalX;
+			force.y = forceMagnitude * normalY;
 
-				// Compute the unit normal direction and project the gravitational force onto each axis, then accumulate.
+			return true;
+		} );
 
-				double normalX = deltaX / distance;
-				double normalY = deltaY / distance;
-				double forceX  = forceMagnitude * normalX;
-				double forceY  = forceMagnitude * normalY;
+		// Each particle's summed force belongs to it alone, so adding them is a plain parallel loop.
 
-				physicsEntityA.forceAccumulator.x += forceX;
-				physicsEntityA.forceAccumulator.y += forceY;
-				physicsEntityB.forceAccumulator.x -= forceX;
-				physicsEntityB.forceAccumulator.y -= forceY;
+		engine::parallelFor ( jobs, n, PARALLEL_GRAIN, [ this ] ( std::size_t begin, std::size_t end )
+		{
+			for ( std::size_t i = begin; i < end; ++i )
+			{
+				physics [ i ]->forceAccumulator.x += accumulator.getForce ( i ).x;
+				physics [ i ]->forceAccumulator.y += accumulator.getForce ( i ).y;
 			}
+		} );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: applyBarnesHut
+	//
+	// Description:
+	//
+	//   Build a Barnes-Hut quadtree over the particle positions and accumulate each particle's approximate force
+	//   from it.
+	//
+	//   Uses the same softening and overlap rule as applyExact. Distant groups of particles are replaced by their
+	//   centre of mass, so the forces on two particles are no longer exactly equal and opposite.
+	//
+	// Arguments:
+	//
+	//   gravitationalConstant (double):
+	//     The gravitational constant G.
+	//
+	//   theta (double):
+	//     The opening angle. Zero reproduces the exact forces; 0.5 is a common balance of speed and accuracy.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void applyBarnesHut ( double gravitationalConstant, double theta )
+	{
+		std::size_t n = transforms.size ();
+
+		bodies.resize ( n );
+
+		for ( std::size_t i = 0; i < n; ++i )
+		{
+			bodies [ i ].position = transforms [ i ]->translation;
+			bodies [ i ].mass     = physics    [ i ]->mass;
+			bodies [ i ].radius   = circles    [ i ]->radius;
 		}
+
+		tree.build ( bodies.data (), n );
+
+		// Walking the tree only reads it, so each particle's force can be evaluated on any thread.
+
+		engine::parallelFor ( jobs, n, PARALLEL_GRAIN, [ this, theta, gravitationalConstant ] ( std::size_t begin, std::size_t end )
+		{
+			for ( std::size_t i = begin; i < end; ++i )
+			{
+				engine::Vector2D force = tree.force ( i, theta, gravitationalConstant, softeningEpsilon );
+
+				physics [ i ]->forceAccumulator.x += force.x;
+				physics [ i ]->forceAccumulator.y += force.y;
+			}
+		} );
 	}
 };
@@ -0,0 +1,424 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS Game Engine - Particle Simulator
+// Version: 1.0
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the SystemPairForces class, an ECS system that evaluates gravity and short-range repulsion for each
+//   particle pair in a single fused pass.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "../../../ecs/System.h"
+#include "../../../ecs/World.h"
+#include "../components/ComponentParticleGroup.h"
+#include "../components/ComponentTransform.h"
+#include "../components/ComponentPhysics.h"
+#include "../components/ComponentCircle.h"
+#include "../components/ComponentNeighbourList.h"
+#include "../components/ComponentWorld.h"
+#include "../../../engine/JobSystem.h"
+#include "../../../engine/PairAccumulator.h"
+#include "../../../engine/simd/PairForceKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//*********************************************************************************************************************
+// Class: SystemPairForces
+//
+// Description:
+//
+//   An ECS system that replaces SystemGravity and SystemRepulsion when ComponentWorld::fusedForcesEnabled is set.
+//
+//   - Positions, masses, and radii are packed into flat arrays once per frame, and forces are summed into flat
+//     arrays before being added to each particle's force accumulator.
+//
+//   - Each pair's distance is computed once and both force laws are applied along the same normal, so a pair
+//     costs one square root and one division.
+//
+//   - The force laws match SystemGravity's exact solver and SystemRepulsion, and each is still switched by
+//     ComponentWorld::gravityEnabled and ComponentWorld::repulsionEnabled. With gravity off, repulsion pairs are
+//     taken from the shared neighbour list instead of all pairs.
+//
+//   - Both paths run on the job system when one is set. The all-pairs kernel runs on fixed blocks of rows, each
+//     summing into force arrays of its own that are then added in block order, and the listed pairs go through a
+//     PairAccumulator, so the forces are the same for any thread count.
+//
+//*********************************************************************************************************************
+
+class SystemPairForces : public ecs::System
+{
+public:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	ecs::Entity            worldEntity      = ecs::NULL_ENTITY;
+	engine::JobSystem*     jobs             = nullptr;
+	double                 softeningEpsilon = 0.009;
+	engine::InstructionSet instructionSet   = engine::detectInstructionSet ();
+	bool                   singlePrecision  = false;
+
+	// Row blocks of the all-pairs kernel. The block count depends only on the particle count, so the summation
+	// order does not change with the thread count.
+
+	static constexpr std::size_t MAX_BLOCKS     = 32;
+	static constexpr std::size_t MIN_BLOCK_ROWS = 64;
+
+	// Particles per job when adding the summed forces together and to the force accumulators.
+
+	static constexpr std::size_t PARALLEL_GRAIN = 2048;
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: update
+	//
+	// Description:
+	//
+	//   Accumulate the gravitational and repulsive forces between particle entities into each particle's force
+	//   accumulator.
+	//
+	// Arguments:
+	//
+	//   world (ecs::World&):
+	//     Reference to the ECS World, providing access to entity components.
+	//
+	//   dt (double):
+	//     Delta time in seconds since the previous frame.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void update ( ecs::World& world, double dt ) override
+	{
+		// Early out if no world entity has been assigned to this system.
+
+		if ( worldEntity == ecs::NULL_ENTITY ) return;
+
+		auto& worldComponent = world.getComponent <ComponentWorld> ( worldEntity );
+
+		// Skip if paused, if the separate force systems are in use, or if both force laws are disabled.
+
+		if ( worldComponent.paused || !worldComponent.fusedForcesEnabled ) return;
+
+		engine::PairForceLaws <double> laws;
+
+		laws.gravitationalConstant = worldComponent.gravitationalConstant;
+		laws.repulsiveConstant     = worldComponent.repulsiveConstant;
+		laws.softeningEpsilon      = softeningEpsilon;
+		laws.gravity               = worldComponent.gravityEnabled;
+		laws.repulsion             = worldComponent.repulsionEnabled;
+
+		if ( !laws.gravity && !laws.repulsion ) return;
+
+		// Pack each particle's position, mass, and radius, and keep its physics component for the write back.
+
+		auto        particles = entities.span ();
+		std::size_t n         = particles.size ();
+
+		packed.resize  ( n );
+		physics.resize ( n );
+
+		for ( std::size_t i = 0; i < n; ++i )
+		{
+			auto& transform = world.getComponent <ComponentTransform> ( particles [ i ] );
+
+			physics          [ i ] = &world.getComponent <ComponentPhysics> ( particles [ i ] );
+			packed.positionX [ i ] = transform.translation.x;
+			packed.positionY [ i ] = transform.translation.y;
+			packed.mass      [ i ] = physics [ i ]->mass;
+			packed.radius    [ i ] = world.getComponent <ComponentCircle> ( particles [ i ] ).radius;
+		}
+
+		// Gravity acts between every pair, through the vector kernel. Repulsion alone only needs the pairs in the
+		// neighbour list.
+
+		if      ( !laws.gravity )   accumulateNeighbourPairs ( world.getComponent <ComponentNeighbourList> ( worldEntity ), particles, laws );
+		else if ( singlePrecision ) accumulateAllPairsSingle ( laws );
+		else                        accumulateAllPairs ( packed, laws );
+
+		// Write the summed forces back to the force accumulators.
+
+		engine::parallelFor ( jobs, n, PARALLEL_GRAIN, [ this ] ( std::size_t begin, std::size_t end )
+		{
+			for ( std::size_t i = begin; i < end; ++i )
+			{
+				physics [ i ]->forceAccumulator.x += packed.forceX [ i ];
+				physics [ i ]->forceAccumulator.y += packed.forceY [ i ];
+			}
+		} );
+	}
+
+private:
+
+	//*****************************************************************************************************************
+	// Struct: PackedParticles
+	//
+	// Description:
+	//
+	//   Structure-of-arrays copy of the particles in one precision, with force sums cleared on every resize, and the
+	//   force arrays of each row block of the all-pairs kernel.
+	//
+	//*****************************************************************************************************************
+
+	template <typename T>
+	struct PackedParticles
+	{
+		std::vector <T> positionX;
+		std::vector <T> positionY;
+		std::vector <T> mass;
+		std::vector <T> radius;
+		std::vector <T> forceX;
+		std::vector <T> forceY;
+
+		std::vector <std::vector <T>> blockForceX;
+		std::vector <std::vector <T>> blockForceY;
+
+		void resize ( std::size_t n )
+		{
+			positionX.resize ( n );
+			positionY.resize ( n );
+			mass.resize      ( n );
+			radius.resize    ( n );
+			forceX.assign    ( n, T ( 0 ) );
+			forceY.assign    ( n, T ( 0 ) );
+		}
+
+		engine::PairForceArrays <T> arrays ()
+		{
+			return { positionX.data (), positionY.data (), mass.data (), radius.data (), forceX.data (), forceY.data (), positionX.size () };
+		}
+	};
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	PackedParticles <double>        packed;
+	PackedParticles <float>         packedSingle;
+	std::vector <ComponentPhysics*> physics;
+	std::vector <std::size_t>       blockRows;
+	engine::PairAccumulator         accumulator;
+
+	//=================================================================================================================
+	// Methods
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: partitionRows
+	//
+	// Description:
+	//
+	//   Cut the rows of n particles into blocks holding about the same number of pairs, so row i < j blocks of the
+	//   triangular pair matrix cost about the same. blockRows receives the first row of every block, followed by n.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void partitionRows ( std::size_t n )
+	{
+		std::size_t blockCount = std::max ( std::size_t ( 1 ), std::min ( MAX_BLOCKS, n / MIN_BLOCK_ROWS ) );
+		double      pairs      = 0.5 * static_cast <double> ( n ) * static_cast <double> ( n - 1 );
+		double      visited    = 0.0;
+
+		blockRows.assign ( 1, 0 );
+
+		for ( std::size_t i = 0; i < n && blockRows.size () < blockCount; ++i )
+		{
+			visited += static_cast <double> ( n - i - 1 );
+
+			if ( visited >= pairs * static_cast <double> ( blockRows.size () ) / static_cast <double> ( blockCount ) ) blockRows.push_back ( i + 1 );
+		}
+
+		blockRows.push_back ( n );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: accumulateAllPairs
+	//
+	// Description:
+	//
+	//   Run the all-pairs kernel over every block of rows, on the job system if one is set, and add the blocks'
+	//   forces to the packed force sums.
+	//
+	//   A block only writes the forces of its own rows and of later points, so its arrays start at its first row.
+	//   The blocks' forces are added to each point in block order.
+	//
+	// Arguments:
+	//
+	//   particles (PackedParticles <T>&):
+	//     The packed particles. Forces are added to forceX and forceY.
+	//
+	//   laws (const engine::PairForceLaws <T>&):
+	//     The force law constants and enabled flags.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename T>
+	void accumulateAllPairs ( PackedParticles <T>& particles, const engine::PairForceLaws <T>& laws )
+	{
+		std::size_t n = particles.positionX.size ();
+
+		if ( n == 0 ) return;
+
+		partitionRows ( n );
+
+		std::size_t blockCount = blockRows.size () - 1;
+
+		particles.blockForceX.resize ( blockCount );
+		particles.blockForceY.resize ( blockCount );
+
+		engine::parallelFor ( jobs, blockCount, 1, [ & ] ( std::size_t begin, std::size_t end )
+		{
+			for ( std::size_t block = begin; block < end; ++block )
+			{
+				std::size_t first = blockRows [ block ];
+				std::size_t last  = blockRows [ block + 1 ];
+
+				particles.blockForceX [ block ].assign ( n - first, T ( 0 ) );
+				particles.blockForceY [ block ].assign ( n - first, T ( 0 ) );
+
+				engine::PairForceArrays <T> arrays
+				{
+					particles.positionX.data () + first,
+					particles.positionY.data () + first,
+					particles.mass.data ()      + first,
+					particles.radius.data ()    + first,
+					particles.blockForceX [ block ].data (),
+					particles.blockForceY [ block ].data (),
+					n - first
+				};
+
+				engine::accumulatePairForces ( instructionSet, arrays, laws, 0, last - first );
+			}
+		} );
+
+		engine::parallelFor ( jobs, n, PARALLEL_GRAIN, [ & ] ( std::size_t begin, std::size_t end )
+		{
+			for ( std::size_t i = begin; i < end; ++i )
+			{
+				for ( std::size_t block = 0; block < blockCount && blockRows [ block ] <= i; ++block )
+				{
+					particles.forceX [ i ] += particles.blockForceX [ block ] [ i - blockRows [ block ] ];
+					particles.forceY [ i ] += particles.blockForceY [ block ] [ i - blockRows [ block ] ];
+				}
+			}
+		} );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: accumulateAllPairsSingle
+	//
+	// Description:
+	//
+	//   Run the all-pairs kernel in single precision, which doubles the pairs per vector instruction, and add the
+	//   resulting forces to the double-precision sums.
+	//
+	//   Positions are taken relative to the first particle before narrowing, so precision is spent on separations
+	//   rather than on the distance from the origin.
+	//
+	// Arguments:
+	//
+	//   laws (const engine::PairForceLaws <double>&):
+	//     The force law constants and enabled flags.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void accumulateAllPairsSingle ( const engine::PairForceLaws <double>& laws )
+	{
+		std::size_t n = packed.positionX.size ();
+
+		if ( n == 0 ) return;
+
+		packedSingle.resize ( n );
+
+		for ( std::size_t i = 0; i < n; ++i )
+		{
+			packedSingle.positionX [ i ] = static_cast <float> ( packed.positionX [ i ] - packed.positionX [ 0 ] );
+			packedSingle.positionY [ i ] = static_cast <float> ( packed.positionY [ i ] - packed.positionY [ 0 ] );
+			packedSingle.mass      [ i ] = static_cast <float> ( packed.mass      [ i ] );
+			packedSingle.radius    [ i ] = static_cast <float> ( packed.radius    [ i ] );
+		}
+
+		engine::PairForceLaws <float> lawsSingle;
+
+		lawsSingle.gravitationalConstant = static_cast <float> ( laws.gravitationalConstant );
+		lawsSingle.repulsiveConstant     = static_cast <float> ( laws.repulsiveConstant );
+		lawsSingle.softeningEpsilon      = static_cast <float> ( laws.softeningEpsilon );
+		lawsSingle.gravity               = laws.gravity;
+		lawsSingle.repulsion             = laws.repulsion;
+
+		accumulateAllPairs ( packedSingle, lawsSingle );
+
+		engine::parallelFor ( jobs, n, PARALLEL_GRAIN, [ this ] ( std::size_t begin, std::size_t end )
+		{
+			for ( std::size_t i = begin; i < end; ++i )
+			{
+				packed.forceX [ i ] += packedSingle.forceX [ i ];
+				packed.forceY [ i ] += packedSingle.forceY [ i ];
+			}
+		} );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: accumulateNeighbourPairs
+	//
+	// Description:
+	//
+	//   Apply repulsion to the pairs in the shared neighbour list, which holds every pair within repulsion range. The
+	//   pairs are summed by the PairAccumulator, on the job system if one is set.
+	//
+	// Arguments:
+	//
+	//   neighbourList (ComponentNeighbourList&):
+	//     The neighbour list shared with SystemRepulsion and SystemCollider.
+	//
+	//   particles (ecs::Span <const ecs::Entity>):
+	//     The system's particles, parallel to the packed arrays.
+	//
+	//   laws (const engine::PairForceLaws <double>&):
+	//     The force law constants.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void accumulateNeighbourPairs ( ComponentNeighbourList& neighbourList, ecs::Span <const ecs::Entity> particles, const engine::PairForceLaws <double>& laws )
+	{
+		updateNeighbourList
+		(
+			neighbourList,
+			particles,
+			[ this ] ( std::size_t i ) { return engine::Vector2D { packed.positionX [ i ], packed.positionY [ i ] }; },
+			[ this ] ( std::size_t i ) { return packed.radius [ i ]; }
+		);
+
+		auto        arrays = packed.arrays ();
+		std::size_t n      = arrays.count;
+
+		accumulator.accumulateListedPairs ( jobs, neighbourList.pairs, n, [ &arrays, &laws ] ( std::size_t i, std::size_t j, engine::Vector2D& force )
+		{
+			return engine::pairForce <double, false, true> ( arrays, laws, i, j, force.x, force.y );
+		} );
+
+		engine::parallelFor ( jobs, n, PARALLEL_GRAIN, [ this ] ( std::size_t begin, std::size_t end )
+		{
+			for ( std::size_t i = begin; i < end; ++i )
+			{
+				packed.forceX [ i ] += accumulator.getForce ( i ).x;
+				packed.forceY [ i ] += accumulator.getForce ( i ).y;
+			}
+		} );
+	}
+};
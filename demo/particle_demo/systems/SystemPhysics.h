@@ -19,13 +19,16 @@
 
 #include "../../../ecs/System.h"
 #include "../../../ecs/World.h"
-#include "../components/ComponentParticleGroup.h"
+#include "../../../engine/JobSystem.h"
 #include "../components/ComponentTransform.h"
 #include "../components/ComponentPhysics.h"
 #include "../components/ComponentTrail.h"
+#include "../components/ComponentTrailStyle.h"
 #include "../components/ComponentUserControl.h"
 #include "../components/ComponentWorld.h"
 
+#include <algorithm>
+
 //*********************************************************************************************************************
 // Class: SystemPhysics
 //
@@ -35,6 +38,8 @@
 //   friction damping with optional anisotropic damping for user-controlled particles, and records each
 //   particle's position into its trail history buffer.
 //
+//   Each particle is updated independently, so when jobs is set the particles are split across its threads.
+//
 //*********************************************************************************************************************
 
 class SystemPhysics : public ecs::System
@@ -45,8 +50,13 @@ public:
 	// Data Members
 	//=================================================================================================================
 
-	ecs::Entity worldEntity         = ecs::NULL_ENTITY;
-	double      anisotropicFriction = 0.99;
+	ecs::Entity        worldEntity         = ecs::NULL_ENTITY;
+	engine::JobSystem* jobs                = nullptr;
+	double             anisotropicFriction = 0.99;
+
+	// The smallest number of particles worth handing to another thread.
+
+	static constexpr std::size_t PARALLEL_GRAIN = 1024;
 
 	//=================================================================================================================
 	// Methods
@@ -58,9 +68,9 @@ public:
 	// Description:
 	//
 	//   Integrate velocity into position, apply friction damping to velocity, and append the current position
-	//   to the trail history deque for each particle entity.
+	//   to the trail history ring buffer for each particle entity.
 	//
-	//   Trims trail history to the configured depth limit.
+	//   Sizes each ring buffer to the configured depth limit, so a full trail drops its oldest position.
 	//
 	// Arguments:
 	//
@@ -84,57 +94,77 @@ public:
 
 		if ( worldComponent.paused ) return;
 
-		// Iterate over all matched particle entities to integrate velocity, apply friction, and record trails.
+		// Resolve the optional user control storage and the shared trail styles once; at most a few particles carry
+		// user control, and every particle only holds a handle to its group's trail style.
 
-		for ( auto entity : entities )
-		{
-			// Fetch the transform, physics, and trail components needed for position integration and history tracking.
+		auto userControls    = world.view <ComponentUserControl> ();
+		auto trailStyles     = world.getSharedComponentArray <ComponentTrailStyle> ();
+		bool frictionEnabled = worldComponent.frictionEnabled;
 
-			auto& transform = world.getComponent <ComponentTransform> ( entity );
-			auto& physics   = world.getComponent <ComponentPhysics> ( entity );
-			auto& trail     = world.getComponent <ComponentTrail> ( entity );
+		// Iterate over all particles to integrate velocity, apply friction, and record trails, split across the job
+		// system's threads. The system's members are the particles, and each range touches only its own particles'
+		// components.
 
-			// Position integration.
+		auto particles    = entities.span ();
+		auto particleView = world.view <ComponentTransform, ComponentPhysics, ComponentTrail, ecs::Shared <ComponentTrailStyle>> ();
 
-			transform.translation.x += physics.velocity.x * dt;
-			transform.translation.y += physics.velocity.y * dt;
+		engine::parallelFor
+		(
+			jobs, particles.size (), PARALLEL_GRAIN,
+			[ & ] ( std::size_t begin, std::size_t end )
+			{
+				for ( std::size_t i = begin; i < end; ++i )
+				{
+					ecs::Entity                        entity     = particles [ i ];
+					ComponentTransform&                transform  = particleView.get <ComponentTransform>                ( entity );
+					ComponentPhysics&                  physics    = particleView.get <ComponentPhysics>                  ( entity );
+					ComponentTrail&                    trail      = particleView.get <ComponentTrail>                    ( entity );
+					ecs::Shared <ComponentTrailStyle>& trailStyle = particleView.get <ecs::Shared <ComponentTrailStyle>> ( entity );
 
-			// Friction damping.
+					// Position integration, keeping the start of the step for render interpolation.
 
-			if ( worldComponent.frictionEnabled )
-			{
-				// User-controlled particles use anisotropic friction: stronger damping on axes without active input.
+					transform.previousTranslation = transform.translation;
 
-				if ( world.hasComponent <ComponentUserControl> ( entity ) )
-				{
-					auto& userControl = world.getComponent <ComponentUserControl> ( entity );
+					transform.translation.x += physics.velocity.x * dt;
+					transform.translation.y += physics.velocity.y * dt;
 
-					bool userInputX = userControl.accelerateLeft || userControl.accelerateRight;
-					bool userInputY = userControl.accelerateUp   || userControl.accelerateDown;
+					// Friction damping.
 
-					double frictionX = userInputX ? physics.frictionCoefficient : anisotropicFriction;
-					double frictionY = userInputY ? physics.frictionCoefficient : anisotropicFriction;
+					if ( frictionEnabled )
+					{
+						// User-controlled particles use anisotropic friction: stronger damping on axes without active input.
 
-					physics.velocity.x *= frictionX;
-					physics.velocity.y *= frictionY;
-				}
-				else
-				{
-					// Non-user-controlled particles apply the standard isotropic friction coefficient uniformly to both axes.
+						if ( userControls.contains ( entity ) )
+						{
+							auto& userControl = userControls.get <ComponentUserControl> ( entity );
 
-					physics.velocity.x *= physics.frictionCoefficient;
-					physics.velocity.y *= physics.frictionCoefficient;
-				}
-			}
+							bool userInputX = userControl.accelerateLeft || userControl.accelerateRight;
+							bool userInputY = userControl.accelerateUp   || userControl.accelerateDown;
 
-			// Record trail history.
+							double frictionX = userInputX ? physics.frictionCoefficient : anisotropicFriction;
+							double frictionY = userInputY ? physics.frictionCoefficient : anisotropicFriction;
 
-			trail.history.push_back ( { transform.translation.x, transform.translation.y } );
+							physics.velocity.x *= frictionX;
+							physics.velocity.y *= frictionY;
+						}
+						else
+						{
+							// Non-user-controlled particles apply the standard isotropic friction coefficient uniformly to both axes.
 
-			while ( static_cast <int> ( trail.history.size () ) > trail.depth )
-			{
-				trail.history.pop_front ();
+							physics.velocity.x *= physics.frictionCoefficient;
+							physics.velocity.y *= physics.frictionCoefficient;
+						}
+					}
+
+					// Record trail history. The ring is sized to the style's depth, which only reallocates if the depth
+					// changes, and a full ring drops its oldest position as it records the new one.
+
+					int depth = trailStyles->getValue ( trailStyle ).depth;
+
+					trail.history.setCapacity ( static_cast <std::size_t> ( std::max ( 0, depth ) ) );
+					trail.history.push ( { transform.translation.x, transform.translation.y } );
+				}
 			}
-		}
+		);
 	}
 };
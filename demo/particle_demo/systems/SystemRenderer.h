@@ -27,6 +27,7 @@
 #include "../components/ComponentSprite.h"
 #include "../components/ComponentShadow.h"
 #include "../components/ComponentTrail.h"
+#include "../components/ComponentTrailStyle.h"
 #include "../components/ComponentProjection2D.h"
 #include "../components/ComponentBackgroundImage.h"
 #include "../components/ComponentUserControl.h"
@@ -51,6 +52,8 @@
 //
 //   - Uses SDL2 textures and fonts via the SDLRenderer facade.
 //
+//   - Trails, shadows, and sprites are drawn grouped by the shared style or texture they reference.
+//
 //*********************************************************************************************************************
 
 class SystemRenderer : public ecs::System
@@ -81,7 +84,8 @@ public:
 	//   Execute the multi-pass rendering pipeline for the current frame.
 	//
 	//   Draws the background, particle trails, shadows, sprites, wireframe circles, HUD overlay, and pause
-	//   indicator in sequential render passes.
+	//   indicator in sequential render passes. Shadows, sprites, circles, and the head of each trail are drawn at the
+	//   world's interpolation alpha between each particle's last two simulation steps.
 	//
 	// Arguments:
 	//
@@ -101,6 +105,10 @@ public:
 
 		auto& worldComponent = world.getComponent <ComponentWorld> ( worldEntity );
 
+		// Draw particles between their last two simulation steps. A paused simulation holds its latest step.
+
+		double interpolation = worldComponent.paused ? 1.0 : world.getInterpolationAlpha ();
+
 		// Compute the world-to-screen scaling factor based on the screen height and zoom level.
 
 		double zoom          = 1.0;
@@ -137,129 +145,171 @@ public:
 
 		if ( worldComponent.trailsVisible )
 		{
-			// Iterate over all particle entities and render their motion trail line segments with fading opacity.
+			// Iterate over the particles one shared trail style at a time and render their motion trail line segments
+			// with fading opacity. The style's color, opacity gradient, and thickness are read once per group.
 
-			for ( auto entity : entities )
-			{
-				// Fetch the trail history and projection scale for this particle entity.
+			world.forEachSharedGroup <ComponentTrailStyle>
+			(
+				[ & ] ( const ComponentTrailStyle& style, ecs::Span <const ecs::Entity> group )
+				{
+					for ( auto entity : group )
+					{
+						// Fetch the trail history, transform, and projection scale for this particle entity.
 
-				auto& trail      = world.getComponent <ComponentTrail>        ( entity );
-				auto& projection = world.getComponent <ComponentProjection2D> ( entity );
+						auto& trail      = world.getComponent <ComponentTrail>        ( entity );
+						auto& transform  = world.getComponent <ComponentTransform>    ( entity );
+						auto& projection = world.getComponent <ComponentProjection2D> ( entity );
 
-				// Compute the per-entity world-to-screen scale from the projection and count the trail history points.
+						// Compute the per-entity world-to-screen scale from the projection and count the trail history points.
 
-				double z                  = projection.scale.x;
-				double worldToScreenScale = screenHeight * z;
+						double z                  = projection.scale.x;
+						double worldToScreenScale = screenHeight * z;
 
-				int totalPoints = static_cast <int> ( trail.history.size () );
+						int totalPoints = static_cast <int> ( trail.history.size () );
 
-				// A trail needs at least two points to form a line segment; skip entities with insufficient history.
+						// A trail needs at least two points to form a line segment; skip entities with insufficient history.
 
-				if ( totalPoints < 2 ) continue;
+						if ( totalPoints < 2 ) continue;
 
-				// Draw each consecutive pair of trail points as a line segment with interpolated opacity from tail to head.
+						// Draw each consecutive pair of trail points as a line segment with interpolated opacity from tail to head.
+						// The history is walked as its ring buffer's two contiguous runs, oldest first, so the segment that
+						// crosses from the first run to the second is drawn like any other. The newest point is the end of the
+						// latest simulation step, so the last segment ends at the interpolated position the sprite is drawn at.
 
-				for ( int i = 0; i < totalPoints - 1; ++i )
-				{
-					// Linearly interpolate opacity from the tail value to the head value based on the segment's position in the trail.
+						engine::Vector2D        head    = interpolate ( transform, interpolation );
+						const engine::Vector2D* p1      = nullptr;
+						int                     segment = 0;
 
-					double progress = static_cast <double> ( i ) / ( totalPoints - 1 );
-					double alpha    = trail.opacityTail + progress * ( trail.opacityHead - trail.opacityTail );
+						for ( ecs::Span <const engine::Vector2D> run : trail.history.spans () )
+						{
+							for ( const engine::Vector2D& p2 : run )
+							{
+								// The oldest point only starts the first segment.
 
-					// Convert the normalized alpha to a byte value and build the RGBA color for this trail segment.
+								if ( p1 == nullptr )
+								{
+									p1 = &p2;
+									continue;
+								}
 
-					uint8_t a = static_cast <uint8_t> ( alpha * 255.0 );
+								// Linearly interpolate opacity from the tail value to the head value based on the segment's position in the trail.
 
-					engine::Color color =
-					{
-						static_cast <uint8_t> ( trail.colorR ),
-						static_cast <uint8_t> ( trail.colorG ),
-						static_cast <uint8_t> ( trail.colorB ),
-						a
-					};
+								double progress = static_cast <double> ( segment ) / ( totalPoints - 1 );
+								double alpha    = style.opacityTail + progress * ( style.opacityHead - style.opacityTail );
+
+								// Convert the normalized alpha to a byte value and build the RGBA color for this trail segment.
+
+								uint8_t a = static_cast <uint8_t> ( alpha * 255.0 );
+
+								engine::Color color =
+								{
+									static_cast <uint8_t> ( style.colorR ),
+									static_cast <uint8_t> ( style.colorG ),
+									static_cast <uint8_t> ( style.colorB ),
+									a
+								};
 
-					// Retrieve the start and end positions of the current trail line segment from the history buffer.
+								// Transform the trail segment endpoints from world coordinates to screen pixel coordinates.
 
-					auto& p1 = trail.history [ i ];
-					auto& p2 = trail.history [ i + 1 ];
+								const engine::Vector2D& end = ( segment == totalPoints - 2 ) ? head : p2;
 
-					// Transform the trail segment endpoints from world coordinates to screen pixel coordinates.
+								int lineStartX = static_cast <int> ( p1->x * worldToScreenScale );
+								int lineStartY = static_cast <int> ( p1->y * worldToScreenScale );
+								int lineEndX   = static_cast <int> ( end.x * worldToScreenScale );
+								int lineEndY   = static_cast <int> ( end.y * worldToScreenScale );
 
-					int lineStartX = static_cast <int> ( p1.x * worldToScreenScale );
-					int lineStartY = static_cast <int> ( p1.y * worldToScreenScale );
-					int lineEndX   = static_cast <int> ( p2.x * worldToScreenScale );
-					int lineEndY   = static_cast <int> ( p2.y * worldToScreenScale );
+								// Render the trail line segment with the configured thickness and the interpolated fade color.
 
-					// Render the trail line segment with the configured thickness and the interpolated fade color.
+								renderer->drawLine ( lineStartX, lineStartY, lineEndX, lineEndY, color, style.thickness );
 
-					renderer->drawLine ( lineStartX, lineStartY, lineEndX, lineEndY, color, trail.thickness );
+								p1 = &p2;
+								++segment;
+							}
+						}
+					}
 				}
-			}
+			);
 		}
 
 		// Pass 3: Shadows.
+		//
+		// Particles are drawn one shared shadow at a time, so the shadow texture is looked up once per group.
 
-		for ( auto entity : entities )
-		{
-			// Fetch the shadow, transform, circle, and projection components needed to render the drop shadow.
+		world.forEachSharedGroup <ComponentShadow>
+		(
+			[ & ] ( const ComponentShadow& shadow, ecs::Span <const ecs::Entity> group )
+			{
+				// Load the shadow texture from the cached resource path; skip the group if the texture is unavailable.
 
-			auto& shadow     = world.getComponent <ComponentShadow>       ( entity );
-			auto& transform  = world.getComponent <ComponentTransform>    ( entity );
-			auto& circle     = world.getComponent <ComponentCircle>       ( entity );
-			auto& projection = world.getComponent <ComponentProjection2D> ( entity );
+				SDL_Texture* shadowTexture = renderer->loadTexture ( shadow.imagePath );
+				if ( !shadowTexture ) return;
 
-			// Compute the per-entity world-to-screen scale using the projection's depth factor.
+				for ( auto entity : group )
+				{
+					// Fetch the transform, circle, and projection components needed to render the drop shadow.
 
-			double z                  = projection.scale.x;
-			double worldToScreenScale = screenHeight * z;
+					auto& transform  = world.getComponent <ComponentTransform>    ( entity );
+					auto& circle     = world.getComponent <ComponentCircle>       ( entity );
+					auto& projection = world.getComponent <ComponentProjection2D> ( entity );
 
-			// Load the shadow texture from the cached resource path; skip this entity if the texture is unavailable.
+					// Compute the per-entity world-to-screen scale using the projection's depth factor.
 
-			SDL_Texture* shadowTexture = renderer->loadTexture ( shadow.imagePath );
-			if ( !shadowTexture ) continue;
+					double z                  = projection.scale.x;
+					double worldToScreenScale = screenHeight * z;
 
-			// Compute the shadow's screen-space diameter, position (offset from the particle), and draw the shadow texture.
+					// Compute the shadow's screen-space diameter, position (offset from the particle), and draw the shadow texture.
 
-			double diameter        = circle.radius * 2.0 * shadow.scale * worldToScreenScale;
-			int    shadowPositionX = static_cast <int> ( ( transform.translation.x + shadow.offset.x ) * worldToScreenScale - diameter / 2.0 );
-			int    shadowPositionY = static_cast <int> ( ( transform.translation.y + shadow.offset.y ) * worldToScreenScale - diameter / 2.0 );
-			int    shadowWidth     = static_cast <int> ( diameter );
-			int    shadowHeight    = static_cast <int> ( diameter );
+					engine::Vector2D position        = interpolate ( transform, interpolation );
+					double           diameter        = circle.radius * 2.0 * shadow.scale * worldToScreenScale;
+					int              shadowPositionX = static_cast <int> ( ( position.x + shadow.offset.x ) * worldToScreenScale - diameter / 2.0 );
+					int              shadowPositionY = static_cast <int> ( ( position.y + shadow.offset.y ) * worldToScreenScale - diameter / 2.0 );
+					int              shadowWidth     = static_cast <int> ( diameter );
+					int              shadowHeight    = static_cast <int> ( diameter );
 
-			renderer->drawTexture ( shadowTexture, shadowPositionX, shadowPositionY, shadowWidth, shadowHeight, shadow.opacity );
-		}
+					renderer->drawTexture ( shadowTexture, shadowPositionX, shadowPositionY, shadowWidth, shadowHeight, shadow.opacity );
+				}
+			}
+		);
 
 		// Pass 4: Sprites.
+		//
+		// Particles are drawn one shared sprite at a time, so each sprite texture is looked up once per group.
 
-		for ( auto entity : entities )
-		{
-			// Fetch the sprite, transform, circle, and projection components needed to render the particle sprite.
+		world.forEachSharedGroup <ComponentSprite>
+		(
+			[ & ] ( const ComponentSprite& sprite, ecs::Span <const ecs::Entity> group )
+			{
+				// Load the sprite texture from the cached resource path; skip the group if the texture is unavailable.
 
-			auto& sprite     = world.getComponent <ComponentSprite>       ( entity );
-			auto& transform  = world.getComponent <ComponentTransform>    ( entity );
-			auto& circle     = world.getComponent <ComponentCircle>       ( entity );
-			auto& projection = world.getComponent <ComponentProjection2D> ( entity );
+				SDL_Texture* spriteTexture = renderer->loadTexture ( sprite.imagePath );
+				if ( !spriteTexture ) return;
 
-			// Compute the per-entity world-to-screen scale from the projection depth factor.
+				for ( auto entity : group )
+				{
+					// Fetch the transform, circle, and projection components needed to render the particle sprite.
 
-			double z                  = projection.scale.x;
-			double worldToScreenScale = screenHeight * z;
+					auto& transform  = world.getComponent <ComponentTransform>    ( entity );
+					auto& circle     = world.getComponent <ComponentCircle>       ( entity );
+					auto& projection = world.getComponent <ComponentProjection2D> ( entity );
 
-			// Load the sprite texture from the cached resource path; skip this entity if the texture is unavailable.
+					// Compute the per-entity world-to-screen scale from the projection depth factor.
 
-			SDL_Texture* spriteTexture = renderer->loadTexture ( sprite.imagePath );
-			if ( !spriteTexture ) continue;
+					double z                  = projection.scale.x;
+					double worldToScreenScale = screenHeight * z;
 
-			// Compute the sprite's screen-space bounding box from its circle radius and draw it centered on the particle.
+					// Compute the sprite's screen-space bounding box from its circle radius and draw it centered on the particle.
 
-			double diameter      = circle.radius * 2.0 * worldToScreenScale;
-			int    drawPositionX = static_cast <int> ( transform.translation.x * worldToScreenScale - diameter / 2.0 );
-			int    drawPositionY = static_cast <int> ( transform.translation.y * worldToScreenScale - diameter / 2.0 );
-			int    drawWidth     = static_cast <int> ( diameter );
-			int    drawHeight    = static_cast <int> ( diameter );
+					engine::Vector2D position      = interpolate ( transform, interpolation );
+					double           diameter      = circle.radius * 2.0 * worldToScreenScale;
+					int              drawPositionX = static_cast <int> ( position.x * worldToScreenScale - diameter / 2.0 );
+					int              drawPositionY = static_cast <int> ( position.y * worldToScreenScale - diameter / 2.0 );
+					int              drawWidth     = static_cast <int> ( diameter );
+					int              drawHeight    = static_cast <int> ( diameter );
 
-			renderer->drawTexture ( spriteTexture, drawPositionX, drawPositionY, drawWidth, drawHeight, sprite.opacity );
-		}
+					renderer->drawTexture ( spriteTexture, drawPositionX, drawPositionY, drawWidth, drawHeight, sprite.opacity );
+				}
+			}
+		);
 
 		// Pass 5: Wireframe circles.
 
@@ -280,8 +330,10 @@ public:
 			double z                  = projection.scale.x;
 			double worldToScreenScale = screenHeight * z;
 
-			int circlePositionX = static_cast <int> ( transform.translation.x * worldToScreenScale );
-			int circlePositionY = static_cast <int> ( transform.translation.y * worldToScreenScale );
+			engine::Vector2D position = interpolate ( transform, interpolation );
+
+			int circlePositionX = static_cast <int> ( position.x * worldToScreenScale );
+			int circlePositionY = static_cast <int> ( position.y * worldToScreenScale );
 			int circleRadius    = static_cast <int> ( circle.radius * worldToScreenScale );
 
 			// Build the wireframe circle color from the circle component's RGB values at full opacity.
@@ -307,9 +359,10 @@ public:
 
 			auto& hud = world.getComponent <ComponentHud> ( hudEntity );
 
-			// Only render the HUD if it is marked visible and has non-empty text content to display.
+			// Only render the HUD if it is marked visible and has non-empty text content to display, or if it shows
+			// the system profile.
 
-			if ( hud.visible && !hud.text.empty () )
+			if ( ( hud.visible && !hud.text.empty () ) || hud.profilerVisible )
 			{
 				// Load the HUD font at the configured size; rendering is skipped if the font cannot be loaded.
 
@@ -319,9 +372,9 @@ public:
 
 				if ( font )
 				{
-					// Build HUD text from selected particle.
+					// Build HUD text from selected particle and the system profile.
 
-					std::string hudText = buildHudText ( world );
+					std::string hudText = buildHudText ( world, hud );
 
 					if ( !hudText.empty () )
 					{
@@ -390,66 +443,105 @@ public:
 
 private:
 
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: interpolate
+	//
+	// Description:
+	//
+	//   Return a particle's position a fraction alpha of the way from the start of the latest simulation step to
+	//   its end.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	static engine::Vector2D interpolate ( const ComponentTransform& transform, double alpha )
+	{
+		return
+		{
+			transform.previousTranslation.x + ( transform.translation.x - transform.previousTranslation.x ) * alpha,
+			transform.previousTranslation.y + ( transform.translation.y - transform.previousTranslation.y ) * alpha
+		};
+	}
+
 	//-----------------------------------------------------------------------------------------------------------------
 	// Method: buildHudText
 	//
 	// Description:
 	//
 	//   Build a formatted multi-line string containing diagnostic information for the currently selected
-	//   particle, including entity ID, group, mass, radius, position, velocity, and speed.
+	//   particle, including entity ID, group, mass, radius, position, velocity, and speed, followed by the live
+	//   per-system timings when the HUD shows the profile and the world's profiler is enabled.
 	//
 	// Arguments:
 	//
 	//   world (ecs::World&):
 	//     Reference to the ECS World, providing access to entity components.
 	//
+	//   hud (const ComponentHud&):
+	//     The HUD component, selecting which sections to show.
+	//
 	// Returns:
 	//
-	//   A formatted multi-line string with particle diagnostics, or an empty string if no particle is selected.
+	//   A formatted multi-line string with particle diagnostics and system timings, or an empty string if there is
+	//   nothing to show.
 	//
 	//-----------------------------------------------------------------------------------------------------------------
 
-	std::string buildHudText ( ecs::World& world ) const
+	std::string buildHudText ( ecs::World& world, const ComponentHud& hud ) const
 	{
+		std::ostringstream infoStream;
+		infoStream << std::fixed << std::setprecision ( 4 );
+
 		// Find the particle with ComponentUserControl.
 
 		ecs::Entity selected = ecs::NULL_ENTITY;
 
-		for ( auto entity : entities )
+		if ( hud.visible )
 		{
-			if ( world.hasComponent <ComponentUserControl> ( entity ) )
+			for ( auto entity : entities )
 			{
-				selected = entity;
-				break;
+				if ( world.hasComponent <ComponentUserControl> ( entity ) )
+				{
+					selected = entity;
+					break;
+				}
 			}
 		}
 
-		// Return an empty string if no particle entity has the user control component attached.
+		// Show the particle section only if a particle entity has the user control component attached.
 
-		if ( selected == ecs::NULL_ENTITY ) return "";
+		if ( selected != ecs::NULL_ENTITY )
+		{
+			// Retrieve the transform, physics, circle, and particle group components from the selected particle entity.
 
-		// Retrieve the transform, physics, circle, and particle group components from the selected particle entity.
+			auto& transform = world.getComponent <ComponentTransform>    ( selected );
+			auto& physics   = world.getComponent <ComponentPhysics>      ( selected );
+			auto& circle    = world.getComponent <ComponentCircle>       ( selected );
+			auto& group     = world.getComponent <ComponentParticleGroup> ( selected );
 
-		auto& transform = world.getComponent <ComponentTransform>    ( selected );
-		auto& physics   = world.getComponent <ComponentPhysics>      ( selected );
-		auto& circle    = world.getComponent <ComponentCircle>       ( selected );
-		auto& group     = world.getComponent <ComponentParticleGroup> ( selected );
+			// Compute the scalar speed as the magnitude of the velocity vector for display in the HUD.
 
-		// Compute the scalar speed as the magnitude of the velocity vector for display in the HUD.
+			double speed = physics.velocity.length ();
 
-		double speed = physics.velocity.length ();
+			// Format the particle diagnostics as a multi-line string with fixed-precision decimal values.
 
-		// Format the particle diagnostics as a multi-line string with fixed-precision decimal values.
+			infoStream << "Particle: " << selected << "\n";
+			infoStream << "Group:    " << group.groupIndex << "\n";
+			infoStream << "Mass:     " << physics.mass << "\n";
+			infoStream << "Radius:   " << circle.radius << "\n";
+			infoStream << "Position: (" << transform.translation.x << ", " << transform.translation.y << ")\n";
+			infoStream << "Velocity: (" << physics.velocity.x << ", " << physics.velocity.y << ")\n";
+			infoStream << "Speed:    " << speed << "\n";
+		}
 
-		std::ostringstream infoStream;
-		infoStream << std::fixed << std::setprecision ( 4 );
-		infoStream << "Particle: " << selected << "\n";
-		infoStream << "Group:    " << group.groupEntity << "\n";
-		infoStream << "Mass:     " << physics.mass << "\n";
-		infoStream << "Radius:   " << circle.radius << "\n";
-		infoStream << "Position: (" << transform.translation.x << ", " << transform.translation.y << ")\n";
-		infoStream << "Velocity: (" << physics.velocity.x << ", " << physics.velocity.y << ")\n";
-		infoStream << "Speed:    " << speed << "\n";
+		// Append the per-system timings over the profiler's rolling window, separated from the particle section by
+		// a blank line.
+
+		if ( hud.profilerVisible && world.getProfiler ().isEnabled () )
+		{
+			if ( selected != ecs::NULL_ENTITY ) infoStream << " \n";
+
+			world.dumpProfile ( infoStream );
+		}
 
 		// Return the fully assembled HUD diagnostic string for rendering by the caller.
 
@@ -23,9 +23,13 @@
 #include "../components/ComponentTransform.h"
 #include "../components/ComponentPhysics.h"
 #include "../components/ComponentCircle.h" 
+#include "../components/ComponentNeighbourList.h"
 #include "../components/ComponentWorld.h"
+#include "../../../engine/JobSystem.h"
+#include "../../../engine/PairAccumulator.h"
 
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 //*********************************************************************************************************************
@@ -38,6 +42,10 @@
 //
 //   Prevents clustering and provides a smooth transition zone before hard collision response.
 //
+//   Pairs are taken from the neighbour list on the world entity, so the cost is linear in the particle count for
+//   bounded density. They are summed by a PairAccumulator, on the job system if one is set, so the forces are the
+//   same for any thread count.
+//
 //*********************************************************************************************************************
 
 class SystemRepulsion : public ecs::System
@@ -48,7 +56,12 @@ public:
 	// Data Members
 	//=================================================================================================================
 
-	ecs::Entity worldEntity = ecs::NULL_ENTITY;
+	ecs::Entity        worldEntity = ecs::NULL_ENTITY;
+	engine::JobSystem* jobs        = nullptr;
+
+	// Particles per job when adding the summed forces to the force accumulators.
+
+	static constexpr std::size_t PARALLEL_GRAIN = 2048;
 
 	//=================================================================================================================
 	// Methods
@@ -59,8 +72,8 @@ public:
 	//
 	// Description:
 	//
-	//   Compute pairwise short-range repulsive forces between all particle entities and accumulate them into
-	//   each particle's force accumulator.
+	//   Compute pairwise short-range repulsive forces between neighbouring particle entities and accumulate them
+	//   into each particle's force accumulator.
 	//
 	//   Only active when particles are within twice their combined radii but not yet overlapping.
 	//
@@ -84,72 +97,102 @@ public:
 
 		auto& worldComponent = world.getComponent <ComponentWorld> ( worldEntity );
 
-		// Skip repulsion computation if the simulation is paused or repulsion is disabled.
+		// Skip repulsion computation if the simulation is paused, repulsion is disabled, or SystemPairForces evaluates it.
 
-		if ( worldComponent.paused || !worldComponent.repulsionEnabled ) return;
+		if ( worldComponent.paused || !worldComponent.repulsionEnabled || worldComponent.fusedForcesEnabled ) return;
 
-		// Cache the repulsive constant and collect all particle entities into a vector for indexed pair iteration.
+		// Cache the repulsive constant and resolve each particle's components once. Repulsion only writes force
+		// accumulators, so the pointers stay valid for the rest of the update.
 
 		double repulsiveConstant = worldComponent.repulsiveConstant;
 
-		std::vector <ecs::Entity> particles ( entities.begin (), entities.end () );
-		std::size_t n = particles.size ();
+		auto        particles = entities.span ();
+		std::size_t n         = particles.size ();
 
-		// Outer loop: iterate over all particles as the primary repulsion candidate.
+		transforms.resize ( n );
+		physics.resize    ( n );
+		circles.resize    ( n );
 
 		for ( std::size_t i = 0; i < n; ++i )
 		{
-			// Fetch transform, physics, and circle components for particle A.
+			transforms [ i ] = &world.getComponent <ComponentTransform> ( particles [ i ] );
+			physics    [ i ] = &world.getComponent <ComponentPhysics>   ( particles [ i ] );
+			circles    [ i ] = &world.getComponent <ComponentCircle>    ( particles [ i ] );
+		}
 
-			auto& transformEntityA = world.getComponent <ComponentTransform> ( particles [ i ] );
-			auto& physicsEntityA = world.getComponent <ComponentPhysics> ( particles [ i ] );
-			auto& circleEntityA = world.getComponent <ComponentCircle> ( particles [ i ] );
+		// Bring the shared neighbour list up to date. It holds every pair within the repulsion threshold, in the
+		// same order as a nested i < j loop. The update shows as its own zone in a profiler trace.
 
-			// Inner loop: test particle A against every subsequent particle to avoid redundant pair checks.
+		auto& neighbourList = world.getComponent <ComponentNeighbourList> ( worldEntity );
 
-			for ( std::size_t j = i + 1; j < n; ++j )
-			{
-				// Fetch transform, physics, and circle components for particle B.
+		{
+			ecs::Profiler::Zone zone ( world.getProfiler (), "Repulsion.NeighbourList" );
+
+			updateNeighbourList
+			(
+				neighbourList,
+				particles,
+				[ this ] ( std::size_t i ) -> const engine::Vector2D& { return transforms [ i ]->translation; },
+				[ this ] ( std::size_t i ) { return circles [ i ]->radius; }
+			);
+		}
+
+		// Visit each listed pair once and sum the equal and opposite forces (Newton's third law).
+
+		accumulator.accumulateListedPairs ( jobs, neighbourList.pairs, n, [ this, repulsiveConstant ] ( std::size_t i, std::size_t j, engine::Vector2D& force )
+		{
+			// Direction from particle 2 to particle 1 (repulsive, pushing away).
 
-				auto& transformEntityB = world.getComponent <ComponentTransform> ( particles [ j ] );
-				auto& physicsEntityB   = world.getComponent <ComponentPhysics> ( particles [ j ] );
-				auto& circleEntityB    = world.getComponent <ComponentCircle> ( particles [ j ] );
+			double deltaX   = transforms [ i ]->translation.x - transforms [ j ]->translation.x;
+			double deltaY   = transforms [ i ]->translation.y - transforms [ j ]->translation.y;
+			double distance = std::sqrt ( deltaX * deltaX + deltaY * deltaY );
 
-				// Direction from particle 2 to particle 1 (repulsive, pushing away).
+			// Compute the combined radii and the repulsion threshold at twice that distance.
 
-				double deltaX   = transformEntityA.translation.x - transformEntityB.translation.x;
-				double deltaY   = transformEntityA.translation.y - transformEntityB.translation.y;
-				double distance = std::sqrt ( deltaX * deltaX + deltaY * deltaY );
+			double minimumDistance = circles [ i ]->radius + circles [ j ]->radius;
+			double threshold       = minimumDistance * 2.0;
 
-				// Compute the combined radii and the repulsion threshold at twice that distance.
+			// Skip if particles are overlapping (handled by collider) or beyond the repulsion threshold.
 
-				double minimumDistance = circleEntityA.radius + circleEntityB.radius;
-				double threshold       = minimumDistance * 2.0;
+			if ( distance <= minimumDistance || distance >= threshold ) return false;
 
-				// Skip if particles are overlapping (handled by collider) or beyond the repulsion threshold.
+			// Quadratic falloff: force is strongest at the combined radii boundary and drops to zero at the threshold.
 
-				if ( distance <= minimumDistance || distance >= threshold ) continue;
+			double scaleFactor         = ( distance - minimumDistance ) / ( threshold - minimumDistance );
+			double oneMinusScaleFactor = 1.0 - scaleFactor;
+			double forceMagnitude      = repulsiveConstant * oneMinusScaleFactor * oneMinusScaleFactor;
 
-				// Quadratic falloff: force is strongest at the combined radii boundary and drops to zero at the threshold.
+			// Project the repulsive force magnitude along the unit normal direction between the two particles.
 
-				double scaleFactor         = ( distance - minimumDistance ) / ( threshold - minimumDistance );
-				double oneMinusScaleFactor = 1.0 - scaleFactor;
-				double forceMagnitude      = repulsiveConstant * oneMinusScaleFactor * oneMinusScaleFactor;
+			double normalX = deltaX / distance;
+			double normalY = deltaY / distance;
 
-				// Project the repulsive force magnitude along the unit normal direction between the two particles.
+			force.x = forceMagnitude * normalX;
+			force.y = forceMagnitude * normalY;
 
-				double normalX = deltaX / distance;
-				double normalY = deltaY / distance;
-				double forceX  = forceMagnitude * normalX;
-				double forceY  = forceMagnitude * normalY;
+			return true;
+		} );
 
-				// Apply equal and opposite repulsive forces to each particle's force accumulator (Newton's third law).
+		// Add each particle's summed force to its force accumulator.
 
-				physicsEntityA.forceAccumulator.x += forceX;
-				physicsEntityA.forceAccumulator.y += forceY;
-				physicsEntityB.forceAccumulator.x -= forceX;
-				physicsEntityB.forceAccumulator.y -= forceY;
+		engine::parallelFor ( jobs, n, PARALLEL_GRAIN, [ this ] ( std::size_t begin, std::size_t end )
+		{
+			for ( std::size_t i = begin; i < end; ++i )
+			{
+				physics [ i ]->forceAccumulator.x += accumulator.getForce ( i ).x;
+				physics [ i ]->forceAccumulator.y += accumulator.getForce ( i ).y;
 			}
-		}
+		} );
 	}
+
+private:
+
+	//=================================================================================================================
+	// Data Members
+	//=================================================================================================================
+
+	std::vector <ComponentTransform*> transforms;
+	std::vector <ComponentPhysics*>   physics;
+	std::vector <ComponentCircle*>    circles;
+	engine::PairAccumulator           accumulator;
 };
@@ -0,0 +1,600 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the Archetype class, which stores every entity sharing one component signature in fixed-size chunks
+//   with one contiguous column per component type.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "ComponentInfo.h"
+#include "Entity.h"
+#include "Signature.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Class: Archetype
+	//
+	// Description:
+	//
+	//   Table of all entities with one exact component signature, stored in structure-of-arrays form.
+	//
+	//   - Rows are packed into chunks of CHUNK_BYTES. Each chunk holds an entity column followed by one column per
+	//     component, so iterating a chunk walks each column linearly.
+	//
+	//   - Rows are dense: row r lives in chunk r / chunkCapacity. Removing a row moves the last row into the hole.
+	//
+	//   - Component values are constructed, moved, and destroyed through their ComponentInfo, so the archetype itself
+	//     is not a template.
+	//
+	//   - Component addresses are stable only until the next row is added to or removed from the archetype.
+	//
+	//*****************************************************************************************************************
+
+	class Archetype
+	{
+	public:
+
+		//=============================================================================================================
+		// Constants
+		//=============================================================================================================
+
+		static constexpr std::size_t CHUNK_BYTES     = 16 * 1024;
+		static constexpr std::size_t CHUNK_ALIGNMENT = 64;
+
+	private:
+
+		//=============================================================================================================
+		// Types
+		//=============================================================================================================
+
+		struct ChunkDeleter
+		{
+			void operator () ( std::byte* memory ) const
+			{
+				::operator delete ( memory, std::align_val_t ( CHUNK_ALIGNMENT ) );
+			}
+		};
+
+		using Chunk = std::unique_ptr <std::byte [], ChunkDeleter>;
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		Signature                                signature;
+		std::vector <ComponentBit>               columnBits;
+		std::vector <const ComponentInfo*>       columnInfos;
+		std::vector <std::size_t>                columnOffsets;
+		std::array  <int, MAX_COMPONENTS>        bitToColumn;
+		std::array  <Archetype*, MAX_COMPONENTS> addEdges    {};
+		std::array  <Archetype*, MAX_COMPONENTS> removeEdges {};
+		std::size_t                              chunkCapacity = 0;
+		std::size_t                              chunkBytes    = CHUNK_BYTES;
+		std::vector <Chunk>                      chunks;
+		std::size_t                              count         = 0;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getSignature
+		//
+		// Description:
+		//
+		//   Return the component signature shared by every entity in this archetype.
+		//
+		// Returns:
+		//
+		//   A const reference to the archetype's signature.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		const Signature& getSignature () const
+		{
+			return signature;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: size
+		//
+		// Description:
+		//
+		//   Return the number of entities stored in this archetype.
+		//
+		// Returns:
+		//
+		//   The row count.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t size () const
+		{
+			return count;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getChunkCapacity
+		//
+		// Description:
+		//
+		//   Return the number of rows that fit in one chunk.
+		//
+		// Returns:
+		//
+		//   The rows per chunk, always at least one.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getChunkCapacity () const
+		{
+			return chunkCapacity;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getChunkCount
+		//
+		// Description:
+		//
+		//   Return the number of chunks holding at least one row.
+		//
+		// Returns:
+		//
+		//   The occupied chunk count.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getChunkCount () const
+		{
+			return ( count + chunkCapacity - 1 ) / chunkCapacity;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getChunkSize
+		//
+		// Description:
+		//
+		//   Return the number of rows stored in a chunk. Every chunk except the last is full.
+		//
+		// Arguments:
+		//
+		//   chunk (std::size_t):
+		//     The chunk index. Must be less than getChunkCount ().
+		//
+		// Returns:
+		//
+		//   The row count of the chunk.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getChunkSize ( std::size_t chunk ) const
+		{
+			return std::min ( chunkCapacity, count - chunk * chunkCapacity );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getColumnBits
+		//
+		// Description:
+		//
+		//   Return the component bit stored in each column, in column order.
+		//
+		// Returns:
+		//
+		//   A const reference to the column bit list.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		const std::vector <ComponentBit>& getColumnBits () const
+		{
+			return columnBits;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getColumn
+		//
+		// Description:
+		//
+		//   Return the column that stores the component with the given bit.
+		//
+		// Arguments:
+		//
+		//   bit (ComponentBit):
+		//     The component bit.
+		//
+		// Returns:
+		//
+		//   The column index, or -1 if the archetype does not contain the component.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		int getColumn ( ComponentBit bit ) const
+		{
+			return bitToColumn [ bit ];
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getEntities
+		//
+		// Description:
+		//
+		//   Return the entity column of a chunk.
+		//
+		// Arguments:
+		//
+		//   chunk (std::size_t):
+		//     The chunk index. Must be less than getChunkCount ().
+		//
+		// Returns:
+		//
+		//   A pointer to getChunkSize ( chunk ) consecutive entity handles.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Entity* getEntities ( std::size_t chunk )
+		{
+			return reinterpret_cast <Entity*> ( chunks [ chunk ].get () );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getColumnData
+		//
+		// Description:
+		//
+		//   Return the start of a component column within a chunk.
+		//
+		// Arguments:
+		//
+		//   chunk (std::size_t):
+		//     The chunk index. Must be less than getChunkCount ().
+		//
+		//   column (int):
+		//     The column index returned by getColumn.
+		//
+		// Returns:
+		//
+		//   A pointer to getChunkSize ( chunk ) consecutive components.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void* getColumnData ( std::size_t chunk, int column )
+		{
+			return chunks [ chunk ].get () + columnOffsets [ column ];
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getEntity
+		//
+		// Description:
+		//
+		//   Return the entity stored in a row.
+		//
+		// Arguments:
+		//
+		//   row (std::size_t):
+		//     The row index. Must be less than size ().
+		//
+		// Returns:
+		//
+		//   The entity handle stored in the row.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Entity getEntity ( std::size_t row ) const
+		{
+			assert ( row < count && "Archetype row out of range." );
+			return reinterpret_cast <const Entity*> ( chunks [ row / chunkCapacity ].get () ) [ row % chunkCapacity ];
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getComponent
+		//
+		// Description:
+		//
+		//   Return the address of one component value.
+		//
+		// Arguments:
+		//
+		//   row (std::size_t):
+		//     The row index.
+		//
+		//   column (int):
+		//     The column index returned by getColumn.
+		//
+		// Returns:
+		//
+		//   A pointer to the component in the given row and column.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void* getComponent ( std::size_t row, int column )
+		{
+			std::byte* chunk = chunks [ row / chunkCapacity ].get ();
+			return chunk + columnOffsets [ column ] + ( row % chunkCapacity ) * columnInfos [ column ]->size;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: addEdge / removeEdge
+		//
+		// Description:
+		//
+		//   Return the cached transition to the archetype reached by adding or removing one component.
+		//
+		//   The cache is filled in by ArchetypeStorage the first time the transition is taken.
+		//
+		// Arguments:
+		//
+		//   bit (ComponentBit):
+		//     The component bit being added or removed.
+		//
+		// Returns:
+		//
+		//   A reference to the cached target archetype pointer, which is nullptr until resolved.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Archetype*& addEdge ( ComponentBit bit )
+		{
+			return addEdges [ bit ];
+		}
+
+		Archetype*& removeEdge ( ComponentBit bit )
+		{
+			return removeEdges [ bit ];
+		}
+
+		//=============================================================================================================
+		// Constructors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor: Archetype
+		//
+		// Description:
+		//
+		//   Build the column layout for a signature.
+		//
+		//   The rows per chunk is the largest count whose entity column plus aligned component columns fit in
+		//   CHUNK_BYTES. A row too large for a standard chunk gets a chunk sized for exactly one row.
+		//
+		// Arguments:
+		//
+		//   signature (const Signature&):
+		//     The component signature of the archetype.
+		//
+		//   componentInfos (const std::array <const ComponentInfo*, MAX_COMPONENTS>&):
+		//     The ComponentInfo of each registered component, indexed by component bit.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Archetype ( const Signature& signature, const std::array <const ComponentInfo*, MAX_COMPONENTS>& componentInfos )
+			: signature ( signature )
+		{
+			bitToColumn.fill ( -1 );
+
+			std::size_t rowBytes = sizeof ( Entity );
+
+			for ( ComponentBit bit = 0; bit < MAX_COMPONENTS; ++bit )
+			{
+				if ( !signature.test ( bit ) ) continue;
+
+				const ComponentInfo* info = componentInfos [ bit ];
+				assert ( info != nullptr                      && "Archetype uses an unregistered component." );
+				assert ( info->alignment <= CHUNK_ALIGNMENT && "Component alignment exceeds the chunk alignment." );
+
+				bitToColumn [ bit ] = static_cast <int> ( columnBits.size () );
+				columnBits.push_back  ( bit );
+				columnInfos.push_back ( info );
+				rowBytes += info->size;
+			}
+
+			columnOffsets.resize ( columnBits.size () );
+
+			// Start from the unpadded estimate and shrink until the padded layout fits.
+
+			chunkCapacity = std::max <std::size_t> ( 1, CHUNK_BYTES / rowBytes );
+
+			while ( chunkCapacity > 1 && layout ( chunkCapacity ) > CHUNK_BYTES )
+			{
+				--chunkCapacity;
+			}
+
+			chunkBytes = std::max ( CHUNK_BYTES, layout ( chunkCapacity ) );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Destructor: ~Archetype
+		//
+		// Description:
+		//
+		//   Destroy every component value still stored in the archetype.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		~Archetype ()
+		{
+			for ( std::size_t row = 0; row < count; ++row )
+			{
+				for ( std::size_t column = 0; column < columnInfos.size (); ++column )
+				{
+					columnInfos [ column ]->destroy ( getComponent ( row, static_cast <int> ( column ) ) );
+				}
+			}
+		}
+
+		Archetype ( const Archetype& )             = delete;
+		Archetype& operator = ( const Archetype& ) = delete;
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: pushRow
+		//
+		// Description:
+		//
+		//   Append a row for an entity, allocating a chunk if the last one is full.
+		//
+		//   Only the entity column is written. The caller must construct every component in the new row before the
+		//   archetype is iterated, grown, or destroyed.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity to store in the row.
+		//
+		// Returns:
+		//
+		//   The index of the new row.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t pushRow ( Entity entity )
+		{
+			if ( count == chunks.size () * chunkCapacity )
+			{
+				chunks.emplace_back
+				(
+					static_cast <std::byte*> ( ::operator new ( chunkBytes, std::align_val_t ( CHUNK_ALIGNMENT ) ) )
+				);
+			}
+
+			std::size_t row = count++;
+			reinterpret_cast <Entity*> ( chunks [ row / chunkCapacity ].get () ) [ row % chunkCapacity ] = entity;
+
+			return row;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: removeRow
+		//
+		// Description:
+		//
+		//   Destroy the components in a row and fill the hole by moving the last row into it.
+		//
+		//   Trailing chunks are released once more than one of them is empty, so an archetype whose size oscillates
+		//   around a chunk boundary does not reallocate on every change.
+		//
+		// Arguments:
+		//
+		//   row (std::size_t):
+		//     The row to remove. Must be less than size ().
+		//
+		// Returns:
+		//
+		//   The entity that was moved into the row, or NULL_ENTITY if the removed row was the last one.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Entity removeRow ( std::size_t row )
+		{
+			assert ( row < count && "Archetype row out of range." );
+
+			std::size_t last  = count - 1;
+			Entity      moved = NULL_ENTITY;
+
+			for ( std::size_t column = 0; column < columnInfos.size (); ++column )
+			{
+				const ComponentInfo* info = columnInfos [ column ];
+				void*                hole = getComponent ( row, static_cast <int> ( column ) );
+
+				info->destroy ( hole );
+
+				if ( row != last )
+				{
+					void* tail = getComponent ( last, static_cast <int> ( column ) );
+					info->moveConstruct ( hole, tail );
+					info->destroy       ( tail );
+				}
+			}
+
+			if ( row != last )
+			{
+				moved = getEntity ( last );
+				reinterpret_cast <Entity*> ( chunks [ row / chunkCapacity ].get () ) [ row % chunkCapacity ] = moved;
+			}
+
+			--count;
+
+			while ( chunks.size () > getChunkCount () + 1 )
+			{
+				chunks.pop_back ();
+			}
+
+			return moved;
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: layout
+		//
+		// Description:
+		//
+		//   Compute the column offsets for a given number of rows per chunk.
+		//
+		//   The entity column starts at offset zero. Each component column follows, aligned to its component type.
+		//
+		// Arguments:
+		//
+		//   rows (std::size_t):
+		//     The candidate rows per chunk.
+		//
+		// Returns:
+		//
+		//   The number of bytes the layout occupies.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t layout ( std::size_t rows )
+		{
+			std::size_t offset = rows * sizeof ( Entity );
+
+			for ( std::size_t column = 0; column < columnInfos.size (); ++column )
+			{
+				std::size_t alignment = columnInfos [ column ]->alignment;
+
+				offset                   = ( offset + alignment - 1 ) / alignment * alignment;
+				columnOffsets [ column ] = offset;
+				offset                  += rows * columnInfos [ column ]->size;
+			}
+
+			return offset;
+		}
+	};
+}
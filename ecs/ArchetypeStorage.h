@@ -0,0 +1,584 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the ArchetypeStorage class, the component store used by a World in archetype storage mode.
+//
+//   Groups entities by signature into Archetype tables and migrates an entity between tables when a component is
+//   added or removed.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "Archetype.h"
+#include "ComponentInfo.h"
+#include "Entity.h"
+#include "Signature.h"
+#include "Span.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Class: ArchetypeStorage
+	//
+	// Description:
+	//
+	//   Owns one Archetype per distinct signature in use and records where each entity's row lives.
+	//
+	//   - Adding or removing a component moves the entity's row to the neighbouring archetype, copying the columns
+	//     both archetypes share. Transitions are cached on the source archetype, so repeated structural changes of
+	//     the same shape skip the signature lookup.
+	//
+	//   - Entities with no components are not stored in any archetype.
+	//
+	//   - Archetypes are never destroyed while the storage lives, and are visited in creation order.
+	//
+	//*****************************************************************************************************************
+
+	class ArchetypeStorage
+	{
+	private:
+
+		//=============================================================================================================
+		// Types
+		//=============================================================================================================
+
+		struct EntityLocation
+		{
+			Archetype*  archetype = nullptr;
+			std::size_t row       = 0;
+		};
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::array <const ComponentInfo*, MAX_COMPONENTS>           componentInfos {};
+		std::unordered_map <Signature, std::unique_ptr <Archetype>> archetypes;
+		std::vector <Archetype*>                                    archetypeOrder;
+		std::vector <EntityLocation>                                locations;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: get
+		//
+		// Description:
+		//
+		//   Retrieve a mutable reference to an entity's component.
+		//
+		//   Asserts if the entity does not have the component.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity whose component is being accessed.
+		//
+		//   bit (ComponentBit):
+		//     The bit of component type T.
+		//
+		// Returns:
+		//
+		//   A reference to the component, valid until the next structural change to the entity's archetype.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		T& get ( Entity entity, ComponentBit bit )
+		{
+			assert ( has ( entity, bit ) && "Retrieving non-existent component." );
+
+			const EntityLocation& location = locations [ entityIndex ( entity ) ];
+			return *static_cast <T*> ( location.archetype->getComponent ( location.row, location.archetype->getColumn ( bit ) ) );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Predicate Accessor: has
+		//
+		// Description:
+		//
+		//   Check whether an entity has the component with the given bit.
+		//
+		//   Stale handles are rejected by comparing the handle with the one stored in the entity's row.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity to query.
+		//
+		//   bit (ComponentBit):
+		//     The component bit.
+		//
+		// Returns:
+		//
+		//   True if the entity is stored in an archetype containing the component, false otherwise.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool has ( Entity entity, ComponentBit bit ) const
+		{
+			uint32_t index = entityIndex ( entity );
+			if ( index >= locations.size () ) return false;
+
+			const EntityLocation& location = locations [ index ];
+
+			return location.archetype != nullptr
+				&& location.archetype->getSignature ().test ( bit )
+				&& location.archetype->getEntity ( location.row ) == entity;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getArchetypeCount
+		//
+		// Description:
+		//
+		//   Return the number of archetypes created so far.
+		//
+		// Returns:
+		//
+		//   The archetype count, including archetypes that are currently empty.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getArchetypeCount () const
+		{
+			return archetypeOrder.size ();
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: registerComponent
+		//
+		// Description:
+		//
+		//   Record the ComponentInfo for a component bit so archetypes containing it can lay out its column.
+		//
+		// Arguments:
+		//
+		//   bit (ComponentBit):
+		//     The component bit.
+		//
+		//   info (const ComponentInfo&):
+		//     The component's type-erased description. Must outlive the storage.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void registerComponent ( ComponentBit bit, const ComponentInfo& info )
+		{
+			componentInfos [ bit ] = &info;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: add
+		//
+		// Description:
+		//
+		//   Add a component to an entity by moving its row to the archetype that also contains the component.
+		//
+		//   Asserts if the entity already has the component.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The target entity.
+		//
+		//   bit (ComponentBit):
+		//     The bit of the component being added.
+		//
+		//   component (const void*):
+		//     The component value to copy into the new row.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void add ( Entity entity, ComponentBit bit, const void* component )
+		{
+			assert ( !has ( entity, bit ) && "Component added to same entity twice." );
+
+			EntityLocation& location = locate ( entity );
+			Archetype*      source   = location.archetype;
+			Archetype*      target;
+
+			if ( source != nullptr )
+			{
+				Archetype*& edge = source->addEdge ( bit );
+				if ( edge == nullptr ) edge = findOrCreate ( Signature ( source->getSignature () ).set ( bit ) );
+				target = edge;
+			}
+			else
+			{
+				target = findOrCreate ( Signature ().set ( bit ) );
+			}
+
+			std::size_t row = target->pushRow ( entity );
+
+			componentInfos [ bit ]->copyConstruct ( target->getComponent ( row, target->getColumn ( bit ) ), component );
+
+			migrate ( location, target, row );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: addMany
+		//
+		// Description:
+		//
+		//   Add several components to an entity with a single move, directly to the archetype that contains all of
+		//   them, instead of stepping through one intermediate archetype per component.
+		//
+		//   Asserts if the entity already has any of the components.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The target entity.
+		//
+		//   bits (const ComponentBit*):
+		//     The bits of the components being added.
+		//
+		//   components (const void* const*):
+		//     The component values to copy into the new row, parallel to bits.
+		//
+		//   count (std::size_t):
+		//     The number of components.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void addMany ( Entity entity, const ComponentBit* bits, const void* const* components, std::size_t count )
+		{
+			EntityLocation& location  = locate ( entity );
+			Signature       signature = location.archetype != nullptr ? location.archetype->getSignature () : Signature ();
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				assert ( !signature.test ( bits [ i ] ) && "Component added to same entity twice." );
+				signature.set ( bits [ i ] );
+			}
+
+			Archetype*  target = findOrCreate ( signature );
+			std::size_t row    = target->pushRow ( entity );
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				componentInfos [ bits [ i ] ]->copyConstruct
+				(
+					target->getComponent ( row, target->getColumn ( bits [ i ] ) ),
+					components [ i ]
+				);
+			}
+
+			migrate ( location, target, row );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: insertMany
+		//
+		// Description:
+		//
+		//   Place a list of entities that have no components yet into the archetype for a signature, giving every
+		//   entity a copy of the same component values.
+		//
+		//   Rows are appended first, then each column is filled for the whole list.
+		//
+		// Arguments:
+		//
+		//   entities (Span <const Entity>):
+		//     The entities to place. None may have any components.
+		//
+		//   signature (const Signature&):
+		//     The signature of the target archetype. Must contain exactly the bits given.
+		//
+		//   bits (const ComponentBit*):
+		//     The component bits.
+		//
+		//   components (const void* const*):
+		//     The component values to copy, parallel to bits.
+		//
+		//   count (std::size_t):
+		//     The number of components.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void insertMany
+		(
+			Span <const Entity> entities,
+			const Signature&    signature,
+			const ComponentBit* bits,
+			const void* const*  components,
+			std::size_t         count
+		)
+		{
+			if ( entities.empty () ) return;
+
+			Archetype*  target = findOrCreate ( signature );
+			std::size_t first  = target->size ();
+
+			for ( Entity entity : entities )
+			{
+				EntityLocation& location = locate ( entity );
+
+				assert ( location.archetype == nullptr && "Inserting entity that already has components." );
+
+				location.archetype = target;
+				location.row       = target->pushRow ( entity );
+			}
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				int                  column = target->getColumn ( bits [ i ] );
+				const ComponentInfo* info   = componentInfos [ bits [ i ] ];
+
+				for ( std::size_t row = first; row < first + entities.size (); ++row )
+				{
+					info->copyConstruct ( target->getComponent ( row, column ), components [ i ] );
+				}
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: remove
+		//
+		// Description:
+		//
+		//   Remove a component from an entity by moving its row to the archetype without the component.
+		//
+		//   Asserts if the entity does not have the component.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The target entity.
+		//
+		//   bit (ComponentBit):
+		//     The bit of the component being removed.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void remove ( Entity entity, ComponentBit bit )
+		{
+			assert ( has ( entity, bit ) && "Removing non-existent component." );
+
+			EntityLocation& location = locations [ entityIndex ( entity ) ];
+			Archetype*      source   = location.archetype;
+
+			// Removing the last component drops the entity out of archetype storage altogether.
+
+			if ( source->getSignature ().count () == 1 )
+			{
+				release ( location );
+				return;
+			}
+
+			Archetype*& edge = source->removeEdge ( bit );
+			if ( edge == nullptr ) edge = findOrCreate ( Signature ( source->getSignature () ).reset ( bit ) );
+
+			Archetype*  target = edge;
+			std::size_t row    = target->pushRow ( entity );
+
+			migrate ( location, target, row );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: entityDestroyed
+		//
+		// Description:
+		//
+		//   Destroy all components of an entity and remove its row.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The destroyed entity.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void entityDestroyed ( Entity entity )
+		{
+			uint32_t index = entityIndex ( entity );
+			if ( index >= locations.size () ) return;
+
+			EntityLocation& location = locations [ index ];
+
+			if ( location.archetype != nullptr && location.archetype->getEntity ( location.row ) == entity )
+			{
+				release ( location );
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: forEachArchetype
+		//
+		// Description:
+		//
+		//   Invoke a callable on every non-empty archetype whose signature contains all required components.
+		//
+		// Arguments:
+		//
+		//   required (const Signature&):
+		//     The components an archetype must contain.
+		//
+		//   function (Function&&):
+		//     Callable taking an Archetype&.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Function>
+		void forEachArchetype ( const Signature& required, Function&& function )
+		{
+			for ( Archetype* archetype : archetypeOrder )
+			{
+				if ( archetype->size () > 0 && ( archetype->getSignature () & required ) == required )
+				{
+					function ( *archetype );
+				}
+			}
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: locate
+		//
+		// Description:
+		//
+		//   Return the location record for an entity, growing the location table if the index is new.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		EntityLocation& locate ( Entity entity )
+		{
+			uint32_t index = entityIndex ( entity );
+
+			if ( index >= locations.size () )
+			{
+				locations.resize ( std::max <std::size_t> ( index + 1, locations.size () * 2 ) );
+			}
+
+			// A recycled index may still point at the row of its destroyed predecessor; only trust rows holding this
+			// exact handle.
+
+			EntityLocation& location = locations [ index ];
+
+			if ( location.archetype != nullptr && location.archetype->getEntity ( location.row ) != entity )
+			{
+				location = EntityLocation {};
+			}
+
+			return location;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: findOrCreate
+		//
+		// Description:
+		//
+		//   Return the archetype for a signature, creating it on first use.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Archetype* findOrCreate ( const Signature& signature )
+		{
+			auto& slot = archetypes [ signature ];
+
+			if ( !slot )
+			{
+				slot = std::make_unique <Archetype> ( signature, componentInfos );
+				archetypeOrder.push_back ( slot.get () );
+			}
+
+			return slot.get ();
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: migrate
+		//
+		// Description:
+		//
+		//   Move the shared columns of an entity's current row into a freshly pushed row of the target archetype,
+		//   remove the old row, and update the entity's location.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void migrate ( EntityLocation& location, Archetype* target, std::size_t row )
+		{
+			Archetype* source = location.archetype;
+
+			if ( source != nullptr )
+			{
+				const std::vector <ComponentBit>& bits = source->getColumnBits ();
+
+				for ( std::size_t column = 0; column < bits.size (); ++column )
+				{
+					int targetColumn = target->getColumn ( bits [ column ] );
+					if ( targetColumn < 0 ) continue;
+
+					componentInfos [ bits [ column ] ]->moveConstruct
+					(
+						target->getComponent ( row,          targetColumn ),
+						source->getComponent ( location.row, static_cast <int> ( column ) )
+					);
+				}
+
+				release ( location );
+			}
+
+			location.archetype = target;
+			location.row       = row;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: release
+		//
+		// Description:
+		//
+		//   Remove an entity's row from its archetype and patch the location of the entity moved into the hole.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void release ( EntityLocation& location )
+		{
+			Entity moved = location.archetype->removeRow ( location.row );
+
+			if ( moved != NULL_ENTITY )
+			{
+				locations [ entityIndex ( moved ) ].row = location.row;
+			}
+
+			location = EntityLocation {};
+		}
+	};
+}
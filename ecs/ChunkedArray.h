@@ -0,0 +1,217 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the ChunkedArray class template, a growable array stored as a list of fixed-size chunks.
+//
+//   Growing the array appends chunks instead of reallocating, so references to existing elements stay valid for the
+//   lifetime of the array.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Class: ChunkedArray
+	//
+	// Description:
+	//
+	//   Append-only array of T stored in chunks of CHUNK_SIZE elements.
+	//
+	//   - Element i lives in chunk i / CHUNK_SIZE at offset i % CHUNK_SIZE; both are computed with a shift and a
+	//     mask.
+	//
+	//   - Chunks are allocated value-initialized, either on demand by pushBack or up front by reserve.
+	//
+	//*****************************************************************************************************************
+
+	template <typename T, std::size_t ChunkBits = 12>
+	class ChunkedArray
+	{
+	public:
+
+		//=============================================================================================================
+		// Constants
+		//=============================================================================================================
+
+		static constexpr std::size_t CHUNK_SIZE = std::size_t ( 1 ) << ChunkBits;
+		static constexpr std::size_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::vector <std::unique_ptr <T []>> chunks;
+		std::size_t                          count = 0;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: operator []
+		//
+		// Description:
+		//
+		//   Return a reference to the element at the given position.
+		//
+		// Arguments:
+		//
+		//   index (std::size_t):
+		//     The element position. Must be less than size ().
+		//
+		// Returns:
+		//
+		//   A reference to the element, valid until the array is destroyed.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		T& operator [] ( std::size_t index )
+		{
+			assert ( index < count && "ChunkedArray index out of range." );
+			return chunks [ index >> ChunkBits ][ index & CHUNK_MASK ];
+		}
+
+		const T& operator [] ( std::size_t index ) const
+		{
+			assert ( index < count && "ChunkedArray index out of range." );
+			return chunks [ index >> ChunkBits ][ index & CHUNK_MASK ];
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: size
+		//
+		// Description:
+		//
+		//   Return the number of elements in the array.
+		//
+		// Returns:
+		//
+		//   The element count.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t size () const
+		{
+			return count;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: capacity
+		//
+		// Description:
+		//
+		//   Return the number of elements that fit in the currently allocated chunks.
+		//
+		// Returns:
+		//
+		//   The allocated capacity in elements.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t capacity () const
+		{
+			return chunks.size () * CHUNK_SIZE;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Predicate Accessor: empty
+		//
+		// Description:
+		//
+		//   Check whether the array holds no elements.
+		//
+		// Returns:
+		//
+		//   True if size () is zero, false otherwise.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool empty () const
+		{
+			return count == 0;
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: reserve
+		//
+		// Description:
+		//
+		//   Allocate enough chunks to hold at least the requested number of elements without further allocation.
+		//
+		// Arguments:
+		//
+		//   elements (std::size_t):
+		//     The number of elements to make room for.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void reserve ( std::size_t elements )
+		{
+			while ( capacity () < elements )
+			{
+				chunks.push_back ( std::make_unique <T []> ( CHUNK_SIZE ) );
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: pushBack
+		//
+		// Description:
+		//
+		//   Append an element, allocating a new chunk if the last one is full.
+		//
+		// Arguments:
+		//
+		//   value (const T&):
+		//     The value to append.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void pushBack ( const T& value )
+		{
+			if ( count == capacity () )
+			{
+				chunks.push_back ( std::make_unique <T []> ( CHUNK_SIZE ) );
+			}
+
+			chunks [ count >> ChunkBits ][ count & CHUNK_MASK ] = value;
+			++count;
+		}
+	};
+}
@@ -8,8 +8,8 @@
 //
 //   Defines the IComponentArray interface and the templated ComponentArray class for the ECS framework.
 //
-//   ComponentArray stores components of a single type in a dense, contiguous vector with O(1) lookup via
-//   entity-to-index mapping.
+//   ComponentArray stores components of a single type in a dense, contiguous vector with O(1) lookup via a paged
+//   sparse entity-to-index mapping.
 //
 // TODO:
 //
@@ -20,9 +20,11 @@
 #pragma once
 
 #include "Entity.h"
+#include "Span.h"
+#include "SparseIndex.h"
 
+#include <algorithm>
 #include <cassert>
-#include <unordered_map>
 #include <vector>
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -93,6 +95,27 @@ namespace ecs
 		//-------------------------------------------------------------------------------------------------------------
 
 		virtual void entityDestroyed ( Entity entity ) = 0;
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: insertCopies
+		//
+		// Description:
+		//
+		//   Insert a copy of one component value for each of a list of entities.
+		//
+		//   Pure virtual; implemented by each typed ComponentArray specialization.
+		//
+		// Arguments:
+		//
+		//   entities (Span <const Entity>):
+		//     The entity IDs to add the component to. None may already have one.
+		//
+		//   component (const void*):
+		//     Pointer to the value to copy, of the array's component type.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		virtual void insertCopies ( Span <const Entity> entities, const void* component ) = 0;
 	};
 
 	//*****************************************************************************************************************
@@ -105,6 +128,10 @@ namespace ecs
 	//   - Maintains a contiguous vector of component data alongside bidirectional entity-to-index and
 	//     index-to-entity mappings.
 	//
+	//   - The entity-to-index mapping is a paged sparse array keyed by entity index, so a lookup is a direct array
+	//     read rather than a hash and bucket walk. The full handle stored in indexToEntity is compared on lookup so
+	//     that a stale handle whose index has been recycled is not mistaken for the live entity.
+	//
 	//   - Removals use a swap-with-last strategy to keep the data array tightly packed for cache-friendly iteration.
 	//
 	//*****************************************************************************************************************
@@ -118,9 +145,9 @@ namespace ecs
 
 	private:
 
-		std::vector <T>                          components;
-		std::unordered_map <Entity, std::size_t> entityToIndex;
-		std::vector <Entity>                     indexToEntity;
+		std::vector <T>      components;
+		SparseIndex          entityToIndex;
+		std::vector <Entity> indexToEntity;
 
 		//=============================================================================================================
 		// Accessors
@@ -150,10 +177,12 @@ namespace ecs
 
 		T& get ( Entity entity )
 		{
-			// Assert that the entity exists in the map, then return a reference to its component via the index lookup.
+			// Assert that the entity has a slot in the sparse index, then return a reference to its component.
 
-			assert ( entityToIndex.find ( entity ) != entityToIndex.end () && "Retrieving non-existent component." );
-			return components [ entityToIndex [ entity ] ];
+			uint32_t index = entityToIndex.find ( entityIndex ( entity ) );
+
+			assert ( index != SparseIndex::INVALID && indexToEntity [ index ] == entity && "Retrieving non-existent component." );
+			return components [ index ];
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
@@ -221,6 +250,24 @@ namespace ecs
 			return indexToEntity [ index ];
 		}
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getEntities
+		//
+		// Description:
+		//
+		//   Return the dense list of entities that own a component in this array, parallel to getData ().
+		//
+		// Returns:
+		//
+		//   A const reference to the internal entity vector.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		const std::vector <Entity>& getEntities () const
+		{
+			return indexToEntity;
+		}
+
 		//-------------------------------------------------------------------------------------------------------------
 		// Predicate Accessor: has
 		//
@@ -241,9 +288,12 @@ namespace ecs
 
 		bool has ( Entity entity ) const
 		{
-			// Return true if the entity-to-index map contains an entry for this entity, indicating a stored component.
+			// Return true if the sparse index holds a slot for this entity's index and the slot belongs to this exact
+			// handle rather than to an earlier generation.
 
-			return entityToIndex.find ( entity ) != entityToIndex.end ();
+			uint32_t index = entityToIndex.find ( entityIndex ( entity ) );
+
+			return index != SparseIndex::INVALID && indexToEntity [ index ] == entity;
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
@@ -276,6 +326,33 @@ namespace ecs
 		// Methods
 		//=============================================================================================================
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: reserve
+		//
+		// Description:
+		//
+		//   Pre-allocate the dense arrays for at least the given number of components.
+		//
+		//   Growing past the current capacity at least doubles it, so reserving room for many small batches in turn,
+		//   as World::addComponents does, does not reallocate the arrays on every batch.
+		//
+		// Arguments:
+		//
+		//   capacity (std::size_t):
+		//     The number of components to make room for.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void reserve ( std::size_t capacity )
+		{
+			if ( capacity <= components.capacity () ) return;
+
+			capacity = std::max ( capacity, components.capacity () * 2 );
+
+			components.reserve    ( capacity );
+			indexToEntity.reserve ( capacity );
+		}
+
 		//-------------------------------------------------------------------------------------------------------------
 		// Method: insert
 		//
@@ -299,13 +376,13 @@ namespace ecs
 		{
 			// Guard against duplicate insertions; each entity may hold at most one component of any given type.
 
-			assert ( entityToIndex.find ( entity ) == entityToIndex.end () && "Component added to same entity twice." );
+			assert ( !entityToIndex.contains ( entityIndex ( entity ) ) && "Component added to same entity twice." );
 
 			// Record the entity-to-index mapping. The new component will occupy the position at the current end of the
 			// dense array.
 
-			std::size_t newIndex     = components.size ();
-			entityToIndex [ entity ] = newIndex;
+			std::size_t newIndex = components.size ();
+			entityToIndex.set ( entityIndex ( entity ), static_cast <uint32_t> ( newIndex ) );
 
 			// Append the entity and its component data to the parallel dense arrays so they remain in sync.
 
@@ -334,11 +411,11 @@ namespace ecs
 
 		void remove ( Entity entity )
 		{
-			assert ( entityToIndex.find ( entity ) != entityToIndex.end () && "Removing non-existent component." );
+			assert ( has ( entity ) && "Removing non-existent component." );
 
 			// Swap the removed element with the last element to keep the array dense.
 
-			std::size_t removedIndex = entityToIndex [ entity ];
+			std::size_t removedIndex = entityToIndex.find ( entityIndex ( entity ) );
 			std::size_t lastIndex    = components.size () - 1;
 
 			// If the element being removed is not already the last, move the last element into the vacated slot and
@@ -348,15 +425,15 @@ namespace ecs
 			{
 				components [ removedIndex ]    = std::move ( components [ lastIndex ] );
 				Entity lastEntity              = indexToEntity [ lastIndex ];
-				entityToIndex [ lastEntity ]   = removedIndex;
+				entityToIndex.set ( entityIndex ( lastEntity ), static_cast <uint32_t> ( removedIndex ) );
 				indexToEntity [ removedIndex ] = lastEntity;
 			}
 
-			// Pop the now-redundant tail entries from both dense arrays and erase the removed entity from the map.
+			// Pop the now-redundant tail entries from both dense arrays and clear the removed entity's sparse slot.
 
 			components.pop_back    ();
 			indexToEntity.pop_back ();
-			entityToIndex.erase    ( entity );
+			entityToIndex.erase    ( entityIndex ( entity ) );
 		}
 
 		
@@ -380,10 +457,44 @@ namespace ecs
 		{
 			// Only attempt removal if this array actually holds a component for the destroyed entity.
 
-			if ( entityToIndex.find ( entity ) != entityToIndex.end () )
+			if ( has ( entity ) )
 			{
 				remove ( entity );
 			}
 		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: insertCopies
+		//
+		// Description:
+		//
+		//   Insert a copy of one component value for each of a list of entities, appending them to the dense array in
+		//   a single fill.
+		//
+		//   Asserts if any entity already has a component of this type.
+		//
+		// Arguments:
+		//
+		//   entities (Span <const Entity>):
+		//     The entity IDs to add the component to.
+		//
+		//   component (const void*):
+		//     Pointer to the T value to copy.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void insertCopies ( Span <const Entity> entities, const void* component ) override
+		{
+			std::size_t first = components.size ();
+
+			for ( std::size_t i = 0; i < entities.size (); ++i )
+			{
+				assert ( !entityToIndex.contains ( entityIndex ( entities [ i ] ) ) && "Component added to same entity twice." );
+				entityToIndex.set ( entityIndex ( entities [ i ] ), static_cast <uint32_t> ( first + i ) );
+			}
+
+			indexToEntity.insert ( indexToEntity.end (), entities.begin (), entities.end () );
+			components.insert    ( components.end (), entities.size (), *static_cast <const T*> ( component ) );
+		}
 	};
 }
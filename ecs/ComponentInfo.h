@@ -0,0 +1,94 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the ComponentInfo struct, a type-erased description of a component type's size, alignment, and
+//   lifetime operations.
+//
+//   Storage that holds several component types in raw byte columns, such as archetype chunks, uses ComponentInfo to
+//   construct, move, and destroy components without knowing their concrete types.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Struct: ComponentInfo
+	//
+	// Description:
+	//
+	//   Size, alignment, and lifetime operations for one component type, expressed as plain function pointers over
+	//   untyped memory.
+	//
+	//*****************************************************************************************************************
+
+	struct ComponentInfo
+	{
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::size_t size;
+		std::size_t alignment;
+
+		void ( *copyConstruct ) ( void* destination, const void* source );
+		void ( *moveConstruct ) ( void* destination, void* source );
+		void ( *destroy )       ( void* object );
+	};
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: componentInfoOf
+	//
+	// Description:
+	//
+	//   Return the ComponentInfo for component type T.
+	//
+	//   The instance is a function-local static, so its address is stable and may be stored by storage backends.
+	//
+	// Returns:
+	//
+	//   A reference to the ComponentInfo describing T.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename T>
+	const ComponentInfo& componentInfoOf ()
+	{
+		static const ComponentInfo info =
+		{
+			sizeof  ( T ),
+			alignof ( T ),
+			[] ( void* destination, const void* source ) { new ( destination ) T ( *static_cast <const T*> ( source ) ); },
+			[] ( void* destination, void* source )       { new ( destination ) T ( std::move ( *static_cast <T*> ( source ) ) ); },
+			[] ( void* object )                          { static_cast <T*> ( object )->~T (); }
+		};
+
+		return info;
+	}
+}
@@ -21,7 +21,9 @@
 
 #include "ComponentArray.h"
 #include "Entity.h"
+#include "SharedComponentArray.h"
 #include "Signature.h"
+#include "Span.h"
 
 #include <cassert>
 #include <memory>
@@ -29,6 +31,7 @@
 #include <typeindex>
 #include <typeinfo>
 #include <unordered_map>
+#include <vector>
 
 //---------------------------------------------------------------------------------------------------------------------
 // Namespace: ecs
@@ -68,6 +71,7 @@ namespace ecs
 
 		std::unordered_map <std::type_index, ComponentBit>                       typeToBit;
 		std::unordered_map <std::type_index, std::shared_ptr <IComponentArray>>  typeToArray;
+		std::vector <std::shared_ptr <IComponentArray>>                          bitToArray;
 		ComponentBit                                                             nextBit = 0;
 
 		//=============================================================================================================
@@ -198,6 +202,32 @@ namespace ecs
 
 			typeToBit   [ ti ] = nextBit;
 			typeToArray [ ti ] = std::make_shared <ComponentArray <T>> ();
+			bitToArray.push_back ( typeToArray [ ti ] );
+			nextBit++;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: registerSharedComponent
+		//
+		// Description:
+		//
+		//   Register a shared component type. The component type entities carry is Shared <T>, which is assigned the
+		//   next available bit and backed by a SharedComponentArray <T> holding both the handles and the values.
+		//
+		//   Asserts if Shared <T> has already been registered.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		void registerSharedComponent ()
+		{
+			std::type_index ti ( typeid( Shared <T> ) );
+
+			assert ( typeToBit.find ( ti ) == typeToBit.end () && "Registering component type more than once." );
+
+			typeToBit   [ ti ] = nextBit;
+			typeToArray [ ti ] = std::make_shared <SharedComponentArray <T>> ();
+			bitToArray.push_back ( typeToArray [ ti ] );
 			nextBit++;
 		}
 
@@ -226,6 +256,36 @@ namespace ecs
 			getComponentArray <T> ()->insert ( entity, component );
 		}
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: addComponents
+		//
+		// Description:
+		//
+		//   Add a copy of the same component of type T to each of a list of entities, growing the array once.
+		//
+		// Arguments:
+		//
+		//   entities (Span <const Entity>):
+		//     The target entity IDs. None may already have a component of type T.
+		//
+		//   component (const T&):
+		//     The component data to copy to every entity.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		void addComponents ( Span <const Entity> entities, const T& component )
+		{
+			auto array = getComponentArray <T> ();
+
+			array->reserve ( array->size () + entities.size () );
+
+			for ( Entity entity : entities )
+			{
+				array->insert ( entity, component );
+			}
+		}
+
 		//-------------------------------------------------------------------------------------------------------------
 		// Method: removeComponent
 		//
@@ -305,5 +365,56 @@ namespace ecs
 
 			return std::static_pointer_cast< ComponentArray <T> >( it->second );
 		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: getSharedComponentArray
+		//
+		// Description:
+		//
+		//   Retrieve the SharedComponentArray for shared component type T.
+		//
+		//   Asserts if T has not been registered with registerSharedComponent.
+		//
+		// Returns:
+		//
+		//   A shared pointer to the SharedComponentArray for type T.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		std::shared_ptr <SharedComponentArray <T>> getSharedComponentArray () const
+		{
+			auto it = typeToArray.find ( std::type_index ( typeid( Shared <T> ) ) );
+			assert ( it != typeToArray.end () && "Shared component not registered before use." );
+
+			return std::static_pointer_cast <SharedComponentArray <T>> ( it->second );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: getComponentArray
+		//
+		// Description:
+		//
+		//   Retrieve the type-erased ComponentArray registered under a component bit.
+		//
+		//   Asserts if no component type has been registered with the bit.
+		//
+		// Arguments:
+		//
+		//   bit (ComponentBit):
+		//     The component bit.
+		//
+		// Returns:
+		//
+		//   A reference to the component array.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		IComponentArray& getComponentArray ( ComponentBit bit ) const
+		{
+			assert ( bit < bitToArray.size () && "Component not registered before use." );
+
+			return *bitToArray [ bit ];
+		}
 	};
 }
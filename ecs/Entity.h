@@ -8,8 +8,12 @@
 //
 //   Defines the Entity type alias and associated constants for the ECS framework.
 //
-//   An entity is a lightweight 32-bit unsigned integer identifier with a reserved null value and a configurable
-//   upper bound on active entities.
+//   An entity is a lightweight 32-bit handle split into an index (low bits) and a generation (high bits), with a
+//   reserved null value. The index width bounds the number of simultaneously living entities; storage for them is
+//   grown on demand at run time.
+//
+//   The generation is bumped each time an index is recycled, so a handle kept past its entity's destruction no
+//   longer matches the live entity that reuses the index.
 //
 // TODO:
 //
@@ -37,6 +41,85 @@ namespace ecs
 {
 	using Entity = uint32_t;
 
-	static constexpr Entity NULL_ENTITY = 0;
-	static constexpr Entity MAX_ENTITIES = 4096;
+	static constexpr uint32_t ENTITY_INDEX_BITS      = 22;
+	static constexpr uint32_t ENTITY_GENERATION_BITS = 32 - ENTITY_INDEX_BITS;
+	static constexpr uint32_t ENTITY_INDEX_MASK      = ( 1u << ENTITY_INDEX_BITS ) - 1;
+	static constexpr uint32_t ENTITY_GENERATION_MASK = ( 1u << ENTITY_GENERATION_BITS ) - 1;
+
+	static constexpr Entity NULL_ENTITY  = 0;
+	static constexpr Entity MAX_ENTITIES = ENTITY_INDEX_MASK;
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: entityIndex
+	//
+	// Description:
+	//
+	//   Extract the index part of an entity handle. The index addresses per-entity storage such as signatures and
+	//   sparse component slots.
+	//
+	// Arguments:
+	//
+	//   entity (Entity):
+	//     The entity handle.
+	//
+	// Returns:
+	//
+	//   The entity's index.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline constexpr uint32_t entityIndex ( Entity entity )
+	{
+		return entity & ENTITY_INDEX_MASK;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: entityGeneration
+	//
+	// Description:
+	//
+	//   Extract the generation part of an entity handle.
+	//
+	// Arguments:
+	//
+	//   entity (Entity):
+	//     The entity handle.
+	//
+	// Returns:
+	//
+	//   The number of times the handle's index had been recycled when the handle was issued, modulo the generation
+	//   range.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline constexpr uint32_t entityGeneration ( Entity entity )
+	{
+		return entity >> ENTITY_INDEX_BITS;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: makeEntity
+	//
+	// Description:
+	//
+	//   Compose an entity handle from an index and a generation.
+	//
+	// Arguments:
+	//
+	//   index (uint32_t):
+	//     The entity index. Must fit in ENTITY_INDEX_BITS.
+	//
+	//   generation (uint32_t):
+	//     The generation. Wrapped to ENTITY_GENERATION_BITS.
+	//
+	// Returns:
+	//
+	//   The composed entity handle.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline constexpr Entity makeEntity ( uint32_t index, uint32_t generation )
+	{
+		return ( ( generation & ENTITY_GENERATION_MASK ) << ENTITY_INDEX_BITS ) | ( index & ENTITY_INDEX_MASK );
+	}
 }
@@ -8,8 +8,11 @@
 //
 //   Defines the EntityManager class, which handles entity lifecycle management for the ECS framework.
 //
-//   Entities are allocated from a recycling ID pool and tracked via per-entity component signatures stored in a
-//   fixed-size array.
+//   Entities are generational handles allocated from an intrusive free list of recycled indices and tracked via
+//   per-entity component signatures indexed by entity index.
+//
+//   Slot and signature storage is chunked and grows on demand, so the manager's footprint tracks the number of
+//   entities actually used and references to existing signatures stay valid as it grows.
 //
 // TODO:
 //
@@ -19,12 +22,12 @@
 
 #pragma once
 
+#include "ChunkedArray.h"
 #include "Entity.h"
 #include "Signature.h"
 
-#include <array>
 #include <cassert>
-#include <queue>
+#include <cstddef>
 
 //---------------------------------------------------------------------------------------------------------------------
 // Namespace: ecs
@@ -47,10 +50,17 @@ namespace ecs
 	//
 	//   Manages the full lifecycle of entities within the ECS framework.
 	//
-	//   - Maintains a recycling pool of entity IDs using a FIFO queue, a fixed-size array of component signatures
-	//     indexed by entity ID, and a count of currently living entities.
+	//   - Each index slot holds the live handle for that index, or, while the index is free, the index of the next
+	//     free slot together with the generation the slot will be reissued with. Free indices therefore form an
+	//     intrusive singly linked list threaded through the slot array, and allocation and recycling are both O(1).
+	//
+	//   - Slots and signatures live in chunked arrays that grow as new indices are first used, so a default-
+	//     constructed manager allocates nothing, and an optional initial capacity pre-allocates chunks for a known
+	//     entity count.
+	//
+	//   - The ID space is bounded only by ENTITY_INDEX_BITS (MAX_ENTITIES).
 	//
-	//   - Entity ID 0 is reserved as NULL_ENTITY and is never allocated.
+	//   - Entity index 0 is reserved so that NULL_ENTITY is never allocated.
 	//
 	//*****************************************************************************************************************
 
@@ -62,9 +72,10 @@ namespace ecs
 		// Data Members
 		//=============================================================================================================
 
-		std::queue <Entity>                           availableIds;
-		std::array <Signature, MAX_ENTITIES + 1>      signatures {};
-		uint32_t                                      livingCount = 0;
+		ChunkedArray <Entity>     slots;
+		ChunkedArray <Signature>  signatures;
+		uint32_t                  freeHead    = 0;
+		uint32_t                  livingCount = 0;
 
 	public:
 
@@ -82,18 +93,19 @@ namespace ecs
 		// Arguments:
 		//
 		//   entity (Entity):
-		//     The target entity ID. Must be in the valid range (1 .. MAX_ENTITIES).
+		//     The target entity handle. Must be alive.
 		//
 		// Returns:
 		//
-		//   A copy of the entity's current component signature bitset.
+		//   A reference to the entity's current component signature bitset. The reference stays valid as the manager
+		//   grows.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		Signature getSignature ( Entity entity ) const
+		const Signature& getSignature ( Entity entity ) const
 		{
-			assert ( entity > NULL_ENTITY && entity <= MAX_ENTITIES && "Entity out of range." );
-			return signatures [ entity ];
+			assert ( isAlive ( entity ) && "Entity is not alive." );
+			return signatures [ entityIndex ( entity ) ];
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
@@ -114,6 +126,54 @@ namespace ecs
 			return livingCount;
 		}
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getCapacity
+		//
+		// Description:
+		//
+		//   Return the number of entity indices that can be issued before the manager allocates another chunk.
+		//
+		// Returns:
+		//
+		//   The currently allocated index capacity, excluding the reserved NULL_ENTITY index.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getCapacity () const
+		{
+			std::size_t capacity = slots.capacity ();
+
+			return capacity > 0 ? capacity - 1 : 0;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Predicate Accessor: isAlive
+		//
+		// Description:
+		//
+		//   Check whether a handle refers to a live entity.
+		//
+		//   A live slot stores exactly the handle it was issued with, so comparing the slot with the handle validates
+		//   both the index and the generation in one read.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity handle to query.
+		//
+		// Returns:
+		//
+		//   True if the handle is the current handle for its index, false if it is null, out of range, or stale.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool isAlive ( Entity entity ) const
+		{
+			uint32_t index = entityIndex ( entity );
+
+			return index != 0 && index < slots.size () && slots [ index ] == entity;
+		}
+
 		//=============================================================================================================
 		// Mutators
 		//=============================================================================================================
@@ -128,7 +188,7 @@ namespace ecs
 		// Arguments:
 		//
 		//   entity (Entity):
-		//     The target entity ID. Must be in the valid range (1 .. MAX_ENTITIES).
+		//     The target entity handle. Must be alive.
 		//
 		//   signature (Signature):
 		//     The new component signature bitset to assign.
@@ -137,8 +197,8 @@ namespace ecs
 
 		void setSignature ( Entity entity, Signature signature )
 		{
-			assert ( entity > NULL_ENTITY && entity <= MAX_ENTITIES && "Entity out of range." );
-			signatures [ entity ] = signature;
+			assert ( isAlive ( entity ) && "Entity is not alive." );
+			signatures [ entityIndex ( entity ) ] = signature;
 		}
 
 		//=============================================================================================================
@@ -146,26 +206,34 @@ namespace ecs
 		//=============================================================================================================
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Constructor 1/1: EntityManager
+		// Constructor 1/2: EntityManager
+		//
+		// Description:
+		//
+		//   Default constructor. The slot and signature arrays start empty and grow as indices are first allocated.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		EntityManager () = default;
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 2/2: EntityManager
 		//
 		// Description:
 		//
-		//   Initialize the entity manager by pre-filling the available ID queue with all valid entity IDs from 1
-		//   through MAX_ENTITIES.
+		//   Construct the manager with storage pre-allocated for an expected number of entities. The manager still
+		//   grows past this capacity on demand.
+		//
+		// Arguments:
 		//
-		//   Entity ID 0 is reserved as NULL_ENTITY and excluded from the pool.
+		//   initialCapacity (std::size_t):
+		//     The number of entities to allocate slot and signature storage for.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		EntityManager ()
+		explicit EntityManager ( std::size_t initialCapacity )
 		{
-			// Pre-fill the queue with all valid entity IDs (1 .. MAX_ENTITIES).
-			// ID 0 is reserved as NULL_ENTITY.
-
-			for ( Entity e = 1; e <= MAX_ENTITIES; ++e )
-			{
-				availableIds.push ( e );
-			}
+			reserve ( initialCapacity );
 		}
 
 		//=============================================================================================================
@@ -178,18 +246,44 @@ namespace ecs
 		// Methods
 		//=============================================================================================================
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: reserve
+		//
+		// Description:
+		//
+		//   Pre-allocate slot and signature storage for at least the given number of entities.
+		//
+		// Arguments:
+		//
+		//   capacity (std::size_t):
+		//     The number of entities to make room for, not counting the reserved NULL_ENTITY index.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void reserve ( std::size_t capacity )
+		{
+			assert ( capacity <= MAX_ENTITIES && "Requested entity capacity exceeds the entity index range." );
+
+			slots.reserve      ( capacity + 1 );
+			signatures.reserve ( capacity + 1 );
+		}
+
 		//-------------------------------------------------------------------------------------------------------------
 		// Method: createEntity
 		//
 		// Description:
 		//
-		//   Allocate and return the next available entity ID from the recycling pool.
+		//   Allocate a new entity handle.
+		//
+		//   - Reuses the most recently freed index, with its bumped generation, if one is available.
+		//
+		//   - Otherwise appends a fresh index at generation 0, growing storage by one chunk if necessary.
 		//
-		//   Asserts if the maximum entity count has been reached.
+		//   Asserts if the entity index range has been exhausted.
 		//
 		// Returns:
 		//
-		//   The newly allocated entity ID.
+		//   The newly allocated entity handle.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
@@ -197,11 +291,36 @@ namespace ecs
 		{
 			assert ( livingCount < MAX_ENTITIES && "Too many entities." );
 
-			Entity id = availableIds.front ();
-			availableIds.pop ();
 			++livingCount;
 
-			return id;
+			// Pop the head of the free list. The free slot holds the next free index and the generation to reissue.
+
+			if ( freeHead != 0 )
+			{
+				uint32_t index = freeHead;
+				Entity   link  = slots [ index ];
+
+				freeHead        = entityIndex ( link );
+				slots [ index ] = makeEntity ( index, entityGeneration ( link ) );
+
+				return slots [ index ];
+			}
+
+			// No recycled index is available, so append a fresh one. Index 0 is reserved for NULL_ENTITY, so the first
+			// allocation also creates the reserved slot.
+
+			if ( slots.empty () )
+			{
+				slots.pushBack      ( NULL_ENTITY );
+				signatures.pushBack ( Signature {} );
+			}
+
+			uint32_t index = static_cast <uint32_t> ( slots.size () );
+
+			slots.pushBack      ( makeEntity ( index, 0 ) );
+			signatures.pushBack ( Signature {} );
+
+			return slots [ index ];
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
@@ -209,22 +328,29 @@ namespace ecs
 		//
 		// Description:
 		//
-		//   Destroy an entity by resetting its component signature, returning its ID to the available pool, and
-		//   decrementing the living entity count.
+		//   Destroy an entity by resetting its component signature, bumping the generation of its index, pushing the
+		//   index onto the free list, and decrementing the living entity count.
 		//
 		// Arguments:
 		//
 		//   entity (Entity):
-		//     The entity ID to destroy. Must be in the valid range (1 .. MAX_ENTITIES).
+		//     The entity handle to destroy. Must be alive.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
 		void destroyEntity ( Entity entity )
 		{
-			assert ( entity > NULL_ENTITY && entity <= MAX_ENTITIES && "Entity out of range." );
+			assert ( isAlive ( entity ) && "Entity is not alive." );
+
+			uint32_t index = entityIndex ( entity );
+
+			// Link the slot into the free list and record the generation it will carry when reissued, which
+			// invalidates every outstanding copy of the destroyed handle.
+
+			signatures [ index ].reset ();
+			slots [ index ] = makeEntity ( freeHead, entityGeneration ( entity ) + 1 );
+			freeHead        = index;
 
-			signatures [ entity ].reset ();
-			availableIds.push ( entity );
 			--livingCount;
 		}
 	};
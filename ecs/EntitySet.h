@@ -0,0 +1,248 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the EntitySet class, a sparse set of entity handles used for system membership.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "Entity.h"
+#include "Span.h"
+#include "SparseIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Class: EntitySet
+	//
+	// Description:
+	//
+	//   Set of entity handles stored densely for iteration, with a paged sparse index for O(1) membership, insert,
+	//   and erase.
+	//
+	//   - Members are kept in a contiguous vector, exposed through begin/end, operator [], and span ().
+	//
+	//   - Insert appends. Erase moves the last member into the erased position. The order therefore depends only on
+	//     the sequence of inserts and erases, so identical runs iterate in identical order.
+	//
+	//   - Inserting or erasing invalidates spans and iterators obtained earlier.
+	//
+	//*****************************************************************************************************************
+
+	class EntitySet
+	{
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::vector <Entity> dense;
+		SparseIndex          positions;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Predicate Accessor: contains
+		//
+		// Description:
+		//
+		//   Check whether an entity handle is a member. A handle from an earlier generation of the same index is not.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity handle to test.
+		//
+		// Returns:
+		//
+		//   True if the exact handle is in the set, false otherwise.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool contains ( Entity entity ) const
+		{
+			uint32_t position = positions.find ( entityIndex ( entity ) );
+			return position != SparseIndex::INVALID && dense [ position ] == entity;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: operator []
+		//
+		// Description:
+		//
+		//   Return the member at a position in iteration order.
+		//
+		// Arguments:
+		//
+		//   position (std::size_t):
+		//     The position. Must be less than size ().
+		//
+		// Returns:
+		//
+		//   The entity handle at the position.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Entity operator [] ( std::size_t position ) const
+		{
+			return dense [ position ];
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessors: size, empty, data, begin, end
+		//
+		// Description:
+		//
+		//   Standard contiguous range accessors over the members in iteration order.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t   size  () const { return dense.size ();  }
+		bool          empty () const { return dense.empty (); }
+		const Entity* data  () const { return dense.data ();  }
+		const Entity* begin () const { return dense.data ();  }
+		const Entity* end   () const { return dense.data () + dense.size (); }
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: span
+		//
+		// Description:
+		//
+		//   Return the members as a contiguous read-only span.
+		//
+		// Returns:
+		//
+		//   A span over the members, valid until the next insert, erase, or clear.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Span <const Entity> span () const
+		{
+			return Span <const Entity> ( dense.data (), dense.size () );
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: insert
+		//
+		// Description:
+		//
+		//   Add an entity to the end of the set if it is not already a member.
+		//
+		//   A stale handle left behind for the same index is replaced in place.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity handle to add.
+		//
+		// Returns:
+		//
+		//   True if the entity was added, false if it was already a member.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool insert ( Entity entity )
+		{
+			uint32_t index    = entityIndex ( entity );
+			uint32_t position = positions.find ( index );
+
+			if ( position != SparseIndex::INVALID )
+			{
+				if ( dense [ position ] == entity ) return false;
+
+				dense [ position ] = entity;
+				return true;
+			}
+
+			positions.set ( index, static_cast <uint32_t> ( dense.size () ) );
+			dense.push_back ( entity );
+
+			return true;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: erase
+		//
+		// Description:
+		//
+		//   Remove an entity from the set by moving the last member into its position.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity handle to remove.
+		//
+		// Returns:
+		//
+		//   True if the entity was removed, false if it was not a member.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool erase ( Entity entity )
+		{
+			if ( !contains ( entity ) ) return false;
+
+			uint32_t index    = entityIndex ( entity );
+			uint32_t position = positions.find ( index );
+			Entity   last     = dense.back ();
+
+			dense [ position ] = last;
+			positions.set ( entityIndex ( last ), position );
+
+			dense.pop_back  ();
+			positions.erase ( index );
+
+			return true;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: clear
+		//
+		// Description:
+		//
+		//   Remove all members.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void clear ()
+		{
+			dense.clear     ();
+			positions.clear ();
+		}
+	};
+}
@@ -0,0 +1,287 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the Prefab class, a reusable set of component values that World::instantiate copies onto new entities.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "ComponentInfo.h"
+#include "Signature.h"
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Class: Prefab
+	//
+	// Description:
+	//
+	//   Owns one value of each component in a prototype, keyed by component bit, created by World::createPrefab.
+	//
+	//   - Values are held in type-erased, suitably aligned buffers and described by their ComponentInfo, so a prefab
+	//     can be handed to either storage backend without knowing the component types.
+	//
+	//   - Instantiating copies the values; later changes to the prefab do not affect entities already created.
+	//
+	//   - A prefab is move-only.
+	//
+	//*****************************************************************************************************************
+
+	class Prefab
+	{
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		Signature                          signature;
+		std::vector <ComponentBit>         bits;
+		std::vector <const ComponentInfo*> infos;
+		std::vector <void*>                values;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: get
+		//
+		// Description:
+		//
+		//   Return the prefab's value for a component bit.
+		//
+		//   Asserts if the prefab does not contain the component.
+		//
+		// Arguments:
+		//
+		//   bit (ComponentBit):
+		//     The bit of component type T.
+		//
+		// Returns:
+		//
+		//   A mutable reference to the stored value.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		T& get ( ComponentBit bit )
+		{
+			std::size_t slot = find ( bit );
+
+			assert ( slot < bits.size () && "Retrieving component not in prefab." );
+			return *static_cast <T*> ( values [ slot ] );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessors: getSignature, getBits, getValues, size
+		//
+		// Description:
+		//
+		//   Return the prefab's signature, its component bits, the value pointers parallel to those bits, and the
+		//   number of components.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		const Signature&                  getSignature () const { return signature; }
+		const std::vector <ComponentBit>& getBits      () const { return bits; }
+		const void* const*                getValues    () const { return values.data (); }
+		std::size_t                       size         () const { return bits.size (); }
+
+		//=============================================================================================================
+		// Constructors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 1/2: Prefab
+		//
+		// Description:
+		//
+		//   Default constructor. Creates a prefab with no components.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Prefab () = default;
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 2/2: Prefab
+		//
+		// Description:
+		//
+		//   Move constructor. Takes ownership of another prefab's values and leaves it empty.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Prefab ( Prefab&& other ) noexcept
+			: signature ( other.signature )
+			, bits      ( std::move ( other.bits ) )
+			, infos     ( std::move ( other.infos ) )
+			, values    ( std::move ( other.values ) )
+		{
+			other.signature.reset ();
+			other.bits.clear      ();
+			other.infos.clear     ();
+			other.values.clear    ();
+		}
+
+		Prefab& operator = ( Prefab&& other ) noexcept
+		{
+			if ( this != &other )
+			{
+				release ();
+
+				std::swap ( signature, other.signature );
+				std::swap ( bits,      other.bits );
+				std::swap ( infos,     other.infos );
+				std::swap ( values,    other.values );
+			}
+
+			return *this;
+		}
+
+		Prefab ( const Prefab& )             = delete;
+		Prefab& operator = ( const Prefab& ) = delete;
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Destructor: ~Prefab
+		//
+		// Description:
+		//
+		//   Destroy every stored value and free its buffer.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		~Prefab ()
+		{
+			release ();
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: set
+		//
+		// Description:
+		//
+		//   Store a copy of a component value, replacing any value already held for the same bit.
+		//
+		// Arguments:
+		//
+		//   bit (ComponentBit):
+		//     The component bit.
+		//
+		//   info (const ComponentInfo&):
+		//     The component's type-erased description.
+		//
+		//   value (const void*):
+		//     The value to copy.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void set ( ComponentBit bit, const ComponentInfo& info, const void* value )
+		{
+			void*       buffer = ::operator new ( info.size, std::align_val_t ( info.alignment ) );
+			std::size_t slot   = find ( bit );
+
+			info.copyConstruct ( buffer, value );
+
+			if ( slot < bits.size () )
+			{
+				free ( slot );
+				values [ slot ] = buffer;
+				return;
+			}
+
+			signature.set    ( bit );
+			bits.push_back   ( bit );
+			infos.push_back  ( &info );
+			values.push_back ( buffer );
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: find
+		//
+		// Description:
+		//
+		//   Return the slot holding a component bit, or size () if the prefab does not contain it.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t find ( ComponentBit bit ) const
+		{
+			std::size_t slot = 0;
+
+			while ( slot < bits.size () && bits [ slot ] != bit ) ++slot;
+
+			return slot;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: free
+		//
+		// Description:
+		//
+		//   Destroy the value in one slot and free its buffer. The slot itself is left in place.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void free ( std::size_t slot )
+		{
+			infos [ slot ]->destroy ( values [ slot ] );
+			::operator delete ( values [ slot ], std::align_val_t ( infos [ slot ]->alignment ) );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: release
+		//
+		// Description:
+		//
+		//   Free every slot and clear the prefab.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void release ()
+		{
+			for ( std::size_t slot = 0; slot < values.size (); ++slot ) free ( slot );
+
+			signature.reset ();
+			bits.clear      ();
+			infos.clear     ();
+			values.clear    ();
+		}
+	};
+}
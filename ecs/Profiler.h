@@ -0,0 +1,541 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines SystemProfile, the rolling timing window every system carries, and Profiler, which switches system
+//   timing on and off and records scoped zones for export as a Chrome trace.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Class: SystemProfile
+	//
+	// Description:
+	//
+	//   The wall times of a system's latest updates, kept in a fixed ring of WINDOW samples, and the number of
+	//   entities the latest update was given.
+	//
+	//   Recording never allocates. The statistics are computed over the samples in the ring when asked for.
+	//
+	//*****************************************************************************************************************
+
+	class SystemProfile
+	{
+	public:
+
+		//=============================================================================================================
+		// Constants
+		//=============================================================================================================
+
+		static constexpr std::size_t WINDOW = 128;
+
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::array <double, WINDOW> samples     {};
+		std::size_t                 next        = 0;
+		std::size_t                 count       = 0;
+		std::size_t                 entityCount = 0;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Accessor: getSampleCount
+		//
+		// Description:
+		//
+		//   Return the number of samples in the window, at most WINDOW.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getSampleCount () const
+		{
+			return count;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Accessor: getEntityCount
+		//
+		// Description:
+		//
+		//   Return the number of entities the latest recorded update was given.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getEntityCount () const
+		{
+			return entityCount;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Accessor: getMinimum
+		//
+		// Description:
+		//
+		//   Return the shortest update in the window in seconds, or 0 if there are no samples.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		double getMinimum () const
+		{
+			return count == 0 ? 0.0 : *std::min_element ( samples.begin (), samples.begin () + count );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Accessor: getAverage
+		//
+		// Description:
+		//
+		//   Return the mean update time in the window in seconds, or 0 if there are no samples.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		double getAverage () const
+		{
+			double sum = 0.0;
+
+			for ( std::size_t i = 0; i < count; ++i ) sum += samples [ i ];
+
+			return count == 0 ? 0.0 : sum / static_cast <double> ( count );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Accessor: getPercentile
+		//
+		// Description:
+		//
+		//   Return the update time in seconds below which the given fraction of the window's samples fall, using
+		//   the nearest sample at or above that rank. 0 gives the minimum and 1 the maximum.
+		//
+		// Arguments:
+		//
+		//   fraction (double):
+		//     The fraction in [ 0, 1 ], for example 0.99 for the 99th percentile.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		double getPercentile ( double fraction ) const
+		{
+			if ( count == 0 ) return 0.0;
+
+			std::array <double, WINDOW> sorted = samples;
+
+			double      position = std::clamp ( fraction, 0.0, 1.0 ) * static_cast <double> ( count - 1 );
+			std::size_t rank     = static_cast <std::size_t> ( position );
+
+			if ( static_cast <double> ( rank ) < position ) ++rank;
+
+			std::nth_element ( sorted.begin (), sorted.begin () + rank, sorted.begin () + count );
+
+			return sorted [ rank ];
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: record
+		//
+		// Description:
+		//
+		//   Add one update to the window, replacing the oldest sample once the window is full.
+		//
+		// Arguments:
+		//
+		//   seconds (double):
+		//     The update's wall time in seconds.
+		//
+		//   entities (std::size_t):
+		//     The number of entities the update was given.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void record ( double seconds, std::size_t entities )
+		{
+			samples [ next ] = seconds;
+			next             = ( next + 1 ) % WINDOW;
+			count            = std::min ( count + 1, WINDOW );
+			entityCount      = entities;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: clear
+		//
+		// Description:
+		//
+		//   Discard every sample.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void clear ()
+		{
+			next        = 0;
+			count       = 0;
+			entityCount = 0;
+		}
+	};
+
+	//*****************************************************************************************************************
+	// Class: Profiler
+	//
+	// Description:
+	//
+	//   Switches for the World's instrumentation, and the store of trace zones.
+	//
+	//   - While enabled, the World times every system update into the system's SystemProfile. While disabled, each
+	//     update costs one extra branch on the enabled flag and nothing else.
+	//
+	//   - While tracing, every timed system update and every Zone opened by a system is also kept as a trace event,
+	//     which writeChromeTrace exports in the Chrome trace event format that chrome://tracing and Perfetto load.
+	//     Tracing switches timing on. At most MAX_TRACE_EVENTS events are kept; later ones are counted and dropped.
+	//
+	//   - Zones may be opened from any thread, including job system workers. A Zone's name is not copied and must
+	//     outlive the profiler, as a string literal does.
+	//
+	//*****************************************************************************************************************
+
+	class Profiler
+	{
+	public:
+
+		using Clock = std::chrono::steady_clock;
+
+		//=============================================================================================================
+		// Constants
+		//=============================================================================================================
+
+		static constexpr std::size_t MAX_TRACE_EVENTS = std::size_t ( 1 ) << 20;
+
+		//*************************************************************************************************************
+		// Class: Zone
+		//
+		// Description:
+		//
+		//   A scoped trace zone. It reads the clock when opened and records an event when it goes out of scope, if
+		//   the profiler was tracing when it was opened. Otherwise it costs one branch.
+		//
+		//   Example:
+		//
+		//     ecs::Profiler::Zone zone ( world.getProfiler (), "Gravity.BuildTree" );
+		//
+		//*************************************************************************************************************
+
+		class Zone
+		{
+		private:
+
+			Profiler*         profiler;
+			const char*       name;
+			Clock::time_point start;
+
+		public:
+
+			Zone ( Profiler& owner, const char* name )
+				: profiler ( owner.isTracing () ? &owner : nullptr )
+				, name     ( name )
+			{
+				if ( profiler ) start = Clock::now ();
+			}
+
+			~Zone ()
+			{
+				if ( profiler ) profiler->addEvent ( name, start, Clock::now () );
+			}
+
+			Zone ( const Zone& )            = delete;
+			Zone& operator = ( const Zone& ) = delete;
+		};
+
+	private:
+
+		//=============================================================================================================
+		// Types
+		//=============================================================================================================
+
+		struct TraceEvent
+		{
+			const char*       name;
+			std::size_t       thread;
+			Clock::time_point start;
+			Clock::time_point end;
+		};
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		bool enabled = false;
+		bool tracing = false;
+
+		mutable std::mutex                                traceMutex;
+		std::vector <TraceEvent>                          traceEvents;
+		std::unordered_map <std::thread::id, std::size_t> traceThreads;
+		std::size_t                                       droppedEvents = 0;
+		Clock::time_point                                 traceStart    = Clock::now ();
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Accessor: isEnabled
+		//
+		// Description:
+		//
+		//   Return true if system updates are being timed.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool isEnabled () const
+		{
+			return enabled;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Accessor: isTracing
+		//
+		// Description:
+		//
+		//   Return true if trace events are being recorded.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool isTracing () const
+		{
+			return tracing;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Accessor: getTraceEventCount
+		//
+		// Description:
+		//
+		//   Return the number of trace events recorded, and optionally the number dropped past MAX_TRACE_EVENTS.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getTraceEventCount ( std::size_t* dropped = nullptr ) const
+		{
+			std::lock_guard <std::mutex> lock ( traceMutex );
+
+			if ( dropped ) *dropped = droppedEvents;
+
+			return traceEvents.size ();
+		}
+
+		//=============================================================================================================
+		// Mutators
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: setEnabled
+		//
+		// Description:
+		//
+		//   Switch system timing on or off. Switching it off also stops tracing. Call between frames, not while
+		//   systems are updating.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void setEnabled ( bool on )
+		{
+			enabled = on;
+
+			if ( !on ) tracing = false;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: setTracing
+		//
+		// Description:
+		//
+		//   Switch trace recording on or off. Switching it on also switches timing on. Recorded events are kept
+		//   until clearTrace. Call between frames, not while systems are updating.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void setTracing ( bool on )
+		{
+			tracing = on;
+
+			if ( on ) enabled = true;
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: addEvent
+		//
+		// Description:
+		//
+		//   Record a trace event for a zone that ran from start to end on the calling thread. Safe to call from any
+		//   thread. Callers check isTracing first; Zone does so when it is opened.
+		//
+		// Arguments:
+		//
+		//   name (const char*):
+		//     The zone name, which must outlive the profiler.
+		//
+		//   start, end (Clock::time_point):
+		//     When the zone opened and closed.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void addEvent ( const char* name, Clock::time_point start, Clock::time_point end )
+		{
+			std::lock_guard <std::mutex> lock ( traceMutex );
+
+			if ( traceEvents.size () >= MAX_TRACE_EVENTS )
+			{
+				++droppedEvents;
+				return;
+			}
+
+			// Number threads in the order they first record, so the trace shows small, stable thread ids.
+
+			auto thread = traceThreads.emplace ( std::this_thread::get_id (), traceThreads.size () ).first->second;
+
+			traceEvents.push_back ( { name, thread, start, end } );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: clearTrace
+		//
+		// Description:
+		//
+		//   Discard the recorded events and restart the trace clock.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void clearTrace ()
+		{
+			std::lock_guard <std::mutex> lock ( traceMutex );
+
+			traceEvents.clear ();
+			traceThreads.clear ();
+			droppedEvents = 0;
+			traceStart    = Clock::now ();
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: writeChromeTrace
+		//
+		// Description:
+		//
+		//   Write the recorded events as a Chrome trace event JSON object, with one complete ("X") event per zone and
+		//   a name for each thread. Times are in microseconds from the start of the trace.
+		//
+		// Arguments:
+		//
+		//   stream (std::ostream&):
+		//     The stream to write to.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void writeChromeTrace ( std::ostream& stream ) const
+		{
+			std::lock_guard <std::mutex> lock ( traceMutex );
+
+			auto microseconds = [ this ] ( Clock::time_point time )
+			{
+				return std::chrono::duration <double, std::micro> ( time - traceStart ).count ();
+			};
+
+			auto flags     = stream.flags ();
+			auto precision = stream.precision ( 3 );
+
+			stream.setf ( std::ios::fixed, std::ios::floatfield );
+			stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+			const char* separator = "\n";
+
+			for ( std::size_t thread = 0; thread < traceThreads.size (); ++thread )
+			{
+				stream << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread << ",\"args\":{\"name\":\"Thread " << thread << "\"}}";
+				separator = ",\n";
+			}
+
+			for ( const TraceEvent& event : traceEvents )
+			{
+				stream << separator << "{\"name\":\"";
+				writeEscaped ( stream, event.name );
+				stream << "\",\"cat\":\"ecs\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":" << microseconds ( event.start ) << ",\"dur\":" << microseconds ( event.end ) - microseconds ( event.start ) << "}";
+				separator = ",\n";
+			}
+
+			stream << "\n]}\n";
+			stream.flags ( flags );
+			stream.precision ( precision );
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: writeEscaped
+		//
+		// Description:
+		//
+		//   Write a string as the contents of a JSON string literal.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static void writeEscaped ( std::ostream& stream, const char* text )
+		{
+			for ( ; *text; ++text )
+			{
+				char c = *text;
+
+				if      ( c == '"' || c == '\\' )                      stream << '\\' << c;
+				else if ( static_cast <unsigned char> ( c ) < 0x20 ) stream << ' ';
+				else                                                   stream << c;
+			}
+		}
+	};
+}
@@ -0,0 +1,268 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the Shared handle and the SharedComponentArray class template, which store a component value once and
+//   let many entities reference it.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "ComponentArray.h"
+#include "Entity.h"
+#include "Span.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Struct: Shared
+	//
+	// Description:
+	//
+	//   Handle to one value of a shared component of type T.
+	//
+	//   The handle is what an entity stores, so Shared <T> is used as the component type in addComponent,
+	//   makeSignature, views, and prefabs. Entities holding equal handles see the same value.
+	//
+	//*****************************************************************************************************************
+
+	template <typename T>
+	struct Shared
+	{
+		//=============================================================================================================
+		// Constants
+		//=============================================================================================================
+
+		static constexpr uint32_t INVALID = UINT32_MAX;
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		uint32_t handle = INVALID;
+
+		//=============================================================================================================
+		// Operators
+		//=============================================================================================================
+
+		bool operator == ( const Shared& other ) const { return handle == other.handle; }
+		bool operator != ( const Shared& other ) const { return handle != other.handle; }
+	};
+
+	//*****************************************************************************************************************
+	// Class: SharedComponentArray
+	//
+	// Description:
+	//
+	//   Storage for a shared component of type T.
+	//
+	//   - Derives from ComponentArray <Shared <T>>, so the per-entity handles are stored and looked up exactly like
+	//     any other component.
+	//
+	//   - The values are held once, in a vector indexed by handle. Values live as long as the array; a value with
+	//     no referencing entities is kept so its handle stays valid.
+	//
+	//   - Entities can be visited grouped by handle, so callers can set up per-value state, such as a texture, once
+	//     per group.
+	//
+	//*****************************************************************************************************************
+
+	template <typename T>
+	class SharedComponentArray : public ComponentArray <Shared <T>>
+	{
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::vector <T>        values;
+		std::vector <Entity>   collectedEntities;
+		std::vector <uint32_t> collectedHandles;
+		std::vector <Entity>   grouped;
+		std::vector <uint32_t> offsets;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getValue
+		//
+		// Description:
+		//
+		//   Return the value a handle refers to.
+		//
+		//   Asserts if the handle was not created by this array.
+		//
+		// Arguments:
+		//
+		//   shared (Shared <T>):
+		//     The handle.
+		//
+		// Returns:
+		//
+		//   A mutable reference to the value. Changing it affects every entity holding the handle.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		T& getValue ( Shared <T> shared )
+		{
+			assert ( shared.handle < values.size () && "Retrieving non-existent shared value." );
+			return values [ shared.handle ];
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getValueCount
+		//
+		// Description:
+		//
+		//   Return the number of values created.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getValueCount () const
+		{
+			return values.size ();
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: create
+		//
+		// Description:
+		//
+		//   Store a new value and return its handle.
+		//
+		// Arguments:
+		//
+		//   value (const T&):
+		//     The value to store.
+		//
+		// Returns:
+		//
+		//   The handle to assign to entities.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Shared <T> create ( const T& value )
+		{
+			values.push_back ( value );
+
+			return Shared <T> { static_cast <uint32_t> ( values.size () - 1 ) };
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: collect
+		//
+		// Description:
+		//
+		//   Record one entity and its handle for the next forEachGroup call.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity.
+		//
+		//   shared (Shared <T>):
+		//     The handle the entity holds.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void collect ( Entity entity, Shared <T> shared )
+		{
+			assert ( shared.handle < values.size () && "Collecting non-existent shared value." );
+
+			collectedEntities.push_back ( entity );
+			collectedHandles.push_back  ( shared.handle );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: forEachGroup
+		//
+		// Description:
+		//
+		//   Invoke a callable once per value with the collected entities that reference it, then clear the
+		//   collection.
+		//
+		//   Entities are grouped with a counting sort over handles. Within a group they keep the order in which they
+		//   were collected. Values with no collected entities are skipped. The buffers are reused between calls.
+		//
+		// Arguments:
+		//
+		//   function (Function&&):
+		//     Callable taking ( const T& value, Span <const Entity> entities ).
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Function>
+		void forEachGroup ( Function&& function )
+		{
+			// Count the entities per handle, then turn the counts into start offsets.
+
+			offsets.assign ( values.size () + 1, 0 );
+
+			for ( uint32_t handle : collectedHandles ) ++offsets [ handle + 1 ];
+
+			for ( std::size_t h = 1; h < offsets.size (); ++h ) offsets [ h ] += offsets [ h - 1 ];
+
+			// Scatter the entities into their groups, advancing each group's start offset as it fills.
+
+			grouped.resize ( collectedEntities.size () );
+
+			for ( std::size_t i = 0; i < collectedEntities.size (); ++i )
+			{
+				grouped [ offsets [ collectedHandles [ i ] ]++ ] = collectedEntities [ i ];
+			}
+
+			// Each start offset now holds its group's end, so a group spans from the previous handle's offset.
+
+			uint32_t begin = 0;
+
+			for ( std::size_t h = 0; h < values.size (); ++h )
+			{
+				uint32_t end = offsets [ h ];
+
+				if ( end > begin )
+				{
+					function ( static_cast <const T&> ( values [ h ] ), Span <const Entity> ( grouped.data () + begin, end - begin ) );
+				}
+
+				begin = end;
+			}
+
+			collectedEntities.clear ();
+			collectedHandles.clear  ();
+		}
+	};
+}
@@ -0,0 +1,143 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the Span class template, a non-owning view of a contiguous sequence of elements.
+//
+//   Stands in for C++20 std::span so the ECS core stays C++17.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Class: Span
+	//
+	// Description:
+	//
+	//   Pointer and length pair over contiguous elements owned elsewhere.
+	//
+	//   A span is invalidated by anything that reallocates or shrinks the underlying storage.
+	//
+	//*****************************************************************************************************************
+
+	template <typename T>
+	class Span
+	{
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		T*          first = nullptr;
+		std::size_t count = 0;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: operator []
+		//
+		// Description:
+		//
+		//   Return a reference to the element at the given position.
+		//
+		// Arguments:
+		//
+		//   index (std::size_t):
+		//     The element position. Must be less than size ().
+		//
+		// Returns:
+		//
+		//   A reference to the element.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		T& operator [] ( std::size_t index ) const
+		{
+			assert ( index < count && "Span index out of range." );
+			return first [ index ];
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessors: data, size, empty, begin, end
+		//
+		// Description:
+		//
+		//   Standard contiguous range accessors.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		T*          data  () const { return first; }
+		std::size_t size  () const { return count; }
+		bool        empty () const { return count == 0; }
+		T*          begin () const { return first; }
+		T*          end   () const { return first + count; }
+
+		//=============================================================================================================
+		// Constructors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 1/2: Span
+		//
+		// Description:
+		//
+		//   Default constructor. Creates an empty span.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Span () = default;
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 2/2: Span
+		//
+		// Description:
+		//
+		//   Construct a span over count elements starting at first.
+		//
+		// Arguments:
+		//
+		//   first (T*):
+		//     Pointer to the first element.
+		//
+		//   count (std::size_t):
+		//     The number of elements.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Span ( T* first, std::size_t count )
+			: first ( first ), count ( count )
+		{
+		}
+	};
+}
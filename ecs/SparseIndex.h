@@ -0,0 +1,239 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the SparseIndex class, a paged sparse array that maps entity IDs to dense-array slots for the ECS
+//   framework.
+//
+//   Pages are allocated on demand, so memory grows with the highest entity ID actually used rather than with the
+//   full ID range, while lookups remain a shift, a mask, and two array reads.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Class: SparseIndex
+	//
+	// Description:
+	//
+	//   Paged sparse array mapping an integer key (an entity ID) to a slot in some dense array.
+	//
+	//   - Keys are split into a page number and an offset within the page. Each page is a fixed-size block of
+	//     PAGE_SIZE slots, allocated the first time a key in its range is assigned.
+	//
+	//   - Unassigned slots hold INVALID, so a lookup for an absent key never needs to allocate.
+	//
+	//*****************************************************************************************************************
+
+	class SparseIndex
+	{
+	public:
+
+		//=============================================================================================================
+		// Constants
+		//=============================================================================================================
+
+		static constexpr std::size_t PAGE_BITS = 10;
+		static constexpr std::size_t PAGE_SIZE = std::size_t ( 1 ) << PAGE_BITS;
+		static constexpr std::size_t PAGE_MASK = PAGE_SIZE - 1;
+		static constexpr uint32_t    INVALID   = UINT32_MAX;
+
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::vector <std::unique_ptr <uint32_t []>> pages;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: find
+		//
+		// Description:
+		//
+		//   Look up the dense slot assigned to a key.
+		//
+		// Arguments:
+		//
+		//   key (std::size_t):
+		//     The key to look up.
+		//
+		// Returns:
+		//
+		//   The dense slot assigned to the key, or INVALID if the key has no slot.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		uint32_t find ( std::size_t key ) const
+		{
+			// Keys beyond the last allocated page, or within a page that was never allocated, have no slot.
+
+			std::size_t page = key >> PAGE_BITS;
+
+			if ( page >= pages.size () || !pages [ page ] )
+			{
+				return INVALID;
+			}
+
+			return pages [ page ][ key & PAGE_MASK ];
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Predicate Accessor: contains
+		//
+		// Description:
+		//
+		//   Check whether a key currently has a dense slot assigned.
+		//
+		// Arguments:
+		//
+		//   key (std::size_t):
+		//     The key to query.
+		//
+		// Returns:
+		//
+		//   True if the key has a slot, false otherwise.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool contains ( std::size_t key ) const
+		{
+			return find ( key ) != INVALID;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getPageCount
+		//
+		// Description:
+		//
+		//   Return the number of page slots in the page table, including pages that have not been allocated.
+		//
+		// Returns:
+		//
+		//   The size of the page table.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getPageCount () const
+		{
+			return pages.size ();
+		}
+
+		//=============================================================================================================
+		// Mutators
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: set
+		//
+		// Description:
+		//
+		//   Assign a dense slot to a key, allocating the key's page if this is the first key in its range.
+		//
+		// Arguments:
+		//
+		//   key (std::size_t):
+		//     The key to assign.
+		//
+		//   slot (uint32_t):
+		//     The dense slot to associate with the key.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void set ( std::size_t key, uint32_t slot )
+		{
+			// Grow the page table to cover the key's page, then allocate the page itself if needed.
+
+			std::size_t page = key >> PAGE_BITS;
+
+			if ( page >= pages.size () )
+			{
+				pages.resize ( page + 1 );
+			}
+
+			if ( !pages [ page ] )
+			{
+				pages [ page ] = std::make_unique <uint32_t []> ( PAGE_SIZE );
+
+				for ( std::size_t i = 0; i < PAGE_SIZE; ++i )
+				{
+					pages [ page ][ i ] = INVALID;
+				}
+			}
+
+			pages [ page ][ key & PAGE_MASK ] = slot;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: erase
+		//
+		// Description:
+		//
+		//   Clear the slot assigned to a key. Pages are kept allocated so that reusing nearby keys stays cheap.
+		//
+		// Arguments:
+		//
+		//   key (std::size_t):
+		//     The key whose slot should be cleared.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void erase ( std::size_t key )
+		{
+			std::size_t page = key >> PAGE_BITS;
+
+			if ( page < pages.size () && pages [ page ] )
+			{
+				pages [ page ][ key & PAGE_MASK ] = INVALID;
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: clear
+		//
+		// Description:
+		//
+		//   Release every page, leaving the index empty.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void clear ()
+		{
+			pages.clear ();
+		}
+	};
+}
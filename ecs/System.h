@@ -20,9 +20,10 @@
 #pragma once
 
 #include "Entity.h"
+#include "EntitySet.h"
+#include "Profiler.h"
 #include "Signature.h"
 
-#include <set>
 #include <string>
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -51,10 +52,20 @@ namespace ecs
 	//   - A system declares a component signature that specifies which components an entity must possess to be
 	//     processed by this system.
 	//
-	//   - The World automatically maintains the set of matching entities.
+	//   - The World automatically maintains the set of matching entities in an EntitySet, which iterates
+	//     contiguously in a deterministic order.
 	//
 	//   - Derived classes implement the pure virtual update method to define per-frame behavior.
 	//
+	//   - A system may declare the component types it reads and writes through World::declareSystemAccess. The World
+	//     then runs it concurrently with other declared systems it does not conflict with. A system without a
+	//     declaration is assumed to touch everything and always runs alone, on the thread calling updateSystems.
+	//
+	//   - A render system draws the world rather than advancing it. updateSystems skips it, and renderSystems runs
+	//     it once per frame on the calling thread, after any number of simulation steps.
+	//
+	//   - While the World's profiler is enabled, the World times every update into profile.
+	//
 	//*****************************************************************************************************************
 
 	class System
@@ -65,10 +76,15 @@ namespace ecs
 		// Data Members
 		//=============================================================================================================
 
-		std::set <Entity> entities;
-		std::string       name;
-		Signature         signature;
-		bool              enabled  = true;
+		EntitySet     entities;
+		std::string   name;
+		Signature     signature;
+		Signature     reads;
+		Signature     writes;
+		bool          accessDeclared = false;
+		bool          enabled        = true;
+		bool          render         = false;
+		SystemProfile profile;
 
 		//=============================================================================================================
 		// Accessors
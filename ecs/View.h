@@ -0,0 +1,482 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the View class template, a typed query over every entity that has a given set of components.
+//
+//   A view resolves its component storage once when it is created, so iterating it costs no per-entity type
+//   lookups.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "Archetype.h"
+#include "ArchetypeStorage.h"
+#include "ComponentArray.h"
+#include "Entity.h"
+#include "Signature.h"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: ecs
+//
+// Description:
+//
+//   Core namespace for the Entity Component System framework.
+//
+//   Contains all ECS types, managers, and system abstractions used to compose game objects through data-driven
+//   entity-component relationships.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace ecs
+{
+	//*****************************************************************************************************************
+	// Class: View
+	//
+	// Description:
+	//
+	//   Query over all entities that have every one of Components, created by World::view.
+	//
+	//   - In sparse storage mode the view holds raw pointers to each ComponentArray and walks the smallest one,
+	//     skipping entities that are missing any of the other components.
+	//
+	//   - In archetype storage mode the view collects the matching archetypes when it is created and walks their
+	//     rows.
+	//
+	//   - Iterating yields std::tuple <Entity, Components&...>, so a range-for can use structured bindings. each ()
+	//     passes the same values as arguments and, in archetype mode, runs over each chunk's columns directly.
+	//
+	//   - A view must not outlive its World, and components must not be added or removed, nor entities destroyed,
+	//     while it is being iterated.
+	//
+	//*****************************************************************************************************************
+
+	template <typename... Components>
+	class View
+	{
+	public:
+
+		//=============================================================================================================
+		// Constants and Types
+		//=============================================================================================================
+
+		static constexpr std::size_t COMPONENT_COUNT = sizeof... ( Components );
+
+		using Reference = std::tuple <Entity, Components&...>;
+
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::tuple <ComponentArray <Components>*...>    arrays;
+		const std::vector <Entity>*                     lead    = nullptr;
+		ArchetypeStorage*                               storage = nullptr;
+		std::array <ComponentBit, COMPONENT_COUNT>      bits    {};
+		std::vector <Archetype*>                        archetypes;
+		std::vector <std::array <int, COMPONENT_COUNT>> columns;
+
+	public:
+
+		//*************************************************************************************************************
+		// Class: View::Iterator
+		//
+		// Description:
+		//
+		//   Forward iterator over the entities matched by a view.
+		//
+		//   In sparse mode position is an index into the lead entity list; in archetype mode it is an archetype and
+		//   a row within it.
+		//
+		//*************************************************************************************************************
+
+		class Iterator
+		{
+		private:
+
+			const View* view;
+			std::size_t archetype;
+			std::size_t position;
+
+		public:
+
+			using iterator_category = std::forward_iterator_tag;
+			using value_type        = Reference;
+			using difference_type   = std::ptrdiff_t;
+			using pointer           = void;
+			using reference         = Reference;
+
+			Iterator ( const View* view, std::size_t archetype, std::size_t position )
+				: view ( view ), archetype ( archetype ), position ( position )
+			{
+				settle ();
+			}
+
+			Reference operator * () const
+			{
+				return view->dereference ( archetype, position, std::index_sequence_for <Components...> {} );
+			}
+
+			Iterator& operator ++ ()
+			{
+				++position;
+				settle ();
+				return *this;
+			}
+
+			bool operator == ( const Iterator& other ) const
+			{
+				return archetype == other.archetype && position == other.position;
+			}
+
+			bool operator != ( const Iterator& other ) const
+			{
+				return !( *this == other );
+			}
+
+		private:
+
+			// Advance to the next matching entity, or to the end position.
+
+			void settle ()
+			{
+				if ( view->storage != nullptr )
+				{
+					while ( archetype < view->archetypes.size () && position >= view->archetypes [ archetype ]->size () )
+					{
+						++archetype;
+						position = 0;
+					}
+
+					if ( archetype == view->archetypes.size () ) position = 0;
+				}
+				else
+				{
+					while ( position < view->lead->size () && !view->contains ( ( *view->lead ) [ position ] ) )
+					{
+						++position;
+					}
+				}
+			}
+		};
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Predicate Accessor: contains
+		//
+		// Description:
+		//
+		//   Check whether an entity has every component of the view.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity to test.
+		//
+		// Returns:
+		//
+		//   True if the entity has all of Components, false otherwise.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool contains ( Entity entity ) const
+		{
+			if ( storage != nullptr )
+			{
+				for ( ComponentBit bit : bits )
+				{
+					if ( !storage->has ( entity, bit ) ) return false;
+				}
+
+				return true;
+			}
+
+			return ( std::get <ComponentArray <Components>*> ( arrays )->has ( entity ) && ... );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: get
+		//
+		// Description:
+		//
+		//   Retrieve one of the view's components for an entity through the storage the view already resolved.
+		//
+		//   Asserts if the entity does not have the component.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity whose component is being accessed.
+		//
+		// Returns:
+		//
+		//   A mutable reference to the entity's component of type T.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		T& get ( Entity entity ) const
+		{
+			static_assert ( indexOf <T> () < COMPONENT_COUNT, "View::get requires one of the view's component types." );
+
+			if ( storage != nullptr )
+			{
+				return storage->template get <T> ( entity, bits [ indexOf <T> () ] );
+			}
+
+			return std::get <ComponentArray <T>*> ( arrays )->get ( entity );
+		}
+
+		//=============================================================================================================
+		// Constructors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 1/2: View
+		//
+		// Description:
+		//
+		//   Construct a sparse-mode view over the given component arrays and select the smallest as the lead.
+		//
+		// Arguments:
+		//
+		//   componentArrays (ComponentArray <Components>*...):
+		//     The arrays holding each component type.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		explicit View ( ComponentArray <Components>*... componentArrays )
+			: arrays ( componentArrays... )
+		{
+			( selectLead ( componentArrays->getEntities () ), ... );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 2/2: View
+		//
+		// Description:
+		//
+		//   Construct an archetype-mode view and collect every non-empty archetype containing all component bits.
+		//
+		// Arguments:
+		//
+		//   archetypeStorage (ArchetypeStorage&):
+		//     The world's archetype storage.
+		//
+		//   componentBits (const std::array <ComponentBit, COMPONENT_COUNT>&):
+		//     The bit of each component type, in template argument order.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		View ( ArchetypeStorage& archetypeStorage, const std::array <ComponentBit, COMPONENT_COUNT>& componentBits )
+			: storage ( &archetypeStorage )
+			, bits    ( componentBits )
+		{
+			Signature required;
+			for ( ComponentBit bit : bits ) required.set ( bit );
+
+			storage->forEachArchetype
+			(
+				required,
+				[ this ] ( Archetype& archetype )
+				{
+					std::array <int, COMPONENT_COUNT> archetypeColumns;
+
+					for ( std::size_t i = 0; i < COMPONENT_COUNT; ++i )
+					{
+						archetypeColumns [ i ] = archetype.getColumn ( bits [ i ] );
+					}
+
+					archetypes.push_back ( &archetype );
+					columns.push_back    ( archetypeColumns );
+				}
+			);
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: begin / end
+		//
+		// Description:
+		//
+		//   Return iterators over the matched entities, for use with range-based for loops.
+		//
+		//   Example: `for ( auto [ entity, transform, physics ] : world.view <Transform, Physics> () )`.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Iterator begin () const
+		{
+			return Iterator ( this, 0, 0 );
+		}
+
+		Iterator end () const
+		{
+			if ( storage != nullptr ) return Iterator ( this, archetypes.size (), 0 );
+
+			return Iterator ( this, 0, lead->size () );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: each
+		//
+		// Description:
+		//
+		//   Invoke a callable for every matched entity.
+		//
+		//   In archetype mode the loop over each chunk indexes the component columns directly.
+		//
+		// Arguments:
+		//
+		//   function (Function&&):
+		//     Callable taking ( Entity entity, Components&... components ).
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Function>
+		void each ( Function&& function ) const
+		{
+			if ( storage != nullptr )
+			{
+				for ( std::size_t a = 0; a < archetypes.size (); ++a )
+				{
+					eachChunk ( *archetypes [ a ], columns [ a ], function, std::index_sequence_for <Components...> {} );
+				}
+
+				return;
+			}
+
+			for ( Entity entity : *lead )
+			{
+				if ( !contains ( entity ) ) continue;
+
+				function ( entity, std::get <ComponentArray <Components>*> ( arrays )->get ( entity )... );
+			}
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: indexOf
+		//
+		// Description:
+		//
+		//   Return the position of T in Components, or COMPONENT_COUNT if T is not one of them.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		static constexpr std::size_t indexOf ()
+		{
+			constexpr bool matches [] = { std::is_same_v <T, Components>... };
+
+			for ( std::size_t i = 0; i < COMPONENT_COUNT; ++i )
+			{
+				if ( matches [ i ] ) return i;
+			}
+
+			return COMPONENT_COUNT;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: selectLead
+		//
+		// Description:
+		//
+		//   Make the given entity list the lead if it is the first or the smallest seen so far.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void selectLead ( const std::vector <Entity>& entities )
+		{
+			if ( lead == nullptr || entities.size () < lead->size () ) lead = &entities;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: dereference
+		//
+		// Description:
+		//
+		//   Build the reference tuple for an iterator position.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <std::size_t... I>
+		Reference dereference ( std::size_t archetype, std::size_t position, std::index_sequence <I...> ) const
+		{
+			if ( storage != nullptr )
+			{
+				Archetype* table = archetypes [ archetype ];
+
+				return Reference
+				(
+					table->getEntity ( position ),
+					*static_cast <Components*> ( table->getComponent ( position, columns [ archetype ][ I ] ) )...
+				);
+			}
+
+			Entity entity = ( *lead ) [ position ];
+
+			return Reference ( entity, std::get <ComponentArray <Components>*> ( arrays )->get ( entity )... );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: eachChunk
+		//
+		// Description:
+		//
+		//   Run a callable over every row of one archetype, one chunk at a time.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Function, std::size_t... I>
+		static void eachChunk
+		(
+			Archetype&                               archetype,
+			const std::array <int, COMPONENT_COUNT>& archetypeColumns,
+			Function&                                function,
+			std::index_sequence <I...>
+		)
+		{
+			for ( std::size_t chunk = 0; chunk < archetype.getChunkCount (); ++chunk )
+			{
+				std::size_t   count    = archetype.getChunkSize ( chunk );
+				const Entity* entities = archetype.getEntities  ( chunk );
+
+				std::tuple <Components*...> data
+				(
+					static_cast <Components*> ( archetype.getColumnData ( chunk, archetypeColumns [ I ] ) )...
+				);
+
+				for ( std::size_t i = 0; i < count; ++i )
+				{
+					function ( entities [ i ], std::get <I> ( data ) [ i ]... );
+				}
+			}
+		}
+	};
+}
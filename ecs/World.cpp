@@ -7,8 +7,9 @@
 // Description:
 //
 //   Implementation of the World class's non-template methods:
+//   - construction, storage mode selection, and entity storage reservation
 //   - entity lifecycle (createEntity, destroyEntity, isAlive)
-//   - system update dispatch
+//   - system update dispatch and scheduling by declared component access
 //   - system entity set maintenance
 //
 // TODO:
@@ -19,6 +20,16 @@
 
 #include "World.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iomanip>
+#include <ostream>
+
+#if defined ( __GNUC__ ) || defined ( __clang__ )
+	#include <cxxabi.h>
+#endif
+
 //---------------------------------------------------------------------------------------------------------------------
 // Namespace: ecs
 //
@@ -33,10 +44,81 @@
 
 namespace ecs
 {
+	//=================================================================================================================
+	// Constructors
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Constructor 2/2: World
+	//
+	// Description:
+	//
+	//   Construct a world with entity storage pre-allocated for an expected number of entities.
+	//
+	// Arguments:
+	//
+	//   initialCapacity (std::size_t):
+	//     The number of entities to pre-allocate storage for.
+	//
+	//   mode (StorageMode):
+	//     The component storage mode.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	World::World ( std::size_t initialCapacity, StorageMode mode )
+		: entityManager ( initialCapacity )
+		, storageMode   ( mode )
+	{
+	}
+
+	//=================================================================================================================
+	// Mutators
+	//=================================================================================================================
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Mutator: setStorageMode
+	//
+	// Description:
+	//
+	//   Select the component storage mode. Asserts if any entity is alive.
+	//
+	// Arguments:
+	//
+	//   mode (StorageMode):
+	//     The storage mode to use for all subsequent component operations.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void World::setStorageMode ( StorageMode mode )
+	{
+		assert ( entityManager.getLivingCount () == 0 && "Storage mode changed while entities are alive." );
+
+		storageMode = mode;
+	}
+
 	//=================================================================================================================
 	// Methods
 	//=================================================================================================================
 
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: reserveEntities
+	//
+	// Description:
+	//
+	//   Pre-allocate entity storage for at least the given number of entities.
+	//
+	// Arguments:
+	//
+	//   capacity (std::size_t):
+	//     The number of entities to make room for.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void World::reserveEntities ( std::size_t capacity )
+	{
+		entityManager.reserve ( capacity );
+	}
+
 	//-----------------------------------------------------------------------------------------------------------------
 	// Method: createEntity
 	//
@@ -55,6 +137,73 @@ namespace ecs
 		return entityManager.createEntity ();
 	}
 
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: instantiate
+	//
+	// Description:
+	//
+	//   Create a batch of entities that each start with a copy of every component in a prefab.
+	//
+	//   The prefab's signature is already known, so each component is written as one fill over the batch, every
+	//   signature is set directly, and system membership is updated in a single pass.
+	//
+	// Arguments:
+	//
+	//   prefab (const Prefab&):
+	//     The prefab to copy.
+	//
+	//   count (std::size_t):
+	//     The number of entities to create.
+	//
+	// Returns:
+	//
+	//   The new entity handles, in creation order.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::vector <Entity> World::instantiate ( const Prefab& prefab, std::size_t count )
+	{
+		std::vector <Entity> entities;
+		entities.reserve ( count );
+
+		entityManager.reserve ( entityManager.getLivingCount () + count );
+
+		for ( std::size_t i = 0; i < count; ++i )
+		{
+			entities.push_back ( entityManager.createEntity () );
+		}
+
+		if ( prefab.size () == 0 ) return entities;
+
+		Span <const Entity>               batch ( entities.data (), entities.size () );
+		const std::vector <ComponentBit>& bits = prefab.getBits ();
+
+		// Copy the component values into storage.
+
+		if ( storageMode == StorageMode::Archetype )
+		{
+			archetypeStorage.insertMany ( batch, prefab.getSignature (), bits.data (), prefab.getValues (), bits.size () );
+		}
+		else
+		{
+			for ( std::size_t i = 0; i < bits.size (); ++i )
+			{
+				componentManager.getComponentArray ( bits [ i ] ).insertCopies ( batch, prefab.getValues () [ i ] );
+			}
+		}
+
+		// Every new entity has exactly the prefab's signature.
+
+		for ( Entity entity : entities )
+		{
+			entityManager.setSignature ( entity, prefab.getSignature () );
+		}
+
+		updateSystemEntitySets ( batch, prefab.getSignature () );
+
+		return entities;
+	}
+
 	//-----------------------------------------------------------------------------------------------------------------
 	// Method: destroyEntity
 	//
@@ -72,17 +221,38 @@ namespace ecs
 
 	void World::destroyEntity ( Entity entity )
 	{
-		// Remove from all system entity sets.
+		// Remove from the entity sets of the systems that could hold it: those whose signature is a subset of the
+		// entity's. Each system is listed under its lowest bit only, so it is visited at most once.
+
+		const Signature& signature = entityManager.getSignature ( entity );
+
+		for ( ComponentBit bit = 0; bit < MAX_COMPONENTS; ++bit )
+		{
+			if ( !signature.test ( bit ) ) continue;
+
+			for ( System* system : systemsByFirstBit [ bit ] )
+			{
+				system->entities.erase ( entity );
+			}
+		}
 
-		for ( auto& [ name, system ] : systems )
+		for ( System* system : universalSystems )
 		{
 			system->entities.erase ( entity );
 		}
 
 		// Clean up component arrays and recycle the ID.
 
-		componentManager.entityDestroyed ( entity );
-		entityManager.destroyEntity      ( entity );
+		if ( storageMode == StorageMode::Archetype )
+		{
+			archetypeStorage.entityDestroyed ( entity );
+		}
+		else
+		{
+			componentManager.entityDestroyed ( entity );
+		}
+
+		entityManager.destroyEntity ( entity );
 	}
 
 	//-----------------------------------------------------------------------------------------------------------------
@@ -90,34 +260,25 @@ namespace ecs
 	//
 	// Description:
 	//
-	//   Check whether an entity is currently alive by verifying it has a non-empty component signature.
+	//   Check whether an entity handle refers to a live entity, validating both its index and its generation.
 	//
 	// Arguments:
 	//
 	//   entity (Entity):
-	//     The entity ID to query.
+	//     The entity handle to query.
 	//
 	// Returns:
 	//
-	//   True if the entity exists and has a non-empty signature, false otherwise.
+	//   True if the entity exists and the handle is current, false if it is null, out of range, or stale.
 	//
 	//-----------------------------------------------------------------------------------------------------------------
 
 	bool World::isAlive ( Entity entity ) const
 	{
-		// Reject the null sentinel and any ID that falls outside the valid entity range.
+		// The entity manager compares the handle against the live handle stored for its index, so a handle that
+		// survived its entity's destruction is rejected even after the index has been reused.
 
-		if ( entity == NULL_ENTITY || entity > MAX_ENTITIES )
-		{
-			return false;
-		}
-
-		// An entity is considered alive if its signature has at least one bit set, meaning it
-		// possesses one or more components.
-		//
-		// A zeroed-out signature indicates the ID has been recycled or was never initialized.
-
-		return entityManager.getSignature ( entity ).any ();
+		return entityManager.isAlive ( entity );
 	}
 
 	//-----------------------------------------------------------------------------------------------------------------
@@ -125,7 +286,8 @@ namespace ecs
 	//
 	// Description:
 	//
-	//   Invoke update on all registered systems in registration order, skipping any that are disabled.
+	//   Invoke update on all registered systems in registration order, skipping any that are disabled and all
+	//   render systems.
 	//
 	// Arguments:
 	//
@@ -141,15 +303,439 @@ namespace ecs
 		// - Each enabled system receives the current delta time and a reference to this World so it can query and 
 		//   modify entities and components.
 		//
-		// - Disabled systems are skipped entirely for the frame.
+		// - Disabled systems are skipped entirely for the frame, and render systems are left to renderSystems.
+
+		for ( System* system : systemOrder )
+		{
+			if ( system->enabled && !system->render )
+			{
+				runSystem ( *system, dt );
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: renderSystems
+	//
+	// Description:
+	//
+	//   Publish the interpolation alpha, then invoke update on all enabled render systems in registration order.
+	//
+	// Arguments:
+	//
+	//   dt (double):
+	//     Delta time in seconds since the previous frame.
+	//
+	//   alpha (double):
+	//     How far the frame lies between the previous and latest simulation steps.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void World::renderSystems ( double dt, double alpha )
+	{
+		interpolationAlpha = alpha;
+
+		for ( System* system : systemOrder )
+		{
+			if ( system->enabled && system->render )
+			{
+				runSystem ( *system, dt );
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: declareSystemAccess
+	//
+	// Description:
+	//
+	//   Record the component types a system reads and writes, and mark its access as declared.
+	//
+	// Arguments:
+	//
+	//   system (System&):
+	//     The system to declare.
+	//
+	//   reads (Signature):
+	//     The component types the system only reads.
+	//
+	//   writes (Signature):
+	//     The component types the system modifies.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void World::declareSystemAccess ( System& system, Signature reads, Signature writes )
+	{
+		system.reads          = reads & ~writes;
+		system.writes         = writes;
+		system.accessDeclared = true;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: buildSchedule
+	//
+	// Description:
+	//
+	//   Arrange the enabled systems into stages, each system one stage after the latest earlier-registered system
+	//   it conflicts with.
+	//
+	// Returns:
+	//
+	//   The stages in execution order, valid until the next call.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	const std::vector <std::vector <System*>>& World::buildSchedule ()
+	{
+		// Stage of each system in registration order. Disabled systems and render systems get no stage.
+
+		const std::size_t NO_STAGE   = static_cast <std::size_t> ( -1 );
+		std::size_t       stageCount = 0;
+
+		systemStages.assign ( systemOrder.size (), NO_STAGE );
+
+		for ( std::size_t i = 0; i < systemOrder.size (); ++i )
+		{
+			if ( !systemOrder [ i ]->enabled || systemOrder [ i ]->render ) continue;
+
+			std::size_t stage = 0;
+
+			for ( std::size_t j = 0; j < i; ++j )
+			{
+				if ( systemStages [ j ] != NO_STAGE && conflicts ( *systemOrder [ j ], *systemOrder [ i ] ) )
+				{
+					stage = std::max ( stage, systemStages [ j ] + 1 );
+				}
+			}
+
+			systemStages [ i ] = stage;
+			stageCount         = std::max ( stageCount, stage + 1 );
+		}
+
+		// Fill the stages, reusing their storage from the previous frame.
+
+		schedule.resize ( stageCount );
+
+		for ( std::vector <System*>& stage : schedule ) stage.clear ();
+
+		for ( std::size_t i = 0; i < systemOrder.size (); ++i )
+		{
+			if ( systemStages [ i ] != NO_STAGE ) schedule [ systemStages [ i ] ].push_back ( systemOrder [ i ] );
+		}
+
+		return schedule;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: conflicts
+	//
+	// Description:
+	//
+	//   Check whether two systems may not run at the same time.
+	//
+	// Arguments:
+	//
+	//   a, b (const System&):
+	//     The systems to compare.
+	//
+	// Returns:
+	//
+	//   True if either system's access is undeclared, or one writes a component type the other reads or writes.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	bool World::conflicts ( const System& a, const System& b )
+	{
+		if ( !a.accessDeclared || !b.accessDeclared ) return true;
+
+		return ( a.writes & ( b.reads | b.writes ) ).any () || ( b.writes & a.reads ).any ();
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: findScheduleRaces
+	//
+	// Description:
+	//
+	//   Find every pair of systems in the same stage that write a common component type.
+	//
+	// Arguments:
+	//
+	//   stages (const std::vector <std::vector <System*>>&):
+	//     The schedule to check.
+	//
+	// Returns:
+	//
+	//   The racing pairs, in stage order.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::vector <std::pair <const System*, const System*>> World::findScheduleRaces ( const std::vector <std::vector <System*>>& stages )
+	{
+		std::vector <std::pair <const System*, const System*>> races;
+
+		for ( const std::vector <System*>& stage : stages )
+		{
+			for ( std::size_t i = 0; i < stage.size (); ++i )
+			{
+				for ( std::size_t j = i + 1; j < stage.size (); ++j )
+				{
+					// An undeclared system may write anything, so it races with every system it shares a stage with.
+
+					bool undeclared = !stage [ i ]->accessDeclared || !stage [ j ]->accessDeclared;
+
+					if ( undeclared || ( stage [ i ]->writes & stage [ j ]->writes ).any () ) races.emplace_back ( stage [ i ], stage [ j ] );
+				}
+			}
+		}
+
+		return races;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: dumpSchedule
+	//
+	// Description:
+	//
+	//   Build the schedule and write it to a stream, followed by the render systems.
+	//
+	//   Example output:
+	//
+	//     Stage 0
+	//       Gravity      reads: ComponentWorld, ComponentTransform  writes: ComponentPhysics
+	//     Stage 1
+	//       Collider     undeclared, runs alone
+	//     Render
+	//       Renderer
+	//
+	// Arguments:
+	//
+	//   stream (std::ostream&):
+	//     The stream to write to.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void World::dumpSchedule ( std::ostream& stream )
+	{
+		const auto& stages = buildSchedule ();
+
+		// Pad system names to the longest, so the access columns line up.
+
+		std::size_t nameWidth = 0;
+
+		for ( System* system : systemOrder ) nameWidth = std::max ( nameWidth, system->name.size () );
+
+		for ( std::size_t stage = 0; stage < stages.size (); ++stage )
+		{
+			stream << "Stage " << stage << "\n";
+
+			for ( System* system : stages [ stage ] )
+			{
+				stream << "  " << system->name << std::string ( nameWidth - system->name.size () + 2, ' ' );
+
+				if ( system->accessDeclared )
+				{
+					stream << "reads: " << describeComponents ( system->reads ) << "  writes: " << describeComponents ( system->writes ) << "\n";
+				}
+				else
+				{
+					stream << "undeclared, runs alone\n";
+				}
+			}
+		}
+
+		// Render systems run after the stages, once per frame.
+
+		bool renderHeader = false;
+
+		for ( System* system : systemOrder )
+		{
+			if ( !system->enabled || !system->render ) continue;
+
+			if ( !renderHeader ) stream << "Render\n";
+
+			stream << "  " << system->name << "\n";
+
+			renderHeader = true;
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: dumpProfile
+	//
+	// Description:
+	//
+	//   Write each enabled system's timings over its profile window to a stream, one line per system in
+	//   registration order. Systems with no samples yet are left out.
+	//
+	// Arguments:
+	//
+	//   stream (std::ostream&):
+	//     The stream to write to.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void World::dumpProfile ( std::ostream& stream ) const
+	{
+		// Pad system names to the longest, so the columns line up.
+
+		std::size_t nameWidth = 6;
+
+		for ( const System* system : systemOrder ) nameWidth = std::max ( nameWidth, system->name.size () );
+
+		auto flags     = stream.flags ();
+		auto precision = stream.precision ( 3 );
+
+		stream.setf ( std::ios::fixed, std::ios::floatfield );
+		stream << "System" << std::string ( nameWidth - 6, ' ' ) << "  Entities  Min ms  Avg ms  P99 ms\n";
+
+		for ( const System* system : systemOrder )
+		{
+			const SystemProfile& profile = system->profile;
+
+			if ( !system->enabled || profile.getSampleCount () == 0 ) continue;
+
+			stream << system->name << std::string ( nameWidth - system->name.size (), ' ' );
+			stream << std::setw ( 10 ) << profile.getEntityCount ();
+			stream << std::setw ( 8 )  << profile.getMinimum () * 1e3;
+			stream << std::setw ( 8 )  << profile.getAverage () * 1e3;
+			stream << std::setw ( 8 )  << profile.getPercentile ( 0.99 ) * 1e3 << "\n";
+		}
+
+		stream.flags ( flags );
+		stream.precision ( precision );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: runSystem
+	//
+	// Description:
+	//
+	//   Invoke a system's update, timing it while the profiler is enabled.
+	//
+	// Arguments:
+	//
+	//   system (System&):
+	//     The system to update.
+	//
+	//   dt (double):
+	//     Delta time in seconds.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void World::runSystem ( System& system, double dt )
+	{
+		// The disabled path is the plain update behind one branch.
+
+		if ( !profiler.isEnabled () )
+		{
+			system.update ( *this, dt );
+			return;
+		}
+
+		// Read the entity count first, since the update may change the system's entity set.
+
+		std::size_t entityCount = system.entities.size ();
+		auto        start       = Profiler::Clock::now ();
+
+		system.update ( *this, dt );
+
+		auto end = Profiler::Clock::now ();
+
+		system.profile.record ( std::chrono::duration <double> ( end - start ).count (), entityCount );
+
+		if ( profiler.isTracing () ) profiler.addEvent ( system.name.c_str (), start, end );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: describeComponents
+	//
+	// Description:
+	//
+	//   Return the type names of the components in a signature, separated by commas, or "none".
+	//
+	//   Names come from typeid and are demangled where the compiler mangles them.
+	//
+	// Arguments:
+	//
+	//   components (const Signature&):
+	//     The component types to name.
+	//
+	// Returns:
+	//
+	//   The names, in bit order.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::string World::describeComponents ( const Signature& components ) const
+	{
+		std::string result;
+
+		for ( ComponentBit bit = 0; bit < MAX_COMPONENTS; ++bit )
+		{
+			if ( !components.test ( bit ) ) continue;
+
+			std::string name = componentNames [ bit ] != nullptr ? componentNames [ bit ] : "?";
+
+			#if defined ( __GNUC__ ) || defined ( __clang__ )
+
+				int   status    = 0;
+				char* demangled = abi::__cxa_demangle ( name.c_str (), nullptr, nullptr, &status );
+
+				if ( status == 0 && demangled != nullptr ) name = demangled;
+
+				std::free ( demangled );
+
+			#endif
+
+			if ( !result.empty () ) result += ", ";
+
+			result += name;
+		}
+
+		return result.empty () ? "none" : result;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: indexSystem
+	//
+	// Description:
+	//
+	//   Append a system to the update order and to the per-bit lookup tables used for membership maintenance.
+	//
+	// Arguments:
+	//
+	//   system (System*):
+	//     The newly registered system.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void World::indexSystem ( System* system )
+	{
+		systemOrder.push_back ( system );
+
+		// A system with no required components matches every entity and is kept in its own list.
+
+		if ( system->signature.none () )
+		{
+			universalSystems.push_back ( system );
+			return;
+		}
+
+		// List the system under every bit it requires, for add and remove, and under its lowest bit alone, for
+		// destroy.
 
-		for ( const auto& name : systemOrder )
+		bool first = true;
+
+		for ( ComponentBit bit = 0; bit < MAX_COMPONENTS; ++bit )
 		{
-			auto& system = systems [ name ];
+			if ( !system->signature.test ( bit ) ) continue;
+
+			systemsByBit [ bit ].push_back ( system );
 
-			if ( system->enabled )
+			if ( first )
 			{
-				system->update ( *this, dt );
+				systemsByFirstBit [ bit ].push_back ( system );
+				first = false;
 			}
 		}
 	}
@@ -159,33 +745,35 @@ namespace ecs
 	//
 	// Description:
 	//
-	//   Refresh every registered system's entity set after an entity's signature changes. 
+	//   Refresh system entity sets after one component bit of an entity's signature has changed.
 	//
-	//   Adds or removes the entity based on whether its signature matches each system's required signature.
+	//   Only systems whose signature contains the changed bit can gain or lose the entity, so only those are
+	//   re-tested. Systems with an empty signature accept every entity that has had a component change.
 	//
 	// Arguments:
 	//
 	//   entity (Entity):
 	//     The entity whose system membership is being refreshed.
 	//
-	//   entitySignature (Signature):
+	//   entitySignature (const Signature&):
 	//     The entity's current component signature after the change.
 	//
+	//   changedBit (ComponentBit):
+	//     The component bit that was set or reset.
+	//
 	//-----------------------------------------------------------------------------------------------------------------
 
-	void World::updateSystemEntitySets ( Entity entity, Signature entitySignature )
+	void World::updateSystemEntitySets ( Entity entity, const Signature& entitySignature, ComponentBit changedBit )
 	{
-		// Walk every registered system and test the entity's signature against it.
+		// Test the entity's signature against each system that requires the changed component.
+		//
+		// - If the bitwise AND equals the system signature, every required component bit is present and the entity
+		//   qualifies for this system.
+		//
+		// - Otherwise, remove it in case it was previously a member but lost a required component.
 
-		for ( auto& [ name, system ] : systems )
+		for ( System* system : systemsByBit [ changedBit ] )
 		{
-			// Bitwise AND the entity's signature with the system's required signature. 
-			//
-			// - If the result equals the system signature, every required component bit is present and the
-			//   entity qualifies for this system.
-			//
-			// - Otherwise, remove it in case it was previously a member but lost a required component.
-
 			const Signature& systemSig = system->signature;
 
 			if ( ( entitySignature & systemSig ) == systemSig )
@@ -197,5 +785,52 @@ namespace ecs
 				system->entities.erase ( entity );
 			}
 		}
+
+		for ( System* system : universalSystems )
+		{
+			system->entities.insert ( entity );
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Method: updateSystemEntitySets
+	//
+	// Description:
+	//
+	//   Refresh system entity sets after the same component bits have changed on a list of entities.
+	//
+	//   Each system that uses any of the changed bits, and each system with an empty signature, is tested against
+	//   the whole list before moving on to the next system.
+	//
+	// Arguments:
+	//
+	//   entities (Span <const Entity>):
+	//     The entities whose system membership is being refreshed.
+	//
+	//   changedBits (const Signature&):
+	//     The component bits that were set or reset on every entity in the list.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void World::updateSystemEntitySets ( Span <const Entity> entities, const Signature& changedBits )
+	{
+		for ( System* system : systemOrder )
+		{
+			const Signature& systemSig = system->signature;
+
+			if ( systemSig.any () && ( systemSig & changedBits ).none () ) continue;
+
+			for ( Entity entity : entities )
+			{
+				if ( ( entityManager.getSignature ( entity ) & systemSig ) == systemSig )
+				{
+					system->entities.insert ( entity );
+				}
+				else
+				{
+					system->entities.erase ( entity );
+				}
+			}
+		}
 	}
 }
@@ -13,6 +13,9 @@
 //
 //   - All ECS interactions flow through this unified interface.
 //
+//   - Component data is held either in one sparse ComponentArray per type or in archetype chunks, selected per
+//     world with StorageMode.
+//
 // TODO:
 //
 //   1. None.
@@ -21,14 +24,27 @@
 
 #pragma once
 
+#include "ArchetypeStorage.h"
+#include "ComponentInfo.h"
 #include "ComponentManager.h"
 #include "Entity.h"
 #include "EntityManager.h"
+#include "Prefab.h"
+#include "SharedComponentArray.h"
 #include "Signature.h"
+#include "Span.h"
 #include "System.h"
+#include "View.h"
 
+#include <array>
+#include <cassert>
+#include <iosfwd>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
 #include <unordered_map>
 #include <vector>
 
@@ -46,6 +62,27 @@
 
 namespace ecs
 {
+	//-----------------------------------------------------------------------------------------------------------------
+	// Enumeration: StorageMode
+	//
+	// Description:
+	//
+	//   Selects how a World stores component data.
+	//
+	//   - Sparse: one ComponentArray per component type. Adding and removing components is cheap, and
+	//     getComponentArray exposes each type's dense array.
+	//
+	//   - Archetype: entities with the same signature share chunks with one column per component. Iteration over
+	//     several components is linear through forEachChunk; adding or removing a component moves the entity's row.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	enum class StorageMode
+	{
+		Sparse,
+		Archetype
+	};
+
 	//*****************************************************************************************************************
 	// Class: World
 	//
@@ -55,7 +92,7 @@ namespace ecs
 	//   coherent interface.
 	//
 	//   - Provides entity lifecycle management, typed component access, variadic signature construction, and ordered
-	//     system updates.
+	//     system updates, optionally running systems with non-conflicting declared access concurrently.
 	//
 	//   - All game-level ECS operations are performed through the World.
 	//
@@ -71,8 +108,18 @@ namespace ecs
 
 		EntityManager                                              entityManager;
 		ComponentManager                                           componentManager;
+		ArchetypeStorage                                           archetypeStorage;
+		StorageMode                                                storageMode = StorageMode::Sparse;
 		std::unordered_map <std::string, std::shared_ptr <System>> systems;
-		std::vector <std::string>                                  systemOrder;
+		std::vector <System*>                                      systemOrder;
+		std::array <std::vector <System*>, MAX_COMPONENTS>         systemsByBit;
+		std::array <std::vector <System*>, MAX_COMPONENTS>         systemsByFirstBit;
+		std::vector <System*>                                      universalSystems;
+		std::array <const char*, MAX_COMPONENTS>                   componentNames {};
+		std::vector <std::vector <System*>>                        schedule;
+		std::vector <std::size_t>                                  systemStages;
+		double                                                     interpolationAlpha = 1.0;
+		Profiler                                                   profiler;
 
 	public:
 
@@ -101,6 +148,11 @@ namespace ecs
 		template <typename T>
 		T& getComponent ( Entity entity )
 		{
+			if ( storageMode == StorageMode::Archetype )
+			{
+				return archetypeStorage.get <T> ( entity, componentManager.getBit <T> () );
+			}
+
 			return componentManager.getComponent <T> ( entity );
 		}
 
@@ -125,6 +177,11 @@ namespace ecs
 		template <typename T>
 		bool hasComponent ( Entity entity ) const
 		{
+			if ( storageMode == StorageMode::Archetype )
+			{
+				return archetypeStorage.has ( entity, componentManager.getBit <T> () );
+			}
+
 			return componentManager.hasComponent <T> ( entity );
 		}
 
@@ -154,6 +211,8 @@ namespace ecs
 		//
 		//   Retrieve the typed ComponentArray for direct iteration over all components of the specified type.
 		//
+		//   In archetype storage mode the arrays are not populated; use forEachChunk instead.
+		//
 		// Returns:
 		//
 		//   A shared pointer to the ComponentArray for type T.
@@ -167,302 +226,1153 @@ namespace ecs
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Value Accessor: getEntityCount
+		// Value Accessor: getSharedComponentArray
 		//
 		// Description:
 		//
-		//   Return the number of currently living entities in the world.
+		//   Retrieve the SharedComponentArray for shared component type T, to resolve handles without a type lookup
+		//   per entity.
 		//
 		// Returns:
 		//
-		//   The count of entities currently alive.
+		//   A shared pointer to the SharedComponentArray for type T.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		uint32_t getEntityCount () const
+		template <typename T>
+		std::shared_ptr <SharedComponentArray <T>> getSharedComponentArray () const
 		{
-			return entityManager.getLivingCount ();
+			return componentManager.getSharedComponentArray <T> ();
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Predicate Accessor: isAlive
+		// Value Accessor: getShared
 		//
 		// Description:
 		//
-		//   Check whether an entity is currently alive by verifying it has a non-empty component signature.
+		//   Return the value a shared component handle refers to.
 		//
 		// Arguments:
 		//
-		//   entity (Entity):
-		//     The entity ID to query.
+		//   shared (Shared <T>):
+		//     The handle, as returned by createShared.
 		//
 		// Returns:
 		//
-		//   True if the entity exists and has a non-empty signature, false otherwise.
+		//   A mutable reference to the value. Changing it affects every entity holding the handle.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		bool   isAlive ( Entity entity ) const;
-
-		//=============================================================================================================
-		// Mutators
-		//=============================================================================================================
+		template <typename T>
+		T& getShared ( Shared <T> shared ) const
+		{
+			return componentManager.getSharedComponentArray <T> ()->getValue ( shared );
+		}
 
-		// None
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getSharedComponent
+		//
+		// Description:
+		//
+		//   Return the shared value an entity references through its Shared <T> component.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity whose shared component is being accessed.
+		//
+		// Returns:
+		//
+		//   A mutable reference to the shared value.
+		//
+		//-------------------------------------------------------------------------------------------------------------
 
-		//=============================================================================================================
-		// Constructors
-		//=============================================================================================================
+		template <typename T>
+		T& getSharedComponent ( Entity entity )
+		{
+			return getShared ( getComponent <Shared <T>> ( entity ) );
+		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Constructor 1/1: World
+		// Value Accessor: getEntityCount
 		//
 		// Description:
 		//
-		//   Default constructor.
+		//   Return the number of currently living entities in the world.
 		//
-		//   Initializes the internal EntityManager and ComponentManager to their default states.
+		// Returns:
+		//
+		//   The count of entities currently alive.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		World () = default;
-
-		//=============================================================================================================
-		// Methods
-		//=============================================================================================================
+		uint32_t getEntityCount () const
+		{
+			return entityManager.getLivingCount ();
+		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: createEntity
+		// Value Accessor: getEntityCapacity
 		//
 		// Description:
 		//
-		//   Allocate a new entity by delegating to the internal EntityManager.
+		//   Return the number of entities the world can hold before it allocates more entity storage.
 		//
 		// Returns:
 		//
-		//   The newly created entity ID.
+		//   The currently allocated entity capacity.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		Entity createEntity ();
+		std::size_t getEntityCapacity () const
+		{
+			return entityManager.getCapacity ();
+		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: destroyEntity
+		// Value Accessor: getStorageMode
 		//
 		// Description:
 		//
-		//   Destroy an entity, removing it from all system entity sets, cleaning up its components, and recycling
-		//   its ID.
+		//   Return the component storage mode of the world.
 		//
-		// Arguments:
+		// Returns:
 		//
-		//   entity (Entity):
-		//     The entity ID to destroy.
+		//   The StorageMode selected at construction or by setStorageMode.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		void destroyEntity ( Entity entity );
+		StorageMode getStorageMode () const
+		{
+			return storageMode;
+		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: registerComponent
+		// Value Accessor: getInterpolationAlpha
 		//
 		// Description:
 		//
-		//   Register a component type with the ComponentManager, assigning it a unique bit index.
+		//   Return how far the frame being rendered lies between the previous simulation step and the latest one.
 		//
-		//   Must be called before any entity can use this component type.
+		//   Render systems draw state that moves each step at previous + ( latest - previous ) * alpha, so motion
+		//   stays smooth when the step rate and the frame rate differ.
+		//
+		// Returns:
+		//
+		//   A value in [ 0, 1 ], set by renderSystems. One means the latest step.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		template <typename T>
-		void registerComponent ()
+		double getInterpolationAlpha () const
 		{
-			componentManager.registerComponent <T> ();
+			return interpolationAlpha;
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: addComponent
+		// Value Accessor: getProfiler
+		//
+		// Description:
+		//
+		//   Return the World's profiler, which switches system timing and tracing on and off, and which systems open
+		//   trace zones on.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Profiler& getProfiler ()
+		{
+			return profiler;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Predicate Accessor: isAlive
 		//
 		// Description:
 		//
-		//   Add a component to an entity, update its signature, and refresh all system entity sets.
+		//   Check whether an entity handle refers to a live entity, validating both its index and its generation.
 		//
 		// Arguments:
 		//
 		//   entity (Entity):
-		//     The target entity ID.
+		//     The entity handle to query.
 		//
-		//   component (const T&):
-		//     The component data to attach to the entity.
+		// Returns:
+		//
+		//   True if the entity exists and the handle is current, false if it is null, out of range, or stale.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		template <typename T>
-		void addComponent ( Entity entity, const T& component )
-		{
-			componentManager.addComponent <T> ( entity, component );
+		bool   isAlive ( Entity entity ) const;
 
-			// Update entity signature and refresh system entity sets.
+		//=============================================================================================================
+		// Mutators
+		//=============================================================================================================
 
-			auto signature = entityManager.getSignature ( entity );
-			signature.set ( componentManager.getBit <T> () );
-			entityManager.setSignature ( entity, signature );
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: setStorageMode
+		//
+		// Description:
+		//
+		//   Select the component storage mode.
+		//
+		//   Asserts if any entity is alive, since existing components are not migrated between storage backends.
+		//
+		// Arguments:
+		//
+		//   mode (StorageMode):
+		//     The storage mode to use for all subsequent component operations.
+		//
+		//-------------------------------------------------------------------------------------------------------------
 
-			updateSystemEntitySets ( entity, signature );
-		}
+		void setStorageMode ( StorageMode mode );
+
+		//=============================================================================================================
+		// Constructors
+		//=============================================================================================================
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: removeComponent
+		// Constructor 1/2: World
+		//
+		// Description:
+		//
+		//   Default constructor.
+		//
+		//   Initializes the internal EntityManager and ComponentManager to their default states. No entity storage is
+		//   allocated until the first entity is created.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		World () = default;
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 2/2: World
 		//
 		// Description:
 		//
-		//   Remove a component from an entity, update its signature, and refresh all system entity sets.
+		//   Construct a world with entity storage pre-allocated for an expected number of entities.
+		//
+		//   The world still grows past this capacity on demand; the capacity only avoids incremental growth while a
+		//   known population is spawned.
 		//
 		// Arguments:
 		//
-		//   entity (Entity):
-		//     The target entity ID.
+		//   initialCapacity (std::size_t):
+		//     The number of entities to pre-allocate storage for.
+		//
+		//   mode (StorageMode):
+		//     The component storage mode. Defaults to StorageMode::Sparse.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		template <typename T>
-		void removeComponent ( Entity entity )
-		{
-			componentManager.removeComponent <T> ( entity );
+		explicit World ( std::size_t initialCapacity, StorageMode mode = StorageMode::Sparse );
 
-			auto signature = entityManager.getSignature ( entity );
-			signature.reset ( componentManager.getBit <T> () );
-			entityManager.setSignature ( entity, signature );
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
 
-			updateSystemEntitySets ( entity, signature );
-		}
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: reserveEntities
+		//
+		// Description:
+		//
+		//   Pre-allocate entity storage for at least the given number of entities.
+		//
+		// Arguments:
+		//
+		//   capacity (std::size_t):
+		//     The number of entities to make room for.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void reserveEntities ( std::size_t capacity );
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: makeSignature
+		// Method: createEntity
 		//
 		// Description:
 		//
-		//   Construct a Signature bitset with the bits set for all specified component types using a variadic
-		//   fold expression.
+		//   Allocate a new entity by delegating to the internal EntityManager.
 		//
-		//   Example: `world.makeSignature <Physics, Transform> ()`.
+		// Returns:
+		//
+		//   The newly created entity ID.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Entity createEntity ();
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: createEntities
+		//
+		// Description:
+		//
+		//   Allocate a batch of entities, each starting with a copy of every prototype component.
+		//
+		//   Entity storage is reserved once for the whole batch and the components are added with addComponents,
+		//   so system membership is updated in a single pass. Per-entity values can be set afterwards through
+		//   getComponent or a view.
+		//
+		// Arguments:
+		//
+		//   count (std::size_t):
+		//     The number of entities to create.
+		//
+		//   prototypes (const Components&...):
+		//     The initial value of each component. May be empty.
 		//
 		// Returns:
 		//
-		//   A Signature with the bits set for each specified component type.
+		//   The new entity handles, in creation order.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
 		template <typename... Components>
-		Signature makeSignature () const
+		std::vector <Entity> createEntities ( std::size_t count, const Components&... prototypes )
 		{
-			Signature signature;
-			( signature.set ( componentManager.getBit <Components> () ), ... );
-			return signature;
+			std::vector <Entity> entities;
+			entities.reserve ( count );
+
+			entityManager.reserve ( entityManager.getLivingCount () + count );
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				entities.push_back ( entityManager.createEntity () );
+			}
+
+			if constexpr ( sizeof... ( Components ) > 0 )
+			{
+				addComponents ( Span <const Entity> ( entities.data (), entities.size () ), prototypes... );
+			}
+
+			return entities;
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: registerSystem
+		// Method: createPrefab
 		//
 		// Description:
 		//
-		//   Create and register a new system of the specified type with a name and required component signature.
-		//
-		//   The system is added to the ordered update list and returned as a shared pointer.
+		//   Capture a set of component values as a prefab that instantiate can copy onto new entities.
 		//
 		// Arguments:
 		//
-		//   name (const std::string&):
-		//     A unique name identifying the system.
-		//
-		//   signature (Signature):
-		//     The component signature specifying which components an entity must have to be processed.
+		//   components (const Components&...):
+		//     The component values. Each type must be registered.
 		//
 		// Returns:
 		//
-		//   A shared pointer to the newly created system instance.
+		//   The new prefab. It does not refer back to the world and may be kept by the caller.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		template <typename T>
-		std::shared_ptr <T> registerSystem ( const std::string& name, Signature signature )
+		template <typename... Components>
+		Prefab createPrefab ( const Components&... components )
 		{
-			auto system = std::make_shared <T> ();
-			system->name      = name;
-			system->signature = signature;
+			Prefab prefab;
 
-			systems [ name ] = system;
-			systemOrder.push_back ( name );
+			( prefab.set ( componentManager.getBit <Components> (), componentInfoOf <Components> (), &components ), ... );
 
-			return system;
+			return prefab;
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: getSystem
+		// Method: getPrefabComponent
 		//
 		// Description:
 		//
-		//   Retrieve a registered system by name, cast to the specified derived type.
+		//   Retrieve a prefab's value for component type T, for example to restore an entity's original value.
+		//
+		//   Asserts if the prefab does not contain the component.
 		//
 		// Arguments:
 		//
-		//   name (const std::string&):
-		//     The name of the system to retrieve.
+		//   prefab (Prefab&):
+		//     The prefab to read from.
 		//
 		// Returns:
 		//
-		//   A shared pointer to the system cast to type T, or nullptr if not found.
+		//   A mutable reference to the prefab's value. Changing it affects only later instantiations.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
 		template <typename T>
-		std::shared_ptr <T> getSystem ( const std::string& name ) const
+		T& getPrefabComponent ( Prefab& prefab ) const
 		{
-			auto it = systems.find ( name );
-			if ( it != systems.end () )
-			{
-				return std::static_pointer_cast< T >( it->second );
-			}
-			return nullptr;
+			return prefab.get <T> ( componentManager.getBit <T> () );
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: updateSystems
+		// Method: instantiate
 		//
 		// Description:
 		//
-		//   Invoke update on all registered systems in registration order, skipping any that are disabled.
+		//   Create a batch of entities that each start with a copy of every component in a prefab.
+		//
+		//   The prefab's signature is already known, so each component is written as one fill over the batch, every
+		//   signature is set directly, and system membership is updated in a single pass.
 		//
 		// Arguments:
 		//
-		//   dt (double):
-		//     Delta time in seconds since the previous frame.
+		//   prefab (const Prefab&):
+		//     The prefab to copy.
+		//
+		//   count (std::size_t):
+		//     The number of entities to create.
+		//
+		// Returns:
+		//
+		//   The new entity handles, in creation order.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		void updateSystems ( double dt );
-
-	private:
+		std::vector <Entity> instantiate ( const Prefab& prefab, std::size_t count );
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: updateSystemEntitySets
+		// Method: destroyEntity
 		//
 		// Description:
 		//
-		//   Refresh every registered system's entity set after an entity's signature changes.
-		//
-		//   Adds or removes the entity based on whether its signature matches each system's required signature.
+		//   Destroy an entity, removing it from all system entity sets, cleaning up its components, and recycling
+		//   its ID.
 		//
 		// Arguments:
 		//
 		//   entity (Entity):
-		//     The entity whose system membership is being refreshed.
+		//     The entity ID to destroy.
 		//
-		//   entitySignature (Signature):
-		//     The entity's current component signature after the change.
+		//-------------------------------------------------------------------------------------------------------------
+
+		void destroyEntity ( Entity entity );
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: registerComponent
+		//
+		// Description:
+		//
+		//   Register a component type with the ComponentManager, assigning it a unique bit index.
+		//
+		//   Must be called before any entity can use this component type.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		void registerComponent ()
+		{
+			componentManager.registerComponent <T> ();
+			archetypeStorage.registerComponent ( componentManager.getBit <T> (), componentInfoOf <T> () );
+
+			componentNames [ componentManager.getBit <T> () ] = typeid ( T ).name ();
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: registerSharedComponent
+		//
+		// Description:
+		//
+		//   Register a shared component type. Entities carry a Shared <T> handle and the values are stored once in a
+		//   SharedComponentArray <T>.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		void registerSharedComponent ()
+		{
+			componentManager.registerSharedComponent <T> ();
+			archetypeStorage.registerComponent ( componentManager.getBit <Shared <T>> (), componentInfoOf <Shared <T>> () );
+
+			componentNames [ componentManager.getBit <Shared <T>> () ] = typeid ( Shared <T> ).name ();
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: createShared
+		//
+		// Description:
+		//
+		//   Store a shared component value and return the handle entities use to reference it.
+		//
+		// Arguments:
+		//
+		//   value (const T&):
+		//     The value to store.
+		//
+		// Returns:
+		//
+		//   The handle, to be added to entities as a Shared <T> component.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		Shared <T> createShared ( const T& value )
+		{
+			return componentManager.getSharedComponentArray <T> ()->create ( value );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: forEachSharedGroup
+		//
+		// Description:
+		//
+		//   Visit every entity that has a Shared <T> component, grouped by the value it references.
+		//
+		//   The callable runs once per referenced value, so per-value work such as binding a texture is done once per
+		//   group rather than once per entity. Works in both storage modes.
+		//
+		// Arguments:
+		//
+		//   function (Function&&):
+		//     Callable taking ( const T& value, Span <const Entity> entities ).
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T, typename Function>
+		void forEachSharedGroup ( Function&& function )
+		{
+			auto& shared = *componentManager.getSharedComponentArray <T> ();
+
+			view <Shared <T>> ().each
+			(
+				[ &shared ] ( Entity entity, Shared <T>& handle )
+				{
+					shared.collect ( entity, handle );
+				}
+			);
+
+			shared.forEachGroup ( std::forward <Function> ( function ) );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: addComponent
+		//
+		// Description:
+		//
+		//   Add a component to an entity, update its signature, and refresh the entity sets of systems that use the
+		//   component.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The target entity ID.
+		//
+		//   component (const T&):
+		//     The component data to attach to the entity.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		void addComponent ( Entity entity, const T& component )
+		{
+			ComponentBit bit = componentManager.getBit <T> ();
+
+			if ( storageMode == StorageMode::Archetype )
+			{
+				archetypeStorage.add ( entity, bit, &component );
+			}
+			else
+			{
+				componentManager.addComponent <T> ( entity, component );
+			}
+
+			// Update entity signature and refresh the entity sets of the systems that use this component.
+
+			auto signature = entityManager.getSignature ( entity );
+			signature.set ( bit );
+			entityManager.setSignature ( entity, signature );
+
+			updateSystemEntitySets ( entity, signature, bit );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: addComponents
+		//
+		// Description:
+		//
+		//   Add the same set of components to every entity in a list.
+		//
+		//   - In sparse mode each component array grows once for the whole list.
+		//
+		//   - In archetype mode each entity moves straight to the archetype holding all of its new components.
+		//
+		//   - Signatures are written once per entity, then every system that uses any of the components is re-tested
+		//     against the whole list in one pass.
+		//
+		// Arguments:
+		//
+		//   entities (Span <const Entity>):
+		//     The target entity IDs. None may already have any of the components.
+		//
+		//   components (const Components&...):
+		//     The component data to copy to every entity.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename... Components>
+		void addComponents ( Span <const Entity> entities, const Components&... components )
+		{
+			static_assert ( sizeof... ( Components ) > 0, "World::addComponents requires at least one component." );
+
+			const std::array <ComponentBit, sizeof... ( Components )> bits { componentManager.getBit <Components> ()... };
+
+			Signature added;
+			for ( ComponentBit bit : bits ) added.set ( bit );
+
+			if ( storageMode == StorageMode::Archetype )
+			{
+				const void* data [] = { &components... };
+
+				for ( Entity entity : entities )
+				{
+					archetypeStorage.addMany ( entity, bits.data (), data, bits.size () );
+				}
+			}
+			else
+			{
+				( componentManager.addComponents <Components> ( entities, components ), ... );
+			}
+
+			for ( Entity entity : entities )
+			{
+				entityManager.setSignature ( entity, entityManager.getSignature ( entity ) | added );
+			}
+
+			updateSystemEntitySets ( entities, added );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: removeComponent
+		//
+		// Description:
+		//
+		//   Remove a component from an entity, update its signature, and refresh the entity sets of systems that use
+		//   the component.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The target entity ID.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		void removeComponent ( Entity entity )
+		{
+			ComponentBit bit = componentManager.getBit <T> ();
+
+			if ( storageMode == StorageMode::Archetype )
+			{
+				archetypeStorage.remove ( entity, bit );
+			}
+			else
+			{
+				componentManager.removeComponent <T> ( entity );
+			}
+
+			auto signature = entityManager.getSignature ( entity );
+			signature.reset ( bit );
+			entityManager.setSignature ( entity, signature );
+
+			updateSystemEntitySets ( entity, signature, bit );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: makeSignature
+		//
+		// Description:
+		//
+		//   Construct a Signature bitset with the bits set for all specified component types using a variadic
+		//   fold expression.
+		//
+		//   Example: `world.makeSignature <Physics, Transform> ()`.
+		//
+		// Returns:
+		//
+		//   A Signature with the bits set for each specified component type.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename... Components>
+		Signature makeSignature () const
+		{
+			Signature signature;
+			( signature.set ( componentManager.getBit <Components> () ), ... );
+			return signature;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: view
+		//
+		// Description:
+		//
+		//   Create a View over every entity that has all of the specified components.
+		//
+		//   The component storage is resolved once here, so iterating the view or calling its each () performs no
+		//   per-entity type lookups.
+		//
+		//   Example:
+		//
+		//     for ( auto [ entity, transform, physics ] : world.view <Transform, Physics> () ) { ... }
+		//
+		//     world.view <Transform, Physics> ().each ( [] ( Entity entity, Transform& transform, Physics& physics ) { ... } );
+		//
+		// Returns:
+		//
+		//   A View over the current matching entities.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename... Components>
+		View <Components...> view ()
+		{
+			static_assert ( sizeof... ( Components ) > 0, "view requires at least one component type." );
+
+			if ( storageMode == StorageMode::Archetype )
+			{
+				return View <Components...> ( archetypeStorage, { componentManager.getBit <Components> ()... } );
+			}
+
+			return View <Components...> ( componentManager.getComponentArray <Components> ().get ()... );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: forEachChunk
+		//
+		// Description:
+		//
+		//   Visit every entity that has all of the specified components, one chunk at a time, passing raw column
+		//   pointers so the loop over a chunk is straight-line code over contiguous arrays.
+		//
+		//   - In archetype mode each call covers one archetype chunk, and entities [ i ] owns element i of every
+		//     column.
+		//
+		//   - In sparse mode there are no shared columns, so each matching entity is passed as a chunk of one.
+		//
+		//   - The callable must not add or remove components or destroy entities; that would move rows under the
+		//     pointers it was given.
+		//
+		//   Example:
+		//
+		//     world.forEachChunk <Transform, Physics> ( [] ( std::size_t count, const Entity* entities,
+		//                                                  Transform* transforms, Physics* physics ) { ... } );
+		//
+		// Arguments:
+		//
+		//   function (Function&&):
+		//     Callable taking ( std::size_t count, const Entity* entities, Components* columns... ).
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename... Components, typename Function>
+		void forEachChunk ( Function&& function )
+		{
+			static_assert ( sizeof... ( Components ) > 0, "forEachChunk requires at least one component type." );
+
+			const Signature required = makeSignature <Components...> ();
+
+			if ( storageMode == StorageMode::Archetype )
+			{
+				archetypeStorage.forEachArchetype
+				(
+					required,
+					[ & ] ( Archetype& archetype )
+					{
+						for ( std::size_t chunk = 0; chunk < archetype.getChunkCount (); ++chunk )
+						{
+							function
+							(
+								archetype.getChunkSize ( chunk ),
+								static_cast <const Entity*> ( archetype.getEntities ( chunk ) ),
+								static_cast <Components*> ( archetype.getColumnData ( chunk, archetype.getColumn ( componentManager.getBit <Components> () ) ) )...
+							);
+						}
+					}
+				);
+
+				return;
+			}
+
+			// Sparse mode: drive the walk from the first component's dense array and look the others up per entity.
+
+			using Lead = std::tuple_element_t <0, std::tuple <Components...>>;
+
+			auto  arrays = std::make_tuple ( componentManager.getComponentArray <Components> ()... );
+			auto& lead   = std::get <std::shared_ptr <ComponentArray <Lead>>> ( arrays );
+
+			for ( std::size_t i = 0; i < lead->size (); ++i )
+			{
+				Entity entity = lead->getEntity ( i );
+
+				if ( ( entityManager.getSignature ( entity ) & required ) != required ) continue;
+
+				function
+				(
+					std::size_t ( 1 ),
+					static_cast <const Entity*> ( &entity ),
+					&std::get <std::shared_ptr <ComponentArray <Components>>> ( arrays )->get ( entity )...
+				);
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: registerSystem
+		//
+		// Description:
+		//
+		//   Create and register a new system of the specified type with a name and required component signature.
+		//
+		//   The system is added to the ordered update list, indexed under each component bit of its signature, and
+		//   returned as a shared pointer. Asserts if a system with the same name is already registered.
+		//
+		//   Entities that already match the signature are not added; register systems before creating entities.
+		//
+		// Arguments:
+		//
+		//   name (const std::string&):
+		//     A unique name identifying the system.
+		//
+		//   signature (Signature):
+		//     The component signature specifying which components an entity must have to be processed.
+		//
+		// Returns:
+		//
+		//   A shared pointer to the newly created system instance.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		std::shared_ptr <T> registerSystem ( const std::string& name, Signature signature )
+		{
+			assert ( systems.find ( name ) == systems.end () && "Registering system more than once." );
+
+			auto system = std::make_shared <T> ();
+			system->name      = name;
+			system->signature = signature;
+
+			systems [ name ] = system;
+			indexSystem ( system.get () );
+
+			return system;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: getSystem
+		//
+		// Description:
+		//
+		//   Retrieve a registered system by name, cast to the specified derived type.
+		//
+		// Arguments:
+		//
+		//   name (const std::string&):
+		//     The name of the system to retrieve.
+		//
+		// Returns:
+		//
+		//   A shared pointer to the system cast to type T, or nullptr if not found.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename T>
+		std::shared_ptr <T> getSystem ( const std::string& name ) const
+		{
+			auto it = systems.find ( name );
+			if ( it != systems.end () )
+			{
+				return std::static_pointer_cast< T >( it->second );
+			}
+			return nullptr;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: updateSystems
+		//
+		// Description:
+		//
+		//   Invoke update on all registered systems in registration order, skipping any that are disabled and all
+		//   render systems.
+		//
+		// Arguments:
+		//
+		//   dt (double):
+		//     Delta time in seconds since the previous frame.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void updateSystems ( double dt );
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: updateSystems
+		//
+		// Description:
+		//
+		//   Invoke update on all enabled systems other than render systems, running the systems of each stage of the
+		//   schedule concurrently.
+		//
+		//   - The schedule is rebuilt every frame by buildSchedule, so enabling or disabling a system takes effect at
+		//     once.
+		//
+		//   - A stage of one system, which includes every system without an access declaration, runs on the calling
+		//     thread. Larger stages are handed to parallelFor, one index per system.
+		//
+		//   - Systems in a stage share the World concurrently, so a declared system must not create or destroy
+		//     entities, or add or remove components, during update. Queue such changes through a command buffer.
+		//
+		// Arguments:
+		//
+		//   dt (double):
+		//     Delta time in seconds since the previous frame.
+		//
+		//   parallelFor (ParallelFor&&):
+		//     Callable taking ( std::size_t count, Body body ), which runs body ( begin, end ) over ranges covering
+		//     [ 0, count ), possibly on several threads, and returns when all are done.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename ParallelFor>
+		void updateSystems ( double dt, ParallelFor&& parallelFor )
+		{
+			for ( const std::vector <System*>& stage : buildSchedule () )
+			{
+				if ( stage.size () == 1 )
+				{
+					runSystem ( *stage [ 0 ], dt );
+					continue;
+				}
+
+				parallelFor
+				(
+					stage.size (),
+					[ this, &stage, dt ] ( std::size_t begin, std::size_t end )
+					{
+						for ( std::size_t i = begin; i < end; ++i ) runSystem ( *stage [ i ], dt );
+					}
+				);
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: renderSystems
+		//
+		// Description:
+		//
+		//   Invoke update on all enabled render systems in registration order, on the calling thread.
+		//
+		// Arguments:
+		//
+		//   dt (double):
+		//     Delta time in seconds since the previous frame.
+		//
+		//   alpha (double):
+		//     The interpolation alpha returned by getInterpolationAlpha while the render systems run.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void renderSystems ( double dt, double alpha = 1.0 );
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: declareSystemAccess
+		//
+		// Description:
+		//
+		//   Declare the component types a system reads and writes, allowing the scheduler to run it alongside other
+		//   declared systems it does not conflict with.
+		//
+		//   Every component the system touches must be listed, including those it reaches through other entities,
+		//   such as the world entity. A type in both sets only needs to be in writes.
+		//
+		// Arguments:
+		//
+		//   system (System&):
+		//     The system to declare.
+		//
+		//   reads (Signature):
+		//     The component types the system only reads, built with makeSignature.
+		//
+		//   writes (Signature):
+		//     The component types the system modifies.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void declareSystemAccess ( System& system, Signature reads, Signature writes );
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: buildSchedule
+		//
+		// Description:
+		//
+		//   Arrange the enabled systems, other than render systems, into stages that respect their declared access.
+		//
+		//   The systems form a dependency graph: a system depends on every earlier-registered system it conflicts
+		//   with. Each system is placed one stage after the latest of those, so conflicting systems keep their
+		//   registration order and the systems within a stage are free of conflicts. Systems keep their registration
+		//   order within a stage.
+		//
+		// Returns:
+		//
+		//   The stages in execution order, valid until the next call.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		const std::vector <std::vector <System*>>& buildSchedule ();
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: conflicts
+		//
+		// Description:
+		//
+		//   Check whether two systems may not run at the same time: one writes a component type the other reads or
+		//   writes, or either has not declared its access.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static bool conflicts ( const System& a, const System& b );
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: findScheduleRaces
+		//
+		// Description:
+		//
+		//   Find every pair of systems that share a stage but write a common component type. buildSchedule never
+		//   produces one; this checks schedules built or edited by hand, and the scheduler itself.
+		//
+		// Arguments:
+		//
+		//   stages (const std::vector <std::vector <System*>>&):
+		//     The schedule to check.
+		//
+		// Returns:
+		//
+		//   The racing pairs, empty if there are none.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static std::vector <std::pair <const System*, const System*>> findScheduleRaces ( const std::vector <std::vector <System*>>& stages );
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: dumpSchedule
+		//
+		// Description:
+		//
+		//   Build the schedule and write it to a stream, one stage per block with each system's reads and writes by
+		//   component type name, then a block listing the render systems.
+		//
+		// Arguments:
+		//
+		//   stream (std::ostream&):
+		//     The stream to write to.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void dumpSchedule ( std::ostream& stream );
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: dumpProfile
+		//
+		// Description:
+		//
+		//   Write each enabled system's timings over its profile window to a stream, one line per system in
+		//   registration order: the entity count of its latest update, then its minimum, average, and 99th
+		//   percentile update times in milliseconds. Systems with no samples yet are left out.
+		//
+		//   Example output:
+		//
+		//     System      Entities  Min ms  Avg ms  P99 ms
+		//     Gravity           15   0.004   0.005   0.012
+		//     Renderer          15   0.851   0.902   1.310
+		//
+		// Arguments:
+		//
+		//   stream (std::ostream&):
+		//     The stream to write to.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void dumpProfile ( std::ostream& stream ) const;
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: runSystem
+		//
+		// Description:
+		//
+		//   Invoke a system's update. While the profiler is enabled, time it into the system's profile, and while
+		//   it is tracing, record it as a trace event named after the system. Otherwise the only cost is the branch
+		//   on the enabled flag.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void runSystem ( System& system, double dt );
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: describeComponents
+		//
+		// Description:
+		//
+		//   Return the type names of the registered components in a signature, separated by commas.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::string describeComponents ( const Signature& components ) const;
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: indexSystem
+		//
+		// Description:
+		//
+		//   Append a system to the update order and to the per-bit lookup tables used for membership maintenance.
+		//
+		// Arguments:
+		//
+		//   system (System*):
+		//     The newly registered system.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void indexSystem ( System* system );
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: updateSystemEntitySets
+		//
+		// Description:
+		//
+		//   Refresh system entity sets after one component bit of an entity's signature has changed.
+		//
+		//   Only systems whose signature contains the changed bit can gain or lose the entity, so only those are
+		//   re-tested. Systems with an empty signature accept every entity that has had a component change.
+		//
+		// Arguments:
+		//
+		//   entity (Entity):
+		//     The entity whose system membership is being refreshed.
+		//
+		//   entitySignature (const Signature&):
+		//     The entity's current component signature after the change.
+		//
+		//   changedBit (ComponentBit):
+		//     The component bit that was set or reset.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void updateSystemEntitySets ( Entity entity, const Signature& entitySignature, ComponentBit changedBit );
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: updateSystemEntitySets
+		//
+		// Description:
+		//
+		//   Refresh system entity sets after the same component bits have changed on a list of entities.
+		//
+		//   Each system that uses any of the changed bits, and each system with an empty signature, is tested against
+		//   the whole list before moving on to the next system.
+		//
+		// Arguments:
+		//
+		//   entities (Span <const Entity>):
+		//     The entities whose system membership is being refreshed.
+		//
+		//   changedBits (const Signature&):
+		//     The component bits that were set or reset on every entity in the list.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		void updateSystemEntitySets ( Entity entity, Signature entitySignature );
+		void updateSystemEntitySets ( Span <const Entity> entities, const Signature& changedBits );
 	};
 }
@@ -216,7 +216,28 @@ namespace engine
 		// Mutators
 		//=============================================================================================================
 
-		// None
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Mutator: set
+		//
+		// Description:
+		//
+		//   Add a property, or replace the value of an existing one. Used to override loaded settings, for example
+		//   from the command line.
+		//
+		// Arguments:
+		//
+		//   key (const std::string&):
+		//     The property key.
+		//
+		//   value (const std::string&):
+		//     The property value, in the same text form as the settings file.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void set ( const std::string& key, const std::string& value )
+		{
+			properties [ key ] = value;
+		}
 
 		//=============================================================================================================
 		// Constructors
@@ -0,0 +1,279 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the Command class, a move-only void() callable that stores small callables inline instead of on the
+//   heap.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	//*****************************************************************************************************************
+	// Class: Command
+	//
+	// Description:
+	//
+	//   A move-only callable taking no arguments and returning nothing, used for deferred commands.
+	//
+	//   A callable of up to INLINE_SIZE bytes that can be moved without throwing, such as a lambda capturing a few
+	//   pointers or values, is stored in the command itself, so posting it allocates nothing. A larger callable is
+	//   moved to the heap and the command holds the pointer.
+	//
+	//   Each stored type gets one static table of operations, so a command costs one indirect call to run and no
+	//   virtual base.
+	//
+	//*****************************************************************************************************************
+
+	class Command
+	{
+	public:
+
+		//=============================================================================================================
+		// Constants
+		//=============================================================================================================
+
+		static constexpr std::size_t INLINE_SIZE = 48;		// Largest callable stored without a heap allocation.
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Struct: Operations
+		//
+		// Description:
+		//
+		//   The invoke, move, and destroy operations for one stored callable type.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		struct Operations
+		{
+			void ( *invoke )  ( void* storage );
+			void ( *move )    ( void* target, void* source );
+			void ( *destroy ) ( void* storage );
+		};
+
+		template <typename F>
+		static constexpr bool storedInline = sizeof ( F ) <= INLINE_SIZE && alignof ( F ) <= alignof ( std::max_align_t ) && std::is_nothrow_move_constructible <F>::value;
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Struct: InlineOperations, HeapOperations
+		//
+		// Description:
+		//
+		//   The operations for a callable stored in the buffer, and for one stored on the heap behind a pointer in
+		//   the buffer.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename F>
+		struct InlineOperations
+		{
+			static void invoke  ( void* storage )               { ( *static_cast <F*> ( storage ) ) (); }
+			static void move    ( void* target, void* source )  { new ( target ) F ( std::move ( *static_cast <F*> ( source ) ) ); static_cast <F*> ( source )->~F (); }
+			static void destroy ( void* storage )               { static_cast <F*> ( storage )->~F (); }
+
+			static constexpr Operations table { invoke, move, destroy };
+		};
+
+		template <typename F>
+		struct HeapOperations
+		{
+			static void invoke  ( void* storage )               { ( **static_cast <F**> ( storage ) ) (); }
+			static void move    ( void* target, void* source )  { *static_cast <F**> ( target ) = *static_cast <F**> ( source ); }
+			static void destroy ( void* storage )               { delete *static_cast <F**> ( storage ); }
+
+			static constexpr Operations table { invoke, move, destroy };
+		};
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		alignas ( std::max_align_t ) unsigned char storage [ INLINE_SIZE ];		// The callable, or a pointer to it.
+		const Operations*                          operations = nullptr;		// Null while the command is empty.
+
+	public:
+
+		//=============================================================================================================
+		// Predicate Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Predicate Accessor: isInline
+		//
+		// Description:
+		//
+		//   Check whether a callable of type F would be stored without a heap allocation.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename F>
+		static constexpr bool isInline ()
+		{
+			return storedInline <std::decay_t <F>>;
+		}
+
+		explicit operator bool () const
+		{
+			return operations != nullptr;
+		}
+
+		//=============================================================================================================
+		// Constructors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 1/3: Command
+		//
+		// Description:
+		//
+		//   Construct an empty command.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Command () = default;
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 2/3: Command
+		//
+		// Description:
+		//
+		//   Construct a command holding a callable, inline if it fits and on the heap otherwise.
+		//
+		// Arguments:
+		//
+		//   callable (F&&):
+		//     A callable with signature void().
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename F, typename = std::enable_if_t <!std::is_same <std::decay_t <F>, Command>::value>>
+		Command ( F&& callable )
+		{
+			using Stored = std::decay_t <F>;
+
+			if constexpr ( storedInline <Stored> )
+			{
+				new ( storage ) Stored ( std::forward <F> ( callable ) );
+				operations = &InlineOperations <Stored>::table;
+			}
+			else
+			{
+				*reinterpret_cast <Stored**> ( storage ) = new Stored ( std::forward <F> ( callable ) );
+				operations = &HeapOperations <Stored>::table;
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 3/3: Command
+		//
+		// Description:
+		//
+		//   Move constructor. The source is left empty.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Command ( Command&& other ) noexcept
+		{
+			if ( other.operations )
+			{
+				other.operations->move ( storage, other.storage );
+				operations       = other.operations;
+				other.operations = nullptr;
+			}
+		}
+
+		Command& operator = ( Command&& other ) noexcept
+		{
+			if ( this != &other )
+			{
+				reset ();
+
+				if ( other.operations )
+				{
+					other.operations->move ( storage, other.storage );
+					operations       = other.operations;
+					other.operations = nullptr;
+				}
+			}
+
+			return *this;
+		}
+
+		Command ( const Command& )             = delete;
+		Command& operator = ( const Command& ) = delete;
+
+		//=============================================================================================================
+		// Destructor
+		//=============================================================================================================
+
+		~Command ()
+		{
+			reset ();
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: operator ()
+		//
+		// Description:
+		//
+		//   Invoke the stored callable. The command must not be empty.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void operator () ()
+		{
+			operations->invoke ( storage );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: reset
+		//
+		// Description:
+		//
+		//   Destroy the stored callable, leaving the command empty.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void reset ()
+		{
+			if ( operations )
+			{
+				operations->destroy ( storage );
+				operations = nullptr;
+			}
+		}
+	};
+}
@@ -6,8 +6,8 @@
 //
 // Description:
 //
-//   Defines the CommandManager class, a deferred command queue that stores callable operations and executes them
-//   in FIFO order during a flush cycle.
+//   Defines the CommandManager class, a deferred command queue that any thread can post callable operations to, and
+//   that executes them in FIFO order during a flush cycle on the main thread.
 //
 // TODO:
 //
@@ -17,8 +17,15 @@
 
 #pragma once
 
-#include <functional>
-#include <queue>
+#include "Command.h"
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 //---------------------------------------------------------------------------------------------------------------------
 // Namespace: engine
@@ -39,30 +46,138 @@ namespace engine
 	//
 	// Description:
 	//
-	//   Manages a queue of deferred commands represented as std::function <void ()> objects.
+	//   Manages a queue of deferred commands, each a Command holding a void() callable.
 	//
-	//   Commands are posted during processing and later executed in FIFO order when flush is called, enabling safe 
+	//   Commands are posted during processing, from the main thread or any other thread such as an input, network, or
+	//   loader thread, and later executed in FIFO order when flush is called on the main thread, enabling safe
 	//   deferred mutation of engine state during iteration.
 	//
+	//   - Posting is lock-free while the ring has room. The ring is a bounded multi-producer, single-consumer queue:
+	//     producers claim a slot by advancing the tail with a compare-and-swap, and each slot's sequence number tells
+	//     the consumer when the command in it is complete.
+	//   - When the ring is full, commands go to an overflow list behind a mutex instead, and keep going there until
+	//     the next flush has drained it, so commands from one thread still run in the order they were posted.
+	//   - The overflow list is unbounded unless setOverflowLimit is called. Past the limit, post drops the command
+	//     and counts it.
+	//   - Small commands are stored inline in the ring slot, so posting one does not allocate.
+	//
+	//   Only one thread may call flush or clear at a time, and commands run on that thread. A command may post
+	//   further commands, which run in the same flush.
+	//
 	//*****************************************************************************************************************
 
 	class CommandManager
 	{
 	private:
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Struct: Slot
+		//
+		// Description:
+		//
+		//   One ring entry, aligned to a cache line so producers filling neighbouring slots do not share one.
+		//
+		//   The sequence is the ring position the slot is free for, and that position plus one once a command has
+		//   been written to it.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		struct alignas ( 64 ) Slot
+		{
+			std::atomic <std::size_t> sequence { 0 };
+			Command                   command;
+		};
+
 		//=============================================================================================================
 		// Data Members
 		//=============================================================================================================
 
-		std::queue <std::function <void ()>> commandQueue;		// FIFO queue of deferred void() commands awaiting execution on the next flush cycle.
+		std::unique_ptr <Slot []> ring;							// Bounded ring of command slots, a power of two long.
+		std::size_t               mask;							// Ring length minus one, to wrap positions into slots.
+
+		alignas ( 64 ) std::atomic <std::size_t> tail { 0 };	// Next position a producer claims.
+		alignas ( 64 ) std::atomic <std::size_t> head { 0 };	// Next position the consumer reads, advanced by flush.
+
+		std::mutex                overflowMutex;				// Guards the overflow list.
+		std::vector <Command>     overflow;						// Commands posted while the ring was full, in order.
+		std::atomic <bool>        overflowing     { false };	// Set while the overflow list holds commands.
+		std::atomic <std::size_t> overflowDepth   { 0 };		// Commands in the overflow list.
+		std::size_t               overflowLimit   = std::numeric_limits <std::size_t>::max ();
+		std::atomic <std::size_t> overflowedCount { 0 };		// Commands ever posted to the overflow list.
+		std::atomic <std::size_t> droppedCount    { 0 };		// Commands ever dropped past the overflow limit.
 
 	public:
 
+		//=============================================================================================================
+		// Constants
+		//=============================================================================================================
+
+		static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
 		//=============================================================================================================
 		// Accessors
 		//=============================================================================================================
 
-		// None
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getCapacity
+		//
+		// Description:
+		//
+		//   Return the number of commands the lock-free ring holds before posting falls back to the overflow list.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getCapacity () const
+		{
+			return mask + 1;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getDepth
+		//
+		// Description:
+		//
+		//   Return the number of commands waiting to run, in the ring and the overflow list.
+		//
+		//   A command another thread is posting at the same moment may or may not be counted.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getDepth () const
+		{
+			std::size_t read    = head.load ( std::memory_order_relaxed );
+			std::size_t claimed = tail.load ( std::memory_order_relaxed );
+
+			return ( claimed > read ? claimed - read : 0 ) + overflowDepth.load ( std::memory_order_relaxed );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getOverflowedCount
+		//
+		// Description:
+		//
+		//   Return the number of commands ever posted to the overflow list because the ring was full.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getOverflowedCount () const
+		{
+			return overflowedCount.load ( std::memory_order_relaxed );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getDroppedCount
+		//
+		// Description:
+		//
+		//   Return the number of commands ever dropped because the overflow list was at its limit.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getDroppedCount () const
+		{
+			return droppedCount.load ( std::memory_order_relaxed );
+		}
 
 		//=============================================================================================================
 		// Predicate Accessors
@@ -83,14 +198,71 @@ namespace engine
 
 		bool empty () const
 		{
-			return commandQueue.empty ();
+			return getDepth () == 0;
 		}
 
 		//=============================================================================================================
 		// Mutators
 		//=============================================================================================================
 
-		// None
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: setOverflowLimit
+		//
+		// Description:
+		//
+		//   Set the most commands the overflow list may hold. Commands posted while the ring is full and the list is
+		//   at the limit are dropped. The default is no limit.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void setOverflowLimit ( std::size_t limit )
+		{
+			std::lock_guard <std::mutex> lock ( overflowMutex );
+
+			overflowLimit = limit;
+		}
+
+		//=============================================================================================================
+		// Constructors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor 1/1: CommandManager
+		//
+		// Description:
+		//
+		//   Construct an empty command queue.
+		//
+		// Arguments:
+		//
+		//   capacity (std::size_t):
+		//     The length of the lock-free ring, rounded up to a power of two.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		explicit CommandManager ( std::size_t capacity = DEFAULT_CAPACITY )
+		{
+			std::size_t length = 2;
+
+			while ( length < capacity ) length <<= 1;
+
+			ring = std::make_unique <Slot []> ( length );
+			mask = length - 1;
+
+			for ( std::size_t i = 0; i < length; ++i ) ring [ i ].sequence.store ( i, std::memory_order_relaxed );
+		}
+
+		CommandManager ( const CommandManager& )             = delete;
+		CommandManager& operator = ( const CommandManager& ) = delete;
+
+		//=============================================================================================================
+		// Destructor
+		//=============================================================================================================
+
+		~CommandManager ()
+		{
+			clear ();
+		}
 
 		//=============================================================================================================
 		// Methods
@@ -101,22 +273,60 @@ namespace engine
 		//
 		// Description:
 		//
-		//   Enqueue a callable command for deferred execution.
+		//   Enqueue a callable command for deferred execution. Safe to call from any thread.
 		//
-		//   The command is moved into the internal queue and will be executed when flush is called.
+		//   The command is moved into a free ring slot, or into the overflow list if the ring is full, and will be
+		//   executed when flush is called.
 		//
 		// Arguments:
 		//
-		//    (std::function <void ()>):
+		//   command (F&&):
 		//     A callable object or lambda with signature void() representing the deferred command to enqueue.
 		//
+		// Returns:
+		//
+		//   True if the command was queued, false if it was dropped because the overflow list was at its limit.
+		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		void post ( std::function <void ()> command )
+		template <typename F>
+		bool post ( F&& command )
 		{
-			// Move the command into the back of the queue for deferred execution during the next flush cycle.
+			// While earlier commands wait in the overflow list, later ones must queue behind them.
+
+			if ( !overflowing.load ( std::memory_order_acquire ) )
+			{
+				std::size_t position = tail.load ( std::memory_order_relaxed );
+
+				for ( ;; )
+				{
+					Slot&          slot     = ring [ position & mask ];
+					std::size_t    sequence = slot.sequence.load ( std::memory_order_acquire );
+					std::ptrdiff_t distance = static_cast <std::ptrdiff_t> ( sequence ) - static_cast <std::ptrdiff_t> ( position );
+
+					if ( distance == 0 )
+					{
+						// The slot is free for this position. Claim it, write the command, then publish it.
+
+						if ( tail.compare_exchange_weak ( position, position + 1, std::memory_order_relaxed ) )
+						{
+							slot.command = Command ( std::forward <F> ( command ) );
+							slot.sequence.store ( position + 1, std::memory_order_release );
+							return true;
+						}
+					}
+					else if ( distance < 0 )
+					{
+						break;		// The ring is full.
+					}
+					else
+					{
+						position = tail.load ( std::memory_order_relaxed );
+					}
+				}
+			}
 
-			commandQueue.push ( std::move ( command ) );
+			return postOverflow ( Command ( std::forward <F> ( command ) ) );
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
@@ -124,21 +334,41 @@ namespace engine
 		//
 		// Description:
 		//
-		//   Execute and remove all queued commands in FIFO order.
+		//   Execute and remove all queued commands in FIFO order, including commands posted while flushing.
 		//
-		//   Each command is moved out of the queue and invoked sequentially until the queue is empty.
+		//   The ring is drained first, then the overflow list, which only holds commands posted after the ring
+		//   filled. Each command is moved out of the queue before it is invoked, so it may post further commands.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
 		void flush ()
 		{
-			// Drain the queue front-to-back, moving each command out before invoking it so the queue slot is freed.
+			bool ran = true;
 
-			while ( !commandQueue.empty () )
+			while ( ran )
 			{
-				auto cmd = std::move ( commandQueue.front () );
-				commandQueue.pop ();
-				cmd ();
+				ran = false;
+
+				// Drain the ring until the next slot is free or still being written.
+
+				while ( Command* command = front () )
+				{
+					Command next = std::move ( *command );
+					pop ();
+					next ();
+					ran = true;
+				}
+
+				// Take the overflow list and reopen the ring to producers, then run the taken commands.
+
+				if ( overflowing.load ( std::memory_order_acquire ) )
+				{
+					std::vector <Command> pending = takeOverflow ();
+
+					for ( Command& next : pending ) next ();
+
+					ran = true;
+				}
 			}
 		}
 
@@ -147,16 +377,106 @@ namespace engine
 		//
 		// Description:
 		//
-		//   Discard all pending commands without executing them by swapping the internal queue with an empty queue.
+		//   Discard all pending commands without executing them.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
 		void clear ()
 		{
-			// Swap with a default-constructed empty queue to discard all pending commands without executing them.
+			while ( Command* command = front () )
+			{
+				command->reset ();
+				pop ();
+			}
+
+			takeOverflow ();
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: front
+		//
+		// Description:
+		//
+		//   Return the command at the head of the ring, or null if the head slot has not been published yet.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Command* front ()
+		{
+			std::size_t position = head.load ( std::memory_order_relaxed );
+			Slot&       slot     = ring [ position & mask ];
+
+			if ( slot.sequence.load ( std::memory_order_acquire ) != position + 1 ) return nullptr;
+
+			return &slot.command;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: pop
+		//
+		// Description:
+		//
+		//   Release the head slot to producers for the position one lap ahead, and advance the head.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void pop ()
+		{
+			std::size_t position = head.load ( std::memory_order_relaxed );
+
+			ring [ position & mask ].sequence.store ( position + mask + 1, std::memory_order_release );
+			head.store ( position + 1, std::memory_order_relaxed );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: postOverflow
+		//
+		// Description:
+		//
+		//   Append a command to the overflow list, or drop it if the list is at its limit.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool postOverflow ( Command command )
+		{
+			std::lock_guard <std::mutex> lock ( overflowMutex );
+
+			if ( overflow.size () >= overflowLimit )
+			{
+				droppedCount.fetch_add ( 1, std::memory_order_relaxed );
+				return false;
+			}
+
+			overflow.push_back ( std::move ( command ) );
+			overflowDepth.store ( overflow.size (), std::memory_order_relaxed );
+			overflowedCount.fetch_add ( 1, std::memory_order_relaxed );
+			overflowing.store ( true, std::memory_order_release );
+
+			return true;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: takeOverflow
+		//
+		// Description:
+		//
+		//   Move out the overflow list and let producers use the ring again.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::vector <Command> takeOverflow ()
+		{
+			std::lock_guard <std::mutex> lock ( overflowMutex );
+
+			std::vector <Command> pending;
+
+			pending.swap ( overflow );
+			overflowDepth.store ( 0, std::memory_order_relaxed );
+			overflowing.store ( false, std::memory_order_release );
 
-			std::queue <std::function <void ()>> empty;
-			commandQueue.swap ( empty );
+			return pending;
 		}
 	};
 }
@@ -6,8 +6,8 @@
 //
 // Description:
 //
-//   Defines the abstract Engine base class, which provides a fixed-timestep main loop integrating the ECS World,
-//   CommandManager, and ResourceManager.
+//   Defines the abstract Engine base class, which provides a main loop integrating the ECS World, CommandManager,
+//   and ResourceManager, with either a variable or a fixed simulation step.
 //
 //   Derived classes override swapBuffer for platform-specific rendering.
 //
@@ -21,9 +21,13 @@
 
 #include "../ecs/World.h"
 #include "CommandManager.h"
+#include "JobSystem.h"
 #include "ResourceManager.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <memory>
 #include <thread>
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -45,12 +49,24 @@ namespace engine
 	//
 	// Description:
 	//
-	//   Abstract base class for the game engine, providing a fixed-timestep main loop that integrates the ECS World,
+	//   Abstract base class for the game engine, providing a main loop that integrates the ECS World,
 	//   CommandManager, and ResourceManager. 
 	//
 	//   Manages frame rate regulation and exposes lifecycle hooks for derived engines to override platform-specific
 	//   rendering via swapBuffer.
 	//
+	//   - With a variable step, the simulation systems advance once per frame by the previous frame's duration.
+	//
+	//   - With a fixed step, frame time is added to an accumulator and the simulation systems advance in steps of
+	//     exactly the fixed step while it holds a whole step, up to a per-frame limit. Step size no longer depends on
+	//     load, and a time scale above one runs the simulation faster than real time.
+	//
+	//   - Render systems run once per frame after the simulation, with the fraction of a step left in the
+	//     accumulator as the interpolation alpha.
+	//
+	//   - Frame pacing either sleeps in whole milliseconds, or sleeps to just short of the frame deadline and yields
+	//     until it passes, which holds the frame rate to within the scheduler's wake-up latency.
+	//
 	//*****************************************************************************************************************
 
 	class Engine
@@ -65,6 +81,10 @@ namespace engine
 		CommandManager   commandManager;
 		ResourceManager  resourceManager;
 
+		// Optional worker threads. When set, systems with non-conflicting declared access run concurrently.
+
+		std::unique_ptr <JobSystem> jobSystem;
+
 		bool   running          = false;
 		bool   fpsTargetEnabled = true;
 		double targetFPS        = 90.0;
@@ -72,6 +92,19 @@ namespace engine
 		int    minDelayMs       = 5;
 		double dt               = 0.0;
 
+		// Fixed-step simulation, and the simulated time not yet consumed by a step.
+
+		bool   fixedStepEnabled = false;
+		double fixedStep        = 1.0 / 120.0;
+		int    maxStepsPerFrame = 8;
+		double timeScale        = 1.0;
+		double accumulator      = 0.0;
+
+		// Precise frame pacing, and how long before the deadline it stops sleeping and starts yielding.
+
+		bool   precisePacing    = false;
+		int    spinMicroseconds = 2000;
+
 	public:
 
 		//=============================================================================================================
@@ -121,6 +154,8 @@ namespace engine
 		//
 		//   Return a mutable reference to the internal CommandManager instance.
 		//
+		//   Any thread may post to it. The commands run on the thread calling run, at the start of the next frame.
+		//
 		// Returns:
 		//
 		//   A mutable reference to the engine's CommandManager.
@@ -186,6 +221,42 @@ namespace engine
 			return dt;
 		}
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Predicate Accessor: isFixedStep
+		//
+		// Description:
+		//
+		//   Check whether the simulation systems advance in fixed steps.
+		//
+		// Returns:
+		//
+		//   True if fixed-step simulation is enabled, false if the step follows the frame time.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool isFixedStep () const
+		{
+			return fixedStepEnabled;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getFixedStep
+		//
+		// Description:
+		//
+		//   Return the fixed simulation step in seconds.
+		//
+		// Returns:
+		//
+		//   The step used when fixed-step simulation is enabled.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		double getFixedStep () const
+		{
+			return fixedStep;
+		}
+
 		//=============================================================================================================
 		// Mutators
 		//=============================================================================================================
@@ -230,6 +301,90 @@ namespace engine
 			fpsTargetEnabled = false;
 		}
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: setFixedStep
+		//
+		// Description:
+		//
+		//   Advance the simulation systems in fixed steps, independent of the frame rate.
+		//
+		// Arguments:
+		//
+		//   step (double):
+		//     The simulation step in seconds.
+		//
+		//   maxSteps (int):
+		//     The most steps run in one frame. Time beyond that is dropped, so a slow frame cannot make the next
+		//     frame slower still.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void setFixedStep ( double step, int maxSteps )
+		{
+			fixedStep        = step;
+			maxStepsPerFrame = std::max ( maxSteps, 1 );
+			fixedStepEnabled = true;
+			accumulator      = 0.0;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: setVariableStep
+		//
+		// Description:
+		//
+		//   Advance the simulation systems once per frame by the previous frame's duration.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void setVariableStep ()
+		{
+			fixedStepEnabled = false;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: setTimeScale
+		//
+		// Description:
+		//
+		//   Set the simulated seconds that pass per real second in fixed-step mode. Values above one run the
+		//   simulation faster than real time, within the per-frame step limit.
+		//
+		// Arguments:
+		//
+		//   scale (double):
+		//     The time scale.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void setTimeScale ( double scale )
+		{
+			timeScale = scale;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: setPrecisePacing
+		//
+		// Description:
+		//
+		//   Select precise frame pacing, which sleeps to within spin microseconds of the frame deadline and yields
+		//   the rest, or the default pacing, which sleeps in whole milliseconds.
+		//
+		// Arguments:
+		//
+		//   enabled (bool):
+		//     True for precise pacing.
+		//
+		//   spin (int):
+		//     Microseconds before the deadline at which sleeping stops. Should cover the scheduler's oversleep.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void setPrecisePacing ( bool enabled, int spin = 2000 )
+		{
+			precisePacing    = enabled;
+			spinMicroseconds = std::max ( spin, 0 );
+		}
+
 		//=============================================================================================================
 		// Destructor
 		//=============================================================================================================
@@ -269,16 +424,16 @@ namespace engine
 		//
 		//   Enter the main game loop.
 		//
-		//   Each iteration flushes deferred commands, updates all ECS systems, swaps the render buffer, regulates the
-		//   frame rate, and computes the delta time for the next frame.
+		//   Each iteration flushes deferred commands, advances the simulation systems by one variable step or by as
+		//   many fixed steps as the accumulated time holds, runs the render systems, swaps the render buffer,
+		//   regulates the frame rate, and computes the delta time for the next frame.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
 		void run ()
 		{
-			running = true;
-
-			auto previous = std::chrono::high_resolution_clock::now ();
+			running     = true;
+			accumulator = 0.0;
 
 			while ( running )
 			{
@@ -288,9 +443,34 @@ namespace engine
 
 				commandManager.flush ();
 
-				// Update all registered systems.
+				// Advance the simulation.
+
+				double alpha = 1.0;
+
+				if ( fixedStepEnabled )
+				{
+					accumulator += dt * timeScale;
+
+					for ( int step = 0; step < maxStepsPerFrame && accumulator >= fixedStep; ++step )
+					{
+						updateSimulation ( fixedStep );
+						accumulator -= fixedStep;
+					}
+
+					// Drop whole steps the limit left behind, keeping the fraction so rendering stays continuous.
+
+					if ( accumulator >= fixedStep ) accumulator = std::fmod ( accumulator, fixedStep );
 
-				world.updateSystems ( dt );
+					alpha = accumulator / fixedStep;
+				}
+				else
+				{
+					updateSimulation ( dt );
+				}
+
+				// Draw the frame, between the last two simulation steps.
+
+				world.renderSystems ( dt, alpha );
 
 				// Swap the render buffer (overridden by graphical engines).
 
@@ -307,6 +487,48 @@ namespace engine
 			}
 		}
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: runSteps
+		//
+		// Description:
+		//
+		//   Advance the simulation by a number of fixed steps back to back, flushing deferred commands before each.
+		//
+		//   Nothing is rendered or swapped and the frame rate is not regulated, so the steps run as fast as the
+		//   simulation systems allow. Used by headless engines. A stop posted by a command ends the run early.
+		//
+		// Arguments:
+		//
+		//   steps (std::size_t):
+		//     The number of fixed steps to run.
+		//
+		// Returns:
+		//
+		//   The number of steps run.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t runSteps ( std::size_t steps )
+		{
+			running = true;
+
+			std::size_t step = 0;
+
+			while ( running && step < steps )
+			{
+				commandManager.flush ();
+
+				if ( !running ) break;
+
+				updateSimulation ( fixedStep );
+				++step;
+			}
+
+			running = false;
+
+			return step;
+		}
+
 		//-------------------------------------------------------------------------------------------------------------
 		// Method: stop
 		//
@@ -323,6 +545,36 @@ namespace engine
 
 	private:
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: updateSimulation
+		//
+		// Description:
+		//
+		//   Update the simulation systems by one step, stage by stage on the job system if there is one.
+		//
+		// Arguments:
+		//
+		//   step (double):
+		//     The step in seconds.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void updateSimulation ( double step )
+		{
+			if ( jobSystem )
+			{
+				world.updateSystems
+				(
+					step,
+					[ this ] ( std::size_t count, auto&& body ) { jobSystem->parallelFor ( count, 1, body ); }
+				);
+			}
+			else
+			{
+				world.updateSystems ( step );
+			}
+		}
+
 		//-------------------------------------------------------------------------------------------------------------
 		// Method: regulateFrameRate
 		//
@@ -330,7 +582,8 @@ namespace engine
 		//
 		//   Sleep the current thread to maintain the configured frame rate.
 		//
-		//   Computes the remaining time in the frame budget and sleeps for that duration if positive.
+		//   Computes the remaining time in the frame budget and sleeps for that duration if positive. Precise pacing
+		//   measures the budget in clock ticks rather than whole milliseconds, and hands over to pacePrecisely.
 		//
 		// Arguments:
 		//
@@ -364,6 +617,16 @@ namespace engine
 				targetDelayMs = minDelayMs;
 			}
 
+			if ( precisePacing )
+			{
+				double targetSeconds = fpsTargetEnabled ? 1.0 / targetFPS : fixedDelayMs / 1000.0;
+
+				targetSeconds = std::max ( targetSeconds, minDelayMs / 1000.0 );
+
+				pacePrecisely ( frameStart + std::chrono::duration_cast <std::chrono::high_resolution_clock::duration> ( std::chrono::duration <double> ( targetSeconds ) ) );
+				return;
+			}
+
 			// Measure how many milliseconds have already been consumed by this frame's update, render, and swap work.
 
 			auto elapsed = std::chrono::high_resolution_clock::now () - frameStart;
@@ -382,5 +645,38 @@ namespace engine
 				std::this_thread::sleep_for ( std::chrono::milliseconds ( sleepMs ) );
 			}
 		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: pacePrecisely
+		//
+		// Description:
+		//
+		//   Wait until a deadline: sleep while it is more than spinMicroseconds away, then yield until it passes.
+		//
+		//   Sleeping wakes late by up to the scheduler's timer resolution, so the last stretch is covered by
+		//   yielding, which returns within microseconds and still lets other threads run.
+		//
+		// Arguments:
+		//
+		//   deadline (std::chrono::high_resolution_clock::time_point):
+		//     The time at which the current frame should end.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void pacePrecisely ( std::chrono::high_resolution_clock::time_point deadline )
+		{
+			auto spin      = std::chrono::microseconds ( spinMicroseconds );
+			auto remaining = deadline - std::chrono::high_resolution_clock::now ();
+
+			if ( remaining > spin )
+			{
+				std::this_thread::sleep_for ( remaining - spin );
+			}
+
+			while ( std::chrono::high_resolution_clock::now () < deadline )
+			{
+				std::this_thread::yield ();
+			}
+		}
 	};
 }
@@ -6,10 +6,10 @@
 //
 // Description:
 //
-//   Defines the Event struct and EventManager class, implementing a publish-subscribe event system with type-erased
-//   payloads.
+//   Defines the EventManager class, implementing a typed publish-subscribe event system.
 //
-//   Events are queued and dispatched to registered listeners during a flush cycle.
+//   Events are plain structs, queued by type into contiguous buffers and dispatched to registered listeners in bulk
+//   during a flush cycle.
 //
 // TODO:
 //
@@ -19,11 +19,14 @@
 
 #pragma once
 
-#include <any>
+#include "../ecs/Span.h"
+
+#include <atomic>
+#include <cstddef>
 #include <functional>
-#include <queue>
-#include <string>
-#include <unordered_map>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -41,37 +44,27 @@
 namespace engine
 {
 	//*****************************************************************************************************************
-	// Struct: Event
+	// Class: EventManager
 	//
 	// Description:
 	//
-	//   Lightweight event structure carrying a named event identifier and an optional type-erased payload.
+	//   Implements a publish-subscribe event system with deferred dispatch, keyed by event type.
 	//
-	//   Used as the message unit passed between publishers and subscribers through the EventManager.
-	//
-	//*****************************************************************************************************************
-
-	struct Event
-	{
-		//=============================================================================================================
-		// Data Members
-		//=============================================================================================================
-
-		std::string name;
-		std::any    payload;
-	};
-
-	using EventListener = std::function <void ( const Event& )>;
-
-	//*****************************************************************************************************************
-	// Class: EventManager
+	//   Any copyable or movable struct is an event type. Listeners register for a type with subscribe, events are
+	//   constructed in place with emit, and all queued events are dispatched to their listeners when flush is called.
 	//
-	// Description:
+	//   - Each event type has its own channel holding a contiguous buffer of pending events. Emitting appends to it,
+	//     so once the buffer has grown to a frame's worth of events, emitting allocates nothing.
+	//   - Each type gets a small dense index the first time it is used, so finding a channel is a vector index, with
+	//     no name hashing or type lookup.
+	//   - A listener takes either one event, const E&, or a whole batch, ecs::Span <const E>. Either way the channel
+	//     calls it once per batch, and a per-event listener is called for each event inside that call.
 	//
-	//   Implements a publish-subscribe event system with deferred dispatch.
+	//   Within a type, events are dispatched in the order emitted. Types are dispatched one after another, in the
+	//   order each was first used, so there is no ordering between events of different types. Events emitted by a
+	//   listener are dispatched in the same flush. Listeners must not subscribe while a flush is dispatching.
 	//
-	//   Listeners register for named events via subscribe, events are enqueued with post, and all queued events are 
-	//   dispatched to their registered listeners in FIFO order when flush is called.
+	//   An EventManager is not thread-safe; emit, subscribe, and flush must be called from one thread.
 	//
 	//*****************************************************************************************************************
 
@@ -79,12 +72,80 @@ namespace engine
 	{
 	private:
 
+		//-------------------------------------------------------------------------------------------------------------
+		// Class: IEventChannel
+		//
+		// Description:
+		//
+		//   Type-erased interface to one event type's channel, so flush can dispatch every channel in turn.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		class IEventChannel
+		{
+		public:
+
+			virtual ~IEventChannel () = default;
+
+			virtual bool        dispatch        () = 0;
+			virtual void        clear           () = 0;
+			virtual std::size_t getPendingCount () const = 0;
+		};
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Class: EventChannel
+		//
+		// Description:
+		//
+		//   The pending events and listeners for one event type.
+		//
+		//   Dispatch swaps the pending buffer with a second buffer and delivers from that, so listeners can emit
+		//   events of the same type without invalidating the batch being delivered. Both buffers keep their capacity
+		//   between flushes.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename E>
+		class EventChannel : public IEventChannel
+		{
+		public:
+
+			std::vector <E>                                            pending;
+			std::vector <E>                                            delivering;
+			std::vector <std::function <void ( ecs::Span <const E> )>> listeners;
+
+			bool dispatch () override
+			{
+				if ( pending.empty () ) return false;
+
+				delivering.swap ( pending );
+
+				ecs::Span <const E> batch ( delivering.data (), delivering.size () );
+
+				for ( auto& listener : listeners ) listener ( batch );
+
+				delivering.clear ();
+				return true;
+			}
+
+			void clear () override
+			{
+				pending.clear ();
+				listeners.clear ();
+			}
+
+			std::size_t getPendingCount () const override
+			{
+				return pending.size ();
+			}
+		};
+
 		//=============================================================================================================
 		// Data Members
 		//=============================================================================================================
 
-		std::queue <Event>                                              eventQueue;
-		std::unordered_map <std::string, std::vector <EventListener>>   listeners;
+		std::vector <std::unique_ptr <IEventChannel>> channels;		// Indexed by event type index; null if unused.
+		std::vector <IEventChannel*>                  order;		// Channels in the order their type was first used.
 
 	public:
 
@@ -92,13 +153,29 @@ namespace engine
 		// Accessors
 		//=============================================================================================================
 
-		// None
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getPendingCount
+		//
+		// Description:
+		//
+		//   Return the number of events of type E waiting for the next flush, or of all types if E is omitted.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename E>
+		std::size_t getPendingCount ()
+		{
+			return getChannel <E> ().pending.size ();
+		}
 
-		//=============================================================================================================
-		// Mutators
-		//=============================================================================================================
+		std::size_t getPendingCount () const
+		{
+			std::size_t count = 0;
 
-		// None
+			for ( const IEventChannel* channel : order ) count += channel->getPendingCount ();
+
+			return count;
+		}
 
 		//=============================================================================================================
 		// Methods
@@ -109,47 +186,68 @@ namespace engine
 		//
 		// Description:
 		//
-		//   Register a listener callback for a named event.
+		//   Register a listener for events of type E.
 		//
-		//   The listener will be invoked whenever an event with the matching name is dispatched during a flush cycle.
+		//   The listener will be invoked with each flush's events of type E, one at a time if it takes const E&, or
+		//   as one batch if it takes ecs::Span <const E>.
 		//
 		// Arguments:
 		//
-		//   eventName (const std::string&):
-		//     The name of the event to subscribe to.
-		//
-		//   listener (EventListener):
-		//     The callback function to invoke when the named event is dispatched.
+		//   listener (Listener&&):
+		//     Callable taking const E& or ecs::Span <const E>.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		void subscribe ( const std::string& eventName, EventListener listener )
+		template <typename E, typename Listener>
+		void subscribe ( Listener&& listener )
 		{
-			listeners [ eventName ].push_back ( std::move ( listener ) );
+			auto& listeners = getChannel <E> ().listeners;
+
+			if constexpr ( std::is_invocable <Listener&, ecs::Span <const E>>::value )
+			{
+				listeners.emplace_back ( std::forward <Listener> ( listener ) );
+			}
+			else
+			{
+				static_assert ( std::is_invocable <Listener&, const E&>::value, "An event listener must take const E& or ecs::Span <const E>." );
+
+				listeners.emplace_back
+				(
+					[ listener = std::forward <Listener> ( listener ) ] ( ecs::Span <const E> events ) mutable
+					{
+						for ( const E& event : events ) listener ( event );
+					}
+				);
+			}
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
-		// Method: post
+		// Method: emit
 		//
 		// Description:
 		//
-		//   Enqueue an event with the given name and optional payload for deferred dispatch. 
-		//
-		//   The event will be delivered to all matching listeners when flush is called.
+		//   Queue an event of type E for dispatch at the next flush, constructing it in place in the type's buffer.
 		//
 		// Arguments:
 		//
-		//   eventName (const std::string&):
-		//     The name identifying the event type.
-		//
-		//   payload (std::any):
-		//     An optional type-erased payload to attach to the event.
+		//   arguments (Arguments&&...):
+		//     The arguments for E's constructor, or the values of its members in order for an aggregate.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
-		void post ( const std::string& eventName, std::any payload = {} )
+		template <typename E, typename... Arguments>
+		void emit ( Arguments&&... arguments )
 		{
-			eventQueue.push ( { eventName, std::move ( payload ) } );
+			auto& pending = getChannel <E> ().pending;
+
+			if constexpr ( std::is_constructible <E, Arguments&&...>::value )
+			{
+				pending.emplace_back ( std::forward <Arguments> ( arguments )... );
+			}
+			else
+			{
+				pending.push_back ( E { std::forward <Arguments> ( arguments )... } );
+			}
 		}
 
 		//-------------------------------------------------------------------------------------------------------------
@@ -157,35 +255,19 @@ namespace engine
 		//
 		// Description:
 		//
-		//   Dispatch all queued events in FIFO order, invoking every registered listener for each event. 
-		//
-		//   The queue is drained completely before returning.
+		//   Dispatch all queued events to their listeners, type by type, until no channel has events left.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
 		void flush ()
 		{
-			// Process every queued event in FIFO order, draining the queue completely before returning.
+			bool dispatched = true;
 
-			while ( !eventQueue.empty () )
+			while ( dispatched )
 			{
-				// Dequeue the next event by moving it out of the front of the queue, then pop the now-empty front element.
-
-				Event event = std::move ( eventQueue.front () );
-				eventQueue.pop ();
-
-				// Look up all listeners registered for this event name. If any subscribers exist, dispatch the event to them.
+				dispatched = false;
 
-				auto it = listeners.find ( event.name );
-				if ( it != listeners.end () )
-				{
-					// Invoke each registered listener callback, passing the current event by const reference.
-
-					for ( auto& listener : it->second )
-					{
-						listener ( event );
-					}
-				}
+				for ( std::size_t i = 0; i < order.size (); ++i ) dispatched |= order [ i ]->dispatch ();
 			}
 		}
 
@@ -194,15 +276,75 @@ namespace engine
 		//
 		// Description:
 		//
-		//   Discard all queued events and remove all registered listeners, resetting the manager to an empty state.
+		//   Discard all queued events and remove all listeners. The channels keep their buffers for reuse.
 		//
 		//-------------------------------------------------------------------------------------------------------------
 
 		void clear ()
 		{
-			std::queue <Event> empty;
-			eventQueue.swap ( empty );
-			listeners.clear ();
+			for ( IEventChannel* channel : order ) channel->clear ();
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: nextTypeIndex
+		//
+		// Description:
+		//
+		//   Return a new event type index. Indices are shared by every EventManager in the process.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static std::size_t nextTypeIndex ()
+		{
+			static std::atomic <std::size_t> next { 0 };
+
+			return next.fetch_add ( 1, std::memory_order_relaxed );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: typeIndex
+		//
+		// Description:
+		//
+		//   Return event type E's index, assigned the first time E is used.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename E>
+		static std::size_t typeIndex ()
+		{
+			static const std::size_t index = nextTypeIndex ();
+
+			return index;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: getChannel
+		//
+		// Description:
+		//
+		//   Return event type E's channel, creating it on first use.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename E>
+		EventChannel <E>& getChannel ()
+		{
+			static_assert ( std::is_same <E, std::decay_t <E>>::value, "Event types must be plain, unqualified types." );
+
+			std::size_t index = typeIndex <E> ();
+
+			if ( index >= channels.size () ) channels.resize ( index + 1 );
+
+			if ( !channels [ index ] )
+			{
+				channels [ index ] = std::make_unique <EventChannel <E>> ();
+				order.push_back ( channels [ index ].get () );
+			}
+
+			return static_cast <EventChannel <E>&> ( *channels [ index ] );
 		}
 	};
 }
@@ -0,0 +1,416 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the JobSystem class, a pool of worker threads with one job queue per thread that the other threads can
+//   steal from, and the parallelFor helper that splits an index range across it.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	//*****************************************************************************************************************
+	// Class: JobSystem
+	//
+	// Description:
+	//
+	//   Runs parallelFor ranges on a fixed pool of threads, one per core by default.
+	//
+	//   - Every thread owns a queue of jobs. A thread takes work from the back of its own queue and, when that is
+	//     empty, steals from the front of the others, so idle threads pick up what busy threads have not started.
+	//
+	//   - Queue 0 belongs to the threads outside the pool, typically the main thread. A thread that calls
+	//     parallelFor pushes the jobs onto its own queue and then works through them alongside the pool until all
+	//     are done, so the calling thread counts as one of getThreadCount () threads.
+	//
+	//   - parallelFor may be called from inside a job; the worker pushes the nested jobs onto its own queue and
+	//     helps with them in the same way.
+	//
+	//   - Each queue is a std::deque guarded by its own mutex rather than a lock-free work-stealing deque. Jobs are
+	//     coarse ranges, so the lock is taken a few times per thread per call rather than per element.
+	//
+	//   - Workers sleep on a condition variable while there is no work queued.
+	//
+	//*****************************************************************************************************************
+
+	class JobSystem
+	{
+	private:
+
+		//=============================================================================================================
+		// Types
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Struct: Job
+		//
+		// Description:
+		//
+		//   One range of a parallelFor, with a type-erased pointer to its body and the counter it decrements when
+		//   done.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		struct Job
+		{
+			void                       ( *run ) ( const void* body, std::size_t begin, std::size_t end ) = nullptr;
+			const void*                body    = nullptr;
+			std::size_t                begin   = 0;
+			std::size_t                end     = 0;
+			std::atomic <std::size_t>* pending = nullptr;
+		};
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Struct: Queue
+		//
+		// Description:
+		//
+		//   One thread's jobs. The owner uses the back, thieves use the front.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		struct Queue
+		{
+			std::mutex       mutex;
+			std::deque <Job> jobs;
+		};
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::vector <std::unique_ptr <Queue>> queues;
+		std::vector <std::thread>             workers;
+		std::atomic <std::size_t>             queued   { 0 };
+		std::mutex                            sleepMutex;
+		std::condition_variable               wake;
+		bool                                  stopping = false;
+
+		// The job system and queue of the current thread, so nested calls push onto the right queue.
+
+		inline static thread_local const JobSystem* currentSystem = nullptr;
+		inline static thread_local std::size_t      currentQueue  = 0;
+
+	public:
+
+		//=============================================================================================================
+		// Constructors and Destructor
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Constructor: JobSystem
+		//
+		// Description:
+		//
+		//   Start the worker threads.
+		//
+		// Arguments:
+		//
+		//   threadCount (std::size_t):
+		//     The number of threads that run jobs, including the calling thread. Zero selects one per hardware
+		//     thread. One runs every parallelFor on the calling thread.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		explicit JobSystem ( std::size_t threadCount = 0 )
+		{
+			if ( threadCount == 0 ) threadCount = std::max ( 1u, std::thread::hardware_concurrency () );
+
+			for ( std::size_t i = 0; i < threadCount; ++i ) queues.push_back ( std::make_unique <Queue> () );
+
+			for ( std::size_t i = 1; i < threadCount; ++i ) workers.emplace_back ( [ this, i ] () { work ( i ); } );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Destructor: ~JobSystem
+		//
+		// Description:
+		//
+		//   Stop and join the worker threads. No parallelFor may be running.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		~JobSystem ()
+		{
+			{
+				std::lock_guard <std::mutex> lock ( sleepMutex );
+				stopping = true;
+			}
+
+			wake.notify_all ();
+
+			for ( std::thread& worker : workers ) worker.join ();
+		}
+
+		JobSystem ( const JobSystem& )            = delete;
+		JobSystem& operator = ( const JobSystem& ) = delete;
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: getThreadCount
+		//
+		// Description:
+		//
+		//   Return the number of threads that run jobs, including the thread calling parallelFor.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t getThreadCount () const { return queues.size (); }
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: parallelFor
+		//
+		// Description:
+		//
+		//   Split [ 0, count ) into ranges of at least grain indices, run body over each range on any thread, and
+		//   return once all ranges are done.
+		//
+		//   The range is cut into about four ranges per thread so that stealing can even out uneven ranges. Which
+		//   thread runs which range is not fixed, so body must only write state owned by the indices it is given.
+		//
+		// Arguments:
+		//
+		//   count (std::size_t):
+		//     The number of indices.
+		//
+		//   grain (std::size_t):
+		//     The smallest range worth sending to another thread.
+		//
+		//   body (Body&&):
+		//     Callable taking ( std::size_t begin, std::size_t end ). Called concurrently from several threads.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Body>
+		void parallelFor ( std::size_t count, std::size_t grain, Body&& body )
+		{
+			if ( count == 0 ) return;
+
+			std::size_t threads   = getThreadCount ();
+			std::size_t rangeSize = std::max ( std::max ( grain, std::size_t ( 1 ) ), ( count + threads * 4 - 1 ) / ( threads * 4 ) );
+			std::size_t ranges    = ( count + rangeSize - 1 ) / rangeSize;
+
+			if ( threads == 1 || ranges == 1 )
+			{
+				body ( std::size_t ( 0 ), count );
+				return;
+			}
+
+			using BodyType = std::remove_reference_t <Body>;
+
+			std::atomic <std::size_t> pending ( ranges );
+			std::size_t               queue = currentSystem == this ? currentQueue : 0;
+
+			// Queue every range on this thread's queue, then wake the pool. The count is raised before the jobs become
+			// visible, so a thread that takes one straight away can never bring it below zero.
+
+			{
+				std::lock_guard <std::mutex> lock ( queues [ queue ]->mutex );
+
+				queued.fetch_add ( ranges );
+
+				for ( std::size_t begin = 0; begin < count; begin += rangeSize )
+				{
+					Job job;
+
+					job.run     = [] ( const void* function, std::size_t first, std::size_t last ) { ( *static_cast <BodyType*> ( const_cast <void*> ( function ) ) ) ( first, last ); };
+					job.body    = &body;
+					job.begin   = begin;
+					job.end     = std::min ( begin + rangeSize, count );
+					job.pending = &pending;
+
+					queues [ queue ]->jobs.push_back ( job );
+				}
+			}
+
+			{
+				std::lock_guard <std::mutex> lock ( sleepMutex );
+			}
+
+			wake.notify_all ();
+
+			// Help until every range is done. Ranges of this call may be running on other threads after the queues are
+			// empty, so keep checking the counter rather than the queues.
+
+			while ( pending.load ( std::memory_order_acquire ) > 0 )
+			{
+				Job job;
+
+				if ( take ( queue, job ) ) execute ( job );
+				else                       std::this_thread::yield ();
+			}
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: work
+		//
+		// Description:
+		//
+		//   Worker thread loop: run jobs while there are any, otherwise sleep until more are queued or the system
+		//   stops.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void work ( std::size_t queue )
+		{
+			currentSystem = this;
+			currentQueue  = queue;
+
+			while ( true )
+			{
+				Job job;
+
+				if ( take ( queue, job ) )
+				{
+					execute ( job );
+					continue;
+				}
+
+				std::unique_lock <std::mutex> lock ( sleepMutex );
+
+				wake.wait ( lock, [ this ] () { return stopping || queued.load () > 0; } );
+
+				if ( stopping ) return;
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: take
+		//
+		// Description:
+		//
+		//   Take the newest job from a thread's own queue, or else steal the oldest job from another queue.
+		//
+		// Arguments:
+		//
+		//   queue (std::size_t):
+		//     The calling thread's queue.
+		//
+		//   job (Job&):
+		//     Receives the job.
+		//
+		// Returns:
+		//
+		//   True if a job was taken.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool take ( std::size_t queue, Job& job )
+		{
+			std::size_t count = queues.size ();
+
+			for ( std::size_t k = 0; k < count; ++k )
+			{
+				Queue&                       victim = *queues [ ( queue + k ) % count ];
+				std::lock_guard <std::mutex> lock ( victim.mutex );
+
+				if ( victim.jobs.empty () ) continue;
+
+				if ( k == 0 )
+				{
+					job = victim.jobs.back ();
+					victim.jobs.pop_back ();
+				}
+				else
+				{
+					job = victim.jobs.front ();
+					victim.jobs.pop_front ();
+				}
+
+				queued.fetch_sub ( 1 );
+
+				return true;
+			}
+
+			return false;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: execute
+		//
+		// Description:
+		//
+		//   Run a job and mark it done.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static void execute ( const Job& job )
+		{
+			job.run ( job.body, job.begin, job.end );
+			job.pending->fetch_sub ( 1, std::memory_order_acq_rel );
+		}
+	};
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: parallelFor
+	//
+	// Description:
+	//
+	//   Run body over [ 0, count ) on a job system, or in one call on the calling thread if there is none. Lets
+	//   systems hold an optional JobSystem pointer and use the same code either way.
+	//
+	// Arguments:
+	//
+	//   jobs (JobSystem*):
+	//     The job system, or nullptr to run serially.
+	//
+	//   count (std::size_t):
+	//     The number of indices.
+	//
+	//   grain (std::size_t):
+	//     The smallest range worth sending to another thread.
+	//
+	//   body (Body&&):
+	//     Callable taking ( std::size_t begin, std::size_t end ).
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename Body>
+	inline void parallelFor ( JobSystem* jobs, std::size_t count, std::size_t grain, Body&& body )
+	{
+		if ( jobs != nullptr ) jobs->parallelFor ( count, grain, body );
+		else if ( count > 0 )  body ( std::size_t ( 0 ), count );
+	}
+}
@@ -0,0 +1,399 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the PairAccumulator class, which sums a symmetric pair interaction over all pairs or over the pairs of
+//   a neighbour list on a job system, with the same result for any number of threads.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "JobSystem.h"
+#include "math/Vector2D.h"
+#include "spatial/NeighbourList.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	//*****************************************************************************************************************
+	// Class: PairAccumulator
+	//
+	// Description:
+	//
+	//   Applies an interaction to every pair i < j, adding its force to i and the opposite force to j, in parallel
+	//   without two threads ever writing the same force.
+	//
+	//   - The points are cut into at most MAX_BLOCKS blocks of consecutive indices. One job handles the pairs whose
+	//     lower index is in its block. It writes the forces of its own block directly and collects the forces on
+	//     points in later blocks in a spill buffer of its own.
+	//
+	//   - The all-pairs walk visits the pair matrix in tiles of one block of rows by one block of columns, so the
+	//     points of a column block stay in cache while every row of the job's block passes over them.
+	//
+	//   - Once every job is done, each block adds the spill buffers of the earlier blocks to its forces in block
+	//     order.
+	//
+	//   - Block boundaries depend only on the point count, not on the thread count, so every force is summed in
+	//     the same order on any number of threads and the result is reproducible bit for bit. Both walks also sum
+	//     in the same order as each other, so an interaction that is zero outside a neighbour list gives identical
+	//     forces either way.
+	//
+	//*****************************************************************************************************************
+
+	class PairAccumulator
+	{
+	public:
+
+		//=============================================================================================================
+		// Constants
+		//=============================================================================================================
+
+		static constexpr std::size_t MAX_BLOCKS     = 64;
+		static constexpr std::size_t MIN_BLOCK_SIZE = 128;
+
+	private:
+
+		//=============================================================================================================
+		// Types
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Struct: Spill
+		//
+		// Description:
+		//
+		//   The force one pair puts on a point in a later block.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		struct Spill
+		{
+			uint32_t index;
+			Vector2D force;
+		};
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::size_t                          blockSize  = MIN_BLOCK_SIZE;
+		std::size_t                          blockCount = 0;
+		std::vector <Vector2D>               forces;
+		std::vector <std::vector <Vector2D>> rowSums;        // Per block: the running force on each of its rows.
+		std::vector <std::vector <Vector2D>> denseSpills;    // Per block: the force on every point after it.
+		std::vector <std::vector <Spill>>    sparseSpills;   // Per block pair: the forces one block puts on a later one.
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessors: size, getForce
+		//
+		// Description:
+		//
+		//   Return the number of points and the force summed on point i by the last accumulation.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t     size     ()                const { return forces.size (); }
+		const Vector2D& getForce ( std::size_t i ) const { return forces [ i ];   }
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: accumulateAllPairs
+		//
+		// Description:
+		//
+		//   Apply an interaction to every pair of count points and sum the forces.
+		//
+		// Arguments:
+		//
+		//   jobs (JobSystem*):
+		//     The job system, or nullptr to run on the calling thread.
+		//
+		//   count (std::size_t):
+		//     The number of points.
+		//
+		//   interaction (Interaction&&):
+		//     Callable taking ( std::size_t i, std::size_t j, Vector2D& force ) with i < j. Sets the force on i and
+		//     returns true, or returns false if the pair does not interact. Called concurrently from several threads.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Interaction>
+		void accumulateAllPairs ( JobSystem* jobs, std::size_t count, Interaction&& interaction )
+		{
+			partition ( count );
+
+			denseSpills.resize ( blockCount );
+
+			parallelFor ( jobs, blockCount, 1, [ & ] ( std::size_t begin, std::size_t end )
+			{
+				for ( std::size_t block = begin; block < end; ++block ) walkAllPairs ( block, interaction );
+			} );
+
+			parallelFor ( jobs, blockCount, 1, [ this ] ( std::size_t begin, std::size_t end )
+			{
+				for ( std::size_t block = begin; block < end; ++block ) reduceDense ( block );
+			} );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: accumulateListedPairs
+		//
+		// Description:
+		//
+		//   Apply an interaction to every pair in a neighbour list and sum the forces.
+		//
+		// Arguments:
+		//
+		//   jobs (JobSystem*):
+		//     The job system, or nullptr to run on the calling thread.
+		//
+		//   pairs (const NeighbourList&):
+		//     The pairs to visit. Must be built over the same count points.
+		//
+		//   count (std::size_t):
+		//     The number of points.
+		//
+		//   interaction (Interaction&&):
+		//     As for accumulateAllPairs.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Interaction>
+		void accumulateListedPairs ( JobSystem* jobs, const NeighbourList& pairs, std::size_t count, Interaction&& interaction )
+		{
+			partition ( count );
+
+			sparseSpills.resize ( blockCount * blockCount );
+
+			parallelFor ( jobs, blockCount, 1, [ & ] ( std::size_t begin, std::size_t end )
+			{
+				for ( std::size_t block = begin; block < end; ++block ) walkListedPairs ( block, pairs, interaction );
+			} );
+
+			parallelFor ( jobs, blockCount, 1, [ this ] ( std::size_t begin, std::size_t end )
+			{
+				for ( std::size_t block = begin; block < end; ++block ) reduceSparse ( block );
+			} );
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: partition
+		//
+		// Description:
+		//
+		//   Choose the block size for count points and clear the forces.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void partition ( std::size_t count )
+		{
+			blockSize  = std::max ( MIN_BLOCK_SIZE, ( count + MAX_BLOCKS - 1 ) / MAX_BLOCKS );
+			blockCount = ( count + blockSize - 1 ) / blockSize;
+
+			forces.assign ( count, Vector2D ( 0.0, 0.0 ) );
+			rowSums.resize ( blockCount );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: walkAllPairs
+		//
+		// Description:
+		//
+		//   Apply the interaction to every pair whose lower index is in a block, one column block at a time.
+		//
+		//   Each row's force is summed in rowSums in ascending j across all tiles and added to its force at the end,
+		//   after the direct contributions of the block's earlier rows, as in walkListedPairs.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Interaction>
+		void walkAllPairs ( std::size_t block, Interaction& interaction )
+		{
+			std::size_t count = forces.size ();
+			std::size_t first = block * blockSize;
+			std::size_t last  = std::min ( first + blockSize, count );
+
+			std::vector <Vector2D>& sums  = rowSums     [ block ];
+			std::vector <Vector2D>& spill = denseSpills [ block ];
+
+			sums.assign  ( last - first, Vector2D ( 0.0, 0.0 ) );
+			spill.assign ( count - last, Vector2D ( 0.0, 0.0 ) );
+
+			for ( std::size_t column = first; column < count; column += blockSize )
+			{
+				std::size_t columnEnd = std::min ( column + blockSize, count );
+				Vector2D*   target    = column == first ? forces.data () + column : spill.data () + ( column - last );
+
+				for ( std::size_t i = first; i < last; ++i )
+				{
+					Vector2D& sum = sums [ i - first ];
+
+					for ( std::size_t j = std::max ( column, i + 1 ); j < columnEnd; ++j )
+					{
+						Vector2D force;
+
+						if ( !interaction ( i, j, force ) ) continue;
+
+						sum.x                    += force.x;
+						sum.y                    += force.y;
+						target [ j - column ].x -= force.x;
+						target [ j - column ].y -= force.y;
+					}
+				}
+			}
+
+			for ( std::size_t i = first; i < last; ++i )
+			{
+				forces [ i ].x += sums [ i - first ].x;
+				forces [ i ].y += sums [ i - first ].y;
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: walkListedPairs
+		//
+		// Description:
+		//
+		//   Apply the interaction to every listed pair whose lower index is in a block, one row at a time.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Interaction>
+		void walkListedPairs ( std::size_t block, const NeighbourList& pairs, Interaction& interaction )
+		{
+			std::size_t first = block * blockSize;
+			std::size_t last  = std::min ( first + blockSize, forces.size () );
+
+			for ( std::size_t target = block + 1; target < blockCount; ++target ) sparseSpills [ block * blockCount + target ].clear ();
+
+			for ( std::size_t i = first; i < last; ++i )
+			{
+				Vector2D sum ( 0.0, 0.0 );
+
+				for ( const uint32_t* neighbour = pairs.begin ( i ); neighbour != pairs.end ( i ); ++neighbour )
+				{
+					std::size_t j = *neighbour;
+					Vector2D    force;
+
+					if ( !interaction ( i, j, force ) ) continue;
+
+					sum.x += force.x;
+					sum.y += force.y;
+
+					if ( j < last )
+					{
+						forces [ j ].x -= force.x;
+						forces [ j ].y -= force.y;
+					}
+					else
+					{
+						sparseSpills [ block * blockCount + j / blockSize ].push_back ( { static_cast <uint32_t> ( j ), Vector2D ( -force.x, -force.y ) } );
+					}
+				}
+
+				forces [ i ].x += sum.x;
+				forces [ i ].y += sum.y;
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: reduceDense
+		//
+		// Description:
+		//
+		//   Add the earlier blocks' spill buffers to a block's forces, in block order.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void reduceDense ( std::size_t block )
+		{
+			std::size_t first = block * blockSize;
+			std::size_t last  = std::min ( first + blockSize, forces.size () );
+
+			for ( std::size_t source = 0; source < block; ++source )
+			{
+				const Vector2D* spill = denseSpills [ source ].data () + ( first - ( source + 1 ) * blockSize );
+
+				for ( std::size_t i = first; i < last; ++i )
+				{
+					forces [ i ].x += spill [ i - first ].x;
+					forces [ i ].y += spill [ i - first ].y;
+				}
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: reduceSparse
+		//
+		// Description:
+		//
+		//   Add the earlier blocks' spilled forces to a block's forces, in block order.
+		//
+		//   Each source block's entries for a point are summed from zero in pair order before being added, as a
+		//   dense spill buffer would sum them, so the listed and all-pairs walks agree bit for bit. Blocks with no
+		//   entry for a point add nothing, where a dense buffer adds an exact zero.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void reduceSparse ( std::size_t block )
+		{
+			for ( std::size_t source = 0; source < block; ++source )
+			{
+				std::vector <Spill>& spills = sparseSpills [ source * blockCount + block ];
+
+				std::stable_sort ( spills.begin (), spills.end (), [] ( const Spill& a, const Spill& b ) { return a.index < b.index; } );
+
+				for ( std::size_t k = 0; k < spills.size (); )
+				{
+					uint32_t index = spills [ k ].index;
+					Vector2D sum ( 0.0, 0.0 );
+
+					for ( ; k < spills.size () && spills [ k ].index == index; ++k )
+					{
+						sum.x += spills [ k ].force.x;
+						sum.y += spills [ k ].force.y;
+					}
+
+					forces [ index ].x += sum.x;
+					forces [ index ].y += sum.y;
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,237 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the RingBuffer class template, a fixed-capacity FIFO that overwrites its oldest element when full.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "../ecs/Span.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	//*****************************************************************************************************************
+	// Class: RingBuffer
+	//
+	// Description:
+	//
+	//   A bounded history of the most recent values, held in one block allocated when the capacity is set.
+	//
+	//   - push is O(1). Once the buffer is full, each push overwrites the oldest value, so a full buffer never
+	//     allocates or frees.
+	//   - Elements are indexed oldest first. They occupy at most two contiguous runs of the block, returned by spans
+	//     for loops that walk them in order without wrapping an index.
+	//   - Memory is capacity elements, whatever the number held.
+	//
+	//*****************************************************************************************************************
+
+	template <typename T>
+	class RingBuffer
+	{
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::vector <T> storage;		// The block, sized to the capacity.
+		std::size_t     start = 0;		// Position of the oldest element.
+		std::size_t     count = 0;		// Number of elements held.
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessors: size, capacity, empty, full
+		//
+		// Description:
+		//
+		//   The number of elements held, the most that can be held, and whether the buffer is empty or full.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t size     () const { return count; }
+		std::size_t capacity () const { return storage.size (); }
+		bool        empty    () const { return count == 0; }
+		bool        full     () const { return count == storage.size (); }
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: operator []
+		//
+		// Description:
+		//
+		//   Return the element at the given position, counting from the oldest.
+		//
+		// Arguments:
+		//
+		//   index (std::size_t):
+		//     The element position. Must be less than size ().
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		const T& operator [] ( std::size_t index ) const
+		{
+			assert ( index < count && "RingBuffer index out of range." );
+
+			return storage [ position ( index ) ];
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessor: spans
+		//
+		// Description:
+		//
+		//   Return the elements as two contiguous runs, oldest first. The second run is empty unless the elements
+		//   wrap past the end of the block.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::array <ecs::Span <const T>, 2> spans () const
+		{
+			std::size_t firstCount = std::min ( count, storage.size () - start );
+
+			return
+			{
+				ecs::Span <const T> ( storage.data () + start, firstCount ),
+				ecs::Span <const T> ( storage.data (),         count - firstCount )
+			};
+		}
+
+		//=============================================================================================================
+		// Mutators
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Mutator: setCapacity
+		//
+		// Description:
+		//
+		//   Set the most elements the buffer holds, keeping the newest ones that fit. Allocates a new block only when
+		//   the capacity changes, so calling it every frame with the same capacity costs a comparison.
+		//
+		// Arguments:
+		//
+		//   newCapacity (std::size_t):
+		//     The new capacity.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void setCapacity ( std::size_t newCapacity )
+		{
+			if ( newCapacity == storage.size () ) return;
+
+			std::vector <T> block ( newCapacity );
+			std::size_t     kept = std::min ( count, newCapacity );
+
+			for ( std::size_t i = 0; i < kept; ++i ) block [ i ] = std::move ( storage [ position ( count - kept + i ) ] );
+
+			storage.swap ( block );
+			start = 0;
+			count = kept;
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: push
+		//
+		// Description:
+		//
+		//   Append a value as the newest element, overwriting the oldest if the buffer is full. Does nothing if the
+		//   capacity is zero.
+		//
+		// Arguments:
+		//
+		//   value (const T&):
+		//     The value to append.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void push ( const T& value )
+		{
+			std::size_t length = storage.size ();
+
+			if ( length == 0 ) return;
+
+			if ( count < length )
+			{
+				storage [ position ( count ) ] = value;
+				++count;
+			}
+			else
+			{
+				storage [ start ] = value;
+
+				if ( ++start == length ) start = 0;
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: clear
+		//
+		// Description:
+		//
+		//   Remove all elements, keeping the block.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void clear ()
+		{
+			start = 0;
+			count = 0;
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: position
+		//
+		// Description:
+		//
+		//   Return the block position of the element at the given index from the oldest, wrapping with a compare
+		//   rather than a division.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t position ( std::size_t index ) const
+		{
+			std::size_t p = start + index;
+
+			return p < storage.size () ? p : p - storage.size ();
+		}
+	};
+}
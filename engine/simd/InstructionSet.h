@@ -0,0 +1,178 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the InstructionSet enumeration and the runtime CPU feature detection used to choose between the scalar
+//   and vectorised kernels.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+
+#if defined ( __x86_64__ ) || defined ( _M_X64 )
+	#define ENGINE_SIMD_X86 1
+#else
+	#define ENGINE_SIMD_X86 0
+#endif
+
+#if ENGINE_SIMD_X86 && defined ( _MSC_VER )
+	#include <immintrin.h>
+	#include <intrin.h>
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	//*****************************************************************************************************************
+	// Enumeration: InstructionSet
+	//
+	// Description:
+	//
+	//   The vector instruction sets a kernel can be dispatched to, in increasing order of width.
+	//
+	//   - Scalar runs one pair at a time and is available everywhere.
+	//
+	//   - SSE2, AVX2, and AVX512 process 2, 4, and 8 doubles (4, 8, and 16 floats) at a time and exist only on
+	//     x86-64. SSE2 is part of the x86-64 baseline.
+	//
+	//*****************************************************************************************************************
+
+	enum class InstructionSet
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+		AVX512
+	};
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: detectInstructionSet
+	//
+	// Description:
+	//
+	//   Return the widest instruction set supported by both the CPU and the operating system. The result is computed
+	//   once and cached.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline InstructionSet detectInstructionSet ()
+	{
+		static const InstructionSet detected = [] ()
+		{
+			#if ENGINE_SIMD_X86 && ( defined ( __GNUC__ ) || defined ( __clang__ ) )
+
+				__builtin_cpu_init ();
+
+				if ( __builtin_cpu_supports ( "avx512f" ) ) return InstructionSet::AVX512;
+				if ( __builtin_cpu_supports ( "avx2" ) )    return InstructionSet::AVX2;
+
+				return InstructionSet::SSE2;
+
+			#elif ENGINE_SIMD_X86 && defined ( _MSC_VER )
+
+				// Leaf 1 ECX bit 27 reports OSXSAVE; XCR0 then says which register states the OS saves.
+
+				int registers [ 4 ];
+
+				__cpuid ( registers, 1 );
+
+				if ( !( registers [ 2 ] & ( 1 << 27 ) ) ) return InstructionSet::SSE2;
+
+				unsigned long long xcr0 = _xgetbv ( 0 );
+
+				__cpuidex ( registers, 7, 0 );
+
+				bool avx2   = ( xcr0 & 0x06 ) == 0x06 && ( registers [ 1 ] & ( 1 << 5 ) );
+				bool avx512 = ( xcr0 & 0xE6 ) == 0xE6 && ( registers [ 1 ] & ( 1 << 16 ) );
+
+				if ( avx512 ) return InstructionSet::AVX512;
+				if ( avx2 )   return InstructionSet::AVX2;
+
+				return InstructionSet::SSE2;
+
+			#else
+
+				return InstructionSet::Scalar;
+
+			#endif
+		} ();
+
+		return detected;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: supportedInstructionSet
+	//
+	// Description:
+	//
+	//   Clamp a requested instruction set to the widest one the machine supports.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline InstructionSet supportedInstructionSet ( InstructionSet requested )
+	{
+		return std::min ( requested, detectInstructionSet () );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: parseInstructionSet
+	//
+	// Description:
+	//
+	//   Convert a settings value to an instruction set. "Auto" and unrecognised names select the widest supported
+	//   set.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline InstructionSet parseInstructionSet ( const std::string& name )
+	{
+		if ( name == "Scalar" ) return InstructionSet::Scalar;
+		if ( name == "SSE2" )   return supportedInstructionSet ( InstructionSet::SSE2 );
+		if ( name == "AVX2" )   return supportedInstructionSet ( InstructionSet::AVX2 );
+		if ( name == "AVX512" ) return supportedInstructionSet ( InstructionSet::AVX512 );
+
+		return detectInstructionSet ();
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: instructionSetName
+	//
+	// Description:
+	//
+	//   Return the settings name of an instruction set.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	inline const char* instructionSetName ( InstructionSet instructionSet )
+	{
+		switch ( instructionSet )
+		{
+			case InstructionSet::SSE2:   return "SSE2";
+			case InstructionSet::AVX2:   return "AVX2";
+			case InstructionSet::AVX512: return "AVX512";
+			default:                     return "Scalar";
+		}
+	}
+}
@@ -0,0 +1,136 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   AVX2 implementation of the all-pairs force kernel: 4 doubles or 8 floats per instruction. Compiled with AVX2
+//   target flags; only called after detectInstructionSet has confirmed support.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "PairForceLoop.h"
+
+#if ENGINE_SIMD_X86
+
+#include <immintrin.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Anonymous Namespace
+//
+// Description:
+//
+//   Vector types for PairForceLoop.h, kept local to this translation unit.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+	//*****************************************************************************************************************
+	// Struct: AVX2Double
+	//
+	// Description:
+	//
+	//   Four doubles per __m256d. Masks are all-ones or all-zero lanes.
+	//
+	//*****************************************************************************************************************
+
+	struct AVX2Double
+	{
+		using Scalar = double;
+		using Vector = __m256d;
+		using Mask   = __m256d;
+
+		static constexpr std::size_t WIDTH = 4;
+
+		static Vector broadcast  ( double value )              { return _mm256_set1_pd ( value );           }
+		static Vector load       ( const double* address )     { return _mm256_loadu_pd ( address );        }
+		static void   store      ( double* address, Vector v ) { _mm256_storeu_pd ( address, v );           }
+		static Vector add        ( Vector a, Vector b )        { return _mm256_add_pd ( a, b );             }
+		static Vector subtract   ( Vector a, Vector b )        { return _mm256_sub_pd ( a, b );             }
+		static Vector multiply   ( Vector a, Vector b )        { return _mm256_mul_pd ( a, b );             }
+		static Vector divide     ( Vector a, Vector b )        { return _mm256_div_pd ( a, b );             }
+		static Vector squareRoot ( Vector a )                  { return _mm256_sqrt_pd ( a );               }
+		static Mask   greater    ( Vector a, Vector b )        { return _mm256_cmp_pd ( a, b, _CMP_GT_OQ ); }
+		static Mask   less       ( Vector a, Vector b )        { return _mm256_cmp_pd ( a, b, _CMP_LT_OQ ); }
+		static Vector keep       ( Mask mask, Vector v )       { return _mm256_and_pd ( mask, v );          }
+
+		static double sum ( Vector v )
+		{
+			__m128d halves = _mm_add_pd ( _mm256_castpd256_pd128 ( v ), _mm256_extractf128_pd ( v, 1 ) );
+
+			return _mm_cvtsd_f64 ( _mm_add_sd ( halves, _mm_unpackhi_pd ( halves, halves ) ) );
+		}
+	};
+
+	//*****************************************************************************************************************
+	// Struct: AVX2Float
+	//
+	// Description:
+	//
+	//   Eight floats per __m256. Masks are all-ones or all-zero lanes.
+	//
+	//*****************************************************************************************************************
+
+	struct AVX2Float
+	{
+		using Scalar = float;
+		using Vector = __m256;
+		using Mask   = __m256;
+
+		static constexpr std::size_t WIDTH = 8;
+
+		static Vector broadcast  ( float value )              { return _mm256_set1_ps ( value );           }
+		static Vector load       ( const float* address )     { return _mm256_loadu_ps ( address );        }
+		static void   store      ( float* address, Vector v ) { _mm256_storeu_ps ( address, v );           }
+		static Vector add        ( Vector a, Vector b )       { return _mm256_add_ps ( a, b );             }
+		static Vector subtract   ( Vector a, Vector b )       { return _mm256_sub_ps ( a, b );             }
+		static Vector multiply   ( Vector a, Vector b )       { return _mm256_mul_ps ( a, b );             }
+		static Vector divide     ( Vector a, Vector b )       { return _mm256_div_ps ( a, b );             }
+		static Vector squareRoot ( Vector a )                 { return _mm256_sqrt_ps ( a );               }
+		static Mask   greater    ( Vector a, Vector b )       { return _mm256_cmp_ps ( a, b, _CMP_GT_OQ ); }
+		static Mask   less       ( Vector a, Vector b )       { return _mm256_cmp_ps ( a, b, _CMP_LT_OQ ); }
+		static Vector keep       ( Mask mask, Vector v )      { return _mm256_and_ps ( mask, v );          }
+
+		static float sum ( Vector v )
+		{
+			__m128 halves = _mm_add_ps ( _mm256_castps256_ps128 ( v ), _mm256_extractf128_ps ( v, 1 ) );
+			__m128 pairs  = _mm_add_ps ( halves, _mm_movehl_ps ( halves, halves ) );
+
+			return _mm_cvtss_f32 ( _mm_add_ss ( pairs, _mm_shuffle_ps ( pairs, pairs, 1 ) ) );
+		}
+	};
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	std::size_t accumulatePairForcesAVX2 ( const PairForceArrays <double>& arrays, const PairForceLaws <double>& laws, std::size_t firstRow, std::size_t lastRow )
+	{
+		return accumulatePairForcesVector <AVX2Double> ( arrays, laws, firstRow, lastRow );
+	}
+
+	std::size_t accumulatePairForcesAVX2 ( const PairForceArrays <float>& arrays, const PairForceLaws <float>& laws, std::size_t firstRow, std::size_t lastRow )
+	{
+		return accumulatePairForcesVector <AVX2Float> ( arrays, laws, firstRow, lastRow );
+	}
+}
+
+#endif
@@ -0,0 +1,123 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   AVX-512 implementation of the all-pairs force kernel: 8 doubles or 16 floats per instruction. Compiled with
+//   AVX-512F target flags; only called after detectInstructionSet has confirmed support.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "PairForceLoop.h"
+
+#if ENGINE_SIMD_X86
+
+#include <immintrin.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Anonymous Namespace
+//
+// Description:
+//
+//   Vector types for PairForceLoop.h, kept local to this translation unit.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+	//*****************************************************************************************************************
+	// Struct: AVX512Double
+	//
+	// Description:
+	//
+	//   Eight doubles per __m512d. Masks are one bit per lane.
+	//
+	//*****************************************************************************************************************
+
+	struct AVX512Double
+	{
+		using Scalar = double;
+		using Vector = __m512d;
+		using Mask   = __mmask8;
+
+		static constexpr std::size_t WIDTH = 8;
+
+		static Vector broadcast  ( double value )              { return _mm512_set1_pd ( value );                }
+		static Vector load       ( const double* address )     { return _mm512_loadu_pd ( address );             }
+		static void   store      ( double* address, Vector v ) { _mm512_storeu_pd ( address, v );                }
+		static Vector add        ( Vector a, Vector b )        { return _mm512_add_pd ( a, b );                  }
+		static Vector subtract   ( Vector a, Vector b )        { return _mm512_sub_pd ( a, b );                  }
+		static Vector multiply   ( Vector a, Vector b )        { return _mm512_mul_pd ( a, b );                  }
+		static Vector divide     ( Vector a, Vector b )        { return _mm512_div_pd ( a, b );                  }
+		static Vector squareRoot ( Vector a )                  { return _mm512_sqrt_pd ( a );                    }
+		static Mask   greater    ( Vector a, Vector b )        { return _mm512_cmp_pd_mask ( a, b, _CMP_GT_OQ ); }
+		static Mask   less       ( Vector a, Vector b )        { return _mm512_cmp_pd_mask ( a, b, _CMP_LT_OQ ); }
+		static Vector keep       ( Mask mask, Vector v )       { return _mm512_maskz_mov_pd ( mask, v );         }
+		static double sum        ( Vector v )                  { return _mm512_reduce_add_pd ( v );              }
+	};
+
+	//*****************************************************************************************************************
+	// Struct: AVX512Float
+	//
+	// Description:
+	//
+	//   Sixteen floats per __m512. Masks are one bit per lane.
+	//
+	//*****************************************************************************************************************
+
+	struct AVX512Float
+	{
+		using Scalar = float;
+		using Vector = __m512;
+		using Mask   = __mmask16;
+
+		static constexpr std::size_t WIDTH = 16;
+
+		static Vector broadcast  ( float value )              { return _mm512_set1_ps ( value );                }
+		static Vector load       ( const float* address )     { return _mm512_loadu_ps ( address );             }
+		static void   store      ( float* address, Vector v ) { _mm512_storeu_ps ( address, v );                }
+		static Vector add        ( Vector a, Vector b )       { return _mm512_add_ps ( a, b );                  }
+		static Vector subtract   ( Vector a, Vector b )       { return _mm512_sub_ps ( a, b );                  }
+		static Vector multiply   ( Vector a, Vector b )       { return _mm512_mul_ps ( a, b );                  }
+		static Vector divide     ( Vector a, Vector b )       { return _mm512_div_ps ( a, b );                  }
+		static Vector squareRoot ( Vector a )                 { return _mm512_sqrt_ps ( a );                    }
+		static Mask   greater    ( Vector a, Vector b )       { return _mm512_cmp_ps_mask ( a, b, _CMP_GT_OQ ); }
+		static Mask   less       ( Vector a, Vector b )       { return _mm512_cmp_ps_mask ( a, b, _CMP_LT_OQ ); }
+		static Vector keep       ( Mask mask, Vector v )      { return _mm512_maskz_mov_ps ( mask, v );         }
+		static float  sum        ( Vector v )                 { return _mm512_reduce_add_ps ( v );              }
+	};
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	std::size_t accumulatePairForcesAVX512 ( const PairForceArrays <double>& arrays, const PairForceLaws <double>& laws, std::size_t firstRow, std::size_t lastRow )
+	{
+		return accumulatePairForcesVector <AVX512Double> ( arrays, laws, firstRow, lastRow );
+	}
+
+	std::size_t accumulatePairForcesAVX512 ( const PairForceArrays <float>& arrays, const PairForceLaws <float>& laws, std::size_t firstRow, std::size_t lastRow )
+	{
+		return accumulatePairForcesVector <AVX512Float> ( arrays, laws, firstRow, lastRow );
+	}
+}
+
+#endif
@@ -0,0 +1,300 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the all-pairs gravity and repulsion kernel over packed particle arrays, with a scalar implementation
+//   and SSE2, AVX2, and AVX-512 implementations chosen at run time.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "InstructionSet.h"
+
+#include <cmath>
+#include <cstddef>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	//*****************************************************************************************************************
+	// Struct: PairForceArrays
+	//
+	// Description:
+	//
+	//   Packed, structure-of-arrays view of the particles a pair force kernel reads and writes. Point i is element i
+	//   of every array. Forces are added to forceX and forceY, which the caller clears.
+	//
+	//*****************************************************************************************************************
+
+	template <typename T>
+	struct PairForceArrays
+	{
+		const T*    positionX = nullptr;
+		const T*    positionY = nullptr;
+		const T*    mass      = nullptr;
+		const T*    radius    = nullptr;
+		T*          forceX    = nullptr;
+		T*          forceY    = nullptr;
+		std::size_t count     = 0;
+	};
+
+	//*****************************************************************************************************************
+	// Struct: PairForceLaws
+	//
+	// Description:
+	//
+	//   The force law constants and which laws are enabled.
+	//
+	//   - Gravity attracts pairs that are apart with the softened inverse-square law.
+	//
+	//   - Repulsion pushes pairs apart with a quadratic falloff between their combined radii and twice that distance.
+	//
+	//   - Overlapping pairs feel neither law; the collider handles contact.
+	//
+	//*****************************************************************************************************************
+
+	template <typename T>
+	struct PairForceLaws
+	{
+		T    gravitationalConstant = T ( 0 );
+		T    repulsiveConstant     = T ( 0 );
+		T    softeningEpsilon      = T ( 0 );
+		bool gravity               = true;
+		bool repulsion             = true;
+	};
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: pairForce
+	//
+	// Description:
+	//
+	//   Compute the combined force of the enabled laws on point i from point j.
+	//
+	//   Each law is expressed as force per unit distance and applied to the displacement directly, so gravity costs a
+	//   single division for both the law and the normalisation.
+	//
+	// Arguments:
+	//
+	//   arrays (const PairForceArrays <T>&):
+	//     The packed points.
+	//
+	//   laws (const PairForceLaws <T>&):
+	//     The force law constants. The enabled flags are ignored in favour of the template parameters.
+	//
+	//   i, j (std::size_t):
+	//     The pair's indices.
+	//
+	//   pairX, pairY (T&):
+	//     Receive the force on point i. The force on point j is its negation.
+	//
+	// Returns:
+	//
+	//   True if a force acts, false if the points overlap or are out of range of the enabled laws.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename T, bool Gravity, bool Repulsion>
+	inline bool pairForce ( const PairForceArrays <T>& arrays, const PairForceLaws <T>& laws, std::size_t i, std::size_t j, T& pairX, T& pairY )
+	{
+		T deltaX          = arrays.positionX [ j ] - arrays.positionX [ i ];
+		T deltaY          = arrays.positionY [ j ] - arrays.positionY [ i ];
+		T distanceSquared = deltaX * deltaX + deltaY * deltaY;
+		T minimumDistance = arrays.radius [ i ] + arrays.radius [ j ];
+		T threshold       = minimumDistance * T ( 2 );
+
+		// Overlapping pairs are left to the collider. Without gravity, pairs beyond the threshold feel nothing.
+
+		if ( distanceSquared <= minimumDistance * minimumDistance ) return false;
+		if ( !Gravity && distanceSquared >= threshold * threshold ) return false;
+
+		T distance = std::sqrt ( distanceSquared );
+
+		// Signed force per unit distance along the displacement from i to j: attraction is positive, repulsion
+		// negative.
+
+		T forcePerDistance = T ( 0 );
+
+		if ( Gravity )
+		{
+			forcePerDistance = laws.gravitationalConstant * arrays.mass [ i ] * arrays.mass [ j ] / ( ( distanceSquared + laws.softeningEpsilon * laws.softeningEpsilon ) * distance );
+		}
+
+		if ( Repulsion && distance < threshold )
+		{
+			T oneMinusScaleFactor = T ( 1 ) - ( distance - minimumDistance ) / ( threshold - minimumDistance );
+
+			forcePerDistance -= laws.repulsiveConstant * oneMinusScaleFactor * oneMinusScaleFactor / distance;
+		}
+
+		pairX = forcePerDistance * deltaX;
+		pairY = forcePerDistance * deltaY;
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: accumulatePairRow
+	//
+	// Description:
+	//
+	//   Apply the force between point i and each point j in [ first, count ), one pair at a time. Used by the scalar
+	//   kernel and for the tail that does not fill a vector.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename T, bool Gravity, bool Repulsion>
+	inline void accumulatePairRow ( const PairForceArrays <T>& arrays, const PairForceLaws <T>& laws, std::size_t i, std::size_t first )
+	{
+		T sumX = T ( 0 );
+		T sumY = T ( 0 );
+
+		for ( std::size_t j = first; j < arrays.count; ++j )
+		{
+			T pairX, pairY;
+
+			if ( !pairForce <T, Gravity, Repulsion> ( arrays, laws, i, j, pairX, pairY ) ) continue;
+
+			sumX                += pairX;
+			sumY                += pairY;
+			arrays.forceX [ j ] -= pairX;
+			arrays.forceY [ j ] -= pairY;
+		}
+
+		arrays.forceX [ i ] += sumX;
+		arrays.forceY [ i ] += sumY;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: accumulatePairForcesScalar
+	//
+	// Description:
+	//
+	//   Apply the enabled laws to every pair, or to every pair whose lower index is in [ firstRow, lastRow ), one
+	//   pair at a time. This is the reference the vector kernels are checked against.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename T>
+	inline void accumulatePairForcesScalar ( const PairForceArrays <T>& arrays, const PairForceLaws <T>& laws, std::size_t firstRow, std::size_t lastRow )
+	{
+		for ( std::size_t i = firstRow; i < lastRow; ++i )
+		{
+			if ( laws.gravity && laws.repulsion ) accumulatePairRow <T, true,  true>  ( arrays, laws, i, i + 1 );
+			else if ( laws.gravity )              accumulatePairRow <T, true,  false> ( arrays, laws, i, i + 1 );
+			else if ( laws.repulsion )            accumulatePairRow <T, false, true>  ( arrays, laws, i, i + 1 );
+		}
+	}
+
+	template <typename T>
+	inline void accumulatePairForcesScalar ( const PairForceArrays <T>& arrays, const PairForceLaws <T>& laws )
+	{
+		accumulatePairForcesScalar ( arrays, laws, 0, arrays.count );
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Functions: accumulatePairForcesSSE2, accumulatePairForcesAVX2, accumulatePairForcesAVX512
+	//
+	// Description:
+	//
+	//   The vector kernels, each compiled in its own translation unit with the matching target flags. They must only
+	//   be called when the CPU supports the instruction set; use accumulatePairForces to dispatch.
+	//
+	//   Each row i in [ firstRow, lastRow ) is processed a whole vector at a time, so the last ( count - i - 1 ) %
+	//   WIDTH pairs of the row are left to the caller. Keeping the scalar code out of the flagged translation units stops the linker from
+	//   picking a flagged copy of a shared inline function for callers on older CPUs.
+	//
+	// Returns:
+	//
+	//   The vector width in elements, WIDTH.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	std::size_t accumulatePairForcesSSE2   ( const PairForceArrays <double>& arrays, const PairForceLaws <double>& laws, std::size_t firstRow, std::size_t lastRow );
+	std::size_t accumulatePairForcesSSE2   ( const PairForceArrays <float>&  arrays, const PairForceLaws <float>&  laws, std::size_t firstRow, std::size_t lastRow );
+	std::size_t accumulatePairForcesAVX2   ( const PairForceArrays <double>& arrays, const PairForceLaws <double>& laws, std::size_t firstRow, std::size_t lastRow );
+	std::size_t accumulatePairForcesAVX2   ( const PairForceArrays <float>&  arrays, const PairForceLaws <float>&  laws, std::size_t firstRow, std::size_t lastRow );
+	std::size_t accumulatePairForcesAVX512 ( const PairForceArrays <double>& arrays, const PairForceLaws <double>& laws, std::size_t firstRow, std::size_t lastRow );
+	std::size_t accumulatePairForcesAVX512 ( const PairForceArrays <float>&  arrays, const PairForceLaws <float>&  laws, std::size_t firstRow, std::size_t lastRow );
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: accumulatePairForces
+	//
+	// Description:
+	//
+	//   Apply the enabled laws to every pair, or to every pair whose lower index is in [ firstRow, lastRow ), with
+	//   the requested kernel, falling back to the widest one the CPU supports. The pairs a vector kernel leaves at
+	//   the end of each row are finished with the scalar row.
+	//
+	//   A row range writes the forces of its own rows and of every later point, so ranges run side by side need
+	//   force arrays of their own.
+	//
+	//   Results match the scalar kernel to within rounding: each pair's force is computed the same way, but the
+	//   per-point sums are added in a different order.
+	//
+	// Arguments:
+	//
+	//   instructionSet (InstructionSet):
+	//     The requested kernel.
+	//
+	//   arrays (const PairForceArrays <T>&):
+	//     The packed points. Forces are added to forceX and forceY.
+	//
+	//   laws (const PairForceLaws <T>&):
+	//     The force law constants and enabled flags.
+	//
+	//   firstRow, lastRow (std::size_t):
+	//     The range of lower indices to visit. Every pair when omitted.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename T>
+	inline void accumulatePairForces ( InstructionSet instructionSet, const PairForceArrays <T>& arrays, const PairForceLaws <T>& laws, std::size_t firstRow, std::size_t lastRow )
+	{
+		std::size_t width = 0;
+
+		switch ( supportedInstructionSet ( instructionSet ) )
+		{
+			#if ENGINE_SIMD_X86
+				case InstructionSet::AVX512: width = accumulatePairForcesAVX512 ( arrays, laws, firstRow, lastRow ); break;
+				case InstructionSet::AVX2:   width = accumulatePairForcesAVX2   ( arrays, laws, firstRow, lastRow ); break;
+				case InstructionSet::SSE2:   width = accumulatePairForcesSSE2   ( arrays, laws, firstRow, lastRow ); break;
+			#endif
+			default:                         accumulatePairForcesScalar ( arrays, laws, firstRow, lastRow ); return;
+		}
+
+		for ( std::size_t i = firstRow; i < lastRow; ++i )
+		{
+			std::size_t first = i + 1 + ( arrays.count - i - 1 ) / width * width;
+
+			if ( laws.gravity && laws.repulsion ) accumulatePairRow <T, true,  true>  ( arrays, laws, i, first );
+			else if ( laws.gravity )              accumulatePairRow <T, true,  false> ( arrays, laws, i, first );
+			else if ( laws.repulsion )            accumulatePairRow <T, false, true>  ( arrays, laws, i, first );
+		}
+	}
+
+	template <typename T>
+	inline void accumulatePairForces ( InstructionSet instructionSet, const PairForceArrays <T>& arrays, const PairForceLaws <T>& laws )
+	{
+		accumulatePairForces ( instructionSet, arrays, laws, 0, arrays.count );
+	}
+}
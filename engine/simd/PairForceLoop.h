@@ -0,0 +1,147 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the vector all-pairs force loop shared by the SSE2, AVX2, and AVX-512 kernels.
+//
+//   Only included by the kernel translation units, each of which supplies a vector type for its instruction set and
+//   is compiled with the matching target flags. Nothing here calls the scalar inline functions of
+//   PairForceKernel.h, so no flagged copy of them is emitted.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "PairForceKernel.h"
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: accumulatePairRows
+	//
+	// Description:
+	//
+	//   Apply the enabled laws to every pair whose lower index is in [ firstRow, lastRow ), WIDTH pairs at a time.
+	//
+	//   V is a vector type providing Scalar, Vector, Mask, WIDTH, and the static operations broadcast, load, store,
+	//   add, subtract, multiply, divide, squareRoot, greater, less, keep (zero the lanes not in a mask), and sum
+	//   (add the lanes).
+	//
+	//   Point i is broadcast and compared with WIDTH consecutive points j at once. The range tests become lane masks,
+	//   so lanes for overlapping or distant pairs contribute zero. The tail of each row that does not fill a vector
+	//   is left to accumulatePairForces.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename V, bool Gravity, bool Repulsion>
+	void accumulatePairRows ( const PairForceArrays <typename V::Scalar>& arrays, const PairForceLaws <typename V::Scalar>& laws, std::size_t firstRow, std::size_t lastRow )
+	{
+		using T      = typename V::Scalar;
+		using Vector = typename V::Vector;
+		using Mask   = typename V::Mask;
+
+		const std::size_t n = arrays.count;
+
+		const Vector one               = V::broadcast ( T ( 1 ) );
+		const Vector two               = V::broadcast ( T ( 2 ) );
+		const Vector softeningSquared  = V::broadcast ( laws.softeningEpsilon * laws.softeningEpsilon );
+		const Vector repulsiveConstant = V::broadcast ( laws.repulsiveConstant );
+
+		for ( std::size_t i = firstRow; i < lastRow; ++i )
+		{
+			const Vector positionXA = V::broadcast ( arrays.positionX [ i ] );
+			const Vector positionYA = V::broadcast ( arrays.positionY [ i ] );
+			const Vector radiusA    = V::broadcast ( arrays.radius [ i ] );
+			const Vector massA      = V::broadcast ( laws.gravitationalConstant * arrays.mass [ i ] );
+
+			Vector sumX = V::broadcast ( T ( 0 ) );
+			Vector sumY = V::broadcast ( T ( 0 ) );
+
+			std::size_t j = i + 1;
+
+			for ( ; j + V::WIDTH <= n; j += V::WIDTH )
+			{
+				Vector deltaX          = V::subtract ( V::load ( arrays.positionX + j ), positionXA );
+				Vector deltaY          = V::subtract ( V::load ( arrays.positionY + j ), positionYA );
+				Vector distanceSquared = V::add ( V::multiply ( deltaX, deltaX ), V::multiply ( deltaY, deltaY ) );
+				Vector minimumDistance = V::add ( radiusA, V::load ( arrays.radius + j ) );
+				Vector threshold       = V::multiply ( minimumDistance, two );
+				Vector distance        = V::squareRoot ( distanceSquared );
+				Mask   apart           = V::greater ( distanceSquared, V::multiply ( minimumDistance, minimumDistance ) );
+
+				Vector forcePerDistance = V::broadcast ( T ( 0 ) );
+
+				if ( Gravity )
+				{
+					Vector massProduct = V::multiply ( massA, V::load ( arrays.mass + j ) );
+
+					forcePerDistance = V::divide ( massProduct, V::multiply ( V::add ( distanceSquared, softeningSquared ), distance ) );
+				}
+
+				if ( Repulsion )
+				{
+					Vector scaleFactor         = V::divide ( V::subtract ( distance, minimumDistance ), V::subtract ( threshold, minimumDistance ) );
+					Vector oneMinusScaleFactor = V::subtract ( one, scaleFactor );
+					Vector repulsion           = V::divide ( V::multiply ( V::multiply ( repulsiveConstant, oneMinusScaleFactor ), oneMinusScaleFactor ), distance );
+
+					forcePerDistance = V::subtract ( forcePerDistance, V::keep ( V::less ( distance, threshold ), repulsion ) );
+				}
+
+				// Masking last discards the infinities and NaNs of coincident points.
+
+				forcePerDistance = V::keep ( apart, forcePerDistance );
+
+				Vector pairX = V::multiply ( forcePerDistance, deltaX );
+				Vector pairY = V::multiply ( forcePerDistance, deltaY );
+
+				sumX = V::add ( sumX, pairX );
+				sumY = V::add ( sumY, pairY );
+
+				V::store ( arrays.forceX + j, V::subtract ( V::load ( arrays.forceX + j ), pairX ) );
+				V::store ( arrays.forceY + j, V::subtract ( V::load ( arrays.forceY + j ), pairY ) );
+			}
+
+			arrays.forceX [ i ] += V::sum ( sumX );
+			arrays.forceY [ i ] += V::sum ( sumY );
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+	// Function: accumulatePairForcesVector
+	//
+	// Description:
+	//
+	//   Select the vector loop for the enabled laws and return the vector width.
+	//
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename V>
+	std::size_t accumulatePairForcesVector ( const PairForceArrays <typename V::Scalar>& arrays, const PairForceLaws <typename V::Scalar>& laws, std::size_t firstRow, std::size_t lastRow )
+	{
+		if ( laws.gravity && laws.repulsion ) accumulatePairRows <V, true,  true>  ( arrays, laws, firstRow, lastRow );
+		else if ( laws.gravity )              accumulatePairRows <V, true,  false> ( arrays, laws, firstRow, lastRow );
+		else if ( laws.repulsion )            accumulatePairRows <V, false, true>  ( arrays, laws, firstRow, lastRow );
+
+		return V::WIDTH;
+	}
+}
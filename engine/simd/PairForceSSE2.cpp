@@ -0,0 +1,133 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   SSE2 implementation of the all-pairs force kernel: 2 doubles or 4 floats per instruction. SSE2 is part of the
+//   x86-64 baseline, so this file needs no extra target flags.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#include "PairForceLoop.h"
+
+#if ENGINE_SIMD_X86
+
+#include <emmintrin.h>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Anonymous Namespace
+//
+// Description:
+//
+//   Vector types for PairForceLoop.h, kept local to this translation unit.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+	//*****************************************************************************************************************
+	// Struct: SSE2Double
+	//
+	// Description:
+	//
+	//   Two doubles per __m128d. Masks are all-ones or all-zero lanes.
+	//
+	//*****************************************************************************************************************
+
+	struct SSE2Double
+	{
+		using Scalar = double;
+		using Vector = __m128d;
+		using Mask   = __m128d;
+
+		static constexpr std::size_t WIDTH = 2;
+
+		static Vector broadcast  ( double value )              { return _mm_set1_pd ( value );    }
+		static Vector load       ( const double* address )     { return _mm_loadu_pd ( address ); }
+		static void   store      ( double* address, Vector v ) { _mm_storeu_pd ( address, v );    }
+		static Vector add        ( Vector a, Vector b )        { return _mm_add_pd ( a, b );      }
+		static Vector subtract   ( Vector a, Vector b )        { return _mm_sub_pd ( a, b );      }
+		static Vector multiply   ( Vector a, Vector b )        { return _mm_mul_pd ( a, b );      }
+		static Vector divide     ( Vector a, Vector b )        { return _mm_div_pd ( a, b );      }
+		static Vector squareRoot ( Vector a )                  { return _mm_sqrt_pd ( a );        }
+		static Mask   greater    ( Vector a, Vector b )        { return _mm_cmpgt_pd ( a, b );    }
+		static Mask   less       ( Vector a, Vector b )        { return _mm_cmplt_pd ( a, b );    }
+		static Vector keep       ( Mask mask, Vector v )       { return _mm_and_pd ( mask, v );   }
+
+		static double sum ( Vector v )
+		{
+			return _mm_cvtsd_f64 ( _mm_add_sd ( v, _mm_unpackhi_pd ( v, v ) ) );
+		}
+	};
+
+	//*****************************************************************************************************************
+	// Struct: SSE2Float
+	//
+	// Description:
+	//
+	//   Four floats per __m128. Masks are all-ones or all-zero lanes.
+	//
+	//*****************************************************************************************************************
+
+	struct SSE2Float
+	{
+		using Scalar = float;
+		using Vector = __m128;
+		using Mask   = __m128;
+
+		static constexpr std::size_t WIDTH = 4;
+
+		static Vector broadcast  ( float value )              { return _mm_set1_ps ( value );    }
+		static Vector load       ( const float* address )     { return _mm_loadu_ps ( address ); }
+		static void   store      ( float* address, Vector v ) { _mm_storeu_ps ( address, v );    }
+		static Vector add        ( Vector a, Vector b )       { return _mm_add_ps ( a, b );      }
+		static Vector subtract   ( Vector a, Vector b )       { return _mm_sub_ps ( a, b );      }
+		static Vector multiply   ( Vector a, Vector b )       { return _mm_mul_ps ( a, b );      }
+		static Vector divide     ( Vector a, Vector b )       { return _mm_div_ps ( a, b );      }
+		static Vector squareRoot ( Vector a )                 { return _mm_sqrt_ps ( a );        }
+		static Mask   greater    ( Vector a, Vector b )       { return _mm_cmpgt_ps ( a, b );    }
+		static Mask   less       ( Vector a, Vector b )       { return _mm_cmplt_ps ( a, b );    }
+		static Vector keep       ( Mask mask, Vector v )      { return _mm_and_ps ( mask, v );   }
+
+		static float sum ( Vector v )
+		{
+			Vector pairs = _mm_add_ps ( v, _mm_movehl_ps ( v, v ) );
+
+			return _mm_cvtss_f32 ( _mm_add_ss ( pairs, _mm_shuffle_ps ( pairs, pairs, 1 ) ) );
+		}
+	};
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	std::size_t accumulatePairForcesSSE2 ( const PairForceArrays <double>& arrays, const PairForceLaws <double>& laws, std::size_t firstRow, std::size_t lastRow )
+	{
+		return accumulatePairForcesVector <SSE2Double> ( arrays, laws, firstRow, lastRow );
+	}
+
+	std::size_t accumulatePairForcesSSE2 ( const PairForceArrays <float>& arrays, const PairForceLaws <float>& laws, std::size_t firstRow, std::size_t lastRow )
+	{
+		return accumulatePairForcesVector <SSE2Float> ( arrays, laws, firstRow, lastRow );
+	}
+}
+
+#endif
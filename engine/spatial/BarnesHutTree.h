@@ -0,0 +1,417 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the BarnesHutTree class, a quadtree of mass-weighted centres used to approximate softened
+//   inverse-square attraction in O(N log N).
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "../math/Vector2D.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	//*****************************************************************************************************************
+	// Class: BarnesHutTree
+	//
+	// Description:
+	//
+	//   Quadtree over a snapshot of bodies, with each node holding the total mass and mass-weighted centre of the
+	//   bodies beneath it.
+	//
+	//   - build () copies the bodies and sorts them into leaf order, so each leaf is a contiguous run. Nodes and
+	//     bodies are flat arrays whose storage is reused across builds.
+	//
+	//   - force () walks the tree for one body. A node is replaced by its centre of mass when its size is less than
+	//     theta times its distance, and no body in it can overlap the target; otherwise it is opened. Leaves are
+	//     summed body by body. A theta of zero opens every node and gives the exact sum.
+	//
+	//   - Bodies closer than their combined radii exert no force on each other, matching the exact solver.
+	//
+	//*****************************************************************************************************************
+
+	class BarnesHutTree
+	{
+	public:
+
+		//=============================================================================================================
+		// Struct: Body
+		//
+		// Description:
+		//
+		//   One point mass with a contact radius.
+		//
+		//=============================================================================================================
+
+		struct Body
+		{
+			Vector2D position;
+			double   mass   = 0.0;
+			double   radius = 0.0;
+		};
+
+	private:
+
+		//=============================================================================================================
+		// Struct: Node
+		//
+		// Description:
+		//
+		//   One square cell. For a leaf, first and count select a run of bodies; otherwise they select a run of
+		//   child nodes.
+		//
+		//=============================================================================================================
+
+		struct Node
+		{
+			Vector2D centreOfMass;
+			Vector2D centre;
+			double   halfSize      = 0.0;
+			double   mass          = 0.0;
+			double   maximumRadius = 0.0;
+			uint32_t first         = 0;
+			uint32_t count         = 0;
+			bool     leaf          = true;
+		};
+
+		//=============================================================================================================
+		// Constants
+		//=============================================================================================================
+
+		static constexpr std::size_t LEAF_CAPACITY = 8;
+		static constexpr int         MAX_DEPTH     = 32;
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		std::vector <Node>     nodes;
+		std::vector <Body>     bodies;
+		std::vector <uint32_t> order;
+		std::vector <uint32_t> slots;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessors: size, getNodeCount
+		//
+		// Description:
+		//
+		//   Return the number of bodies and nodes in the last build.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t size         () const { return bodies.size (); }
+		std::size_t getNodeCount () const { return nodes.size ();  }
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: build
+		//
+		// Description:
+		//
+		//   Build the tree over a set of bodies, replacing the previous contents.
+		//
+		// Arguments:
+		//
+		//   source (const Body*):
+		//     The bodies. Bodies are later identified by their index in this array.
+		//
+		//   count (std::size_t):
+		//     The number of bodies.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void build ( const Body* source, std::size_t count )
+		{
+			nodes.clear   ();
+			bodies.resize ( count );
+			order.resize  ( count );
+			slots.resize  ( count );
+
+			if ( count == 0 ) return;
+
+			for ( std::size_t i = 0; i < count; ++i ) order [ i ] = static_cast <uint32_t> ( i );
+
+			// Fit a square around all bodies.
+
+			Vector2D lower = source [ 0 ].position;
+			Vector2D upper = source [ 0 ].position;
+
+			for ( std::size_t i = 1; i < count; ++i )
+			{
+				lower.x = std::min ( lower.x, source [ i ].position.x );
+				lower.y = std::min ( lower.y, source [ i ].position.y );
+				upper.x = std::max ( upper.x, source [ i ].position.x );
+				upper.y = std::max ( upper.y, source [ i ].position.y );
+			}
+
+			Node root;
+
+			root.centre   = Vector2D ( 0.5 * ( lower.x + upper.x ), 0.5 * ( lower.y + upper.y ) );
+			root.halfSize = 0.5 * std::max ( upper.x - lower.x, upper.y - lower.y ) + 1e-12;
+			root.first    = 0;
+			root.count    = static_cast <uint32_t> ( count );
+
+			nodes.push_back ( root );
+			subdivide ( source, 0, 0 );
+
+			// Store the bodies in leaf order, and record where each original body ended up.
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				bodies [ i ]          = source [ order [ i ] ];
+				slots [ order [ i ] ] = static_cast <uint32_t> ( i );
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: force
+		//
+		// Description:
+		//
+		//   Return the approximate force the other bodies exert on one body.
+		//
+		//   Each contribution is G m1 m2 / ( d^2 + epsilon^2 ) along the unsoftened unit direction.
+		//
+		// Arguments:
+		//
+		//   index (std::size_t):
+		//     The body's index in the array passed to build.
+		//
+		//   theta (double):
+		//     The opening angle. Smaller is more accurate and slower.
+		//
+		//   gravitationalConstant (double):
+		//     The constant G.
+		//
+		//   softeningEpsilon (double):
+		//     The softening length epsilon.
+		//
+		// Returns:
+		//
+		//   The force on the body.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		Vector2D force ( std::size_t index, double theta, double gravitationalConstant, double softeningEpsilon ) const
+		{
+			const uint32_t self             = slots [ index ];
+			const Body&    target           = bodies [ self ];
+			const double   softeningSquared = softeningEpsilon * softeningEpsilon;
+			const double   thetaSquared     = theta * theta;
+			double         forceX           = 0.0;
+			double         forceY           = 0.0;
+
+			// Accumulate the attraction from a point mass, skipping contact and coincidence.
+
+			auto attract = [ & ] ( const Vector2D& position, double mass, double contactDistance )
+			{
+				double deltaX          = position.x - target.position.x;
+				double deltaY          = position.y - target.position.y;
+				double distanceSquared = deltaX * deltaX + deltaY * deltaY;
+				double distance        = std::sqrt ( distanceSquared );
+
+				if ( distance <= contactDistance ) return;
+
+				double forceMagnitude = gravitationalConstant * target.mass * mass / ( distanceSquared + softeningSquared );
+
+				forceX += forceMagnitude * deltaX / distance;
+				forceY += forceMagnitude * deltaY / distance;
+			};
+
+			uint32_t stack [ 4 * MAX_DEPTH + 4 ];
+			int      top = 0;
+
+			stack [ top++ ] = 0;
+
+			while ( top > 0 )
+			{
+				const Node& node = nodes [ stack [ --top ] ];
+
+				if ( node.leaf )
+				{
+					for ( uint32_t b = node.first; b < node.first + node.count; ++b )
+					{
+						if ( b != self ) attract ( bodies [ b ].position, bodies [ b ].mass, target.radius + bodies [ b ].radius );
+					}
+
+					continue;
+				}
+
+				// Accept the centre of mass if the node is small relative to its distance and lies entirely beyond
+				// contact range of every body in it.
+
+				double deltaX          = node.centreOfMass.x - target.position.x;
+				double deltaY          = node.centreOfMass.y - target.position.y;
+				double distanceSquared = deltaX * deltaX + deltaY * deltaY;
+				double size            = 2.0 * node.halfSize;
+				double gapX            = std::max ( std::abs ( target.position.x - node.centre.x ) - node.halfSize, 0.0 );
+				double gapY            = std::max ( std::abs ( target.position.y - node.centre.y ) - node.halfSize, 0.0 );
+				double contactDistance = target.radius + node.maximumRadius;
+
+				if ( size * size < thetaSquared * distanceSquared && gapX * gapX + gapY * gapY > contactDistance * contactDistance )
+				{
+					attract ( node.centreOfMass, node.mass, 0.0 );
+					continue;
+				}
+
+				for ( uint32_t c = node.first; c < node.first + node.count; ++c ) stack [ top++ ] = c;
+			}
+
+			return Vector2D ( forceX, forceY );
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: subdivide
+		//
+		// Description:
+		//
+		//   Split a node's bodies into quadrants, recurse into each non-empty quadrant, and fill in the node's mass,
+		//   centre of mass, and maximum radius.
+		//
+		//   Nodes at LEAF_CAPACITY bodies or fewer, or at MAX_DEPTH, stay leaves. The depth limit bounds the tree
+		//   when many bodies share a position.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void subdivide ( const Body* source, uint32_t index, int depth )
+		{
+			Node node = nodes [ index ];
+
+			if ( node.count <= LEAF_CAPACITY || depth == MAX_DEPTH )
+			{
+				double   mass          = 0.0;
+				double   maximumRadius = 0.0;
+				Vector2D weighted;
+
+				for ( uint32_t i = node.first; i < node.first + node.count; ++i )
+				{
+					const Body& body = source [ order [ i ] ];
+
+					mass          += body.mass;
+					weighted.x    += body.mass * body.position.x;
+					weighted.y    += body.mass * body.position.y;
+					maximumRadius  = std::max ( maximumRadius, body.radius );
+				}
+
+				setMass ( nodes [ index ], mass, weighted, maximumRadius );
+				return;
+			}
+
+			// Partition the run by y, then each half by x, giving the quadrants in order.
+
+			auto begin = order.begin () + node.first;
+			auto end   = begin + node.count;
+
+			auto below = [ & ] ( uint32_t b ) { return source [ b ].position.y < node.centre.y; };
+			auto left  = [ & ] ( uint32_t b ) { return source [ b ].position.x < node.centre.x; };
+
+			auto middle     = std::partition ( begin,  end,    below );
+			auto lowerSplit = std::partition ( begin,  middle, left );
+			auto upperSplit = std::partition ( middle, end,    left );
+
+			decltype ( begin ) bounds [ 5 ] = { begin, lowerSplit, middle, upperSplit, end };
+
+			// Append the non-empty children contiguously before recursing, so the node can address them as a run.
+
+			double   quarterSize = 0.5 * node.halfSize;
+			uint32_t firstChild  = static_cast <uint32_t> ( nodes.size () );
+
+			for ( int q = 0; q < 4; ++q )
+			{
+				if ( bounds [ q ] == bounds [ q + 1 ] ) continue;
+
+				Node child;
+
+				child.centre   = Vector2D ( node.centre.x + ( q & 1 ? quarterSize : -quarterSize ), node.centre.y + ( q & 2 ? quarterSize : -quarterSize ) );
+				child.halfSize = quarterSize;
+				child.first    = static_cast <uint32_t> ( bounds [ q ] - order.begin () );
+				child.count    = static_cast <uint32_t> ( bounds [ q + 1 ] - bounds [ q ] );
+
+				nodes.push_back ( child );
+			}
+
+			uint32_t childCount = static_cast <uint32_t> ( nodes.size () ) - firstChild;
+
+			for ( uint32_t c = firstChild; c < firstChild + childCount; ++c ) subdivide ( source, c, depth + 1 );
+
+			// Combine the children. The node's body run is re-used as its child run.
+
+			double   mass          = 0.0;
+			double   maximumRadius = 0.0;
+			Vector2D weighted;
+
+			for ( uint32_t c = firstChild; c < firstChild + childCount; ++c )
+			{
+				const Node& child = nodes [ c ];
+
+				mass          += child.mass;
+				weighted.x    += child.mass * child.centreOfMass.x;
+				weighted.y    += child.mass * child.centreOfMass.y;
+				maximumRadius  = std::max ( maximumRadius, child.maximumRadius );
+			}
+
+			Node& parent = nodes [ index ];
+
+			parent.leaf  = false;
+			parent.first = firstChild;
+			parent.count = childCount;
+
+			setMass ( parent, mass, weighted, maximumRadius );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: setMass
+		//
+		// Description:
+		//
+		//   Store a node's totals. A massless node keeps its geometric centre as its centre of mass.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		static void setMass ( Node& node, double mass, const Vector2D& weighted, double maximumRadius )
+		{
+			node.mass          = mass;
+			node.maximumRadius = maximumRadius;
+			node.centreOfMass  = mass > 0.0 ? Vector2D ( weighted.x / mass, weighted.y / mass ) : node.centre;
+		}
+	};
+}
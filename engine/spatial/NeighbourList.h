@@ -0,0 +1,289 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the NeighbourList class, a Verlet neighbour list of point pairs within interaction range plus a skin
+//   distance, rebuilt only when points have moved far enough to invalidate it.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "../math/Vector2D.h"
+#include "SpatialHashGrid.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	//*****************************************************************************************************************
+	// Class: NeighbourList
+	//
+	// Description:
+	//
+	//   Pairs of points, by index, whose distance at build time was less than the sum of their reaches plus the
+	//   skin.
+	//
+	//   - Each point has a reach, the distance out to which it interacts. A pair closer than the sum of their
+	//     reaches is in the list for as long as neither point has moved more than half the skin since the build.
+	//
+	//   - Pairs are stored per point as the neighbours with a higher index, in ascending order, so walking the
+	//     list visits pairs in the same order as a nested i < j loop.
+	//
+	//   - Candidates are found with a SpatialHashGrid, so building is linear in the point count for bounded
+	//     density.
+	//
+	//*****************************************************************************************************************
+
+	class NeighbourList
+	{
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		double                 skin       = 0.0;
+		bool                   stale      = true;
+		std::size_t            buildCount = 0;
+		std::vector <Vector2D> anchors;
+		std::vector <double>   reaches;
+		std::vector <uint32_t> offsets;
+		std::vector <uint32_t> neighbours;
+		std::vector <uint32_t> candidates;
+		SpatialHashGrid        grid;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessors: getSkin, setSkin
+		//
+		// Description:
+		//
+		//   Get or set the skin distance. Setting it invalidates the list.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		double getSkin () const { return skin; }
+
+		void setSkin ( double distance )
+		{
+			skin  = distance;
+			stale = true;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessors: size, getPairCount, getBuildCount
+		//
+		// Description:
+		//
+		//   Return the number of points and pairs in the current list, and the number of builds so far.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		std::size_t size          () const { return anchors.size ();    }
+		std::size_t getPairCount  () const { return neighbours.size (); }
+		std::size_t getBuildCount () const { return buildCount;         }
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessors: begin, end
+		//
+		// Description:
+		//
+		//   Return the range of neighbours of point i with a higher index, in ascending order.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		const uint32_t* begin ( std::size_t i ) const { return neighbours.data () + offsets [ i ];     }
+		const uint32_t* end   ( std::size_t i ) const { return neighbours.data () + offsets [ i + 1 ]; }
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Predicate Accessor: displaced
+		//
+		// Description:
+		//
+		//   Check whether a point has moved more than half the skin from where it was at the last build.
+		//
+		// Arguments:
+		//
+		//   i (std::size_t):
+		//     The point index.
+		//
+		//   position (const Vector2D&):
+		//     The point's current position.
+		//
+		// Returns:
+		//
+		//   True if the list may no longer hold every pair in range of this point.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		bool displaced ( std::size_t i, const Vector2D& position ) const
+		{
+			double deltaX   = position.x - anchors [ i ].x;
+			double deltaY   = position.y - anchors [ i ].y;
+			double halfSkin = 0.5 * skin;
+
+			return deltaX * deltaX + deltaY * deltaY > halfSkin * halfSkin;
+		}
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: invalidate
+		//
+		// Description:
+		//
+		//   Force the next update to rebuild, for example after the set of points has changed.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		void invalidate ()
+		{
+			stale = true;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: update
+		//
+		// Description:
+		//
+		//   Rebuild the list if it is invalid, the point count or any reach has changed, or any point has moved more
+		//   than half the skin since the last build.
+		//
+		// Arguments:
+		//
+		//   count (std::size_t):
+		//     The number of points.
+		//
+		//   position (Position&&):
+		//     Callable taking a point index and returning its position as a Vector2D.
+		//
+		//   reach (Reach&&):
+		//     Callable taking a point index and returning its reach.
+		//
+		// Returns:
+		//
+		//   True if the list was rebuilt.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Position, typename Reach>
+		bool update ( std::size_t count, Position&& position, Reach&& reach )
+		{
+			bool rebuild = stale || count != anchors.size ();
+
+			for ( std::size_t i = 0; i < count && !rebuild; ++i )
+			{
+				rebuild = displaced ( i, position ( i ) ) || reach ( i ) != reaches [ i ];
+			}
+
+			if ( rebuild ) build ( count, position, reach );
+
+			return rebuild;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: build
+		//
+		// Description:
+		//
+		//   Rebuild the list from the current positions and reaches.
+		//
+		// Arguments:
+		//
+		//   count (std::size_t):
+		//     The number of points.
+		//
+		//   position (Position&&):
+		//     Callable taking a point index and returning its position as a Vector2D.
+		//
+		//   reach (Reach&&):
+		//     Callable taking a point index and returning its reach.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Position, typename Reach>
+		void build ( std::size_t count, Position&& position, Reach&& reach )
+		{
+			anchors.resize ( count );
+			reaches.resize ( count );
+			offsets.assign ( count + 1, 0 );
+			neighbours.clear ();
+
+			stale = false;
+			++buildCount;
+
+			double maximumReach = 0.0;
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				anchors [ i ] = position ( i );
+				reaches [ i ] = reach ( i );
+				maximumReach  = std::max ( maximumReach, reaches [ i ] );
+			}
+
+			// Any pair in range is at most one cell apart on each axis.
+
+			double cellSize = 2.0 * maximumReach + skin;
+
+			if ( count == 0 || cellSize <= 0.0 ) return;
+
+			grid.build ( count, cellSize, [ this ] ( std::size_t i ) -> const Vector2D& { return anchors [ i ]; } );
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				candidates.clear ();
+
+				grid.query
+				(
+					anchors [ i ],
+					[ & ] ( uint32_t j )
+					{
+						if ( j <= i ) return;
+
+						double deltaX = anchors [ j ].x - anchors [ i ].x;
+						double deltaY = anchors [ j ].y - anchors [ i ].y;
+						double range  = reaches [ i ] + reaches [ j ] + skin;
+
+						if ( deltaX * deltaX + deltaY * deltaY < range * range ) candidates.push_back ( j );
+					}
+				);
+
+				std::sort ( candidates.begin (), candidates.end () );
+
+				neighbours.insert ( neighbours.end (), candidates.begin (), candidates.end () );
+				offsets [ i + 1 ] = static_cast <uint32_t> ( neighbours.size () );
+			}
+		}
+	};
+}
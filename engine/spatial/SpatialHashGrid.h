@@ -0,0 +1,241 @@
+//---------------------------------------------------------------------------------------------------------------------
+// Project: ECS (Entity Component System) Game Engine
+// Version: 2.1 (C++17 Upgrade)
+// Date:    2011
+// Author:  Rohin Gosling
+//
+// Description:
+//
+//   Defines the SpatialHashGrid class, a uniform-grid broad phase that buckets 2D points by cell so that
+//   neighbourhood queries touch only nearby points.
+//
+// TODO:
+//
+//   1. None.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "../math/Vector2D.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//---------------------------------------------------------------------------------------------------------------------
+// Namespace: engine
+//
+// Description:
+//
+//   Core namespace for the game engine framework.
+//
+//   Contains math utilities, platform abstractions, resource management, and application infrastructure used to build
+//   game applications on top of the ECS layer.
+//
+//---------------------------------------------------------------------------------------------------------------------
+
+namespace engine
+{
+	//*****************************************************************************************************************
+	// Class: SpatialHashGrid
+	//
+	// Description:
+	//
+	//   Uniform grid over an unbounded plane, with cells hashed into a fixed table sized from the point count.
+	//
+	//   - build () takes a snapshot of point positions. Points are identified by their index in the snapshot and
+	//     are not tracked afterwards, so callers rebuild when points have moved far enough to matter.
+	//
+	//   - Buckets are laid out with a counting sort, so the whole grid is two flat arrays and rebuilding reuses
+	//     their storage. Within a bucket, points are in ascending index order.
+	//
+	//   - Distinct cells may share a bucket. Queries can therefore return points from outside the neighbourhood,
+	//     and callers must still apply their own exact test.
+	//
+	//*****************************************************************************************************************
+
+	class SpatialHashGrid
+	{
+	private:
+
+		//=============================================================================================================
+		// Data Members
+		//=============================================================================================================
+
+		double                 cellSize    = 1.0;
+		std::size_t            bucketMask  = 0;
+		std::vector <uint32_t> bucketStart;
+		std::vector <uint32_t> pointBucket;
+		std::vector <uint32_t> points;
+
+	public:
+
+		//=============================================================================================================
+		// Accessors
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Value Accessors: getCellSize, size
+		//
+		// Description:
+		//
+		//   Return the cell edge length and the number of points in the last build.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		double      getCellSize () const { return cellSize; }
+		std::size_t size        () const { return points.size (); }
+
+		//=============================================================================================================
+		// Methods
+		//=============================================================================================================
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: build
+		//
+		// Description:
+		//
+		//   Bucket a set of points by cell, replacing the previous contents.
+		//
+		// Arguments:
+		//
+		//   count (std::size_t):
+		//     The number of points.
+		//
+		//   size (double):
+		//     The cell edge length. Must be greater than zero.
+		//
+		//   position (Position&&):
+		//     Callable taking a point index and returning its position as a Vector2D.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Position>
+		void build ( std::size_t count, double size, Position&& position )
+		{
+			assert ( size > 0.0 && "Spatial hash cell size must be positive." );
+
+			cellSize = size;
+
+			// Use a power-of-two table with at least two buckets per point to keep shared buckets rare.
+
+			std::size_t bucketCount = 2;
+
+			while ( bucketCount < 2 * count ) bucketCount <<= 1;
+
+			bucketMask = bucketCount - 1;
+
+			// Count the points per bucket, then turn the counts into start offsets.
+
+			bucketStart.assign ( bucketCount + 1, 0 );
+			pointBucket.resize ( count );
+			points.resize      ( count );
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				const Vector2D& point = position ( i );
+
+				pointBucket [ i ] = bucket ( cell ( point.x ), cell ( point.y ) );
+				++bucketStart [ pointBucket [ i ] + 1 ];
+			}
+
+			for ( std::size_t b = 1; b <= bucketCount; ++b ) bucketStart [ b ] += bucketStart [ b - 1 ];
+
+			// Scatter the point indices into their buckets in ascending order, then shift the advanced offsets back
+			// to the bucket starts.
+
+			for ( std::size_t i = 0; i < count; ++i )
+			{
+				points [ bucketStart [ pointBucket [ i ] ]++ ] = static_cast <uint32_t> ( i );
+			}
+
+			for ( std::size_t b = bucketCount; b > 0; --b ) bucketStart [ b ] = bucketStart [ b - 1 ];
+
+			bucketStart [ 0 ] = 0;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: query
+		//
+		// Description:
+		//
+		//   Visit every point whose cell is the cell containing a position or one of its eight neighbours.
+		//
+		//   Any point within one cell size of the position on both axes is visited. Each point is visited at most
+		//   once; points sharing a bucket with a neighbouring cell may also be visited.
+		//
+		// Arguments:
+		//
+		//   position (const Vector2D&):
+		//     The query position.
+		//
+		//   function (Function&&):
+		//     Callable taking a point index (uint32_t).
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		template <typename Function>
+		void query ( const Vector2D& position, Function&& function ) const
+		{
+			int64_t     cellX = cell ( position.x );
+			int64_t     cellY = cell ( position.y );
+			uint32_t    visited [ 9 ];
+			std::size_t visitedCount = 0;
+
+			for ( int64_t dy = -1; dy <= 1; ++dy )
+			{
+				for ( int64_t dx = -1; dx <= 1; ++dx )
+				{
+					uint32_t b = bucket ( cellX + dx, cellY + dy );
+
+					// Skip a bucket already visited through another cell hashing to it.
+
+					bool seen = false;
+
+					for ( std::size_t v = 0; v < visitedCount; ++v ) seen = seen || visited [ v ] == b;
+
+					if ( seen ) continue;
+
+					visited [ visitedCount++ ] = b;
+
+					for ( uint32_t p = bucketStart [ b ]; p < bucketStart [ b + 1 ]; ++p ) function ( points [ p ] );
+				}
+			}
+		}
+
+	private:
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: cell
+		//
+		// Description:
+		//
+		//   Return the integer cell coordinate containing a world coordinate.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		int64_t cell ( double coordinate ) const
+		{
+			return static_cast <int64_t> ( std::floor ( coordinate / cellSize ) );
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// Method: bucket
+		//
+		// Description:
+		//
+		//   Hash a cell to its bucket.
+		//
+		//-------------------------------------------------------------------------------------------------------------
+
+		uint32_t bucket ( int64_t cellX, int64_t cellY ) const
+		{
+			uint64_t hash = static_cast <uint64_t> ( cellX ) * 73856093u ^ static_cast <uint64_t> ( cellY ) * 19349663u;
+
+			return static_cast <uint32_t> ( ( hash ^ ( hash >> 29 ) ) & bucketMask );
+		}
+	};
+}